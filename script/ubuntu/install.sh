@@ -10,5 +10,6 @@ sudo apt-get install cmake --yes
 sudo apt-get install flex --yes
 sudo apt-get install gcc --yes
 sudo apt-get install make --yes
+sudo apt-get install nodejs --yes
 
 echo "All done."
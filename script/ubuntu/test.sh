@@ -10,35 +10,123 @@ RED='\033[0;31m'
 OFF='\033[0m'
 STATUS=0
 
-echo "Compiler should accept..."
-echo ""
+# The JavaScript output runs under Node.js, where print writes a line.
+PRELUDE='function print(value) { console.log(value) }'
+if ! command -v node >/dev/null 2>&1; then
+	echo -e "${RED}Node.js is required to run the tests${OFF} (see install.sh)."
+	exit 1
+fi
+
+# The assembly of the x86-64 target is only assembled and run on such a host.
+NATIVE=0
+if [ "$(uname -m)" == "x86_64" ] && command -v as >/dev/null 2>&1 && command -v ld >/dev/null 2>&1; then
+	NATIVE=1
+fi
+
+# Usage: accepts <input> [arguments...]
+# Runs the output too, and compares what it prints with <input>.expected,
+# which every accepted program must have.
+function accepts() {
+	local input="$1"
+	shift
+	cat "$input" | build/Compiler "$@" >build/test.out 2>/dev/null
+	local result="$?"
+	if [ "$result" != "0" ]; then
+		STATUS=1
+		echo -e "    $(basename "$input") $*, ${RED}but it rejects${OFF} (status $result)"
+		return
+	fi
+	if [ ! -f "$input.expected" ]; then
+		STATUS=1
+		echo -e "    $(basename "$input") $*, ${RED}but it has no expected output${OFF}"
+		return
+	fi
+	if [ "$(head --bytes=1 build/test.out)" == "#" ]; then
+		if [ "$NATIVE" == "0" ]; then
+			echo -e "    $(basename "$input") $*, ${GREEN}and it does${OFF} (not run on this host)"
+			return
+		fi
+		as -o build/test.o build/test.out 2>/dev/null && ld -o build/test build/test.o 2>/dev/null && timeout 10 build/test >build/test.actual 2>/dev/null
+	else
+		(echo "$PRELUDE"; cat build/test.out) | timeout 10 node >build/test.actual 2>/dev/null
+	fi
+	result="$?"
+	if [ "$result" != "0" ]; then
+		STATUS=1
+		echo -e "    $(basename "$input") $*, ${RED}but its output fails${OFF} (status $result)"
+	elif ! cmp --silent build/test.actual "$input.expected"; then
+		STATUS=1
+		echo -e "    $(basename "$input") $*, ${RED}but its output prints something else${OFF}"
+	else
+		echo -e "    $(basename "$input") $*, ${GREEN}and it does${OFF} (status $result)"
+	fi
+}
 
-for test in $(ls src/test/c/accept/); do
-	cat "src/test/c/accept/$test" | build/Compiler >/dev/null 2>&1
-	RESULT="$?"
-	if [ "$RESULT" == "0" ]; then
-		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
+# Usage: rejects <input> [arguments...]
+function rejects() {
+	local input="$1"
+	shift
+	cat "$input" | build/Compiler "$@" >/dev/null 2>&1
+	local result="$?"
+	if [ "$result" != "0" ]; then
+		echo -e "    $(basename "$input") $*, ${GREEN}and it does${OFF} (status $result)"
 	else
 		STATUS=1
-		echo -e "    $test, ${RED}but it rejects${OFF} (status $RESULT)"
+		echo -e "    $(basename "$input") $*, ${RED}but it accepts${OFF} (status $result)"
 	fi
+}
+
+# Usage: cases <directory>
+# Lists the programs of a directory, without their expected outputs and
+# profiles.
+function cases() {
+	ls "$1" | grep --invert-match --regexp='\.expected$' --regexp='\.profile$'
+}
+
+echo "Compiler should accept..."
+echo ""
+
+for test in $(cases src/test/c/accept/); do
+	for arguments in "" "-O0" "-O1" "-O2" "--target=auto" "--time-passes" "--profile-generate=build/test.profile"; do
+		accepts "src/test/c/accept/$test" $arguments
+	done
+done
+for test in $(cases src/test/c/x86-64/accept/); do
+	for level in "-O0" "-O1" "-O2"; do
+		accepts "src/test/c/x86-64/accept/$test" $level --target=x86-64
+	done
+done
+for test in $(cases src/test/c/profile/); do
+	for level in "-O0" "-O1" "-O2"; do
+		accepts "src/test/c/profile/$test" $level "--profile-use=src/test/c/profile/$test.profile"
+	done
+done
+for test in $(cases src/test/c/x86-64/reject/); do
+	accepts "src/test/c/x86-64/reject/$test" --target=auto
 done
 echo ""
 
 echo "Compiler should reject..."
 echo ""
 
-for test in $(ls src/test/c/reject/); do
-	cat "src/test/c/reject/$test" | build/Compiler >/dev/null 2>&1
-	RESULT="$?"
-	if [ "$RESULT" != "0" ]; then
-		echo -e "    $test, ${GREEN}and it does${OFF} (status $RESULT)"
-	else
-		STATUS=1
-		echo -e "    $test, ${RED}but it accepts${OFF} (status $RESULT)"
-	fi
+for test in $(cases src/test/c/reject/); do
+	for level in "-O0" "-O1" "-O2"; do
+		rejects "src/test/c/reject/$test" $level
+	done
+done
+for test in $(cases src/test/c/x86-64/reject/); do
+	for level in "-O0" "-O1" "-O2"; do
+		rejects "src/test/c/x86-64/reject/$test" $level --target=x86-64
+	done
 done
+rejects src/test/c/accept/01-VariableDeclaration -O3
+rejects src/test/c/accept/01-VariableDeclaration --target=arm
+rejects src/test/c/accept/01-VariableDeclaration --target=x86-64 --profile-generate=build/test.profile
+rejects src/test/c/accept/01-VariableDeclaration --profile-use=src/test/c/profile/01-hot-branch.profile
+rejects src/test/c/profile/01-hot-branch --profile-use=src/test/c/profile/missing.profile
 echo ""
 
+rm --force build/test build/test.actual build/test.o build/test.out build/test.profile
+
 echo "All done."
 exit $STATUS
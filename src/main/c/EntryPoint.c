@@ -1,5 +1,24 @@
-// #include "backend/code-generation/Generator.h"
-// #include "backend/domain-specific/Calculator.h"
+#include "backend/code-generation/AsyncLowering.h"
+#include "backend/code-generation/Generator.h"
+#include "backend/code-generation/X86Generator.h"
+#include "backend/domain-specific/Calculator.h"
+#include "backend/intermediate-representation/IntermediateRepresentation.h"
+#include "backend/intermediate-representation/SsaBuilder.h"
+#include "backend/optimization/BlockLayout.h"
+#include "backend/optimization/ConstantFolding.h"
+#include "backend/optimization/DeadCodeElimination.h"
+#include "backend/optimization/EscapeAnalysis.h"
+#include "backend/optimization/IndexedLoops.h"
+#include "backend/optimization/InductionVariables.h"
+#include "backend/optimization/Inliner.h"
+#include "backend/optimization/LiteralPool.h"
+#include "backend/optimization/LoopInvariantCodeMotion.h"
+#include "backend/optimization/LoopUnrolling.h"
+#include "backend/optimization/PartialEvaluation.h"
+#include "backend/optimization/PassManager.h"
+#include "backend/optimization/Profiling.h"
+#include "backend/optimization/Specialization.h"
+#include "backend/optimization/TypedArrays.h"
 #include "frontend/lexical-analysis/FlexActions.h"
 #include "frontend/syntactic-analysis/AbstractSyntaxTree.h"
 #include "frontend/syntactic-analysis/BisonActions.h"
@@ -8,6 +27,7 @@
 #include "shared/Environment.h"
 #include "shared/Logger.h"
 #include "shared/String.h"
+#include "shared/StringPool.h"
 
 /**
  * The main entry-point of the entire application. If you use "strtok" to
@@ -16,43 +36,120 @@
  */
 const int main(const int count, const char **arguments) {
 	Logger *logger = createLogger("EntryPoint");
+	initializeStringPoolModule();
 	initializeFlexActionsModule();
 	initializeBisonActionsModule();
 	initializeSyntacticAnalyzerModule();
 	initializeAbstractSyntaxTreeModule();
-	// initializeCalculatorModule();
-	// initializeGeneratorModule();
-
-	// Logs the arguments of the application.
-	for (int k = 0; k < count; ++k) {
-		logDebugging(logger, "Argument %d: \"%s\"", k, arguments[k]);
-	}
+	initializeCalculatorModule();
+	initializeIntermediateRepresentationModule();
+	initializeSsaBuilderModule();
+	initializePassManagerModule();
+	initializeProfilingModule();
+	initializeBlockLayoutModule();
+	initializeInlinerModule();
+	initializeConstantFoldingModule();
+	initializePartialEvaluationModule();
+	initializeSpecializationModule();
+	initializeInductionVariablesModule();
+	initializeLoopInvariantCodeMotionModule();
+	initializeIndexedLoopsModule();
+	initializeTypedArraysModule();
+	initializeLoopUnrollingModule();
+	initializeLiteralPoolModule();
+	initializeEscapeAnalysisModule();
+	initializeDeadCodeEliminationModule();
+	initializeAsyncLoweringModule();
+	initializeGeneratorModule();
+	initializeX86GeneratorModule();
 
 	// Begin compilation process.
 	CompilerState compilerState = {
 		.abstractSyntaxtTree = NULL,
+		.intermediateRepresentation = NULL,
+		.profile = NULL,
+		.optimizationLevel = 1,
+		.target = JAVASCRIPT_TARGET,
+		.timePasses = false,
+		.profileOutput = NULL,
+		.profileInput = NULL,
 		.succeed = false,
 		.value = 0};
-	const SyntacticAnalysisStatus syntacticAnalysisStatus = parse(&compilerState);
 	CompilationStatus compilationStatus = SUCCEED;
-	if (syntacticAnalysisStatus == ACCEPT) {
+
+	// Logs and applies the arguments of the application.
+	for (int k = 0; k < count; ++k) {
+		logDebugging(logger, "Argument %d: \"%s\"", k, arguments[k]);
+		if (k == 0) {
+			continue;
+		}
+		if (strcmp(arguments[k], "-O0") == 0 || strcmp(arguments[k], "-O1") == 0 || strcmp(arguments[k], "-O2") == 0) {
+			compilerState.optimizationLevel = arguments[k][2] - '0';
+		}
+		else if (strcmp(arguments[k], "--target=javascript") == 0) {
+			compilerState.target = JAVASCRIPT_TARGET;
+		}
+		else if (strcmp(arguments[k], "--target=x86-64") == 0) {
+			compilerState.target = X86_64_TARGET;
+		}
+		else if (strcmp(arguments[k], "--target=auto") == 0) {
+			compilerState.target = AUTOMATIC_TARGET;
+		}
+		else if (strcmp(arguments[k], "--time-passes") == 0) {
+			compilerState.timePasses = true;
+		}
+		else if (strncmp(arguments[k], "--profile-generate=", 19) == 0 && arguments[k][19] != '\0') {
+			compilerState.profileOutput = arguments[k] + 19;
+		}
+		else if (strncmp(arguments[k], "--profile-use=", 14) == 0 && arguments[k][14] != '\0') {
+			compilerState.profileInput = arguments[k] + 14;
+		}
+		else {
+			logError(logger, "Unknown argument: \"%s\".", arguments[k]);
+			compilationStatus = FAILED;
+		}
+	}
+	if (compilerState.profileOutput != NULL && compilerState.target != JAVASCRIPT_TARGET) {
+		logError(logger, "Only the JavaScript target can be instrumented.");
+		compilationStatus = FAILED;
+	}
+	const SyntacticAnalysisStatus syntacticAnalysisStatus = compilationStatus == SUCCEED ? parse(&compilerState) : REJECT;
+	if (compilationStatus == FAILED) {
+		logError(logger, "Usage: Compiler [-O0|-O1|-O2] [--target=javascript|x86-64|auto] [--profile-generate=file] [--profile-use=file] [--time-passes] < input");
+	}
+	else if (syntacticAnalysisStatus == ACCEPT) {
 		// ----------------------------------------------------------------------------------------
 		// Beginning of the Backend... ------------------------------------------------------------
-		logDebugging(logger, "Computing expression value...");
 		Program *program = compilerState.abstractSyntaxtTree;
-		// ComputationResult computationResult = computeExpression(program->expression);
-		// if (computationResult.succeed) {
-		// 	compilerState.value = computationResult.value;
-		// 	generate(&compilerState);
-		// }
-		// else {
-		// 	logError(logger, "The computation phase rejects the input program.");
-		// 	compilationStatus = FAILED;
-		// }
+		PassManager *passManager = createPassManager(&compilerState);
+		logDebugging(logger, "Running the passes at -O%u...", compilerState.optimizationLevel);
+		if (!runPasses(passManager)) {
+			logError(logger, "The pipeline of passes is inconsistent.");
+			compilationStatus = FAILED;
+		}
+		else if (!compilerState.succeed) {
+			logError(logger, "The backend cannot compile the program (for its target, or with its profile).");
+			compilationStatus = FAILED;
+		}
+		else if (getBooleanOrDefault("PRINT_IR", false) && ensureAnalysis(passManager, "representations")) {
+			printIrModule(stderr, compilerState.intermediateRepresentation);
+		}
+		if (compilationStatus == SUCCEED && getBooleanOrDefault("PRINT_IR_PAIRS", false) && ensureAnalysis(passManager, "representations")) {
+			printIrPairs(stderr, compilerState.intermediateRepresentation);
+		}
+		if (compilerState.timePasses) {
+			printPassStatistics(passManager, stderr);
+		}
+		destroyPassManager(passManager);
 		// ...end of the Backend. -----------------------------------------------------------------
 		// ----------------------------------------------------------------------------------------
+		logDebugging(logger, "Releasing IR resources...");
+		releaseIrModule(compilerState.intermediateRepresentation);
+		compilerState.intermediateRepresentation = NULL;
+		releaseProfile(compilerState.profile);
+		compilerState.profile = NULL;
 		logDebugging(logger, "Releasing AST resources...");
-		// releaseProgram(program);
+		releaseProgram(program);
 	}
 	else {
 		logError(logger, "The syntactic-analysis phase rejects the input program.");
@@ -60,12 +157,32 @@ const int main(const int count, const char **arguments) {
 	}
 
 	logDebugging(logger, "Releasing modules resources...");
-	// shutdownGeneratorModule();
-	// shutdownCalculatorModule();
+	shutdownX86GeneratorModule();
+	shutdownGeneratorModule();
+	shutdownAsyncLoweringModule();
+	shutdownDeadCodeEliminationModule();
+	shutdownEscapeAnalysisModule();
+	shutdownLiteralPoolModule();
+	shutdownLoopUnrollingModule();
+	shutdownTypedArraysModule();
+	shutdownIndexedLoopsModule();
+	shutdownLoopInvariantCodeMotionModule();
+	shutdownInductionVariablesModule();
+	shutdownSpecializationModule();
+	shutdownPartialEvaluationModule();
+	shutdownConstantFoldingModule();
+	shutdownInlinerModule();
+	shutdownBlockLayoutModule();
+	shutdownProfilingModule();
+	shutdownPassManagerModule();
+	shutdownSsaBuilderModule();
+	shutdownIntermediateRepresentationModule();
+	shutdownCalculatorModule();
 	shutdownAbstractSyntaxTreeModule();
 	shutdownSyntacticAnalyzerModule();
 	shutdownBisonActionsModule();
 	shutdownFlexActionsModule();
+	shutdownStringPoolModule();
 	logDebugging(logger, "Compilation is done.");
 	destroyLogger(logger);
 	return compilationStatus;
@@ -0,0 +1,999 @@
+#include "AsyncLowering.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializeAsyncLoweringModule() {
+	_logger = createLogger("AsyncLowering");
+}
+
+void shutdownAsyncLoweringModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The states from which a local declared by the async function is observed.
+ */
+typedef struct {
+	char *name;
+	int firstState;
+	boolean parameter;
+	boolean spilled;
+} LocalUsage;
+
+typedef struct {
+	AsyncStateMachine *stateMachine;
+	LocalUsage *locals;
+	unsigned int localCount;
+	unsigned int localCapacity;
+} LoweringContext;
+
+/**
+ * A binding in scope while the shadowed locals are renamed.
+ */
+typedef struct {
+	const char *name;
+	char *renamed;
+} ScopedLocal;
+
+/**
+ * The bindings in scope (the innermost last), and whether the declarations
+ * met are renamed (not the ones of nested functions, which own them).
+ */
+typedef struct {
+	ScopedLocal *locals;
+	unsigned int count;
+	unsigned int capacity;
+	boolean renaming;
+} Renaming;
+
+static AsyncOperation *_append(LoweringContext *context, const unsigned int state, const AsyncOperationType type);
+static boolean _awaits(Code *code);
+static boolean _callAwaits(FunctionCall *functionCall);
+static boolean _codeDeclaresAsync(Code *code);
+static void _computeSpilledLocals(LoweringContext *context);
+static void _declareLocal(LoweringContext *context, char *name, const boolean parameter);
+static unsigned int _lowerAwait(LoweringContext *context, const unsigned int state, FunctionCall *functionCall);
+static unsigned int _lowerCode(LoweringContext *context, unsigned int state, Code *code);
+static unsigned int _lowerForLoop(LoweringContext *context, unsigned int state, ForLoop *forLoop);
+static unsigned int _lowerStatement(LoweringContext *context, unsigned int state, Statement *statement);
+static unsigned int _lowerSwitch(LoweringContext *context, unsigned int state, SwitchStatement *switchStatement);
+static unsigned int _newState(LoweringContext *context);
+static void _referenceArguments(LoweringContext *context, const unsigned int state, ArgumentList *arguments);
+static void _referenceCode(LoweringContext *context, const unsigned int state, Code *code);
+static void _referenceExpression(LoweringContext *context, const unsigned int state, Expression *expression);
+static void _referenceFunctionBody(LoweringContext *context, const unsigned int state, FunctionBody *body);
+static void _referenceFunctionCall(LoweringContext *context, const unsigned int state, FunctionCall *functionCall);
+static void _referenceIterable(LoweringContext *context, const unsigned int state, IterableVariable *iterable);
+static void _referenceName(LoweringContext *context, const unsigned int state, const char *name);
+static void _referenceObjectContent(LoweringContext *context, const unsigned int state, ObjectContent *objectContent);
+static void _referenceOperation(LoweringContext *context, const unsigned int state, AsyncOperation *operation);
+static void _referenceReturnValue(LoweringContext *context, const unsigned int state, ReturnValue *returnValue);
+static void _referenceStatement(LoweringContext *context, const unsigned int state, Statement *statement);
+static void _referenceVariable(LoweringContext *context, const unsigned int state, Variable *variable);
+static void _renameBlock(Renaming *renaming, Code *code);
+static void _renameDeclaration(Renaming *renaming, Declaration *declaration);
+static void _renameExpression(Renaming *renaming, Expression *expression);
+static void _renameFunction(Renaming *renaming, VariableTypeList *parameters, FunctionBody *body);
+static void _renameFunctionCall(Renaming *renaming, FunctionCall *functionCall);
+static void _renameIterable(Renaming *renaming, IterableVariable *iterable);
+static char *_renamedLocal(const Renaming *renaming, char *name);
+static void _renameShadowedLocals(AsyncFunction *asyncFunction);
+static void _renameStatement(Renaming *renaming, Statement *statement);
+static void _renameVariable(Renaming *renaming, Variable *variable);
+static void _scopeLocal(Renaming *renaming, const char *name, char *renamed);
+static boolean _statementAwaits(Statement *statement);
+static boolean _variableAwaits(Variable *variable);
+
+/**
+ * Appends a new operation at the end of a state.
+ */
+static AsyncOperation *_append(LoweringContext *context, const unsigned int state, const AsyncOperationType type) {
+	AsyncOperation *operation = calloc(1, sizeof(AsyncOperation));
+	operation->type = type;
+	AsyncState *asyncState = &context->stateMachine->states[state];
+	if (asyncState->last == NULL) {
+		asyncState->first = operation;
+	}
+	else {
+		asyncState->last->next = operation;
+	}
+	asyncState->last = operation;
+	return operation;
+}
+
+/**
+ * Returns true if some statement of the code suspends. Nested functions are
+ * not inspected, because they own their awaits.
+ */
+static boolean _awaits(Code *code) {
+	for (; code != NULL; code = code->next) {
+		if (_statementAwaits(code->statement)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static boolean _callAwaits(FunctionCall *functionCall) {
+	return functionCall != NULL && functionCall->type == AWAIT_CALL;
+}
+
+static boolean _codeDeclaresAsync(Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		switch (statement->statement) {
+			case ASYNC_FUNCTION_ST:
+				return true;
+			case IF_ST:
+				if (_codeDeclaresAsync(statement->ifStatement->thenBody) || _codeDeclaresAsync(statement->ifStatement->elseBody)) {
+					return true;
+				}
+				break;
+			case WHILE_ST:
+				if (_codeDeclaresAsync(statement->whileLoop->body)) {
+					return true;
+				}
+				break;
+			case FOR_ST:
+				if (_codeDeclaresAsync(statement->forLoop->body)) {
+					return true;
+				}
+				break;
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					if (_codeDeclaresAsync(content->body)) {
+						return true;
+					}
+				}
+				break;
+			case FUNCTION_DECLARATION_ST: {
+				FunctionBody *body = statement->FunctionDeclaration->body;
+				if (body != NULL) {
+					if (_codeDeclaresAsync(body->code) || (body->returnValue != NULL && body->returnValue->type == ASYNC_FUNCTION_RT)) {
+						return true;
+					}
+				}
+				break;
+			}
+			default:
+				break;
+		}
+	}
+	return false;
+}
+
+/**
+ * A parameter is spilled as soon as any state reads it, because the states
+ * run inside a separate step function. A local is spilled when more than one
+ * state observes it. The hoisted functions observe their locals from a state
+ * of their own, since any state may call them.
+ */
+static void _computeSpilledLocals(LoweringContext *context) {
+	AsyncStateMachine *stateMachine = context->stateMachine;
+	for (unsigned int k = 0; k < stateMachine->stateCount; ++k) {
+		for (AsyncOperation *operation = stateMachine->states[k].first; operation != NULL; operation = operation->next) {
+			_referenceOperation(context, k, operation);
+		}
+	}
+	for (unsigned int k = 0; k < stateMachine->functionCount; ++k) {
+		_referenceStatement(context, stateMachine->stateCount, stateMachine->functions[k]);
+	}
+	stateMachine->spilledLocals = calloc(context->localCount + 1, sizeof(char *));
+	for (unsigned int k = 0; k < context->localCount; ++k) {
+		LocalUsage *local = &context->locals[k];
+		if (local->spilled || (local->parameter && 0 <= local->firstState)) {
+			stateMachine->spilledLocals[stateMachine->spilledLocalCount++] = local->name;
+		}
+	}
+}
+
+static void _declareLocal(LoweringContext *context, char *name, const boolean parameter) {
+	for (unsigned int k = 0; k < context->localCount; ++k) {
+		if (strcmp(context->locals[k].name, name) == 0) {
+			return;
+		}
+	}
+	if (context->localCount == context->localCapacity) {
+		context->localCapacity = context->localCapacity == 0 ? 8 : 2 * context->localCapacity;
+		context->locals = realloc(context->locals, context->localCapacity * sizeof(LocalUsage));
+	}
+	LocalUsage *local = &context->locals[context->localCount++];
+	local->name = name;
+	local->firstState = -1;
+	local->parameter = parameter;
+	local->spilled = false;
+}
+
+/**
+ * Suspends the machine on a call, and returns the state that resumes it.
+ */
+static unsigned int _lowerAwait(LoweringContext *context, const unsigned int state, FunctionCall *functionCall) {
+	const unsigned int resumeState = _newState(context);
+	AsyncOperation *operation = _append(context, state, AWAIT_AO);
+	operation->functionCall = functionCall;
+	operation->resumeState = resumeState;
+	++context->stateMachine->suspendPoints;
+	return resumeState;
+}
+
+static unsigned int _lowerCode(LoweringContext *context, unsigned int state, Code *code) {
+	for (; code != NULL; code = code->next) {
+		state = _lowerStatement(context, state, code->statement);
+	}
+	return state;
+}
+
+static unsigned int _lowerForLoop(LoweringContext *context, unsigned int state, ForLoop *forLoop) {
+	ParamsFor *params = forLoop->params;
+	const unsigned int headState = _newState(context);
+	const unsigned int exitState = _newState(context);
+	if (params->type == FOR_CLASSIC) {
+		const unsigned int bodyState = _newState(context);
+		if (params->init != NULL) {
+			_lowerStatement(context, state, DeclarationStatementSemanticAction(params->init));
+		}
+		_append(context, state, JUMP_AO)->nextState = headState;
+		AsyncOperation *branch = _append(context, headState, BRANCH_AO);
+		branch->condition = params->condition;
+		branch->thenState = bodyState;
+		branch->elseState = exitState;
+		const unsigned int lastState = _lowerCode(context, bodyState, forLoop->body);
+		if (params->updateType == INC_DEC_UT) {
+			_append(context, lastState, STATEMENT_AO)->statement = IncDecStatementSemanticAction(params->updateIncDec);
+		}
+		else if (params->update != NULL) {
+			_append(context, lastState, STATEMENT_AO)->statement = ExpressionStatementSemanticAction(params->update);
+		}
+		_append(context, lastState, JUMP_AO)->nextState = headState;
+	}
+	else {
+		const unsigned int iterator = context->stateMachine->iteratorCount++;
+		IterableVariable *iterable = params->iterable;
+		AsyncOperation *iterate;
+		if (iterable->type == FUNCTIONCALL_IT && _callAwaits(iterable->functionCall)) {
+			state = _lowerAwait(context, state, iterable->functionCall);
+			iterate = _append(context, state, ITERATE_AO);
+			iterate->iterable = NULL;
+		}
+		else {
+			iterate = _append(context, state, ITERATE_AO);
+			iterate->iterable = iterable;
+		}
+		iterate->iterator = iterator;
+		_append(context, state, JUMP_AO)->nextState = headState;
+		AsyncOperation *advance = _append(context, headState, ADVANCE_AO);
+		advance->iterator = iterator;
+		advance->binding = params->value->variable->variableType->id;
+		advance->declares = true;
+		advance->exitState = exitState;
+		_declareLocal(context, advance->binding, false);
+		const unsigned int lastState = _lowerCode(context, headState, forLoop->body);
+		_append(context, lastState, JUMP_AO)->nextState = headState;
+	}
+	return exitState;
+}
+
+/**
+ * Lowers a statement that starts on the given state, and returns the state
+ * on which the control-flow continues afterwards.
+ */
+static unsigned int _lowerStatement(LoweringContext *context, unsigned int state, Statement *statement) {
+	if (statement->statement == FUNCTION_DECLARATION_ST || statement->statement == ASYNC_FUNCTION_ST) {
+		AsyncStateMachine *stateMachine = context->stateMachine;
+		if (stateMachine->functionCount == stateMachine->functionCapacity) {
+			stateMachine->functionCapacity = stateMachine->functionCapacity == 0 ? 4 : 2 * stateMachine->functionCapacity;
+			stateMachine->functions = realloc(stateMachine->functions, stateMachine->functionCapacity * sizeof(Statement *));
+		}
+		stateMachine->functions[stateMachine->functionCount++] = statement;
+		return state;
+	}
+	if (!_statementAwaits(statement)) {
+		if (statement->statement == DECLARATION_ST) {
+			_declareLocal(context, statement->declaration->variable->variableType->id, false);
+		}
+		_append(context, state, STATEMENT_AO)->statement = statement;
+		return state;
+	}
+	switch (statement->statement) {
+		case FUNCTIONCALL_ST:
+			return _lowerAwait(context, state, statement->functionCall);
+		case DECLARATION_ST:
+		case VARIABLE_ST: {
+			const boolean declares = statement->statement == DECLARATION_ST;
+			Variable *variable = declares ? statement->declaration->variable : statement->variable;
+			state = _lowerAwait(context, state, variable->functionCall);
+			AsyncOperation *receive = _append(context, state, RECEIVE_AO);
+			receive->binding = variable->variableType->id;
+			receive->declares = declares;
+			if (declares) {
+				_declareLocal(context, receive->binding, false);
+			}
+			return state;
+		}
+		case IF_ST: {
+			IfStatement *ifStatement = statement->ifStatement;
+			const unsigned int thenState = _newState(context);
+			const unsigned int joinState = _newState(context);
+			const unsigned int elseState = ifStatement->elseBody == NULL ? joinState : _newState(context);
+			AsyncOperation *branch = _append(context, state, BRANCH_AO);
+			branch->condition = ifStatement->condition;
+			branch->thenState = thenState;
+			branch->elseState = elseState;
+			_append(context, _lowerCode(context, thenState, ifStatement->thenBody), JUMP_AO)->nextState = joinState;
+			if (ifStatement->elseBody != NULL) {
+				_append(context, _lowerCode(context, elseState, ifStatement->elseBody), JUMP_AO)->nextState = joinState;
+			}
+			return joinState;
+		}
+		case WHILE_ST: {
+			const unsigned int headState = _newState(context);
+			const unsigned int bodyState = _newState(context);
+			const unsigned int exitState = _newState(context);
+			_append(context, state, JUMP_AO)->nextState = headState;
+			AsyncOperation *branch = _append(context, headState, BRANCH_AO);
+			branch->condition = statement->whileLoop->condition;
+			branch->thenState = bodyState;
+			branch->elseState = exitState;
+			_append(context, _lowerCode(context, bodyState, statement->whileLoop->body), JUMP_AO)->nextState = headState;
+			return exitState;
+		}
+		case FOR_ST:
+			return _lowerForLoop(context, state, statement->forLoop);
+		case SWITCH_ST:
+			return _lowerSwitch(context, state, statement->switchStatement);
+		default:
+			logError(_logger, "The statement cannot be suspended: %d", statement->statement);
+			_append(context, state, STATEMENT_AO)->statement = statement;
+			return state;
+	}
+}
+
+/**
+ * The cases of a switch never fall through (each one ends with a "break"),
+ * so they lower to a chain of strict comparisons.
+ */
+static unsigned int _lowerSwitch(LoweringContext *context, unsigned int state, SwitchStatement *switchStatement) {
+	const unsigned int exitState = _newState(context);
+	unsigned int testState = state;
+	boolean hasDefault = false;
+	for (SwitchContent *content = switchStatement->content; content != NULL; content = content->next) {
+		if (content->condition == NULL) {
+			_append(context, _lowerCode(context, testState, content->body), JUMP_AO)->nextState = exitState;
+			hasDefault = true;
+			break;
+		}
+		const unsigned int caseState = _newState(context);
+		const unsigned int nextState = _newState(context);
+		Expression *subject = FactorExpressionSemanticAction(VariableFactorSemanticAction(switchStatement->id));
+		AsyncOperation *branch = _append(context, testState, BRANCH_AO);
+		branch->condition = ExpressionSemanticAction(subject, content->condition, STRICT_EQUAL_OP);
+		branch->thenState = caseState;
+		branch->elseState = nextState;
+		_append(context, _lowerCode(context, caseState, content->body), JUMP_AO)->nextState = exitState;
+		testState = nextState;
+	}
+	if (!hasDefault) {
+		_append(context, testState, JUMP_AO)->nextState = exitState;
+	}
+	return exitState;
+}
+
+static unsigned int _newState(LoweringContext *context) {
+	AsyncStateMachine *stateMachine = context->stateMachine;
+	if (stateMachine->stateCount == stateMachine->stateCapacity) {
+		stateMachine->stateCapacity = stateMachine->stateCapacity == 0 ? 4 : 2 * stateMachine->stateCapacity;
+		stateMachine->states = realloc(stateMachine->states, stateMachine->stateCapacity * sizeof(AsyncState));
+	}
+	AsyncState *state = &stateMachine->states[stateMachine->stateCount];
+	state->first = NULL;
+	state->last = NULL;
+	return stateMachine->stateCount++;
+}
+
+static void _referenceArguments(LoweringContext *context, const unsigned int state, ArgumentList *arguments) {
+	for (; arguments != NULL; arguments = arguments->next) {
+		_referenceExpression(context, state, arguments->expression);
+	}
+}
+
+static void _referenceCode(LoweringContext *context, const unsigned int state, Code *code) {
+	for (; code != NULL; code = code->next) {
+		_referenceStatement(context, state, code->statement);
+	}
+}
+
+static void _referenceExpression(LoweringContext *context, const unsigned int state, Expression *expression) {
+	if (expression == NULL) {
+		return;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			switch (expression->factor->type) {
+				case VARIABLE:
+					_referenceName(context, state, expression->factor->variableName);
+					break;
+				case EXPRESSION:
+					_referenceExpression(context, state, expression->factor->expression);
+					break;
+				case FUNCTIONCALL:
+					_referenceFunctionCall(context, state, expression->factor->functionCall);
+					break;
+				default:
+					break;
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			_referenceExpression(context, state, expression->expression);
+			break;
+		default:
+			_referenceExpression(context, state, expression->leftExpression);
+			_referenceExpression(context, state, expression->rightExpression);
+			break;
+	}
+}
+
+static void _referenceFunctionBody(LoweringContext *context, const unsigned int state, FunctionBody *body) {
+	if (body != NULL) {
+		_referenceCode(context, state, body->code);
+		_referenceReturnValue(context, state, body->returnValue);
+	}
+}
+
+static void _referenceFunctionCall(LoweringContext *context, const unsigned int state, FunctionCall *functionCall) {
+	if (functionCall != NULL) {
+		_referenceArguments(context, state, functionCall->arguments);
+	}
+}
+
+static void _referenceIterable(LoweringContext *context, const unsigned int state, IterableVariable *iterable) {
+	switch (iterable->type) {
+		case VARIABLE_IT:
+			_referenceName(context, state, iterable->variableName);
+			break;
+		case FUNCTIONCALL_IT:
+			_referenceFunctionCall(context, state, iterable->functionCall);
+			break;
+		case ARRAY_IT:
+			for (ArrayContent *element = iterable->arrayContent; element != NULL; element = element->next) {
+				_referenceExpression(context, state, element->value);
+			}
+			break;
+		case OBJECT_IT:
+			_referenceObjectContent(context, state, iterable->objectContent);
+			break;
+	}
+}
+
+static void _referenceName(LoweringContext *context, const unsigned int state, const char *name) {
+	for (unsigned int k = 0; k < context->localCount; ++k) {
+		LocalUsage *local = &context->locals[k];
+		if (strcmp(local->name, name) == 0) {
+			if (local->firstState < 0) {
+				local->firstState = state;
+			}
+			else if (local->firstState != state) {
+				local->spilled = true;
+			}
+			return;
+		}
+	}
+}
+
+static void _referenceObjectContent(LoweringContext *context, const unsigned int state, ObjectContent *objectContent) {
+	for (; objectContent != NULL; objectContent = objectContent->next) {
+		_referenceExpression(context, state, objectContent->value);
+	}
+}
+
+static void _referenceOperation(LoweringContext *context, const unsigned int state, AsyncOperation *operation) {
+	switch (operation->type) {
+		case STATEMENT_AO:
+			_referenceStatement(context, state, operation->statement);
+			break;
+		case AWAIT_AO:
+			_referenceFunctionCall(context, state, operation->functionCall);
+			break;
+		case RECEIVE_AO:
+		case ADVANCE_AO:
+			if (operation->binding != NULL) {
+				_referenceName(context, state, operation->binding);
+			}
+			break;
+		case BRANCH_AO:
+			_referenceExpression(context, state, operation->condition);
+			break;
+		case RETURN_AO:
+			_referenceReturnValue(context, state, operation->returnValue);
+			break;
+		case ITERATE_AO:
+			if (operation->iterable != NULL) {
+				_referenceIterable(context, state, operation->iterable);
+			}
+			break;
+		case JUMP_AO:
+			break;
+	}
+}
+
+static void _referenceReturnValue(LoweringContext *context, const unsigned int state, ReturnValue *returnValue) {
+	if (returnValue == NULL) {
+		return;
+	}
+	switch (returnValue->type) {
+		case EXPRESSION_RT:
+			_referenceExpression(context, state, returnValue->expression);
+			break;
+		case FUNCTIONCALL_RT:
+			_referenceFunctionCall(context, state, returnValue->functionCall);
+			break;
+		case ASYNC_FUNCTION_RT:
+			_referenceFunctionBody(context, state, returnValue->asyncFunction->body);
+			break;
+		default:
+			break;
+	}
+}
+
+static void _referenceStatement(LoweringContext *context, const unsigned int state, Statement *statement) {
+	switch (statement->statement) {
+		case IF_ST:
+			_referenceExpression(context, state, statement->ifStatement->condition);
+			_referenceCode(context, state, statement->ifStatement->thenBody);
+			_referenceCode(context, state, statement->ifStatement->elseBody);
+			break;
+		case WHILE_ST:
+			_referenceExpression(context, state, statement->whileLoop->condition);
+			_referenceCode(context, state, statement->whileLoop->body);
+			break;
+		case FOR_ST: {
+			ParamsFor *params = statement->forLoop->params;
+			if (params->type == FOR_CLASSIC) {
+				if (params->init != NULL) {
+					_referenceVariable(context, state, params->init->variable);
+				}
+				_referenceExpression(context, state, params->condition);
+				if (params->updateType == INC_DEC_UT) {
+					_referenceExpression(context, state, params->updateIncDec->expression);
+				}
+				else {
+					_referenceExpression(context, state, params->update);
+				}
+			}
+			else {
+				_referenceVariable(context, state, params->value->variable);
+				_referenceIterable(context, state, params->iterable);
+			}
+			_referenceCode(context, state, statement->forLoop->body);
+			break;
+		}
+		case DECLARATION_ST:
+			_referenceVariable(context, state, statement->declaration->variable);
+			break;
+		case VARIABLE_ST:
+			_referenceVariable(context, state, statement->variable);
+			break;
+		case EXPRESSION_ST:
+			_referenceExpression(context, state, statement->expression);
+			break;
+		case INC_DEC_ST:
+			_referenceExpression(context, state, statement->incDec->expression);
+			break;
+		case FUNCTIONCALL_ST:
+			_referenceFunctionCall(context, state, statement->functionCall);
+			break;
+		case FUNCTION_DECLARATION_ST:
+			_referenceFunctionBody(context, state, statement->FunctionDeclaration->body);
+			break;
+		case ASYNC_FUNCTION_ST:
+			_referenceFunctionBody(context, state, statement->asyncFunction->body);
+			break;
+		case SWITCH_ST:
+			_referenceName(context, state, statement->switchStatement->id);
+			for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+				_referenceExpression(context, state, content->condition);
+				_referenceCode(context, state, content->body);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+static void _referenceVariable(LoweringContext *context, const unsigned int state, Variable *variable) {
+	_referenceName(context, state, variable->variableType->id);
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_referenceExpression(context, state, variable->expression);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				_referenceExpression(context, state, element->value);
+			}
+			break;
+		case OBJECT_VAR:
+			_referenceObjectContent(context, state, variable->objectContent);
+			break;
+		case FUNCTIONCALL_VAR:
+			_referenceFunctionCall(context, state, variable->functionCall);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Brings the declarations of a block into scope before renaming it (a
+ * "let" or "const" shadows from the start of its block), and then drops
+ * them at its end.
+ */
+static void _renameBlock(Renaming *renaming, Code *code) {
+	const unsigned int base = renaming->count;
+	for (Code *statement = code; statement != NULL; statement = statement->next) {
+		if (statement->statement->statement == DECLARATION_ST) {
+			_renameDeclaration(renaming, statement->statement->declaration);
+		}
+	}
+	for (; code != NULL; code = code->next) {
+		_renameStatement(renaming, code->statement);
+	}
+	renaming->count = base;
+}
+
+/**
+ * Gives a new name to a "let" or "const" that shadows another local of the
+ * async function. A "var" is the same binding at every depth.
+ */
+static void _renameDeclaration(Renaming *renaming, Declaration *declaration) {
+	VariableType *variableType = declaration->variable->variableType;
+	char *renamed = variableType->id;
+	if (renaming->renaming && declaration->type != VAR_DT) {
+		for (unsigned int k = 0; k < renaming->count; ++k) {
+			if (strcmp(renaming->locals[k].name, variableType->id) == 0) {
+				renamed = createSyntheticName(variableType->id);
+				logDebugging(_logger, "The local \"%s\" shadows another one, so it is renamed \"%s\".", variableType->id, renamed);
+				break;
+			}
+		}
+	}
+	_scopeLocal(renaming, variableType->id, renamed);
+	variableType->id = renamed;
+}
+
+static void _renameExpression(Renaming *renaming, Expression *expression) {
+	if (expression == NULL) {
+		return;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			switch (expression->factor->type) {
+				case VARIABLE:
+					expression->factor->variableName = _renamedLocal(renaming, expression->factor->variableName);
+					break;
+				case EXPRESSION:
+					_renameExpression(renaming, expression->factor->expression);
+					break;
+				case FUNCTIONCALL:
+					_renameFunctionCall(renaming, expression->factor->functionCall);
+					break;
+				default:
+					break;
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			_renameExpression(renaming, expression->expression);
+			break;
+		default:
+			_renameExpression(renaming, expression->leftExpression);
+			_renameExpression(renaming, expression->rightExpression);
+			break;
+	}
+}
+
+/**
+ * A nested function reads the locals of the async function, but its own
+ * parameters and declarations shadow them (and keep their names).
+ */
+static void _renameFunction(Renaming *renaming, VariableTypeList *parameters, FunctionBody *body) {
+	const unsigned int base = renaming->count;
+	const boolean enclosing = renaming->renaming;
+	renaming->renaming = false;
+	for (; parameters != NULL; parameters = parameters->next) {
+		_scopeLocal(renaming, parameters->variableType->id, parameters->variableType->id);
+	}
+	if (body != NULL) {
+		_renameBlock(renaming, body->code);
+		ReturnValue *returnValue = body->returnValue;
+		if (returnValue != NULL && returnValue->type == EXPRESSION_RT) {
+			_renameExpression(renaming, returnValue->expression);
+		}
+		else if (returnValue != NULL && returnValue->type == FUNCTIONCALL_RT) {
+			_renameFunctionCall(renaming, returnValue->functionCall);
+		}
+	}
+	renaming->renaming = enclosing;
+	renaming->count = base;
+}
+
+static void _renameFunctionCall(Renaming *renaming, FunctionCall *functionCall) {
+	if (functionCall == NULL) {
+		return;
+	}
+	functionCall->id = _renamedLocal(renaming, functionCall->id);
+	for (ArgumentList *argument = functionCall->arguments; argument != NULL; argument = argument->next) {
+		_renameExpression(renaming, argument->expression);
+	}
+}
+
+static void _renameIterable(Renaming *renaming, IterableVariable *iterable) {
+	switch (iterable->type) {
+		case VARIABLE_IT:
+			iterable->variableName = _renamedLocal(renaming, iterable->variableName);
+			break;
+		case FUNCTIONCALL_IT:
+			_renameFunctionCall(renaming, iterable->functionCall);
+			break;
+		case ARRAY_IT:
+			for (ArrayContent *element = iterable->arrayContent; element != NULL; element = element->next) {
+				_renameExpression(renaming, element->value);
+			}
+			break;
+		case OBJECT_IT:
+			for (ObjectContent *property = iterable->objectContent; property != NULL; property = property->next) {
+				_renameExpression(renaming, property->value);
+			}
+			break;
+	}
+}
+
+/**
+ * The name of the innermost binding in scope (the name itself if it is not
+ * a local).
+ */
+static char *_renamedLocal(const Renaming *renaming, char *name) {
+	for (unsigned int k = renaming->count; 0 < k; --k) {
+		if (strcmp(renaming->locals[k - 1].name, name) == 0) {
+			return renaming->locals[k - 1].renamed;
+		}
+	}
+	return name;
+}
+
+/**
+ * The spilled locals live in the frame by name, so two locals that shadow
+ * one another would share a slot. Every "let" and "const" that shadows
+ * another local of the async function gets a name of its own first.
+ */
+static void _renameShadowedLocals(AsyncFunction *asyncFunction) {
+	Renaming renaming = {.locals = NULL, .count = 0, .capacity = 0, .renaming = true};
+	for (VariableTypeList *argument = asyncFunction->arguments; argument != NULL; argument = argument->next) {
+		_scopeLocal(&renaming, argument->variableType->id, argument->variableType->id);
+	}
+	if (asyncFunction->body != NULL) {
+		_renameBlock(&renaming, asyncFunction->body->code);
+		ReturnValue *returnValue = asyncFunction->body->returnValue;
+		if (returnValue != NULL && returnValue->type == EXPRESSION_RT) {
+			_renameExpression(&renaming, returnValue->expression);
+		}
+		else if (returnValue != NULL && returnValue->type == FUNCTIONCALL_RT) {
+			_renameFunctionCall(&renaming, returnValue->functionCall);
+		}
+	}
+	free(renaming.locals);
+}
+
+static void _renameStatement(Renaming *renaming, Statement *statement) {
+	switch (statement->statement) {
+		case IF_ST:
+			_renameExpression(renaming, statement->ifStatement->condition);
+			_renameBlock(renaming, statement->ifStatement->thenBody);
+			_renameBlock(renaming, statement->ifStatement->elseBody);
+			break;
+		case WHILE_ST:
+			_renameExpression(renaming, statement->whileLoop->condition);
+			_renameBlock(renaming, statement->whileLoop->body);
+			break;
+		case FOR_ST: {
+			ParamsFor *params = statement->forLoop->params;
+			const unsigned int base = renaming->count;
+			if (params->type == FOR_CLASSIC) {
+				if (params->init != NULL) {
+					_renameDeclaration(renaming, params->init);
+					_renameVariable(renaming, params->init->variable);
+				}
+				_renameExpression(renaming, params->condition);
+				if (params->updateType == INC_DEC_UT) {
+					_renameExpression(renaming, params->updateIncDec->expression);
+				}
+				else {
+					_renameExpression(renaming, params->update);
+				}
+			}
+			else {
+				// The iterable is evaluated outside of the scope of the element.
+				_renameIterable(renaming, params->iterable);
+				_renameDeclaration(renaming, params->value);
+			}
+			_renameBlock(renaming, statement->forLoop->body);
+			renaming->count = base;
+			break;
+		}
+		case DECLARATION_ST:
+			_renameVariable(renaming, statement->declaration->variable);
+			break;
+		case VARIABLE_ST:
+			statement->variable->variableType->id = _renamedLocal(renaming, statement->variable->variableType->id);
+			_renameVariable(renaming, statement->variable);
+			break;
+		case EXPRESSION_ST:
+			_renameExpression(renaming, statement->expression);
+			break;
+		case INC_DEC_ST:
+			_renameExpression(renaming, statement->incDec->expression);
+			break;
+		case FUNCTIONCALL_ST:
+			_renameFunctionCall(renaming, statement->functionCall);
+			break;
+		case FUNCTION_DECLARATION_ST:
+			_renameFunction(renaming, statement->FunctionDeclaration->arguments, statement->FunctionDeclaration->body);
+			break;
+		case ASYNC_FUNCTION_ST:
+			_renameFunction(renaming, statement->asyncFunction->arguments, statement->asyncFunction->body);
+			break;
+		case SWITCH_ST:
+			statement->switchStatement->id = _renamedLocal(renaming, statement->switchStatement->id);
+			for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+				_renameExpression(renaming, content->condition);
+				_renameBlock(renaming, content->body);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Renames the reads of the value of a variable (its name is renamed by the
+ * declaration or the assignment).
+ */
+static void _renameVariable(Renaming *renaming, Variable *variable) {
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_renameExpression(renaming, variable->expression);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				_renameExpression(renaming, element->value);
+			}
+			break;
+		case OBJECT_VAR:
+			for (ObjectContent *property = variable->objectContent; property != NULL; property = property->next) {
+				_renameExpression(renaming, property->value);
+			}
+			break;
+		case FUNCTIONCALL_VAR:
+			_renameFunctionCall(renaming, variable->functionCall);
+			break;
+		case ARROWFUNCTION_VAR:
+			_renameFunction(renaming, variable->arrowFunction->arguments, variable->arrowFunction->body);
+			break;
+		default:
+			break;
+	}
+}
+
+static void _scopeLocal(Renaming *renaming, const char *name, char *renamed) {
+	if (renaming->count == renaming->capacity) {
+		renaming->capacity = renaming->capacity == 0 ? 8 : 2 * renaming->capacity;
+		renaming->locals = realloc(renaming->locals, renaming->capacity * sizeof(ScopedLocal));
+	}
+	renaming->locals[renaming->count].name = name;
+	renaming->locals[renaming->count++].renamed = renamed;
+}
+
+static boolean _statementAwaits(Statement *statement) {
+	switch (statement->statement) {
+		case FUNCTIONCALL_ST:
+			return _callAwaits(statement->functionCall);
+		case DECLARATION_ST:
+			return _variableAwaits(statement->declaration->variable);
+		case VARIABLE_ST:
+			return _variableAwaits(statement->variable);
+		case IF_ST:
+			return _awaits(statement->ifStatement->thenBody) || _awaits(statement->ifStatement->elseBody);
+		case WHILE_ST:
+			return _awaits(statement->whileLoop->body);
+		case FOR_ST: {
+			ParamsFor *params = statement->forLoop->params;
+			if (params->type == FOR_OF && params->iterable->type == FUNCTIONCALL_IT && _callAwaits(params->iterable->functionCall)) {
+				return true;
+			}
+			return _awaits(statement->forLoop->body);
+		}
+		case SWITCH_ST:
+			for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+				if (_awaits(content->body)) {
+					return true;
+				}
+			}
+			return false;
+		default:
+			return false;
+	}
+}
+
+static boolean _variableAwaits(Variable *variable) {
+	return variable->type == FUNCTIONCALL_VAR && _callAwaits(variable->functionCall);
+}
+
+/** PUBLIC FUNCTIONS */
+
+boolean hasAsyncFunctions(Program *program) {
+	return program != NULL && _codeDeclaresAsync(program->code);
+}
+
+boolean isSpilledLocal(const AsyncStateMachine *stateMachine, const char *name) {
+	for (unsigned int k = 0; k < stateMachine->spilledLocalCount; ++k) {
+		if (strcmp(stateMachine->spilledLocals[k], name) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+AsyncStateMachine *lowerAsyncFunction(AsyncFunction *asyncFunction) {
+	LoweringContext context = {
+		.stateMachine = calloc(1, sizeof(AsyncStateMachine)),
+		.locals = NULL,
+		.localCount = 0,
+		.localCapacity = 0};
+	context.stateMachine->function = asyncFunction;
+	_renameShadowedLocals(asyncFunction);
+	for (VariableTypeList *argument = asyncFunction->arguments; argument != NULL; argument = argument->next) {
+		_declareLocal(&context, argument->variableType->id, true);
+	}
+	unsigned int state = _newState(&context);
+	FunctionBody *body = asyncFunction->body;
+	if (body != NULL) {
+		state = _lowerCode(&context, state, body->code);
+		if (body->returnValue != NULL) {
+			_append(&context, state, RETURN_AO)->returnValue = body->returnValue;
+		}
+	}
+	AsyncState *lastState = &context.stateMachine->states[state];
+	if (lastState->last == NULL || lastState->last->type != RETURN_AO) {
+		_append(&context, state, RETURN_AO)->returnValue = NULL;
+	}
+	_computeSpilledLocals(&context);
+	logDebugging(_logger, "Async function \"%s\" lowered into %d states (%d suspend points, %d spilled locals).",
+				 asyncFunction->id,
+				 context.stateMachine->stateCount,
+				 context.stateMachine->suspendPoints,
+				 context.stateMachine->spilledLocalCount);
+	free(context.locals);
+	return context.stateMachine;
+}
+
+void releaseAsyncStateMachine(AsyncStateMachine *stateMachine) {
+	if (stateMachine != NULL) {
+		for (unsigned int k = 0; k < stateMachine->stateCount; ++k) {
+			AsyncOperation *operation = stateMachine->states[k].first;
+			while (operation != NULL) {
+				AsyncOperation *next = operation->next;
+				free(operation);
+				operation = next;
+			}
+		}
+		free(stateMachine->states);
+		free(stateMachine->spilledLocals);
+		free(stateMachine->functions);
+		free(stateMachine);
+	}
+}
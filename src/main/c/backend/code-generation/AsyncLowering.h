@@ -0,0 +1,124 @@
+#ifndef ASYNC_LOWERING_HEADER
+#define ASYNC_LOWERING_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../frontend/syntactic-analysis/BisonActions.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../optimization/TreeRewriting.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeAsyncLoweringModule();
+
+/** Shutdown module's internal state. */
+void shutdownAsyncLoweringModule();
+
+/**
+ * The state a machine moves to once its body completes.
+ */
+#define FINAL_ASYNC_STATE -1
+
+typedef enum AsyncOperationType AsyncOperationType;
+
+typedef struct AsyncOperation AsyncOperation;
+typedef struct AsyncState AsyncState;
+typedef struct AsyncStateMachine AsyncStateMachine;
+
+/**
+ * The operations of a lowered async function. Every statement that does not
+ * contain an "await" survives as a single STATEMENT_AO; the control flow
+ * around suspend points is made explicit with branches and jumps between
+ * states.
+ */
+enum AsyncOperationType {
+	STATEMENT_AO,
+	AWAIT_AO,
+	RECEIVE_AO,
+	BRANCH_AO,
+	JUMP_AO,
+	RETURN_AO,
+	ITERATE_AO,
+	ADVANCE_AO
+};
+
+struct AsyncOperation {
+	AsyncOperationType type;
+	union {
+		Statement *statement;
+		struct {					   // await
+			FunctionCall *functionCall;
+			unsigned int resumeState;
+		};
+		struct {					   // receive, advance
+			char *binding;			   // NULL discards the settled value
+			boolean declares;
+			unsigned int exitState;	   // only for advance
+		};
+		struct {					   // branch
+			Expression *condition;
+			unsigned int thenState;
+			unsigned int elseState;
+		};
+		unsigned int nextState;		   // jump
+		ReturnValue *returnValue;	   // return
+		IterableVariable *iterable;	   // iterate (NULL iterates the settled value)
+	};
+	unsigned int iterator;			   // iterate, advance
+	AsyncOperation *next;
+};
+
+struct AsyncState {
+	AsyncOperation *first;
+	AsyncOperation *last;
+};
+
+/**
+ * A resumable state machine. The frame of a pending call only holds the
+ * current state and the spilled locals (those observed from more than one
+ * state), so a suspended call costs a small object instead of a native
+ * stack.
+ *
+ * The nested functions are hoisted out of the states (every state can call
+ * them), so the locals that they observe are spilled too.
+ */
+struct AsyncStateMachine {
+	AsyncFunction *function;
+	AsyncState *states;
+	unsigned int stateCount;
+	unsigned int stateCapacity;
+	char **spilledLocals;
+	unsigned int spilledLocalCount;
+	Statement **functions;
+	unsigned int functionCount;
+	unsigned int functionCapacity;
+	unsigned int iteratorCount;
+	unsigned int suspendPoints;
+};
+
+/**
+ * Returns true if the program declares at least one async function, at any
+ * depth.
+ */
+boolean hasAsyncFunctions(Program *program);
+
+/**
+ * Returns true if the local must live in the frame of the machine.
+ */
+boolean isSpilledLocal(const AsyncStateMachine *stateMachine, const char *name);
+
+/**
+ * Splits the body of an async function into states at every "await" and
+ * computes the locals that must be spilled into its frame. The locals that
+ * shadow other ones are renamed first (in the AST), so each one has a slot
+ * of its own.
+ */
+AsyncStateMachine *lowerAsyncFunction(AsyncFunction *asyncFunction);
+
+/**
+ * Releases a state machine. The AST nodes it borrows are not released.
+ */
+void releaseAsyncStateMachine(AsyncStateMachine *stateMachine);
+
+#endif
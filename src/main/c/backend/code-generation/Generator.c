@@ -6,6 +6,16 @@ const char _indentationCharacter = ' ';
 const char _indentationSize = 4;
 static Logger * _logger = NULL;
 
+// The async function being emitted, if any. Its spilled locals live in the frame.
+static AsyncStateMachine * _stateMachine = NULL;
+
+// The program being emitted.
+static Program * _program = NULL;
+
+// The sites to count, when instrumenting, and the ones emitted so far.
+static Profile * _profile = NULL;
+static boolean * _observed = NULL;
+
 void initializeGeneratorModule() {
 	_logger = createLogger("Generator");
 }
@@ -18,125 +28,940 @@ void shutdownGeneratorModule() {
 
 /** PRIVATE FUNCTIONS */
 
-static const char _expressionTypeToCharacter(const ExpressionType type);
-static void _generateConstant(const unsigned int indentationLevel, Constant * constant);
-static void _generateEpilogue(const int value);
-static void _generateExpression(const unsigned int indentationLevel, Expression * expression);
-static void _generateFactor(const unsigned int indentationLevel, Factor * factor);
+static const char * _declarationTypeToKeyword(const DeclarationType type);
+static unsigned int _expressionPrecedence(const ExpressionType type);
+static const char * _expressionTypeToOperator(const ExpressionType type);
+static void _generateArguments(ArgumentList * arguments);
+static void _generateArrayContent(ArrayContent * arrayContent);
+static void _generateAsyncFunction(const unsigned int indentationLevel, AsyncFunction * asyncFunction);
+static void _generateAsyncOperation(const unsigned int indentationLevel, AsyncOperation * operation);
+static void _generateBinding(const char * name);
+static void _generateCall(FunctionCall * functionCall);
+static void _generateCode(const unsigned int indentationLevel, Code * code);
+static void _generateCondition(const void * node, Expression * condition);
+static void _generateConstant(Constant * constant);
+static void _generateCounter(const unsigned int indentationLevel, const void * node, const unsigned int counter);
+static void _generateFloating(const double number);
+static void _generateDeclaration(Declaration * declaration);
+static void _generateEnum(const unsigned int indentationLevel, TypeDeclaration * typeDeclaration);
+static void _generateEpilogue();
+static void _generateExpression(Expression * expression, const unsigned int precedence);
+static void _generateFactor(Factor * factor);
+static void _generateForLoop(const unsigned int indentationLevel, ForLoop * forLoop);
+static void _generateFunctionBody(const unsigned int indentationLevel, FunctionBody * body);
+static void _generateFunctionCall(FunctionCall * functionCall);
+static void _generateFunctionDeclaration(const unsigned int indentationLevel, FunctionDeclaration * functionDeclaration);
+static void _generateIfStatement(const unsigned int indentationLevel, IfStatement * ifStatement);
+static void _generateIncDec(IncDec * incDec);
+static void _generateIndexedBody(const unsigned int indentationLevel, ForLoop * forLoop, const unsigned int offset);
+static void _generateIndexedLoop(const unsigned int indentationLevel, ForLoop * forLoop);
+static void _generateIndexedItems(ParamsFor * params);
+static void _generateInstrumentation(const char * path);
+static void _generateIterable(IterableVariable * iterable);
+static void _generateObjectContent(ObjectContent * objectContent);
+static void _generateParameters(VariableTypeList * parameters);
 static void _generateProgram(Program * program);
-static void _generatePrologue(void);
+static void _generatePrologue(Program * program);
+static void _generateReturnValue(const unsigned int indentationLevel, ReturnValue * returnValue);
+static void _generateScalarLoop(const unsigned int indentationLevel, ForLoop * forLoop);
+static void _generateStatement(const unsigned int indentationLevel, Statement * statement);
+static void _generateSwitch(const unsigned int indentationLevel, SwitchStatement * switchStatement);
+static void _generateTypedArray(const char * storage, ArrayContent * arrayContent);
+static void _generateVariableValue(Variable * variable);
 static char * _indentation(const unsigned int indentationLevel);
+static const char * _indexedItems(ParamsFor * params);
+static int _instrumentedSite(const void * node);
+static boolean _isSpilled(const char * name);
 static void _output(const unsigned int indentationLevel, const char * const format, ...);
 
 /**
- * Converts and expression type to the proper character of the operation
- * involved, or returns '\0' if that's not possible.
+ * Converts a declaration type into its JavaScript keyword.
+ */
+static const char * _declarationTypeToKeyword(const DeclarationType type) {
+	switch (type) {
+		case CONST_DT: return "const";
+		case VAR_DT: return "var";
+		default: return "let";
+	}
+}
+
+/**
+ * The binding power of an operator in JavaScript. The tree is printed with
+ * the minimum amount of parenthesis that preserves its shape.
+ */
+static unsigned int _expressionPrecedence(const ExpressionType type) {
+	switch (type) {
+		case OR_OP: return 1;
+		case AND_OP: return 2;
+		case EQUAL_OP:
+		case NEQUAL_OP:
+		case STRICT_EQUAL_OP:
+		case STRICT_NEQUAL_OP: return 3;
+		case GREATER_OP:
+		case LESS_OP:
+		case GREATER_EQUAL_OP:
+		case LESS_EQUAL_OP: return 4;
+		case ADD_OP:
+		case SUB_OP: return 5;
+		case MUL_OP:
+		case DIV_OP: return 6;
+		case NOT_OP:
+		case AWAIT_OP: return 7;
+		default: return 8;
+	}
+}
+
+/**
+ * Converts and expression type to the proper operator, or returns an empty
+ * string if that's not possible.
  */
-static const char _expressionTypeToCharacter(const ExpressionType type) {
+static const char * _expressionTypeToOperator(const ExpressionType type) {
 	switch (type) {
-		case ADDITION: return '+';
-		case DIVISION: return '/';
-		case MULTIPLICATION: return '*';
-		case SUBTRACTION: return '-';
+		case ADD_OP: return "+";
+		case SUB_OP: return "-";
+		case MUL_OP: return "*";
+		case DIV_OP: return "/";
+		case GREATER_OP: return ">";
+		case LESS_OP: return "<";
+		case EQUAL_OP: return "==";
+		case NEQUAL_OP: return "!=";
+		case GREATER_EQUAL_OP: return ">=";
+		case LESS_EQUAL_OP: return "<=";
+		case STRICT_EQUAL_OP: return "===";
+		case STRICT_NEQUAL_OP: return "!==";
+		case OR_OP: return "||";
+		case AND_OP: return "&&";
+		case NOT_OP: return "!";
+		case AWAIT_OP: return "await ";
 		default:
-			logError(_logger, "The specified expression type cannot be converted into character: %d", type);
-			return '\0';
+			logError(_logger, "The specified expression type cannot be converted into an operator: %d", type);
+			return "";
 	}
 }
 
+static void _generateArguments(ArgumentList * arguments) {
+	for (; arguments != NULL; arguments = arguments->next) {
+		_generateExpression(arguments->expression, 0);
+		if (arguments->next != NULL) {
+			_output(0, "%s", ", ");
+		}
+	}
+}
+
+static void _generateArrayContent(ArrayContent * arrayContent) {
+	_output(0, "%s", "[");
+	for (; arrayContent != NULL; arrayContent = arrayContent->next) {
+		_generateExpression(arrayContent->value, 0);
+		if (arrayContent->next != NULL) {
+			_output(0, "%s", ", ");
+		}
+	}
+	_output(0, "%s", "]");
+}
+
+/**
+ * Generates an async function as a resumable state machine: an entry
+ * function that allocates the frame, and a step function shared by every
+ * call that runs the frame until the next suspend point. The "$async"
+ * driver of the prologue resumes the step function once each awaited value
+ * settles. The spilled locals live in their own object of the frame, so no
+ * name of the program clashes with the fields of the driver.
+ */
+static void _generateAsyncFunction(const unsigned int indentationLevel, AsyncFunction * asyncFunction) {
+	AsyncStateMachine * enclosingStateMachine = _stateMachine;
+	AsyncStateMachine * stateMachine = lowerAsyncFunction(asyncFunction);
+	_output(indentationLevel, "function %s(", asyncFunction->id);
+	_generateParameters(asyncFunction->arguments);
+	_output(0, "%s", ") {\n");
+	_output(1 + indentationLevel, "%s", "return $async({ state: 0, locals: {");
+	for (unsigned int k = 0; k < stateMachine->spilledLocalCount; ++k) {
+		const char * name = stateMachine->spilledLocals[k];
+		boolean parameter = false;
+		for (VariableTypeList * argument = asyncFunction->arguments; argument != NULL; argument = argument->next) {
+			if (strcmp(argument->variableType->id, name) == 0) {
+				parameter = true;
+			}
+		}
+		_output(0, "%s %s: %s", k == 0 ? "" : ",", name, parameter ? name : "undefined");
+	}
+	_output(0, "%s", stateMachine->spilledLocalCount == 0 ? "}" : " }");
+	for (unsigned int k = 0; k < stateMachine->iteratorCount; ++k) {
+		_output(0, ", $iterator%d: undefined", k);
+	}
+	_output(0, " }, %s$step);\n", asyncFunction->id);
+	_output(indentationLevel, "%s", "}\n\n");
+	_output(indentationLevel, "function %s$step($frame, $sent) {\n", asyncFunction->id);
+	_stateMachine = stateMachine;
+	for (unsigned int k = 0; k < stateMachine->functionCount; ++k) {
+		_generateStatement(1 + indentationLevel, stateMachine->functions[k]);
+	}
+	_output(1 + indentationLevel, "%s", "for (;;) {\n");
+	_output(2 + indentationLevel, "%s", "switch ($frame.state) {\n");
+	for (unsigned int k = 0; k < stateMachine->stateCount; ++k) {
+		_output(3 + indentationLevel, "case %d: {\n", k);
+		for (AsyncOperation * operation = stateMachine->states[k].first; operation != NULL; operation = operation->next) {
+			_generateAsyncOperation(4 + indentationLevel, operation);
+		}
+		_output(3 + indentationLevel, "%s", "}\n");
+	}
+	_stateMachine = enclosingStateMachine;
+	_output(2 + indentationLevel, "%s", "}\n");
+	_output(1 + indentationLevel, "%s", "}\n");
+	_output(indentationLevel, "%s", "}\n");
+	releaseAsyncStateMachine(stateMachine);
+}
+
+static void _generateAsyncOperation(const unsigned int indentationLevel, AsyncOperation * operation) {
+	switch (operation->type) {
+		case STATEMENT_AO:
+			_generateStatement(indentationLevel, operation->statement);
+			break;
+		case AWAIT_AO:
+			_output(indentationLevel, "$frame.state = %d;\n", operation->resumeState);
+			_output(indentationLevel, "%s", "return ");
+			_generateCall(operation->functionCall);
+			_output(0, "%s", ";\n");
+			break;
+		case RECEIVE_AO:
+			if (operation->binding != NULL) {
+				_output(indentationLevel, "%s", operation->declares && !_isSpilled(operation->binding) ? "let " : "");
+				_generateBinding(operation->binding);
+				_output(0, "%s", " = $sent;\n");
+			}
+			break;
+		case BRANCH_AO:
+			_output(indentationLevel, "%s", "$frame.state = ");
+			_generateExpression(operation->condition, 1);
+			_output(0, " ? %d : %d;\n", operation->thenState, operation->elseState);
+			_output(indentationLevel, "%s", "continue;\n");
+			break;
+		case JUMP_AO:
+			_output(indentationLevel, "$frame.state = %d;\n", operation->nextState);
+			_output(indentationLevel, "%s", "continue;\n");
+			break;
+		case RETURN_AO:
+			_output(indentationLevel, "$frame.state = %d;\n", FINAL_ASYNC_STATE);
+			if (operation->returnValue == NULL) {
+				_output(indentationLevel, "%s", "return;\n");
+			}
+			else {
+				_generateReturnValue(indentationLevel, operation->returnValue);
+			}
+			break;
+		case ITERATE_AO:
+			_output(indentationLevel, "$frame.$iterator%d = ", operation->iterator);
+			if (operation->iterable == NULL) {
+				_output(0, "%s", "$sent");
+			}
+			else {
+				_generateIterable(operation->iterable);
+			}
+			_output(0, "%s", "[Symbol.iterator]();\n");
+			break;
+		case ADVANCE_AO:
+			_output(indentationLevel, "const $next = $frame.$iterator%d.next();\n", operation->iterator);
+			_output(indentationLevel, "%s", "if ($next.done) {\n");
+			_output(1 + indentationLevel, "$frame.state = %d;\n", operation->exitState);
+			_output(1 + indentationLevel, "%s", "continue;\n");
+			_output(indentationLevel, "%s", "}\n");
+			_output(indentationLevel, "%s", operation->declares && !_isSpilled(operation->binding) ? "let " : "");
+			_generateBinding(operation->binding);
+			_output(0, "%s", " = $next.value;\n");
+			break;
+	}
+}
+
+/**
+ * Generates a reference to a variable, that lives in the frame if the
+ * current async function spills it.
+ */
+static void _generateBinding(const char * name) {
+	if (_isSpilled(name)) {
+		_output(0, "$frame.locals.%s", name);
+	}
+	else {
+		_output(0, "%s", name);
+	}
+}
+
+/**
+ * Generates a call without its "await" keyword.
+ */
+static void _generateCall(FunctionCall * functionCall) {
+	const int site = _instrumentedSite(functionCall);
+	if (0 <= site) {
+		_output(0, "(++$profile[%d], ", 2 * site);
+	}
+	_output(0, "%s(", functionCall->id);
+	_generateArguments(functionCall->arguments);
+	_output(0, "%s", site < 0 ? ")" : "))");
+}
+
+static void _generateCode(const unsigned int indentationLevel, Code * code) {
+	for (; code != NULL; code = code->next) {
+		_generateStatement(indentationLevel, code->statement);
+	}
+}
+
+/**
+ * Generates the condition of a branch or a loop, which counts its outcomes
+ * when instrumenting.
+ */
+static void _generateCondition(const void * node, Expression * condition) {
+	const int site = _instrumentedSite(node);
+	if (0 <= site) {
+		_output(0, "$branch(%d, ", site);
+	}
+	_generateExpression(condition, 0);
+	if (0 <= site) {
+		_output(0, "%s", ")");
+	}
+}
+
+/**
+ * Generates the shortest digits that read back as exactly the same number (a
+ * number too large for a double reads back as Infinity). Integers are written
+ * in full, as JavaScript prints them.
+ */
+static void _generateFloating(const double number) {
+	if (isinf(number)) {
+		_output(0, "%s1e999", number < 0 ? "-" : "");
+		return;
+	}
+	if (number == trunc(number) && fabs(number) < 1e21) {
+		_output(0, "%.0f", number);
+		return;
+	}
+	char digits[32];
+	for (int precision = 1; precision <= 17; ++precision) {
+		snprintf(digits, sizeof(digits), "%.*g", precision, number);
+		if (strtod(digits, NULL) == number) {
+			break;
+		}
+	}
+	_output(0, "%s", digits);
+}
+
 /**
  * Generates the output of a constant.
  */
-static void _generateConstant(const unsigned int indentationLevel, Constant * constant) {
-	_output(indentationLevel, "%s", "[ $C$, circle, draw, black!20\n");
-	_output(1 + indentationLevel, "%s%d%s", "[ $", constant->value, "$, circle, draw ]\n");
-	_output(indentationLevel, "%s", "]\n");
+static void _generateConstant(Constant * constant) {
+	switch (constant->type) {
+		case NUMBER:
+			if (constant->numberType == INTEGER_NT) {
+				_output(0, "%d", constant->integer);
+			}
+			else {
+				_generateFloating(constant->floating);
+			}
+			break;
+		case STRING:
+			_output(0, "%s", constant->string);
+			break;
+		case BOOLEAN:
+			_output(0, "%s", constant->boolean ? "true" : "false");
+			break;
+		default:
+			logError(_logger, "The specified constant type is unknown: %d", constant->type);
+			break;
+	}
+}
+
+/**
+ * Generates an increment of a counter of a site, when instrumenting.
+ */
+static void _generateCounter(const unsigned int indentationLevel, const void * node, const unsigned int counter) {
+	const int site = _instrumentedSite(node);
+	if (0 <= site) {
+		_output(indentationLevel, "++$profile[%d];\n", 2 * site + counter);
+	}
+}
+
+/**
+ * Generates a declaration without its trailing semicolon, so it can also be
+ * the initialization of a for loop. Spilled locals become a store into the
+ * frame.
+ */
+static void _generateDeclaration(Declaration * declaration) {
+	Variable * variable = declaration->variable;
+	if (_isSpilled(variable->variableType->id)) {
+		_generateBinding(variable->variableType->id);
+		_output(0, "%s", " = ");
+		if (variable->type == UNINITIALIZED) {
+			_output(0, "%s", "undefined");
+		}
+		else {
+			_generateVariableValue(variable);
+		}
+	}
+	else if (findArrayScalars(variable) != NULL) {
+		char ** scalars = findArrayScalars(variable);
+		_output(0, "%s ", _declarationTypeToKeyword(declaration->type));
+		unsigned int k = 0;
+		for (ArrayContent * element = variable->arrayContent; element != NULL; element = element->next, ++k) {
+			_output(0, "%s%s = ", k == 0 ? "" : ", ", scalars[k]);
+			_generateExpression(element->value, 0);
+		}
+	}
+	else {
+		_output(0, "%s %s", _declarationTypeToKeyword(declaration->type), variable->variableType->id);
+		if (variable->type != UNINITIALIZED) {
+			_output(0, "%s", " = ");
+			_generateVariableValue(variable);
+		}
+	}
 }
 
 /**
- * Creates the epilogue of the generated output, that is, the final lines that
- * completes a valid Latex document.
+ * Enumerations are the only type declarations that survive, as a frozen
+ * object that maps every member to its ordinal.
  */
-static void _generateEpilogue(const int value) {
-	_output(0, "%s%d%s",
-		"            [ $", value, "$, circle, draw, blue ]\n"
-		"        ]\n"
-		"    \\end{forest}\n"
-		"\\end{document}\n\n"
-	);
+static void _generateEnum(const unsigned int indentationLevel, TypeDeclaration * typeDeclaration) {
+	_output(indentationLevel, "const %s = Object.freeze({ ", typeDeclaration->id);
+	unsigned int ordinal = 0;
+	for (ArgumentList * member = typeDeclaration->enumm; member != NULL; member = member->next) {
+		Expression * expression = member->expression;
+		if (expression->type == FACTOR && expression->factor->type == VARIABLE) {
+			_output(0, "%s%s: %d", 0 < ordinal ? ", " : "", expression->factor->variableName, ordinal);
+			++ordinal;
+		}
+		else {
+			logError(_logger, "The members of the enumeration \"%s\" must be identifiers.", typeDeclaration->id);
+		}
+	}
+	_output(0, "%s", " });\n");
 }
 
 /**
- * Generates the output of an expression.
+ * Generates the output of an expression. If the operator binds less than the
+ * context requires, the expression is wrapped in parenthesis.
+ */
+/**
+ * Lists the sites that the instrumented output does not count (because the
+ * passes removed or cloned their code), so their counts read as unknown.
+ * As a function declaration, it is hoisted above the program.
  */
-static void _generateExpression(const unsigned int indentationLevel, Expression * expression) {
-	_output(indentationLevel, "%s", "[ $E$, circle, draw, black!20\n");
+static void _generateEpilogue() {
+	if (_profile == NULL) {
+		return;
+	}
+	_output(0, "%s", "\nfunction $unobserved() {\n");
+	_output(1, "%s", "return [");
+	boolean first = true;
+	for (unsigned int k = 0; k < _profile->siteCount; ++k) {
+		if (!_observed[k]) {
+			_output(0, "%s%u", first ? "" : ", ", k);
+			first = false;
+		}
+	}
+	_output(0, "%s", "];\n}\n");
+}
+
+static void _generateExpression(Expression * expression, const unsigned int precedence) {
+	const unsigned int ownPrecedence = _expressionPrecedence(expression->type);
+	const boolean parenthesized = ownPrecedence < precedence;
+	if (parenthesized) {
+		_output(0, "%s", "(");
+	}
 	switch (expression->type) {
-		case ADDITION:
-		case DIVISION:
-		case MULTIPLICATION:
-		case SUBTRACTION:
-			_generateExpression(1 + indentationLevel, expression->leftExpression);
-			_output(1 + indentationLevel, "%s%c%s", "[ $", _expressionTypeToCharacter(expression->type), "$, circle, draw, purple ]\n");
-			_generateExpression(1 + indentationLevel, expression->rightExpression);
-			break;
 		case FACTOR:
-			_generateFactor(1 + indentationLevel, expression->factor);
+			_generateFactor(expression->factor);
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			_output(0, "%s", _expressionTypeToOperator(expression->type));
+			_generateExpression(expression->expression, ownPrecedence);
 			break;
 		default:
-			logError(_logger, "The specified expression type is unknown: %d", expression->type);
+			_generateExpression(expression->leftExpression, ownPrecedence);
+			_output(0, " %s ", _expressionTypeToOperator(expression->type));
+			_generateExpression(expression->rightExpression, 1 + ownPrecedence);
 			break;
 	}
-	_output(indentationLevel, "%s", "]\n");
+	if (parenthesized) {
+		_output(0, "%s", ")");
+	}
 }
 
 /**
  * Generates the output of a factor.
  */
-static void _generateFactor(const unsigned int indentationLevel, Factor * factor) {
-	_output(indentationLevel, "%s", "[ $F$, circle, draw, black!20\n");
+static void _generateFactor(Factor * factor) {
 	switch (factor->type) {
 		case CONSTANT:
-			_generateConstant(1 + indentationLevel, factor->constant);
+			_generateConstant(factor->constant);
+			break;
+		case VARIABLE:
+			_generateBinding(factor->variableName);
 			break;
 		case EXPRESSION:
-			_output(1 + indentationLevel, "%s", "[ $($, circle, draw, purple ]\n");
-			_generateExpression(1 + indentationLevel, factor->expression);
-			_output(1 + indentationLevel, "%s", "[ $)$, circle, draw, purple ]\n");
+			_output(0, "%s", "(");
+			_generateExpression(factor->expression, 0);
+			_output(0, "%s", ")");
+			break;
+		case FUNCTIONCALL:
+			_generateFunctionCall(factor->functionCall);
 			break;
 		default:
 			logError(_logger, "The specified factor type is unknown: %d", factor->type);
 			break;
 	}
-	_output(indentationLevel, "%s", "]\n");
+}
+
+static void _generateForLoop(const unsigned int indentationLevel, ForLoop * forLoop) {
+	ParamsFor * params = forLoop->params;
+	if (params->type == FOR_OF) {
+		_generateCounter(indentationLevel, forLoop, 1);
+	}
+	if (params->type == FOR_OF && findScalarIterable(params) != NULL) {
+		_generateScalarLoop(indentationLevel, forLoop);
+		return;
+	}
+	if (params->type == FOR_OF && findIndexedLoop(params) != NULL) {
+		_generateIndexedLoop(indentationLevel, forLoop);
+		return;
+	}
+	_output(indentationLevel, "%s", "for (");
+	if (params->type == FOR_CLASSIC) {
+		if (params->init != NULL) {
+			_generateDeclaration(params->init);
+		}
+		_output(0, "%s", "; ");
+		_generateCondition(forLoop, params->condition);
+		_output(0, "%s", ";");
+		if (params->updateType == INC_DEC_UT) {
+			_output(0, "%s", " ");
+			_generateIncDec(params->updateIncDec);
+		}
+		else if (params->update != NULL) {
+			_output(0, "%s", " ");
+			_generateExpression(params->update, 0);
+		}
+	}
+	else {
+		_generateDeclaration(params->value);
+		_output(0, "%s", " of ");
+		_generateIterable(params->iterable);
+	}
+	_output(0, "%s", ") {\n");
+	if (params->type == FOR_OF) {
+		_generateCounter(1 + indentationLevel, forLoop, 0);
+	}
+	_generateCode(1 + indentationLevel, forLoop->body);
+	_output(indentationLevel, "%s", "}\n");
+}
+
+static void _generateFunctionBody(const unsigned int indentationLevel, FunctionBody * body) {
+	if (body != NULL) {
+		_generateCode(indentationLevel, body->code);
+		if (body->returnValue != NULL) {
+			_generateReturnValue(indentationLevel, body->returnValue);
+		}
+	}
+}
+
+static void _generateFunctionCall(FunctionCall * functionCall) {
+	if (functionCall->type == AWAIT_CALL) {
+		_output(0, "%s", "await ");
+	}
+	_generateCall(functionCall);
+}
+
+static void _generateFunctionDeclaration(const unsigned int indentationLevel, FunctionDeclaration * functionDeclaration) {
+	_output(indentationLevel, "function %s(", functionDeclaration->id);
+	_generateParameters(functionDeclaration->arguments);
+	_output(0, "%s", ") {\n");
+	_generateFunctionBody(1 + indentationLevel, functionDeclaration->body);
+	_output(indentationLevel, "%s", "}\n");
+}
+
+static void _generateIfStatement(const unsigned int indentationLevel, IfStatement * ifStatement) {
+	_output(indentationLevel, "%s", "if (");
+	_generateCondition(ifStatement, ifStatement->condition);
+	_output(0, "%s", ") {\n");
+	_generateCode(1 + indentationLevel, ifStatement->thenBody);
+	if (ifStatement->elseBody != NULL) {
+		_output(indentationLevel, "%s", "} else {\n");
+		_generateCode(1 + indentationLevel, ifStatement->elseBody);
+	}
+	_output(indentationLevel, "%s", "}\n");
+}
+
+static void _generateIncDec(IncDec * incDec) {
+	const char * operator = incDec->type == INC_OP ? "++" : "--";
+	if (incDec->position == PREFIX) {
+		_output(0, "%s", operator);
+	}
+	_generateExpression(incDec->expression, _expressionPrecedence(FACTOR));
+	if (incDec->position == POSTFIX) {
+		_output(0, "%s", operator);
+	}
+}
+
+/**
+ * A for...of over an array of invariant length, as a loop over its indexes
+ * (which skips the iterator protocol). An unrolled loop runs several copies
+ * of the body per iteration, each in its own block (so its declarations do
+ * not clash), and then the remaining elements one at a time.
+ */
+static void _generateIndexedLoop(const unsigned int indentationLevel, ForLoop * forLoop) {
+	ParamsFor * params = forLoop->params;
+	const char * index = findIndexedLoop(params)->index;
+	const char * items = _indexedItems(params);
+	const unsigned int unroll = findUnrollFactor(params);
+	if (unroll <= 1) {
+		_output(indentationLevel, "for (let %s = 0", index);
+		if (items != NULL) {
+			_output(0, ", %s = ", items);
+			_generateIterable(params->iterable);
+		}
+		_output(0, "; %s < ", index);
+		_generateIndexedItems(params);
+		_output(0, ".length; %s++) {\n", index);
+		_generateIndexedBody(1 + indentationLevel, forLoop, 0);
+		_output(indentationLevel, "%s", "}\n");
+		return;
+	}
+	_output(indentationLevel, "%s", "{\n");
+	_output(1 + indentationLevel, "let %s = 0", index);
+	if (items != NULL) {
+		_output(0, ", %s = ", items);
+		_generateIterable(params->iterable);
+	}
+	_output(0, "%s", ";\n");
+	_output(1 + indentationLevel, "for (; %s + %u < ", index, unroll - 1);
+	_generateIndexedItems(params);
+	_output(0, ".length; %s += %u) {\n", index, unroll);
+	for (unsigned int copy = 0; copy < unroll; ++copy) {
+		_output(2 + indentationLevel, "%s", "{\n");
+		_generateIndexedBody(3 + indentationLevel, forLoop, copy);
+		_output(2 + indentationLevel, "%s", "}\n");
+	}
+	_output(1 + indentationLevel, "%s", "}\n");
+	_output(1 + indentationLevel, "for (; %s < ", index);
+	_generateIndexedItems(params);
+	_output(0, ".length; %s++) {\n", index);
+	_generateIndexedBody(2 + indentationLevel, forLoop, 0);
+	_output(1 + indentationLevel, "%s", "}\n");
+	_output(indentationLevel, "%s", "}\n");
+}
+
+/**
+ * The body of an indexed loop, for the element at an offset of the index.
+ */
+static void _generateIndexedBody(const unsigned int indentationLevel, ForLoop * forLoop, const unsigned int offset) {
+	ParamsFor * params = forLoop->params;
+	Declaration * value = params->value;
+	const char * element = value->variable->variableType->id;
+	_output(indentationLevel, "%s", "");
+	if (_isSpilled(element)) {
+		_generateBinding(element);
+	}
+	else {
+		_output(0, "%s %s", _declarationTypeToKeyword(value->type), element);
+	}
+	_output(0, "%s", " = ");
+	_generateIndexedItems(params);
+	const char * index = findIndexedLoop(params)->index;
+	if (offset == 0) {
+		_output(0, "[%s];\n", index);
+	}
+	else {
+		_output(0, "[%s + %u];\n", index, offset);
+	}
+	_generateCounter(indentationLevel, forLoop, 0);
+	_generateCode(indentationLevel, forLoop->body);
+}
+
+static void _generateIndexedItems(ParamsFor * params) {
+	const char * items = _indexedItems(params);
+	if (items != NULL) {
+		_output(0, "%s", items);
+	}
+	else {
+		_generateBinding(params->iterable->variableName);
+	}
+}
+
+/**
+ * Creates the counters of every site, and the handler that writes them into
+ * the profile when the process exits (see Profiling). A branch counts its
+ * outcomes in a call to "$branch", which returns the condition untouched.
+ */
+static void _generateInstrumentation(const char * path) {
+	_output(0, "const $profile = new Float64Array(%u);\n\n", 2 * _profile->siteCount);
+	_output(0, "%s",
+		"function $branch(site, condition) {\n"
+		"    ++$profile[2 * site + (condition ? 0 : 1)];\n"
+		"    return condition;\n"
+		"}\n\n"
+		"process.on(\"exit\", function () {\n"
+		"    const counts = Array.from($profile);\n"
+		"    for (const site of $unobserved()) {\n"
+		"        counts[2 * site] = counts[2 * site + 1] = NaN;\n"
+		"    }\n"
+		"    require(\"fs\").writeFileSync(\"");
+	for (; *path != '\0'; ++path) {
+		if (*path == '"' || *path == '\\') {
+			_output(0, "%s", "\\");
+		}
+		_output(0, "%c", *path);
+	}
+	_output(0, "\", \"profile %u %08x\\n\" + counts.join(\" \") + \"\\n\");\n", _profile->siteCount, _profile->signature);
+	_output(0, "%s", "});\n\n");
+}
+
+static void _generateIterable(IterableVariable * iterable) {
+	switch (iterable->type) {
+		case VARIABLE_IT:
+			_generateBinding(iterable->variableName);
+			break;
+		case FUNCTIONCALL_IT:
+			_generateFunctionCall(iterable->functionCall);
+			break;
+		case ARRAY_IT:
+			_generateArrayContent(iterable->arrayContent);
+			break;
+		case OBJECT_IT:
+			_generateObjectContent(iterable->objectContent);
+			break;
+	}
+}
+
+static void _generateObjectContent(ObjectContent * objectContent) {
+	_output(0, "%s", "{ ");
+	for (; objectContent != NULL; objectContent = objectContent->next) {
+		_output(0, "%s: ", objectContent->key);
+		_generateExpression(objectContent->value, 0);
+		if (objectContent->next != NULL) {
+			_output(0, "%s", ", ");
+		}
+	}
+	_output(0, "%s", " }");
+}
+
+/**
+ * Generates the parameters of a function, without their type annotations.
+ */
+static void _generateParameters(VariableTypeList * parameters) {
+	for (; parameters != NULL; parameters = parameters->next) {
+		_output(0, "%s%s", parameters->variableType->id, parameters->next == NULL ? "" : ", ");
+	}
 }
 
 /**
  * Generates the output of the program.
  */
 static void _generateProgram(Program * program) {
-	_generateExpression(3, program->expression);
+	_generateCode(0, program->code);
 }
 
 /**
- * Creates the prologue of the generated output, a Latex document that renders
- * a tree thanks to the Forest package.
- *
- * @see https://ctan.dcc.uchile.cl/graphics/pgf/contrib/forest/forest-doc.pdf
+ * Creates the prologue of the generated output: the runtime support that the
+ * program needs, if any. Every await resumes through "Promise.resolve" in a
+ * microtask of its own, as a native await does, so the continuations of all
+ * the async functions interleave in the order of plain JavaScript.
  */
-static void _generatePrologue(void) {
-	_output(0, "%s",
-		"\\documentclass{standalone}\n\n"
-		"\\usepackage[utf8]{inputenc}\n"
-		"\\usepackage[T1]{fontenc}\n"
-		"\\usepackage{amsmath}\n"
-		"\\usepackage{forest}\n"
-		"\\usepackage{microtype}\n\n"
-		"\\begin{document}\n"
-		"    \\centering\n"
-		"    \\begin{forest}\n"
-		"        [ \\text{$=$}, circle, draw, purple\n"
-	);
+static void _generatePrologue(Program * program) {
+	if (hasAsyncFunctions(program)) {
+		_output(0, "%s",
+			"function $async(frame, step) {\n"
+			"    return new Promise(function (resolve, reject) {\n"
+			"        function resume(sent) {\n"
+			"            let value;\n"
+			"            try {\n"
+			"                value = step(frame, sent);\n"
+			"            } catch (error) {\n"
+			"                reject(error);\n"
+			"                return;\n"
+			"            }\n"
+			"            if (frame.state < 0) {\n"
+			"                resolve(value);\n"
+			"            } else {\n"
+			"                Promise.resolve(value).then(resume, reject);\n"
+			"            }\n"
+			"        }\n"
+			"        resume(undefined);\n"
+			"    });\n"
+			"}\n\n"
+		);
+	}
+}
+
+static void _generateReturnValue(const unsigned int indentationLevel, ReturnValue * returnValue) {
+	switch (returnValue->type) {
+		case EXPRESSION_RT:
+			_output(indentationLevel, "%s", "return ");
+			_generateExpression(returnValue->expression, 0);
+			_output(0, "%s", ";\n");
+			break;
+		case FUNCTIONCALL_RT:
+			// Returning from an async function adopts the state of the promise.
+			_output(indentationLevel, "%s", "return ");
+			if (_stateMachine == NULL) {
+				_generateFunctionCall(returnValue->functionCall);
+			}
+			else {
+				_generateCall(returnValue->functionCall);
+			}
+			_output(0, "%s", ";\n");
+			break;
+		case ASYNC_FUNCTION_RT:
+			_generateAsyncFunction(indentationLevel, returnValue->asyncFunction);
+			_output(indentationLevel, "return %s;\n", returnValue->asyncFunction->id);
+			break;
+		case VOID_RT:
+			_output(indentationLevel, "%s", "return;\n");
+			break;
+		default:
+			logError(_logger, "The specified return type is unknown: %d", returnValue->type);
+			break;
+	}
+}
+
+/**
+ * A for...of over an array replaced by scalars, as one block per element
+ * (so the declarations of every copy of the body do not clash).
+ */
+static void _generateScalarLoop(const unsigned int indentationLevel, ForLoop * forLoop) {
+	Declaration * value = forLoop->params->value;
+	Variable * array = findScalarIterable(forLoop->params);
+	char ** scalars = findArrayScalars(array);
+	unsigned int k = 0;
+	for (ArrayContent * element = array->arrayContent; element != NULL; element = element->next, ++k) {
+		_output(indentationLevel, "%s", "{\n");
+		_output(1 + indentationLevel, "%s %s = %s;\n", _declarationTypeToKeyword(value->type), value->variable->variableType->id, scalars[k]);
+		_generateCounter(1 + indentationLevel, forLoop, 0);
+		_generateCode(1 + indentationLevel, forLoop->body);
+		_output(indentationLevel, "%s", "}\n");
+	}
+}
+
+static void _generateStatement(const unsigned int indentationLevel, Statement * statement) {
+	switch (statement->statement) {
+		case IF_ST:
+			_generateIfStatement(indentationLevel, statement->ifStatement);
+			break;
+		case WHILE_ST:
+			_output(indentationLevel, "%s", "while (");
+			_generateCondition(statement->whileLoop, statement->whileLoop->condition);
+			_output(0, "%s", ") {\n");
+			_generateCode(1 + indentationLevel, statement->whileLoop->body);
+			_output(indentationLevel, "%s", "}\n");
+			break;
+		case FOR_ST:
+			_generateForLoop(indentationLevel, statement->forLoop);
+			break;
+		case DECLARATION_ST:
+			_output(indentationLevel, "%s", "");
+			_generateDeclaration(statement->declaration);
+			_output(0, "%s", ";\n");
+			break;
+		case EXPRESSION_ST:
+			_output(indentationLevel, "%s", "");
+			_generateExpression(statement->expression, 0);
+			_output(0, "%s", ";\n");
+			break;
+		case VARIABLE_ST:
+			_output(indentationLevel, "%s", "");
+			_generateBinding(statement->variable->variableType->id);
+			_output(0, "%s", " = ");
+			_generateVariableValue(statement->variable);
+			_output(0, "%s", ";\n");
+			break;
+		case FUNCTIONCALL_ST:
+			_output(indentationLevel, "%s", "");
+			_generateFunctionCall(statement->functionCall);
+			_output(0, "%s", ";\n");
+			break;
+		case FUNCTION_DECLARATION_ST:
+			_generateFunctionDeclaration(indentationLevel, statement->FunctionDeclaration);
+			break;
+		case ASYNC_FUNCTION_ST:
+			_generateAsyncFunction(indentationLevel, statement->asyncFunction);
+			break;
+		case TYPE_DECLARATION_ST:
+			if (statement->typeDeclaration->type == TYPE_ENUM) {
+				_generateEnum(indentationLevel, statement->typeDeclaration);
+			}
+			break;
+		case INC_DEC_ST:
+			_output(indentationLevel, "%s", "");
+			_generateIncDec(statement->incDec);
+			_output(0, "%s", ";\n");
+			break;
+		case SWITCH_ST:
+			_generateSwitch(indentationLevel, statement->switchStatement);
+			break;
+		default:
+			logError(_logger, "The specified statement type is unknown: %d", statement->statement);
+			break;
+	}
+}
+
+static void _generateSwitch(const unsigned int indentationLevel, SwitchStatement * switchStatement) {
+	_output(indentationLevel, "%s", "switch (");
+	_generateBinding(switchStatement->id);
+	_output(0, "%s", ") {\n");
+	for (SwitchContent * content = switchStatement->content; content != NULL; content = content->next) {
+		if (content->condition == NULL) {
+			_output(1 + indentationLevel, "%s", "default:\n");
+			_generateCounter(2 + indentationLevel, content, 0);
+			_generateCode(2 + indentationLevel, content->body);
+		}
+		else {
+			_output(1 + indentationLevel, "%s", "case ");
+			_generateExpression(content->condition, 0);
+			_output(0, "%s", ":\n");
+			_generateCounter(2 + indentationLevel, content, 0);
+			_generateCode(2 + indentationLevel, content->body);
+			_output(2 + indentationLevel, "%s", "break;\n");
+		}
+	}
+	_output(indentationLevel, "%s", "}\n");
+}
+
+/**
+ * An array literal stored in a typed array, which takes its elements as
+ * arguments (so no intermediate array is built).
+ */
+static void _generateTypedArray(const char * storage, ArrayContent * arrayContent) {
+	_output(0, "%s.of(", storage);
+	for (; arrayContent != NULL; arrayContent = arrayContent->next) {
+		_generateExpression(arrayContent->value, 0);
+		if (arrayContent->next != NULL) {
+			_output(0, "%s", ", ");
+		}
+	}
+	_output(0, "%s", ")");
+}
+
+static void _generateVariableValue(Variable * variable) {
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_generateExpression(variable->expression, 0);
+			break;
+		case ARRAY_VAR:
+			if (findArrayStorage(variable) != NULL) {
+				_generateTypedArray(findArrayStorage(variable), variable->arrayContent);
+			}
+			else {
+				_generateArrayContent(variable->arrayContent);
+			}
+			break;
+		case OBJECT_VAR:
+			_generateObjectContent(variable->objectContent);
+			break;
+		case FUNCTIONCALL_VAR:
+			_generateFunctionCall(variable->functionCall);
+			break;
+		case UNINITIALIZED:
+			_output(0, "%s", "undefined");
+			break;
+		default:
+			logError(_logger, "The specified variable type is unknown: %d", variable->type);
+			break;
+	}
 }
 
 /**
@@ -146,6 +971,29 @@ static char * _indentation(const unsigned int level) {
 	return indentation(_indentationCharacter, level, _indentationSize);
 }
 
+/**
+ * The copy of the literal that an indexed loop iterates, unless the literal
+ * was pooled into a binding since then (see LiteralPool).
+ */
+static const char * _indexedItems(ParamsFor * params) {
+	return params->iterable->type == ARRAY_IT ? findIndexedLoop(params)->items : NULL;
+}
+
+/**
+ * The index of the site of a node, if the output counts it (-1 otherwise).
+ */
+static int _instrumentedSite(const void * node) {
+	const int site = findProfileSite(_profile, node);
+	if (0 <= site) {
+		_observed[site] = true;
+	}
+	return site;
+}
+
+static boolean _isSpilled(const char * name) {
+	return _stateMachine != NULL && isSpilledLocal(_stateMachine, name);
+}
+
 /**
  * Outputs a formatted string to standard output. The "fflush" instruction
  * allows to see the output even close to a failure, because it drops the
@@ -167,8 +1015,17 @@ static void _output(const unsigned int indentationLevel, const char * const form
 
 void generate(CompilerState * compilerState) {
 	logDebugging(_logger, "Generating final output...");
-	_generatePrologue();
+	_program = compilerState->abstractSyntaxtTree;
+	if (compilerState->profileOutput != NULL && compilerState->profile != NULL) {
+		_profile = compilerState->profile;
+		_observed = calloc(_profile->siteCount, sizeof(boolean));
+		_generateInstrumentation(compilerState->profileOutput);
+	}
+	_generatePrologue(compilerState->abstractSyntaxtTree);
 	_generateProgram(compilerState->abstractSyntaxtTree);
-	_generateEpilogue(compilerState->value);
+	_generateEpilogue();
+	free(_observed);
+	_observed = NULL;
+	_profile = NULL;
 	logDebugging(_logger, "Generation is done.");
 }
@@ -5,8 +5,16 @@
 #include "../../shared/CompilerState.h"
 #include "../../shared/Logger.h"
 #include "../../shared/String.h"
+#include "../optimization/EscapeAnalysis.h"
+#include "../optimization/IndexedLoops.h"
+#include "../optimization/LoopUnrolling.h"
+#include "../optimization/Profiling.h"
+#include "../optimization/TypedArrays.h"
+#include "AsyncLowering.h"
+#include <math.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 /** Initialize module's internal state. */
 void initializeGeneratorModule();
@@ -15,7 +23,10 @@ void initializeGeneratorModule();
 void shutdownGeneratorModule();
 
 /**
- * Generates the final output using the current compiler state.
+ * Generates the final output (a JavaScript program without type annotations)
+ * using the current compiler state. When instrumenting (see
+ * "--profile-generate"), the output also counts how every site of the
+ * profile runs, and writes those counts once the process exits.
  */
 void generate(CompilerState * compilerState);
 
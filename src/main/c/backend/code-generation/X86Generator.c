@@ -0,0 +1,1721 @@
+#include "X86Generator.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializeX86GeneratorModule() {
+	_logger = createLogger("X86Generator");
+}
+
+void shutdownX86GeneratorModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The registers that hold values. The first ones survive the calls (the
+ * callee saves them), and the others do not. The registers of the arguments
+ * and the scratch registers (rax, rcx, xmm14 and xmm15) are never allocated,
+ * so writing them never overwrites a value.
+ */
+#define GENERAL_REGISTERS 7
+#define CALLEE_SAVED_REGISTERS 5
+#define FLOAT_REGISTERS 6
+#define GENERAL_ARGUMENTS 6
+#define FLOAT_ARGUMENTS 8
+
+static const char * const _generalRegisters[] = {"%rbx", "%r12", "%r13", "%r14", "%r15", "%r10", "%r11"};
+static const char * const _floatRegisters[] = {"%xmm8", "%xmm9", "%xmm10", "%xmm11", "%xmm12", "%xmm13"};
+static const char * const _generalArguments[] = {"%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"};
+static const char * const _floatArguments[] = {"%xmm0", "%xmm1", "%xmm2", "%xmm3", "%xmm4", "%xmm5", "%xmm6", "%xmm7"};
+
+/**
+ * The size of the text of an operand (a register, a slot of the frame, a
+ * label or an immediate).
+ */
+#define OPERAND_SIZE 48
+
+/**
+ * Where a value lives: general registers hold the integers, the booleans and
+ * the strings (a pointer to their length, followed by their bytes), and
+ * float registers hold every other number.
+ */
+typedef enum {
+	NO_CLASS,
+	GENERAL_CLASS,
+	FLOAT_CLASS
+} RegisterClass;
+
+/**
+ * A binding of the module scope, that lives in memory (labeled "G" and its
+ * index). It only ever holds values of a single type (ANY_VT if it does not).
+ */
+typedef struct {
+	const char * name;
+	IrValueType type;
+} X86Global;
+
+/**
+ * The types that a function takes and returns: ANY_VT for the parameters
+ * that it never reads (no register carries them), and UNDEFINED_VT if it
+ * returns nothing.
+ */
+typedef struct {
+	IrValueType returnType;
+	IrValueType * parameterTypes;
+	unsigned int parameterCount;
+} X86Signature;
+
+/**
+ * The type of a value that is not known yet, while the types are inferred
+ * (every other type is above it).
+ */
+#define UNKNOWN_VT ((IrValueType) (ANY_VT + 1))
+
+/**
+ * The state of the generation of a whole module: the uses and the types of
+ * every value, and the globals and constants (doubles and strings) that its
+ * functions refer to, emitted after them.
+ */
+typedef struct {
+	const IrModule * module;
+	Target target;
+	unsigned int ** uses;
+	IrValueType ** types;
+	X86Signature * signatures;
+	X86Global * globals;
+	unsigned int globalCount;
+	unsigned int globalCapacity;
+	const char ** strings;
+	unsigned int stringCount;
+	unsigned int stringCapacity;
+	double * floats;
+	unsigned int floatCount;
+	unsigned int floatCapacity;
+	unsigned int labelCount;
+} X86Program;
+
+/**
+ * A condition of the flags, as the suffix of the instructions that test it
+ * (and of the ones that test its inverse). An unordered comparison of doubles
+ * (with a NaN) sets the parity, so an equality must also be ordered, and an
+ * inequality can also be unordered.
+ */
+typedef enum {
+	NO_PARITY,
+	ORDERED_PARITY,
+	UNORDERED_PARITY
+} X86Parity;
+
+typedef struct {
+	const char * suffix;
+	const char * inverse;
+	X86Parity parity;
+} X86Condition;
+
+/**
+ * A copy into a phi, on an edge. Once its source is overwritten by another
+ * copy (in a cycle), it reads a swap slot of the frame instead.
+ */
+typedef struct {
+	unsigned int source;
+	unsigned int destination;
+	int swap;
+} X86Move;
+
+/**
+ * An edge whose copies into phis run on their own, after a branch.
+ */
+typedef struct {
+	unsigned int from;
+	unsigned int to;
+} X86Edge;
+
+/**
+ * The state of the generation of a single function. Positions number the
+ * instructions along the order of the blocks (every phi at the start of its
+ * block), and a value lives in a single interval: from its definition, up to
+ * its last use or the end of the last block where it is still live.
+ */
+typedef struct {
+	X86Program * program;
+	const IrFunction * function;
+	unsigned int index;
+	const unsigned int * uses;
+	const IrValueType * types;
+	RegisterClass * classes;
+	boolean * allocated;
+	boolean * fused;
+	unsigned int * positions;
+	unsigned int * starts;
+	unsigned int * ends;
+	int * registers;
+	int * slots;
+	unsigned int slotCount;
+	unsigned int swapCount;
+	boolean saved[CALLEE_SAVED_REGISTERS];
+	unsigned int savedCount;
+	unsigned int * order;
+	unsigned int orderCount;
+	unsigned int * blockStarts;
+	unsigned int * blockEnds;
+	unsigned int * calls;
+	unsigned int callCount;
+	X86Condition pending;
+	X86Edge * edges;
+	unsigned int edgeCount;
+	unsigned int edgeCapacity;
+} X86Function;
+
+static void _allocateRegisters(X86Function * x86Function);
+static boolean _check(X86Program * program, const unsigned int function);
+static boolean _checkCall(X86Program * program, const unsigned int function, const unsigned int value);
+static boolean _checkInstruction(X86Program * program, const unsigned int function, const unsigned int value);
+static boolean _checkOperand(X86Program * program, const unsigned int function, const unsigned int value, const IrValueType type);
+static RegisterClass _class(const X86Program * program, const unsigned int function, const unsigned int value);
+static X86Condition _compare(X86Function * x86Function, const unsigned int value);
+static void _computeIntervals(X86Function * x86Function);
+static void _convert(const char * source, const RegisterClass sourceClass, const RegisterClass class, const char * target);
+static boolean _crossesCall(const X86Function * x86Function, const unsigned int value);
+static boolean _decodeString(const char * lexeme, char * bytes, size_t * length);
+static void _emitBranch(X86Function * x86Function, const unsigned int block, const unsigned int value, const unsigned int next);
+static void _emitCall(X86Function * x86Function, const unsigned int value);
+static void _emitData(const X86Program * program);
+static void _emitEpilogue(const X86Function * x86Function);
+static void _emitFunction(X86Program * program, const unsigned int function);
+static void _emitInstruction(X86Function * x86Function, const unsigned int block, const unsigned int value, const unsigned int next);
+static void _emitJump(X86Function * x86Function, const X86Condition condition, const boolean when, const char * label);
+static void _emitMoves(X86Function * x86Function, const unsigned int from, const unsigned int to);
+static unsigned int _findFloat(X86Program * program, const double number);
+static unsigned int _findGlobal(const X86Program * program, const char * name);
+static unsigned int _findString(X86Program * program, const char * lexeme);
+static boolean _hasMoves(const X86Function * x86Function, const unsigned int block);
+static boolean _immediate(X86Function * x86Function, const unsigned int value, const RegisterClass class, char * immediate);
+static boolean _inferred(const IrInstruction * instruction);
+static void _inferTypes(X86Program * program);
+static IrValueType _join(const IrValueType type, const IrValueType other);
+static void _load(X86Function * x86Function, const unsigned int value, const RegisterClass class, const char * scratch, char * target);
+static void _location(const X86Function * x86Function, const unsigned int value, char * location);
+static void _output(const char * const format, ...);
+static boolean _pure(const IrFunction * function, const unsigned int value, const unsigned int depth);
+static void _read(X86Function * x86Function, const unsigned int value, const RegisterClass class, const char * target);
+static boolean _recordGlobal(X86Program * program, const char * name, const IrValueType type);
+static void _result(const X86Function * x86Function, const unsigned int value, char * target);
+static boolean _sameLocation(const X86Function * x86Function, const unsigned int value, const unsigned int other);
+static const char * _scratch(const RegisterClass class);
+static void _slotLocation(const X86Function * x86Function, const unsigned int slot, char * location);
+static boolean _source(X86Function * x86Function, const unsigned int value, const RegisterClass class, char * source);
+static void _targetLabel(X86Function * x86Function, const unsigned int from, const unsigned int to, char * label);
+static IrValueType _transfer(const X86Program * program, const unsigned int function, const unsigned int value);
+static boolean _unsupported(const X86Program * program, const unsigned int function, const char * construct);
+static void _write(const X86Function * x86Function, const unsigned int value, const char * source, const RegisterClass sourceClass);
+
+/**
+ * Assigns a register or a slot of the frame to every value (Poletto and
+ * Sarkar, "Linear Scan Register Allocation", 1999), visiting the intervals
+ * by their start. Once the registers of a class run out, the interval that
+ * ends last goes to the frame. A value that lives across a call only takes
+ * a register saved by the callee (so doubles that do are always spilled).
+ */
+static void _allocateRegisters(X86Function * x86Function) {
+	const IrFunction * function = x86Function->function;
+	unsigned int * intervals = malloc(function->instructionCount * sizeof(unsigned int));
+	unsigned int * active = malloc(function->instructionCount * sizeof(unsigned int));
+	unsigned int intervalCount = 0;
+	unsigned int activeCount = 0;
+	for (unsigned int k = 0; k < function->instructionCount; ++k) {
+		x86Function->registers[k] = -1;
+		x86Function->slots[k] = -1;
+		if (!x86Function->allocated[k]) {
+			continue;
+		}
+		unsigned int j = intervalCount++;
+		for (; 0 < j && x86Function->starts[k] < x86Function->starts[intervals[j - 1]]; --j) {
+			intervals[j] = intervals[j - 1];
+		}
+		intervals[j] = k;
+	}
+	for (unsigned int k = 0; k < intervalCount; ++k) {
+		const unsigned int value = intervals[k];
+		const RegisterClass class = x86Function->classes[value];
+		const boolean crossesCall = _crossesCall(x86Function, value);
+		unsigned int kept = 0;
+		for (unsigned int a = 0; a < activeCount; ++a) {
+			if (x86Function->starts[value] <= x86Function->ends[active[a]]) {
+				active[kept++] = active[a];
+			}
+		}
+		activeCount = kept;
+		const unsigned int candidates = crossesCall
+			? (class == GENERAL_CLASS ? CALLEE_SAVED_REGISTERS : 0)
+			: (class == GENERAL_CLASS ? GENERAL_REGISTERS : FLOAT_REGISTERS);
+		boolean busy[GENERAL_REGISTERS] = {false};
+		for (unsigned int a = 0; a < activeCount; ++a) {
+			if (x86Function->classes[active[a]] == class) {
+				busy[x86Function->registers[active[a]]] = true;
+			}
+		}
+		// The registers saved by the callee cost a push, so they go last.
+		int chosen = -1;
+		for (unsigned int r = 0; r < candidates && chosen < 0; ++r) {
+			const unsigned int candidate = class == GENERAL_CLASS && !crossesCall ? (r + CALLEE_SAVED_REGISTERS) % GENERAL_REGISTERS : r;
+			if (!busy[candidate]) {
+				chosen = candidate;
+			}
+		}
+		if (chosen < 0) {
+			unsigned int victim = 0;
+			boolean found = false;
+			for (unsigned int a = 0; a < activeCount; ++a) {
+				const unsigned int other = active[a];
+				if (x86Function->classes[other] == class && (unsigned int) x86Function->registers[other] < candidates
+					&& (!found || x86Function->ends[active[victim]] < x86Function->ends[other])) {
+					victim = a;
+					found = true;
+				}
+			}
+			if (found && x86Function->ends[value] < x86Function->ends[active[victim]]) {
+				const unsigned int spilled = active[victim];
+				chosen = x86Function->registers[spilled];
+				x86Function->registers[spilled] = -1;
+				x86Function->slots[spilled] = x86Function->slotCount++;
+				active[victim] = active[--activeCount];
+			}
+		}
+		if (chosen < 0) {
+			x86Function->slots[value] = x86Function->slotCount++;
+			continue;
+		}
+		x86Function->registers[value] = chosen;
+		active[activeCount++] = value;
+		if (class == GENERAL_CLASS && chosen < CALLEE_SAVED_REGISTERS && !x86Function->saved[chosen]) {
+			x86Function->saved[chosen] = true;
+			++x86Function->savedCount;
+		}
+	}
+	free(active);
+	free(intervals);
+}
+
+/**
+ * Checks that every instruction of the function is supported, and records
+ * the globals and the strings that it refers to.
+ */
+static boolean _check(X86Program * program, const unsigned int function) {
+	const IrFunction * irFunction = &program->module->functions[function];
+	if (irFunction->async) {
+		return _unsupported(program, function, "async functions");
+	}
+	if (0 < function && irFunction->parent != 0) {
+		return _unsupported(program, function, "nested functions");
+	}
+	const X86Signature * signature = &program->signatures[function];
+	unsigned int generalArguments = 0;
+	unsigned int floatArguments = 0;
+	for (unsigned int k = 0; k < signature->parameterCount; ++k) {
+		generalArguments += signature->parameterTypes[k] == BOOLEAN_VT || signature->parameterTypes[k] == STRING_VT;
+		floatArguments += signature->parameterTypes[k] == NUMBER_VT;
+	}
+	if (GENERAL_ARGUMENTS < generalArguments || FLOAT_ARGUMENTS < floatArguments) {
+		return _unsupported(program, function, "functions with that many parameters");
+	}
+	for (unsigned int k = 0; k < irFunction->instructionCount; ++k) {
+		if (irFunction->instructions[k].block != IR_NONE && !_checkInstruction(program, function, k)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Calls are bound statically: the arguments must have the types of the
+ * parameters that the callee reads. The only unbound call is to "print",
+ * with a single argument.
+ */
+static boolean _checkCall(X86Program * program, const unsigned int function, const unsigned int value) {
+	const IrFunction * irFunction = &program->module->functions[function];
+	const IrInstruction * instruction = &irFunction->instructions[value];
+	if (instruction->callee == IR_NONE) {
+		if (strcmp(instruction->name, "print") != 0 || instruction->operandCount != 1 || 0 < program->uses[function][value]) {
+			return _unsupported(program, function, "calls to unknown functions");
+		}
+		const IrValueType type = program->types[function][instruction->operands[0]];
+		return _checkOperand(program, function, instruction->operands[0], type == BOOLEAN_VT || type == STRING_VT ? type : NUMBER_VT);
+	}
+	const X86Signature * signature = &program->signatures[instruction->callee];
+	for (unsigned int k = 0; k < signature->parameterCount; ++k) {
+		if (signature->parameterTypes[k] == ANY_VT) {
+			continue;
+		}
+		if (instruction->operandCount <= k) {
+			return _unsupported(program, function, "calls with missing arguments");
+		}
+		if (!_checkOperand(program, function, instruction->operands[k], signature->parameterTypes[k])) {
+			return false;
+		}
+	}
+	if (0 < program->uses[function][value] && program->types[function][value] != signature->returnType) {
+		return _unsupported(program, function, "calls whose result has an unknown type");
+	}
+	return true;
+}
+
+static boolean _checkInstruction(X86Program * program, const unsigned int function, const unsigned int value) {
+	const IrFunction * irFunction = &program->module->functions[function];
+	const IrInstruction * instruction = &irFunction->instructions[value];
+	const unsigned int uses = program->uses[function][value];
+	if (0 < uses && _class(program, function, value) == NO_CLASS && instruction->opcode != CLOSURE_IR) {
+		return _unsupported(program, function, "values that are not numbers, booleans nor strings");
+	}
+	switch (instruction->opcode) {
+		case CONSTANT_IR:
+			if (instruction->type == STRING_VT) {
+				char * bytes = malloc(strlen(instruction->string) + 1);
+				size_t length = 0;
+				const boolean decoded = _decodeString(instruction->string, bytes, &length);
+				free(bytes);
+				if (!decoded) {
+					return _unsupported(program, function, "strings with interpolations or unknown escapes");
+				}
+				_findString(program, instruction->string);
+			}
+			return true;
+		case PARAMETER_IR:
+		case JUMP_IR:
+			return true;
+		case PHI_IR: {
+			const IrBlock * block = &irFunction->blocks[instruction->block];
+			for (unsigned int k = 0; 0 < uses && k < instruction->operandCount && k < block->predecessorCount; ++k) {
+				if (!_checkOperand(program, function, instruction->operands[k], program->types[function][value])) {
+					return false;
+				}
+			}
+			return true;
+		}
+		case LOAD_IR:
+			return true;
+		case STORE_IR: {
+			const IrValueType type = program->globals[_findGlobal(program, instruction->name)].type;
+			if (type == ANY_VT) {
+				return _unsupported(program, function, "globals of changing types");
+			}
+			return type == FUNCTION_VT || _class(program, function, instruction->operands[0]) != NO_CLASS
+				|| _unsupported(program, function, "globals that are not numbers, booleans nor strings");
+		}
+		case CLOSURE_IR:
+			// Functions are only called by name, so they are never values.
+			for (unsigned int k = 0; k < irFunction->instructionCount; ++k) {
+				const IrInstruction * other = &irFunction->instructions[k];
+				for (unsigned int o = 0; other->block != IR_NONE && other->opcode != STORE_IR && o < other->operandCount; ++o) {
+					if (other->operands[o] == value) {
+						return _unsupported(program, function, "functions as values");
+					}
+				}
+			}
+			return true;
+		case ADD_IR:
+		case SUB_IR:
+		case MUL_IR:
+		case DIV_IR:
+			if (program->types[function][value] != NUMBER_VT) {
+				return _unsupported(program, function, "operations on strings");
+			}
+			return _checkOperand(program, function, instruction->operands[0], NUMBER_VT)
+				&& _checkOperand(program, function, instruction->operands[1], NUMBER_VT);
+		case GREATER_IR:
+		case LESS_IR:
+		case GREATER_EQUAL_IR:
+		case LESS_EQUAL_IR:
+			return _checkOperand(program, function, instruction->operands[0], NUMBER_VT)
+				&& _checkOperand(program, function, instruction->operands[1], NUMBER_VT);
+		case EQUAL_IR:
+		case NEQUAL_IR:
+		case STRICT_EQUAL_IR:
+		case STRICT_NEQUAL_IR: {
+			const IrValueType type = program->types[function][instruction->operands[0]] == BOOLEAN_VT ? BOOLEAN_VT : NUMBER_VT;
+			return _checkOperand(program, function, instruction->operands[0], type)
+				&& _checkOperand(program, function, instruction->operands[1], type);
+		}
+		case AND_IR:
+		case OR_IR:
+			// Both operands are computed, so the right one must not do anything else.
+			if (!_pure(irFunction, instruction->operands[1], 0)) {
+				return _unsupported(program, function, "logical operators with side effects");
+			}
+			return _checkOperand(program, function, instruction->operands[0], BOOLEAN_VT)
+				&& _checkOperand(program, function, instruction->operands[1], BOOLEAN_VT);
+		case NOT_IR:
+		case BRANCH_IR:
+			return _checkOperand(program, function, instruction->operands[0], BOOLEAN_VT);
+		case CALL_IR:
+			return _checkCall(program, function, value);
+		case RETURN_IR: {
+			const IrValueType returnType = program->signatures[function].returnType;
+			const IrValueType type = instruction->operandCount == 0 ? UNDEFINED_VT : program->types[function][instruction->operands[0]];
+			if (type != returnType) {
+				return _unsupported(program, function, "functions that return values of different types");
+			}
+			return type == UNDEFINED_VT || _checkOperand(program, function, instruction->operands[0], type);
+		}
+		default:
+			return _unsupported(program, function, irOpcodeName(instruction->opcode));
+	}
+}
+
+static boolean _checkOperand(X86Program * program, const unsigned int function, const unsigned int value, const IrValueType type) {
+	if (program->types[function][value] != type || _class(program, function, value) == NO_CLASS) {
+		return _unsupported(program, function, "operands of unexpected types");
+	}
+	return true;
+}
+
+static RegisterClass _class(const X86Program * program, const unsigned int function, const unsigned int value) {
+	switch (program->types[function][value]) {
+		case NUMBER_VT:
+			return program->module->functions[function].instructions[value].representation == INT32_REP ? GENERAL_CLASS : FLOAT_CLASS;
+		case BOOLEAN_VT:
+		case STRING_VT:
+			return GENERAL_CLASS;
+		default:
+			return NO_CLASS;
+	}
+}
+
+/**
+ * Compares the operands of a comparison, and returns the condition that
+ * holds if it is true. Integers (and booleans) compare as such, and any
+ * other number as a double, ordered so that a NaN makes it false.
+ */
+static X86Condition _compare(X86Function * x86Function, const unsigned int value) {
+	const IrInstruction * instruction = &x86Function->function->instructions[value];
+	const unsigned int left = instruction->operands[0];
+	const unsigned int right = instruction->operands[1];
+	char source[OPERAND_SIZE];
+	if (x86Function->classes[left] == GENERAL_CLASS && x86Function->classes[right] == GENERAL_CLASS) {
+		char target[OPERAND_SIZE];
+		_load(x86Function, left, GENERAL_CLASS, "%rax", target);
+		if (!_source(x86Function, right, GENERAL_CLASS, source)) {
+			_read(x86Function, right, GENERAL_CLASS, "%rcx");
+			strcpy(source, "%rcx");
+		}
+		_output("\tcmpq %s, %s\n", source, target);
+		switch (instruction->opcode) {
+			case GREATER_IR: return (X86Condition) {"g", "le", NO_PARITY};
+			case LESS_IR: return (X86Condition) {"l", "ge", NO_PARITY};
+			case GREATER_EQUAL_IR: return (X86Condition) {"ge", "l", NO_PARITY};
+			case LESS_EQUAL_IR: return (X86Condition) {"le", "g", NO_PARITY};
+			case EQUAL_IR:
+			case STRICT_EQUAL_IR: return (X86Condition) {"e", "ne", NO_PARITY};
+			default: return (X86Condition) {"ne", "e", NO_PARITY};
+		}
+	}
+	// "a < b" is "b > a", so only "above" (false if unordered) is tested.
+	const boolean swapped = instruction->opcode == LESS_IR || instruction->opcode == LESS_EQUAL_IR;
+	char target[OPERAND_SIZE];
+	_load(x86Function, swapped ? right : left, FLOAT_CLASS, "%xmm14", target);
+	if (!_source(x86Function, swapped ? left : right, FLOAT_CLASS, source)) {
+		_read(x86Function, swapped ? left : right, FLOAT_CLASS, "%xmm15");
+		strcpy(source, "%xmm15");
+	}
+	_output("\tucomisd %s, %s\n", source, target);
+	switch (instruction->opcode) {
+		case GREATER_IR:
+		case LESS_IR: return (X86Condition) {"a", "be", NO_PARITY};
+		case GREATER_EQUAL_IR:
+		case LESS_EQUAL_IR: return (X86Condition) {"ae", "b", NO_PARITY};
+		case EQUAL_IR:
+		case STRICT_EQUAL_IR: return (X86Condition) {"e", "ne", ORDERED_PARITY};
+		default: return (X86Condition) {"ne", "e", UNORDERED_PARITY};
+	}
+}
+
+/**
+ * Lays out the blocks (in reverse postorder), numbers the instructions, and
+ * computes the liveness of every allocated value at the boundaries of the
+ * blocks, until it reaches a fixed point. Then, it turns them into intervals.
+ */
+static void _computeIntervals(X86Function * x86Function) {
+	const IrFunction * function = x86Function->function;
+	const unsigned int values = function->instructionCount;
+	unsigned int position = 0;
+	for (unsigned int k = 0; k < values; ++k) {
+		x86Function->positions[k] = IR_NONE;
+	}
+	for (unsigned int k = 0; k < x86Function->orderCount; ++k) {
+		const unsigned int b = x86Function->order[k];
+		const IrBlock * block = &function->blocks[b];
+		x86Function->blockStarts[b] = position;
+		for (unsigned int p = 0; p < block->phiCount; ++p) {
+			x86Function->positions[block->phis[p]] = position;
+		}
+		position += 2;
+		for (unsigned int i = 0; i < block->instructionCount; ++i) {
+			const unsigned int value = block->instructions[i];
+			// Parameters are all written by the prologue.
+			x86Function->positions[value] = function->instructions[value].opcode == PARAMETER_IR ? 0 : position;
+			if (function->instructions[value].opcode == CALL_IR) {
+				x86Function->calls[x86Function->callCount++] = position;
+			}
+			position += 2;
+		}
+		x86Function->blockEnds[b] = position - 1;
+	}
+	for (unsigned int k = 0; k < values; ++k) {
+		const IrInstruction * instruction = &function->instructions[k];
+		x86Function->classes[k] = _class(x86Function->program, x86Function->index, k);
+		x86Function->allocated[k] = x86Function->positions[k] != IR_NONE && 0 < x86Function->uses[k]
+			&& x86Function->classes[k] != NO_CLASS && instruction->opcode != CONSTANT_IR && !x86Function->fused[k];
+		x86Function->starts[k] = x86Function->positions[k];
+		x86Function->ends[k] = x86Function->positions[k];
+	}
+
+	boolean * liveIn = calloc((size_t) function->blockCount * values, sizeof(boolean));
+	boolean * liveOut = calloc((size_t) function->blockCount * values, sizeof(boolean));
+	boolean * live = malloc(values * sizeof(boolean));
+	boolean changed = true;
+	while (changed) {
+		changed = false;
+		for (unsigned int k = x86Function->orderCount; 0 < k; --k) {
+			const unsigned int b = x86Function->order[k - 1];
+			const IrBlock * block = &function->blocks[b];
+			unsigned int successors[2];
+			const unsigned int successorCount = getIrSuccessors(function, b, successors);
+			memset(live, 0, values * sizeof(boolean));
+			for (unsigned int s = 0; s < successorCount; ++s) {
+				const IrBlock * successor = &function->blocks[successors[s]];
+				for (unsigned int v = 0; v < values; ++v) {
+					live[v] |= liveIn[successors[s] * values + v];
+				}
+				for (unsigned int p = 0; p < successor->phiCount; ++p) {
+					const IrInstruction * phi = &function->instructions[successor->phis[p]];
+					for (unsigned int o = 0; x86Function->allocated[successor->phis[p]] && o < successor->predecessorCount; ++o) {
+						if (successor->predecessors[o] == b && o < phi->operandCount && x86Function->allocated[phi->operands[o]]) {
+							live[phi->operands[o]] = true;
+						}
+					}
+				}
+			}
+			memcpy(&liveOut[b * values], live, values * sizeof(boolean));
+			for (unsigned int i = block->instructionCount; 0 < i; --i) {
+				const IrInstruction * instruction = &function->instructions[block->instructions[i - 1]];
+				live[block->instructions[i - 1]] = false;
+				for (unsigned int o = 0; o < instruction->operandCount; ++o) {
+					if (x86Function->allocated[instruction->operands[o]]) {
+						live[instruction->operands[o]] = true;
+					}
+				}
+			}
+			for (unsigned int p = 0; p < block->phiCount; ++p) {
+				live[block->phis[p]] = false;
+			}
+			if (memcmp(&liveIn[b * values], live, values * sizeof(boolean)) != 0) {
+				memcpy(&liveIn[b * values], live, values * sizeof(boolean));
+				changed = true;
+			}
+		}
+	}
+
+	#define EXTEND(value, position) do { \
+		if ((position) < x86Function->starts[value]) x86Function->starts[value] = (position); \
+		if (x86Function->ends[value] < (position)) x86Function->ends[value] = (position); \
+	} while (0)
+	for (unsigned int k = 0; k < x86Function->orderCount; ++k) {
+		const unsigned int b = x86Function->order[k];
+		const IrBlock * block = &function->blocks[b];
+		for (unsigned int v = 0; v < values; ++v) {
+			if (liveIn[b * values + v]) {
+				EXTEND(v, x86Function->blockStarts[b]);
+			}
+			if (liveOut[b * values + v]) {
+				EXTEND(v, x86Function->blockEnds[b]);
+			}
+		}
+		for (unsigned int i = 0; i < block->instructionCount; ++i) {
+			const unsigned int value = block->instructions[i];
+			const IrInstruction * instruction = &function->instructions[value];
+			for (unsigned int o = 0; o < instruction->operandCount; ++o) {
+				if (x86Function->allocated[instruction->operands[o]]) {
+					EXTEND(instruction->operands[o], x86Function->positions[value]);
+				}
+			}
+		}
+		// A phi is written at the end of every predecessor.
+		for (unsigned int p = 0; p < block->phiCount; ++p) {
+			for (unsigned int o = 0; x86Function->allocated[block->phis[p]] && o < block->predecessorCount; ++o) {
+				if (x86Function->blockEnds[block->predecessors[o]] != IR_NONE) {
+					EXTEND(block->phis[p], x86Function->blockEnds[block->predecessors[o]]);
+				}
+			}
+		}
+	}
+	#undef EXTEND
+	free(live);
+	free(liveOut);
+	free(liveIn);
+}
+
+/**
+ * Moves an operand of a class into a register of a class, converting
+ * between integers and doubles if they differ.
+ */
+static void _convert(const char * source, const RegisterClass sourceClass, const RegisterClass class, const char * target) {
+	if (sourceClass != class) {
+		_output(class == FLOAT_CLASS ? "\tcvtsi2sdq %s, %s\n" : "\tcvttsd2siq %s, %s\n", source, target);
+	}
+	else if (strcmp(source, target) != 0) {
+		_output(class == GENERAL_CLASS ? "\tmovq %s, %s\n" : (source[0] == '%' ? "\tmovapd %s, %s\n" : "\tmovsd %s, %s\n"), source, target);
+	}
+}
+
+static boolean _crossesCall(const X86Function * x86Function, const unsigned int value) {
+	for (unsigned int k = 0; k < x86Function->callCount; ++k) {
+		if (x86Function->starts[value] < x86Function->calls[k] && x86Function->calls[k] < x86Function->ends[value]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Decodes the lexeme of a string (with its quotes) into its bytes. Returns
+ * false for templates with interpolations, and for unknown escapes.
+ */
+static boolean _decodeString(const char * lexeme, char * bytes, size_t * length) {
+	const size_t size = strlen(lexeme);
+	*length = 0;
+	for (size_t k = 1; k + 1 < size; ++k) {
+		if (lexeme[0] == '`' && lexeme[k] == '$' && lexeme[k + 1] == '{') {
+			return false;
+		}
+		if (lexeme[k] != '\\') {
+			bytes[(*length)++] = lexeme[k];
+			continue;
+		}
+		switch (lexeme[++k]) {
+			case 'n': bytes[(*length)++] = '\n'; break;
+			case 't': bytes[(*length)++] = '\t'; break;
+			case 'r': bytes[(*length)++] = '\r'; break;
+			case '0': bytes[(*length)++] = '\0'; break;
+			case '\\':
+			case '\'':
+			case '"':
+			case '`': bytes[(*length)++] = lexeme[k]; break;
+			default: return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Jumps to the false target unless the condition holds, and then to the
+ * true target, unless any of them is the next block. A comparison fused
+ * into the branch left its condition in the flags.
+ */
+static void _emitBranch(X86Function * x86Function, const unsigned int block, const unsigned int value, const unsigned int next) {
+	const IrInstruction * branch = &x86Function->function->instructions[value];
+	const unsigned int operand = branch->operands[0];
+	const IrInstruction * condition = &x86Function->function->instructions[operand];
+	char trueLabel[OPERAND_SIZE];
+	char falseLabel[OPERAND_SIZE];
+	const boolean trueFallsThrough = branch->targets[0] == next && !_hasMoves(x86Function, next);
+	const boolean falseFallsThrough = branch->targets[1] == next && !_hasMoves(x86Function, next);
+	if (condition->opcode == CONSTANT_IR) {
+		if (!(condition->boolean ? trueFallsThrough : falseFallsThrough)) {
+			_targetLabel(x86Function, block, branch->targets[condition->boolean ? 0 : 1], trueLabel);
+			_output("\tjmp %s\n", trueLabel);
+		}
+		return;
+	}
+	_targetLabel(x86Function, block, branch->targets[0], trueLabel);
+	_targetLabel(x86Function, block, branch->targets[1], falseLabel);
+	X86Condition flags = x86Function->pending;
+	if (!x86Function->fused[operand]) {
+		char location[OPERAND_SIZE];
+		_location(x86Function, operand, location);
+		if (location[0] == '%') {
+			_output("\ttestq %s, %s\n", location, location);
+		}
+		else {
+			_output("\tcmpq $0, %s\n", location);
+		}
+		flags = (X86Condition) {"ne", "e", NO_PARITY};
+	}
+	if (falseFallsThrough) {
+		_emitJump(x86Function, flags, true, trueLabel);
+		return;
+	}
+	_emitJump(x86Function, flags, false, falseLabel);
+	if (!trueFallsThrough) {
+		_output("\tjmp %s\n", trueLabel);
+	}
+}
+
+/**
+ * Passes the arguments in the registers of the System V ABI (numbers as
+ * doubles), and writes the result (from rax, or xmm0 for numbers).
+ */
+static void _emitCall(X86Function * x86Function, const unsigned int value) {
+	const IrInstruction * instruction = &x86Function->function->instructions[value];
+	if (instruction->callee == IR_NONE) {
+		const unsigned int argument = instruction->operands[0];
+		switch (x86Function->types[argument]) {
+			case BOOLEAN_VT:
+				_read(x86Function, argument, GENERAL_CLASS, "%rdi");
+				_output("\tcall __print_boolean\n");
+				break;
+			case STRING_VT:
+				_read(x86Function, argument, GENERAL_CLASS, "%rdi");
+				_output("\tcall __print_string\n");
+				break;
+			default:
+				_read(x86Function, argument, FLOAT_CLASS, "%xmm0");
+				_output("\tcall __print_number\n");
+				break;
+		}
+		return;
+	}
+	const X86Signature * signature = &x86Function->program->signatures[instruction->callee];
+	unsigned int generalArguments = 0;
+	unsigned int floatArguments = 0;
+	for (unsigned int k = 0; k < signature->parameterCount; ++k) {
+		if (signature->parameterTypes[k] == NUMBER_VT) {
+			_read(x86Function, instruction->operands[k], FLOAT_CLASS, _floatArguments[floatArguments++]);
+		}
+		else if (signature->parameterTypes[k] != ANY_VT) {
+			_read(x86Function, instruction->operands[k], GENERAL_CLASS, _generalArguments[generalArguments++]);
+		}
+	}
+	_output("\tcall F%u\n", instruction->callee);
+	if (signature->returnType == NUMBER_VT) {
+		_write(x86Function, value, "%xmm0", FLOAT_CLASS);
+	}
+	else {
+		_write(x86Function, value, "%rax", GENERAL_CLASS);
+	}
+}
+
+/**
+ * Writes the constants (doubles, and strings as their length followed by
+ * their bytes) and the globals, after every function.
+ */
+static void _emitData(const X86Program * program) {
+	_output("\t.section .rodata\n");
+	_output("\t.p2align 3\n");
+	for (unsigned int k = 0; k < program->floatCount; ++k) {
+		unsigned long long bits;
+		memcpy(&bits, &program->floats[k], sizeof(bits));
+		_output(".LC%u:\t.quad 0x%016llx\n", k, bits);
+	}
+	for (unsigned int k = 0; k < program->stringCount; ++k) {
+		char * bytes = malloc(strlen(program->strings[k]) + 1);
+		size_t length = 0;
+		_decodeString(program->strings[k], bytes, &length);
+		_output(".LS%u:\t.quad %zu\n", k, length);
+		_output("\t.ascii \"");
+		for (size_t b = 0; b < length; ++b) {
+			const unsigned char byte = bytes[b];
+			_output(byte < ' ' || 126 < byte || byte == '"' || byte == '\\' ? "\\%03o" : "%c", byte);
+		}
+		_output("\"\n");
+		_output("\t.p2align 3\n");
+		free(bytes);
+	}
+	_output("\t.bss\n");
+	_output("\t.p2align 3\n");
+	for (unsigned int k = 0; k < program->globalCount; ++k) {
+		if (program->globals[k].type != FUNCTION_VT) {
+			_output("G%u:\t.zero 8\t# %s\n", k, program->globals[k].name);
+		}
+	}
+}
+
+static void _emitEpilogue(const X86Function * x86Function) {
+	if (x86Function->savedCount == 0) {
+		_output("\tleave\n");
+	}
+	else {
+		_output("\tleaq -%u(%%rbp), %%rsp\n", 8 * x86Function->savedCount);
+		for (unsigned int r = CALLEE_SAVED_REGISTERS; 0 < r; --r) {
+			if (x86Function->saved[r - 1]) {
+				_output("\tpopq %s\n", _generalRegisters[r - 1]);
+			}
+		}
+		_output("\tpopq %%rbp\n");
+	}
+	_output("\tret\n");
+}
+
+/**
+ * Allocates the registers of a function, and writes it: its prologue (that
+ * saves the registers it takes from the callee, reserves its frame, and moves
+ * the parameters where they live), its blocks (in reverse postorder, so most
+ * jumps fall through), and the copies into phis of the edges that need them.
+ */
+static void _emitFunction(X86Program * program, const unsigned int function) {
+	const IrFunction * irFunction = &program->module->functions[function];
+	const unsigned int values = irFunction->instructionCount;
+	X86Function x86Function = {
+		.program = program,
+		.function = irFunction,
+		.index = function,
+		.uses = program->uses[function],
+		.types = program->types[function],
+		.classes = malloc(values * sizeof(RegisterClass)),
+		.allocated = malloc(values * sizeof(boolean)),
+		.fused = calloc(values, sizeof(boolean)),
+		.positions = malloc(values * sizeof(unsigned int)),
+		.starts = malloc(values * sizeof(unsigned int)),
+		.ends = malloc(values * sizeof(unsigned int)),
+		.registers = malloc(values * sizeof(int)),
+		.slots = malloc(values * sizeof(int)),
+		.order = malloc(irFunction->blockCount * sizeof(unsigned int)),
+		.blockStarts = malloc(irFunction->blockCount * sizeof(unsigned int)),
+		.blockEnds = malloc(irFunction->blockCount * sizeof(unsigned int)),
+		.calls = malloc(values * sizeof(unsigned int))
+	};
+	x86Function.orderCount = orderIrBlocks(irFunction, x86Function.order);
+	for (unsigned int b = 0; b < irFunction->blockCount; ++b) {
+		x86Function.blockEnds[b] = IR_NONE;
+	}
+	// A comparison used only by the branch that follows it stays in the flags.
+	for (unsigned int b = 0; b < irFunction->blockCount; ++b) {
+		const IrBlock * block = &irFunction->blocks[b];
+		if (block->instructionCount < 2) {
+			continue;
+		}
+		const IrInstruction * branch = &irFunction->instructions[block->instructions[block->instructionCount - 1]];
+		const unsigned int condition = block->instructions[block->instructionCount - 2];
+		const IrOpcode opcode = irFunction->instructions[condition].opcode;
+		if (branch->opcode == BRANCH_IR && branch->operands[0] == condition && x86Function.uses[condition] == 1
+			&& GREATER_IR <= opcode && opcode <= STRICT_NEQUAL_IR) {
+			x86Function.fused[condition] = true;
+		}
+	}
+	// A global read only by the next instruction is read there, from memory.
+	for (unsigned int b = 0; b < irFunction->blockCount; ++b) {
+		const IrBlock * block = &irFunction->blocks[b];
+		for (unsigned int i = 0; i + 1 < block->instructionCount; ++i) {
+			const unsigned int load = block->instructions[i];
+			const IrInstruction * user = &irFunction->instructions[block->instructions[i + 1]];
+			if (irFunction->instructions[load].opcode != LOAD_IR || x86Function.uses[load] != 1 || user->opcode == BRANCH_IR
+				|| _class(program, function, load) == NO_CLASS) {
+				continue;
+			}
+			for (unsigned int o = 0; o < user->operandCount; ++o) {
+				x86Function.fused[load] |= user->operands[o] == load;
+			}
+		}
+	}
+	_computeIntervals(&x86Function);
+	_allocateRegisters(&x86Function);
+	for (unsigned int b = 0; b < irFunction->blockCount; ++b) {
+		const IrBlock * block = &irFunction->blocks[b];
+		unsigned int phis = 0;
+		for (unsigned int p = 0; p < block->phiCount; ++p) {
+			phis += x86Function.allocated[block->phis[p]];
+		}
+		if (x86Function.swapCount < phis) {
+			x86Function.swapCount = phis;
+		}
+	}
+
+	// The frame keeps the stack aligned to 16 bytes at every call.
+	unsigned int frameSize = 8 * (x86Function.slotCount + x86Function.swapCount);
+	if ((8 * x86Function.savedCount + frameSize) % 16 != 0) {
+		frameSize += 8;
+	}
+	_output("\n# %s\n", irFunction->name);
+	_output("F%u:\n", function);
+	_output("\tpushq %%rbp\n");
+	_output("\tmovq %%rsp, %%rbp\n");
+	for (unsigned int r = 0; r < CALLEE_SAVED_REGISTERS; ++r) {
+		if (x86Function.saved[r]) {
+			_output("\tpushq %s\n", _generalRegisters[r]);
+		}
+	}
+	if (0 < frameSize) {
+		_output("\tsubq $%u, %%rsp\n", frameSize);
+	}
+	const X86Signature * signature = &program->signatures[function];
+	unsigned int generalArguments = 0;
+	unsigned int floatArguments = 0;
+	for (unsigned int k = 0; k < signature->parameterCount; ++k) {
+		if (signature->parameterTypes[k] == ANY_VT) {
+			continue;
+		}
+		const boolean isNumber = signature->parameterTypes[k] == NUMBER_VT;
+		const char * argument = isNumber ? _floatArguments[floatArguments++] : _generalArguments[generalArguments++];
+		for (unsigned int v = 0; v < values; ++v) {
+			const IrInstruction * instruction = &irFunction->instructions[v];
+			if (instruction->opcode == PARAMETER_IR && instruction->index == k && x86Function.allocated[v]) {
+				_write(&x86Function, v, argument, isNumber ? FLOAT_CLASS : GENERAL_CLASS);
+			}
+		}
+	}
+	for (unsigned int k = 0; k < x86Function.orderCount; ++k) {
+		const unsigned int b = x86Function.order[k];
+		const unsigned int next = k + 1 < x86Function.orderCount ? x86Function.order[k + 1] : IR_NONE;
+		const IrBlock * block = &irFunction->blocks[b];
+		_output(".LF%uB%u:\n", function, b);
+		for (unsigned int i = 0; i < block->instructionCount; ++i) {
+			_emitInstruction(&x86Function, b, block->instructions[i], next);
+		}
+	}
+	for (unsigned int k = 0; k < x86Function.edgeCount; ++k) {
+		_output(".LF%uE%u:\n", function, k);
+		_emitMoves(&x86Function, x86Function.edges[k].from, x86Function.edges[k].to);
+		_output("\tjmp .LF%uB%u\n", function, x86Function.edges[k].to);
+	}
+	logDebugging(_logger, "Function \"%s\": %u slots, %u registers saved.", irFunction->name, x86Function.slotCount, x86Function.savedCount);
+	free(x86Function.edges);
+	free(x86Function.calls);
+	free(x86Function.blockEnds);
+	free(x86Function.blockStarts);
+	free(x86Function.order);
+	free(x86Function.slots);
+	free(x86Function.registers);
+	free(x86Function.ends);
+	free(x86Function.starts);
+	free(x86Function.positions);
+	free(x86Function.fused);
+	free(x86Function.allocated);
+	free(x86Function.classes);
+}
+
+static void _emitInstruction(X86Function * x86Function, const unsigned int block, const unsigned int value, const unsigned int next) {
+	const IrInstruction * instruction = &x86Function->function->instructions[value];
+	char source[OPERAND_SIZE];
+	char target[OPERAND_SIZE];
+	switch (instruction->opcode) {
+		case LOAD_IR:
+			if (x86Function->allocated[value]) {
+				const unsigned int global = _findGlobal(x86Function->program, instruction->name);
+				sprintf(source, "G%u(%%rip)", global);
+				_write(x86Function, value, source, x86Function->program->globals[global].type == NUMBER_VT ? FLOAT_CLASS : GENERAL_CLASS);
+			}
+			break;
+		case STORE_IR: {
+			const unsigned int operand = instruction->operands[0];
+			if (x86Function->function->instructions[operand].opcode == CLOSURE_IR) {
+				break;
+			}
+			const RegisterClass class = x86Function->types[operand] == NUMBER_VT ? FLOAT_CLASS : GENERAL_CLASS;
+			if (_immediate(x86Function, operand, class, source)) {
+				_output("\tmovq %s, G%u(%%rip)\n", source, _findGlobal(x86Function->program, instruction->name));
+				break;
+			}
+			if (!_source(x86Function, operand, class, source) || source[0] != '%') {
+				_read(x86Function, operand, class, _scratch(class));
+				strcpy(source, _scratch(class));
+			}
+			_output(class == FLOAT_CLASS ? "\tmovsd %s, G%u(%%rip)\n" : "\tmovq %s, G%u(%%rip)\n", source, _findGlobal(x86Function->program, instruction->name));
+			break;
+		}
+		case ADD_IR:
+		case SUB_IR:
+		case MUL_IR:
+		case DIV_IR: {
+			if (!x86Function->allocated[value]) {
+				break;
+			}
+			const unsigned int right = instruction->operands[1];
+			if (x86Function->classes[value] == GENERAL_CLASS && instruction->opcode != DIV_IR) {
+				static const char * const mnemonics[] = {"addq", "subq", "imulq"};
+				_result(x86Function, value, target);
+				_read(x86Function, instruction->operands[0], GENERAL_CLASS, target);
+				if (!_source(x86Function, right, GENERAL_CLASS, source)) {
+					_read(x86Function, right, GENERAL_CLASS, "%rcx");
+					strcpy(source, "%rcx");
+				}
+				_output("\t%s %s, %s\n", mnemonics[instruction->opcode - ADD_IR], source, target);
+				_write(x86Function, value, target, GENERAL_CLASS);
+			}
+			else {
+				static const char * const mnemonics[] = {"addsd", "subsd", "mulsd", "divsd"};
+				_result(x86Function, value, target);
+				if (x86Function->classes[value] != FLOAT_CLASS) {
+					strcpy(target, "%xmm14");
+				}
+				_read(x86Function, instruction->operands[0], FLOAT_CLASS, target);
+				if (!_source(x86Function, right, FLOAT_CLASS, source)) {
+					_read(x86Function, right, FLOAT_CLASS, "%xmm15");
+					strcpy(source, "%xmm15");
+				}
+				_output("\t%s %s, %s\n", mnemonics[instruction->opcode - ADD_IR], source, target);
+				_write(x86Function, value, target, FLOAT_CLASS);
+			}
+			break;
+		}
+		case GREATER_IR:
+		case LESS_IR:
+		case GREATER_EQUAL_IR:
+		case LESS_EQUAL_IR:
+		case EQUAL_IR:
+		case NEQUAL_IR:
+		case STRICT_EQUAL_IR:
+		case STRICT_NEQUAL_IR: {
+			if (x86Function->fused[value]) {
+				x86Function->pending = _compare(x86Function, value);
+				break;
+			}
+			if (!x86Function->allocated[value]) {
+				break;
+			}
+			const X86Condition condition = _compare(x86Function, value);
+			switch (condition.parity) {
+				case NO_PARITY:
+					_output("\tset%s %%al\n", condition.suffix);
+					break;
+				case ORDERED_PARITY:
+					_output("\tsete %%al\n");
+					_output("\tsetnp %%cl\n");
+					_output("\tandb %%cl, %%al\n");
+					break;
+				case UNORDERED_PARITY:
+					_output("\tsetne %%al\n");
+					_output("\tsetp %%cl\n");
+					_output("\torb %%cl, %%al\n");
+					break;
+			}
+			_output("\tmovzbl %%al, %%eax\n");
+			_write(x86Function, value, "%rax", GENERAL_CLASS);
+			break;
+		}
+		case AND_IR:
+		case OR_IR:
+			if (!x86Function->allocated[value]) {
+				break;
+			}
+			_result(x86Function, value, target);
+			_read(x86Function, instruction->operands[0], GENERAL_CLASS, target);
+			if (!_source(x86Function, instruction->operands[1], GENERAL_CLASS, source)) {
+				_read(x86Function, instruction->operands[1], GENERAL_CLASS, "%rcx");
+				strcpy(source, "%rcx");
+			}
+			_output(instruction->opcode == AND_IR ? "\tandq %s, %s\n" : "\torq %s, %s\n", source, target);
+			_write(x86Function, value, target, GENERAL_CLASS);
+			break;
+		case NOT_IR:
+			if (x86Function->allocated[value]) {
+				_result(x86Function, value, target);
+				_read(x86Function, instruction->operands[0], GENERAL_CLASS, target);
+				_output("\txorq $1, %s\n", target);
+				_write(x86Function, value, target, GENERAL_CLASS);
+			}
+			break;
+		case CALL_IR:
+			_emitCall(x86Function, value);
+			break;
+		case JUMP_IR:
+			_emitMoves(x86Function, block, instruction->targets[0]);
+			if (instruction->targets[0] != next) {
+				_output("\tjmp .LF%uB%u\n", x86Function->index, instruction->targets[0]);
+			}
+			break;
+		case BRANCH_IR:
+			_emitBranch(x86Function, block, value, next);
+			break;
+		case RETURN_IR:
+			if (x86Function->program->signatures[x86Function->index].returnType == NUMBER_VT) {
+				_read(x86Function, instruction->operands[0], FLOAT_CLASS, "%xmm0");
+			}
+			else if (x86Function->program->signatures[x86Function->index].returnType != UNDEFINED_VT) {
+				_read(x86Function, instruction->operands[0], GENERAL_CLASS, "%rax");
+			}
+			_emitEpilogue(x86Function);
+			break;
+		default:
+			// Constants are materialized where they are used, and parameters by the prologue.
+			break;
+	}
+}
+
+/**
+ * Jumps to a label if the condition is (or is not) true. The conditions of
+ * doubles that depend on the parity take two jumps.
+ */
+static void _emitJump(X86Function * x86Function, const X86Condition condition, const boolean when, const char * label) {
+	if (condition.parity == NO_PARITY) {
+		_output("\tj%s %s\n", when ? condition.suffix : condition.inverse, label);
+	}
+	else if ((condition.parity == ORDERED_PARITY) == when) {
+		// Only "equal" and ordered jumps, so an unordered result skips it.
+		const unsigned int skip = x86Function->program->labelCount++;
+		_output("\tjp .LX%u\n", skip);
+		_output("\tje %s\n", label);
+		_output(".LX%u:\n", skip);
+	}
+	else {
+		_output("\tjp %s\n", label);
+		_output("\tjne %s\n", label);
+	}
+}
+
+/**
+ * Copies the operands of the phis of a block that come from a predecessor
+ * into the phis, all at once: a copy runs once no other copy reads the
+ * location it writes, and a cycle of copies is broken by saving one of
+ * those locations into a swap slot.
+ */
+static void _emitMoves(X86Function * x86Function, const unsigned int from, const unsigned int to) {
+	const IrFunction * function = x86Function->function;
+	const IrBlock * block = &function->blocks[to];
+	X86Move * moves = malloc((block->phiCount + 1) * sizeof(X86Move));
+	unsigned int moveCount = 0;
+	for (unsigned int p = 0; p < block->phiCount; ++p) {
+		const unsigned int phi = block->phis[p];
+		for (unsigned int o = 0; x86Function->allocated[phi] && o < block->predecessorCount; ++o) {
+			if (block->predecessors[o] == from) {
+				const unsigned int source = function->instructions[phi].operands[o];
+				if (!_sameLocation(x86Function, source, phi)) {
+					moves[moveCount++] = (X86Move) {.source = source, .destination = phi, .swap = -1};
+				}
+				break;
+			}
+		}
+	}
+	unsigned int swapCount = 0;
+	while (0 < moveCount) {
+		unsigned int chosen = 0;
+		boolean ready = false;
+		for (unsigned int m = 0; m < moveCount && !ready; ++m) {
+			ready = true;
+			for (unsigned int n = 0; n < moveCount && ready; ++n) {
+				ready = n == m || 0 <= moves[n].swap || !_sameLocation(x86Function, moves[n].source, moves[m].destination);
+			}
+			chosen = m;
+		}
+		if (!ready) {
+			chosen = 0;
+			char location[OPERAND_SIZE];
+			char swap[OPERAND_SIZE];
+			const unsigned int destination = moves[chosen].destination;
+			_location(x86Function, destination, location);
+			_slotLocation(x86Function, x86Function->slotCount + swapCount, swap);
+			if (location[0] != '%') {
+				_output("\tmovq %s, %%rax\n", location);
+				_output("\tmovq %%rax, %s\n", swap);
+			}
+			else {
+				_output(x86Function->classes[destination] == GENERAL_CLASS ? "\tmovq %s, %s\n" : "\tmovsd %s, %s\n", location, swap);
+			}
+			for (unsigned int n = 0; n < moveCount; ++n) {
+				if (moves[n].swap < 0 && _sameLocation(x86Function, moves[n].source, destination)) {
+					moves[n].swap = swapCount;
+				}
+			}
+			++swapCount;
+		}
+		const X86Move move = moves[chosen];
+		const RegisterClass class = x86Function->classes[move.destination];
+		char source[OPERAND_SIZE];
+		if (0 <= move.swap) {
+			_slotLocation(x86Function, x86Function->slotCount + move.swap, source);
+			_write(x86Function, move.destination, source, x86Function->classes[move.source]);
+		}
+		else if (_source(x86Function, move.source, class, source) && source[0] == '%') {
+			_write(x86Function, move.destination, source, class);
+		}
+		else if (0 <= x86Function->registers[move.destination]) {
+			// A constant (or a value of the other class) goes straight into the register of the phi.
+			_location(x86Function, move.destination, source);
+			_read(x86Function, move.source, class, source);
+		}
+		else if (_immediate(x86Function, move.source, class, source)) {
+			char location[OPERAND_SIZE];
+			_location(x86Function, move.destination, location);
+			_output("\tmovq %s, %s\n", source, location);
+		}
+		else {
+			_read(x86Function, move.source, class, _scratch(class));
+			_write(x86Function, move.destination, _scratch(class), class);
+		}
+		moves[chosen] = moves[--moveCount];
+	}
+	free(moves);
+}
+
+static unsigned int _findFloat(X86Program * program, const double number) {
+	for (unsigned int k = 0; k < program->floatCount; ++k) {
+		if (memcmp(&program->floats[k], &number, sizeof(double)) == 0) {
+			return k;
+		}
+	}
+	if (program->floatCount == program->floatCapacity) {
+		program->floatCapacity = program->floatCapacity == 0 ? 8 : 2 * program->floatCapacity;
+		program->floats = realloc(program->floats, program->floatCapacity * sizeof(double));
+	}
+	program->floats[program->floatCount] = number;
+	return program->floatCount++;
+}
+
+/**
+ * Returns the index of a global, or the number of globals if there is none.
+ */
+static unsigned int _findGlobal(const X86Program * program, const char * name) {
+	for (unsigned int k = 0; k < program->globalCount; ++k) {
+		if (strcmp(program->globals[k].name, name) == 0) {
+			return k;
+		}
+	}
+	return program->globalCount;
+}
+
+static unsigned int _findString(X86Program * program, const char * lexeme) {
+	for (unsigned int k = 0; k < program->stringCount; ++k) {
+		if (strcmp(program->strings[k], lexeme) == 0) {
+			return k;
+		}
+	}
+	if (program->stringCount == program->stringCapacity) {
+		program->stringCapacity = program->stringCapacity == 0 ? 8 : 2 * program->stringCapacity;
+		program->strings = realloc(program->strings, program->stringCapacity * sizeof(const char *));
+	}
+	program->strings[program->stringCount] = lexeme;
+	return program->stringCount++;
+}
+
+static boolean _hasMoves(const X86Function * x86Function, const unsigned int block) {
+	const IrBlock * irBlock = &x86Function->function->blocks[block];
+	for (unsigned int p = 0; p < irBlock->phiCount; ++p) {
+		if (x86Function->allocated[irBlock->phis[p]]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Writes the immediate that stores a constant into memory as a class, if its
+ * 64 bits are a sign-extended 32-bit immediate (integers and booleans, and
+ * the double 0). Returns false for any other value.
+ */
+static boolean _immediate(X86Function * x86Function, const unsigned int value, const RegisterClass class, char * immediate) {
+	const IrInstruction * instruction = &x86Function->function->instructions[value];
+	if (instruction->opcode != CONSTANT_IR || (instruction->type != NUMBER_VT && instruction->type != BOOLEAN_VT)) {
+		return false;
+	}
+	if (instruction->type == BOOLEAN_VT || class == GENERAL_CLASS) {
+		return _source(x86Function, value, GENERAL_CLASS, immediate);
+	}
+	int64_t bits;
+	memcpy(&bits, &instruction->number, sizeof(bits));
+	if (bits < INT32_MIN || INT32_MAX < bits) {
+		return false;
+	}
+	sprintf(immediate, "$%" PRId64, bits);
+	return true;
+}
+
+/**
+ * True if the type of a value is inferred from the values that reach it,
+ * instead of the IR: the ones that the IR leaves unknown, and the loads of a
+ * global, whose type in the IR comes from an annotation that nothing checks
+ * against its values (e.g., "let b: number = 'oops'").
+ */
+static boolean _inferred(const IrInstruction * instruction) {
+	if (instruction->opcode == LOAD_IR) {
+		return instruction->type != FUNCTION_VT;
+	}
+	return instruction->type == ANY_VT && (instruction->opcode == PHI_IR || instruction->opcode == CALL_IR
+		|| (ADD_IR <= instruction->opcode && instruction->opcode <= DIV_IR));
+}
+
+/**
+ * Infers the types that the IR leaves unknown (e.g., the globals that a
+ * function reads, or the results of the calls to a function): a global has
+ * the type of every value written into it, a function returns the type of
+ * every value that it returns, and the operations follow their operands. It
+ * starts from unknown types and only raises them, until nothing changes.
+ */
+static void _inferTypes(X86Program * program) {
+	const IrModule * module = program->module;
+	for (unsigned int f = 0; f < module->functionCount; ++f) {
+		const IrFunction * function = &module->functions[f];
+		program->types[f] = malloc(function->instructionCount * sizeof(IrValueType));
+		program->signatures[f].returnType = UNKNOWN_VT;
+		for (unsigned int v = 0; v < function->instructionCount; ++v) {
+			program->types[f][v] = _inferred(&function->instructions[v]) ? UNKNOWN_VT : function->instructions[v].type;
+		}
+	}
+	boolean changed = true;
+	while (changed) {
+		changed = false;
+		for (unsigned int f = 0; f < module->functionCount; ++f) {
+			const IrFunction * function = &module->functions[f];
+			X86Signature * signature = &program->signatures[f];
+			for (unsigned int v = 0; v < function->instructionCount; ++v) {
+				const IrInstruction * instruction = &function->instructions[v];
+				if (instruction->block == IR_NONE) {
+					continue;
+				}
+				if (_inferred(instruction)) {
+					const IrValueType type = _join(program->types[f][v], _transfer(program, f, v));
+					changed |= type != program->types[f][v];
+					program->types[f][v] = type;
+				}
+				if (instruction->opcode == STORE_IR) {
+					changed |= _recordGlobal(program, instruction->name, program->types[f][instruction->operands[0]]);
+				}
+				if (instruction->opcode == RETURN_IR) {
+					const IrValueType type = _join(signature->returnType, instruction->operandCount == 0 ? UNDEFINED_VT : program->types[f][instruction->operands[0]]);
+					changed |= type != signature->returnType;
+					signature->returnType = type;
+				}
+			}
+		}
+	}
+	// Whatever is still unknown could be anything (e.g., it is never written).
+	for (unsigned int f = 0; f < module->functionCount; ++f) {
+		const IrFunction * function = &module->functions[f];
+		X86Signature * signature = &program->signatures[f];
+		signature->returnType = signature->returnType == UNKNOWN_VT ? ANY_VT : signature->returnType;
+		for (unsigned int v = 0; v < function->instructionCount; ++v) {
+			program->types[f][v] = program->types[f][v] == UNKNOWN_VT ? ANY_VT : program->types[f][v];
+		}
+	}
+	for (unsigned int k = 0; k < program->globalCount; ++k) {
+		program->globals[k].type = program->globals[k].type == UNKNOWN_VT ? ANY_VT : program->globals[k].type;
+	}
+}
+
+static IrValueType _join(const IrValueType type, const IrValueType other) {
+	if (type == UNKNOWN_VT || type == other) {
+		return other;
+	}
+	return other == UNKNOWN_VT ? type : ANY_VT;
+}
+
+/**
+ * Writes a register that holds a value as a class: the one where it lives,
+ * or a scratch register that it is loaded into.
+ */
+static void _load(X86Function * x86Function, const unsigned int value, const RegisterClass class, const char * scratch, char * target) {
+	if (!_source(x86Function, value, class, target) || target[0] != '%') {
+		_read(x86Function, value, class, scratch);
+		strcpy(target, scratch);
+	}
+}
+
+/**
+ * Writes where an allocated value lives: a register, or a slot of the frame.
+ * A fused load lives in its global.
+ */
+static void _location(const X86Function * x86Function, const unsigned int value, char * location) {
+	const int r = x86Function->registers[value];
+	if (x86Function->fused[value] && x86Function->function->instructions[value].opcode == LOAD_IR) {
+		sprintf(location, "G%u(%%rip)", _findGlobal(x86Function->program, x86Function->function->instructions[value].name));
+	}
+	else if (0 <= r) {
+		strcpy(location, x86Function->classes[value] == GENERAL_CLASS ? _generalRegisters[r] : _floatRegisters[r]);
+	}
+	else {
+		_slotLocation(x86Function, x86Function->slots[value], location);
+	}
+}
+
+static void _output(const char * const format, ...) {
+	va_list arguments;
+	va_start(arguments, format);
+	vfprintf(stdout, format, arguments);
+	va_end(arguments);
+}
+
+/**
+ * Returns true if computing a value does nothing else (it calls nothing),
+ * looking a few operands deep.
+ */
+static boolean _pure(const IrFunction * function, const unsigned int value, const unsigned int depth) {
+	const IrInstruction * instruction = &function->instructions[value];
+	if (instruction->opcode == CALL_IR || 4 < depth) {
+		return false;
+	}
+	if (instruction->opcode == PHI_IR) {
+		return true;
+	}
+	for (unsigned int k = 0; k < instruction->operandCount; ++k) {
+		if (!_pure(function, instruction->operands[k], depth + 1)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Loads a value into a register of a class. Constants are materialized
+ * there (doubles from the pool, strings by address), and any other value is
+ * converted from where it lives.
+ */
+static void _read(X86Function * x86Function, const unsigned int value, const RegisterClass class, const char * target) {
+	const IrInstruction * instruction = &x86Function->function->instructions[value];
+	if (instruction->opcode != CONSTANT_IR) {
+		char location[OPERAND_SIZE];
+		_location(x86Function, value, location);
+		_convert(location, x86Function->classes[value], class, target);
+	}
+	else if (instruction->type == STRING_VT) {
+		_output("\tleaq .LS%u(%%rip), %s\n", _findString(x86Function->program, instruction->string), target);
+	}
+	else if (instruction->type == BOOLEAN_VT) {
+		_output("\tmovq $%d, %s\n", instruction->boolean ? 1 : 0, target);
+	}
+	else if (class == GENERAL_CLASS) {
+		const boolean wide = instruction->number < -2147483648.0 || 2147483648.0 <= instruction->number;
+		_output(wide ? "\tmovabsq $%.0f, %s\n" : "\tmovq $%.0f, %s\n", instruction->number, target);
+	}
+	else if (instruction->number == 0 && !signbit(instruction->number)) {
+		_output("\txorpd %s, %s\n", target, target);
+	}
+	else {
+		_output("\tmovsd .LC%u(%%rip), %s\n", _findFloat(x86Function->program, instruction->number), target);
+	}
+}
+
+/**
+ * Records the type of a value written into a global (joined with the types
+ * of its other values). Returns true if the type of the global changes.
+ */
+static boolean _recordGlobal(X86Program * program, const char * name, const IrValueType type) {
+	const unsigned int global = _findGlobal(program, name);
+	if (global < program->globalCount) {
+		const IrValueType joined = _join(program->globals[global].type, type);
+		const boolean changed = joined != program->globals[global].type;
+		program->globals[global].type = joined;
+		return changed;
+	}
+	if (program->globalCount == program->globalCapacity) {
+		program->globalCapacity = program->globalCapacity == 0 ? 8 : 2 * program->globalCapacity;
+		program->globals = realloc(program->globals, program->globalCapacity * sizeof(X86Global));
+	}
+	program->globals[program->globalCount++] = (X86Global) {.name = name, .type = type};
+	return true;
+}
+
+/**
+ * Writes the register where an operation computes a value: the one where
+ * the value lives, or a scratch register (if it lives in the frame). No
+ * operand lives there, because their intervals overlap.
+ */
+static void _result(const X86Function * x86Function, const unsigned int value, char * target) {
+	if (0 <= x86Function->registers[value]) {
+		_location(x86Function, value, target);
+	}
+	else {
+		strcpy(target, _scratch(x86Function->classes[value]));
+	}
+}
+
+static boolean _sameLocation(const X86Function * x86Function, const unsigned int value, const unsigned int other) {
+	if (!x86Function->allocated[value] || !x86Function->allocated[other]) {
+		return false;
+	}
+	if (0 <= x86Function->registers[value]) {
+		return x86Function->registers[value] == x86Function->registers[other] && x86Function->classes[value] == x86Function->classes[other];
+	}
+	return x86Function->slots[value] == x86Function->slots[other];
+}
+
+static const char * _scratch(const RegisterClass class) {
+	return class == GENERAL_CLASS ? "%rax" : "%xmm14";
+}
+
+/**
+ * Writes the address of a slot of the frame, below the saved registers.
+ */
+static void _slotLocation(const X86Function * x86Function, const unsigned int slot, char * location) {
+	sprintf(location, "-%u(%%rbp)", 8 * (x86Function->savedCount + 1 + slot));
+}
+
+/**
+ * Writes an operand that reads a value as a class as it is (a register, a
+ * slot, an immediate or a double of the pool). Returns false if the value
+ * must be converted or materialized first.
+ */
+static boolean _source(X86Function * x86Function, const unsigned int value, const RegisterClass class, char * source) {
+	const IrInstruction * instruction = &x86Function->function->instructions[value];
+	if (instruction->opcode != CONSTANT_IR) {
+		if (x86Function->classes[value] != class) {
+			return false;
+		}
+		_location(x86Function, value, source);
+	}
+	else if (instruction->type == BOOLEAN_VT) {
+		sprintf(source, "$%d", instruction->boolean ? 1 : 0);
+	}
+	else if (instruction->type != NUMBER_VT) {
+		return false;
+	}
+	else if (class == GENERAL_CLASS) {
+		// An instruction only takes a sign-extended 32-bit immediate.
+		if (instruction->number < -2147483648.0 || 2147483648.0 <= instruction->number) {
+			return false;
+		}
+		sprintf(source, "$%.0f", instruction->number);
+	}
+	else {
+		sprintf(source, ".LC%u(%%rip)", _findFloat(x86Function->program, instruction->number));
+	}
+	return true;
+}
+
+/**
+ * Writes the label that a branch jumps to: the block itself, or a stub that
+ * first copies into its phis.
+ */
+static void _targetLabel(X86Function * x86Function, const unsigned int from, const unsigned int to, char * label) {
+	if (!_hasMoves(x86Function, to)) {
+		sprintf(label, ".LF%uB%u", x86Function->index, to);
+		return;
+	}
+	if (x86Function->edgeCount == x86Function->edgeCapacity) {
+		x86Function->edgeCapacity = x86Function->edgeCapacity == 0 ? 4 : 2 * x86Function->edgeCapacity;
+		x86Function->edges = realloc(x86Function->edges, x86Function->edgeCapacity * sizeof(X86Edge));
+	}
+	sprintf(label, ".LF%uE%u", x86Function->index, x86Function->edgeCount);
+	x86Function->edges[x86Function->edgeCount++] = (X86Edge) {.from = from, .to = to};
+}
+
+/**
+ * The type of a value that the IR leaves unknown, given the types of its
+ * operands, globals and callees inferred so far.
+ */
+static IrValueType _transfer(const X86Program * program, const unsigned int function, const unsigned int value) {
+	const IrFunction * irFunction = &program->module->functions[function];
+	const IrInstruction * instruction = &irFunction->instructions[value];
+	const IrValueType * types = program->types[function];
+	switch (instruction->opcode) {
+		case LOAD_IR: {
+			const unsigned int global = _findGlobal(program, instruction->name);
+			return global < program->globalCount ? program->globals[global].type : UNKNOWN_VT;
+		}
+		case PHI_IR: {
+			IrValueType type = UNKNOWN_VT;
+			for (unsigned int k = 0; k < instruction->operandCount && k < irFunction->blocks[instruction->block].predecessorCount; ++k) {
+				type = _join(type, types[instruction->operands[k]]);
+			}
+			return type;
+		}
+		case CALL_IR:
+			return instruction->callee == IR_NONE ? ANY_VT : program->signatures[instruction->callee].returnType;
+		case ADD_IR:
+		case SUB_IR:
+		case MUL_IR:
+		case DIV_IR: {
+			const IrValueType left = types[instruction->operands[0]];
+			const IrValueType right = types[instruction->operands[1]];
+			if (left == UNKNOWN_VT || right == UNKNOWN_VT) {
+				return UNKNOWN_VT;
+			}
+			// Only an addition can concatenate strings, any other operation is numeric.
+			return instruction->opcode != ADD_IR || (left == NUMBER_VT && right == NUMBER_VT) ? NUMBER_VT : ANY_VT;
+		}
+		default:
+			return ANY_VT;
+	}
+}
+
+static boolean _unsupported(const X86Program * program, const unsigned int function, const char * construct) {
+	if (program->target == AUTOMATIC_TARGET) {
+		logDebugging(_logger, "The x86-64 target does not support %s (in \"%s\").", construct, program->module->functions[function].name);
+	}
+	else {
+		logError(_logger, "The x86-64 target does not support %s (in \"%s\").", construct, program->module->functions[function].name);
+	}
+	return false;
+}
+
+/**
+ * Writes a value where it lives, from a register or an operand of memory of
+ * a class (converting it, if the value has the other class).
+ */
+static void _write(const X86Function * x86Function, const unsigned int value, const char * source, const RegisterClass sourceClass) {
+	if (!x86Function->allocated[value]) {
+		return;
+	}
+	const RegisterClass class = x86Function->classes[value];
+	char location[OPERAND_SIZE];
+	_location(x86Function, value, location);
+	if (location[0] == '%') {
+		_convert(source, sourceClass, class, location);
+		return;
+	}
+	if (sourceClass != class || source[0] != '%') {
+		_convert(source, sourceClass, class, _scratch(class));
+		source = _scratch(class);
+	}
+	_output(class == GENERAL_CLASS ? "\tmovq %s, %s\n" : "\tmovsd %s, %s\n", source, location);
+}
+
+/** PUBLIC FUNCTIONS */
+
+boolean generateX86(CompilerState * compilerState) {
+	logDebugging(_logger, "Generating x86-64 assembly...");
+	const IrModule * module = compilerState->intermediateRepresentation;
+	X86Program program = {
+		.module = module,
+		.target = compilerState->target,
+		.uses = calloc(module->functionCount, sizeof(unsigned int *)),
+		.types = calloc(module->functionCount, sizeof(IrValueType *)),
+		.signatures = calloc(module->functionCount, sizeof(X86Signature))
+	};
+	for (unsigned int f = 0; f < module->functionCount; ++f) {
+		const IrFunction * function = &module->functions[f];
+		X86Signature * signature = &program.signatures[f];
+		program.uses[f] = calloc(function->instructionCount, sizeof(unsigned int));
+		signature->parameterCount = function->parameterCount;
+		signature->parameterTypes = malloc((function->parameterCount + 1) * sizeof(IrValueType));
+		for (unsigned int k = 0; k < function->parameterCount; ++k) {
+			signature->parameterTypes[k] = ANY_VT;
+		}
+		for (unsigned int v = 0; v < function->instructionCount; ++v) {
+			const IrInstruction * instruction = &function->instructions[v];
+			if (instruction->block == IR_NONE) {
+				continue;
+			}
+			const unsigned int operandCount = instruction->opcode == PHI_IR ? function->blocks[instruction->block].predecessorCount : instruction->operandCount;
+			for (unsigned int o = 0; o < operandCount && o < instruction->operandCount; ++o) {
+				++program.uses[f][instruction->operands[o]];
+			}
+		}
+		for (unsigned int v = 0; v < function->instructionCount; ++v) {
+			const IrInstruction * instruction = &function->instructions[v];
+			if (instruction->block != IR_NONE && instruction->opcode == PARAMETER_IR && 0 < program.uses[f][v]) {
+				signature->parameterTypes[instruction->index] = instruction->type;
+			}
+		}
+	}
+	_inferTypes(&program);
+
+	boolean supported = true;
+	for (unsigned int f = 0; f < module->functionCount && supported; ++f) {
+		supported = _check(&program, f);
+	}
+	if (supported) {
+		_output("# Generated for x86-64 Linux: as -o program.o program.s && ld -o program program.o\n");
+		_output("\t.text\n");
+		for (unsigned int f = 0; f < module->functionCount; ++f) {
+			_emitFunction(&program, f);
+		}
+		_emitData(&program);
+		emitX86Runtime(stdout);
+		fflush(stdout);
+	}
+
+	for (unsigned int f = 0; f < module->functionCount; ++f) {
+		free(program.signatures[f].parameterTypes);
+		free(program.types[f]);
+		free(program.uses[f]);
+	}
+	free(program.signatures);
+	free(program.types);
+	free(program.uses);
+	free(program.floats);
+	free(program.strings);
+	free(program.globals);
+	logDebugging(_logger, "Generation is done.");
+	return supported;
+}
@@ -0,0 +1,37 @@
+#ifndef X86_GENERATOR_HEADER
+#define X86_GENERATOR_HEADER
+
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "../intermediate-representation/IntermediateRepresentation.h"
+#include "X86Runtime.h"
+#include <inttypes.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeX86GeneratorModule();
+
+/** Shutdown module's internal state. */
+void shutdownX86GeneratorModule();
+
+/**
+ * Generates the final output for x86-64 Linux (GNU assembly, with its own
+ * runtime) from the IR module, whose numbers must carry their inferred
+ * representations. Every function becomes a function of the System V ABI:
+ * the values live in the registers picked by a linear scan over their live
+ * intervals, or in the frame once the registers run out, and a number is an
+ * integer only where it is proven to fit in 32 bits (a double otherwise).
+ *
+ * It only supports the numeric programs: top-level functions, numbers,
+ * booleans and strings (to print them), module bindings, and calls to those
+ * functions or to "print". It returns false (and writes nothing) for any
+ * other program.
+ */
+boolean generateX86(CompilerState * compilerState);
+
+#endif
@@ -0,0 +1,495 @@
+#include "X86Runtime.h"
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The runtime, in GNU assembly. It only talks to the kernel (no C library),
+ * so a program links on its own.
+ */
+static const char * const _runtime[] = {
+	"\t.text",
+	"# Bignums (for the digits of a number) are 20 little-endian limbs of 64 bits.",
+	"# __bn_small(rdi = bignum, rsi = value): bignum = value.",
+	"__bn_small:",
+	"\tmovq %rsi, (%rdi)",
+	"\txorl %eax, %eax",
+	"\tmovl $1, %ecx",
+	"1:\tmovq %rax, (%rdi,%rcx,8)",
+	"\tincl %ecx",
+	"\tcmpl $20, %ecx",
+	"\tjb 1b",
+	"\tret",
+	"# __bn_mul(rdi = bignum, rsi = factor): bignum *= factor.",
+	"__bn_mul:",
+	"\txorl %ecx, %ecx",
+	"\txorl %r8d, %r8d",
+	"1:\tmovq (%rdi,%rcx,8), %rax",
+	"\tmulq %rsi",
+	"\taddq %r8, %rax",
+	"\tadcq $0, %rdx",
+	"\tmovq %rax, (%rdi,%rcx,8)",
+	"\tmovq %rdx, %r8",
+	"\tincl %ecx",
+	"\tcmpl $20, %ecx",
+	"\tjb 1b",
+	"\tret",
+	"# __bn_shift(rdi = bignum, rsi = count): bignum *= 2^count.",
+	"__bn_shift:",
+	"\tpushq %rbx",
+	"\tpushq %r12",
+	"\tmovq %rdi, %rbx",
+	"\tmovq %rsi, %r12",
+	"1:\tcmpq $60, %r12",
+	"\tjb 2f",
+	"\tmovq %rbx, %rdi",
+	"\tmovabsq $0x1000000000000000, %rsi",
+	"\tcall __bn_mul",
+	"\tsubq $60, %r12",
+	"\tjmp 1b",
+	"2:\tmovq %rbx, %rdi",
+	"\tmovl $1, %esi",
+	"\tmovl %r12d, %ecx",
+	"\tshlq %cl, %rsi",
+	"\tcall __bn_mul",
+	"\tpopq %r12",
+	"\tpopq %rbx",
+	"\tret",
+	"# __bn_add(rdi = bignum, rsi = augend, rdx = addend): bignum = augend + addend.",
+	"__bn_add:",
+	"\tmovq %rdx, %r9",
+	"\txorl %ecx, %ecx",
+	"\tmovl $20, %r10d",
+	"\tclc",
+	"1:\tmovq (%rsi,%rcx,8), %rax",
+	"\tadcq (%r9,%rcx,8), %rax",
+	"\tmovq %rax, (%rdi,%rcx,8)",
+	"\tincq %rcx",
+	"\tdecq %r10",
+	"\tjnz 1b",
+	"\tret",
+	"# __bn_sub(rdi = bignum, rsi = subtrahend): bignum -= subtrahend.",
+	"__bn_sub:",
+	"\txorl %ecx, %ecx",
+	"\tmovl $20, %r10d",
+	"\tclc",
+	"1:\tmovq (%rsi,%rcx,8), %rax",
+	"\tsbbq %rax, (%rdi,%rcx,8)",
+	"\tincq %rcx",
+	"\tdecq %r10",
+	"\tjnz 1b",
+	"\tret",
+	"# __bn_cmp(rdi = bignum, rsi = other): eax = -1, 0 or 1.",
+	"__bn_cmp:",
+	"\tmovl $19, %ecx",
+	"1:\tmovq (%rdi,%rcx,8), %rax",
+	"\tcmpq (%rsi,%rcx,8), %rax",
+	"\tja 2f",
+	"\tjb 3f",
+	"\tsubl $1, %ecx",
+	"\tjns 1b",
+	"\txorl %eax, %eax",
+	"\tret",
+	"2:\tmovl $1, %eax",
+	"\tret",
+	"3:\tmovl $-1, %eax",
+	"\tret",
+	"# __bn_high(): eax > 0 if r + m+ reaches s (inclusive if the mantissa is even, in ebx).",
+	"__bn_high:",
+	"\tleaq __bn_t(%rip), %rdi",
+	"\tleaq __bn_r(%rip), %rsi",
+	"\tleaq __bn_mp(%rip), %rdx",
+	"\tcall __bn_add",
+	"\tleaq __bn_t(%rip), %rdi",
+	"\tleaq __bn_s(%rip), %rsi",
+	"\tcall __bn_cmp",
+	"\taddl %ebx, %eax",
+	"\tret",
+	"# __emit(rdi = text, rsi = length): appends to the output buffer.",
+	"__emit:",
+	"\tmovq __length(%rip), %rdx",
+	"\tleaq __buffer(%rip), %rcx",
+	"1:\ttestq %rsi, %rsi",
+	"\tjz 3f",
+	"\tcmpq $4096, %rdx",
+	"\tjb 2f",
+	"\tpushq %rdi",
+	"\tpushq %rsi",
+	"\tmovq %rdx, __length(%rip)",
+	"\tcall __flush",
+	"\tpopq %rsi",
+	"\tpopq %rdi",
+	"\txorl %edx, %edx",
+	"\tleaq __buffer(%rip), %rcx",
+	"2:\tmovb (%rdi), %al",
+	"\tmovb %al, (%rcx,%rdx)",
+	"\tincq %rdx",
+	"\tincq %rdi",
+	"\tdecq %rsi",
+	"\tjmp 1b",
+	"3:\tmovq %rdx, __length(%rip)",
+	"\tret",
+	"# __flush(): writes the output buffer to the standard output.",
+	"__flush:",
+	"\tmovl $1, %eax",
+	"\tmovl $1, %edi",
+	"\tleaq __buffer(%rip), %rsi",
+	"\tmovq __length(%rip), %rdx",
+	"\ttestq %rdx, %rdx",
+	"\tjz 1f",
+	"\tsyscall",
+	"1:\tmovq $0, __length(%rip)",
+	"\tret",
+	"# The printers write their value and a new line, as \"console.log\" does.",
+	"__newline:",
+	"\tleaq __newline_text(%rip), %rdi",
+	"\tmovl $1, %esi",
+	"\tjmp __emit",
+	"# __print_string(rdi = string, as its length followed by its bytes).",
+	"__print_string:",
+	"\tmovq (%rdi), %rsi",
+	"\taddq $8, %rdi",
+	"\tcall __emit",
+	"\tjmp __newline",
+	"# __print_boolean(rdi = 0 or 1).",
+	"__print_boolean:",
+	"\tleaq __true_text(%rip), %rax",
+	"\tleaq __false_text(%rip), %rcx",
+	"\ttestq %rdi, %rdi",
+	"\tcmovzq %rcx, %rax",
+	"\tmovl $5, %esi",
+	"\tsubq %rdi, %rsi",
+	"\tmovq %rax, %rdi",
+	"\tcall __emit",
+	"\tjmp __newline",
+	"# __print_number(xmm0): the shortest digits that read back as the same double",
+	"# (Burger and Dybvig, \"Printing Floating-Point Numbers Quickly and Accurately\",",
+	"# 1996), laid out as \"Number.prototype.toString\" does.",
+	"__print_number:",
+	"\tpushq %rbx",
+	"\tpushq %r12",
+	"\tpushq %r13",
+	"\tpushq %r14",
+	"\tpushq %r15",
+	"\tmovq %xmm0, %rbx",
+	"\tleaq __text(%rip), %r12",
+	"\tmovq %rbx, %rax",
+	"\tshrq $52, %rax",
+	"\tandl $0x7ff, %eax",
+	"\tcmpl $0x7ff, %eax",
+	"\tjne .Lruntime_finite",
+	"\tmovq %rbx, %rcx",
+	"\tshlq $12, %rcx",
+	"\tjnz .Lruntime_nan",
+	"\ttestq %rbx, %rbx",
+	"\tjns 1f",
+	"\tmovb $45, (%r12)",
+	"\tincq %r12",
+	"1:\tleaq __infinity_text(%rip), %rsi",
+	"\tmovl $8, %ecx",
+	"\tjmp .Lruntime_copy",
+	".Lruntime_nan:",
+	"\tleaq __nan_text(%rip), %rsi",
+	"\tmovl $3, %ecx",
+	".Lruntime_copy:",
+	"\tmovb (%rsi), %al",
+	"\tmovb %al, (%r12)",
+	"\tincq %rsi",
+	"\tincq %r12",
+	"\tdecl %ecx",
+	"\tjnz .Lruntime_copy",
+	"\tjmp .Lruntime_write",
+	".Lruntime_finite:",
+	"\ttestq %rbx, %rbx",
+	"\tjns 1f",
+	"\tmovb $45, (%r12)",
+	"\tincq %r12",
+	"\tbtrq $63, %rbx",
+	"1:\ttestq %rbx, %rbx",
+	"\tjnz 2f",
+	"\tmovb $48, (%r12)",
+	"\tincq %r12",
+	"\tjmp .Lruntime_write",
+	"2:\tmovq %rbx, %r13",
+	"\tshrq $52, %r13",
+	"\tmovabsq $0xfffffffffffff, %r14",
+	"\tandq %rbx, %r14",
+	"\ttestq %r13, %r13",
+	"\tjz 3f",
+	"\tbtsq $52, %r14",
+	"\tleaq -1075(%r13), %r15",
+	"\tjmp 4f",
+	"3:\tmovq $-1074, %r15",
+	"\tmovl $1, %r13d",
+	"4:\txorl %ebx, %ebx",
+	"\ttestq $1, %r14",
+	"\tsete %bl",
+	"\txorl %eax, %eax",
+	"\tcmpq $1, %r13",
+	"\tjbe 5f",
+	"\tmovabsq $0x10000000000000, %rcx",
+	"\tcmpq %rcx, %r14",
+	"\tsete %al",
+	"5:\tmovl %eax, %r13d",
+	"\tleaq __bn_r(%rip), %rdi",
+	"\tmovq %r14, %rsi",
+	"\tcall __bn_small",
+	"\tleaq __bn_mm(%rip), %rdi",
+	"\tmovl $1, %esi",
+	"\tcall __bn_small",
+	"\tleaq __bn_mp(%rip), %rdi",
+	"\tmovl $1, %esi",
+	"\tcall __bn_small",
+	"\tleaq __bn_s(%rip), %rdi",
+	"\tmovl $1, %esi",
+	"\tcall __bn_small",
+	"\ttestq %r15, %r15",
+	"\tjs 6f",
+	"\tleaq __bn_r(%rip), %rdi",
+	"\tleaq 1(%r15,%r13), %rsi",
+	"\tcall __bn_shift",
+	"\tleaq __bn_s(%rip), %rdi",
+	"\tleaq 1(%r13), %rsi",
+	"\tcall __bn_shift",
+	"\tleaq __bn_mp(%rip), %rdi",
+	"\tleaq (%r15,%r13), %rsi",
+	"\tcall __bn_shift",
+	"\tleaq __bn_mm(%rip), %rdi",
+	"\tmovq %r15, %rsi",
+	"\tcall __bn_shift",
+	"\tjmp 7f",
+	"6:\tleaq __bn_r(%rip), %rdi",
+	"\tleaq 1(%r13), %rsi",
+	"\tcall __bn_shift",
+	"\tleaq __bn_s(%rip), %rdi",
+	"\tmovl $1, %esi",
+	"\tsubq %r15, %rsi",
+	"\taddq %r13, %rsi",
+	"\tcall __bn_shift",
+	"\tleaq __bn_mp(%rip), %rdi",
+	"\tmovq %r13, %rsi",
+	"\tcall __bn_shift",
+	"7:\txorl %r15d, %r15d",
+	"8:\tcall __bn_high",
+	"\ttestl %eax, %eax",
+	"\tjle 9f",
+	"\tleaq __bn_s(%rip), %rdi",
+	"\tmovl $10, %esi",
+	"\tcall __bn_mul",
+	"\tincq %r15",
+	"\tjmp 8b",
+	"9:\tleaq __bn_t(%rip), %rdi",
+	"\tleaq __bn_r(%rip), %rsi",
+	"\tleaq __bn_mp(%rip), %rdx",
+	"\tcall __bn_add",
+	"\tleaq __bn_t(%rip), %rdi",
+	"\tmovl $10, %esi",
+	"\tcall __bn_mul",
+	"\tleaq __bn_t(%rip), %rdi",
+	"\tleaq __bn_s(%rip), %rsi",
+	"\tcall __bn_cmp",
+	"\taddl %ebx, %eax",
+	"\ttestl %eax, %eax",
+	"\tjg 10f",
+	"\tcall __bn_scale",
+	"\tdecq %r15",
+	"\tjmp 9b",
+	"10:\txorl %r13d, %r13d",
+	".Lruntime_digit:",
+	"\tcall __bn_scale",
+	"\txorl %r14d, %r14d",
+	"11:\tleaq __bn_r(%rip), %rdi",
+	"\tleaq __bn_s(%rip), %rsi",
+	"\tcall __bn_cmp",
+	"\ttestl %eax, %eax",
+	"\tjs 12f",
+	"\tleaq __bn_r(%rip), %rdi",
+	"\tleaq __bn_s(%rip), %rsi",
+	"\tcall __bn_sub",
+	"\tincl %r14d",
+	"\tjmp 11b",
+	"12:\tleaq __bn_r(%rip), %rdi",
+	"\tleaq __bn_mm(%rip), %rsi",
+	"\tcall __bn_cmp",
+	"\tsubl %ebx, %eax",
+	"\tsets __low(%rip)",
+	"\tcall __bn_high",
+	"\ttestl %eax, %eax",
+	"\tsetg %al",
+	"\tmovb __low(%rip), %cl",
+	"\tmovb %al, %dl",
+	"\torb %cl, %dl",
+	"\tjnz 13f",
+	"\tleaq __digits(%rip), %rdx",
+	"\tmovb %r14b, (%rdx,%r13)",
+	"\tincq %r13",
+	"\tjmp .Lruntime_digit",
+	"13:\ttestb %al, %al",
+	"\tjz 15f",
+	"\ttestb %cl, %cl",
+	"\tjz 14f",
+	"\tleaq __bn_t(%rip), %rdi",
+	"\tleaq __bn_r(%rip), %rsi",
+	"\tleaq __bn_r(%rip), %rdx",
+	"\tcall __bn_add",
+	"\tleaq __bn_t(%rip), %rdi",
+	"\tleaq __bn_s(%rip), %rsi",
+	"\tcall __bn_cmp",
+	"\ttestl %eax, %eax",
+	"\tjs 15f",
+	"\tjnz 14f",
+	"\ttestl $1, %r14d",
+	"\tjz 15f",
+	"14:\tincl %r14d",
+	"15:\tleaq __digits(%rip), %rdx",
+	"\tmovb %r14b, (%rdx,%r13)",
+	"\tincq %r13",
+	"\tleaq __digits(%rip), %rsi",
+	"\tcmpq %r13, %r15",
+	"\tjl 20f",
+	"\tcmpq $21, %r15",
+	"\tjg 30f",
+	"\txorl %ecx, %ecx",
+	"16:\tmovb (%rsi,%rcx), %al",
+	"\taddb $48, %al",
+	"\tmovb %al, (%r12)",
+	"\tincq %r12",
+	"\tincq %rcx",
+	"\tcmpq %r13, %rcx",
+	"\tjb 16b",
+	"17:\tcmpq %r15, %rcx",
+	"\tjae .Lruntime_write",
+	"\tmovb $48, (%r12)",
+	"\tincq %r12",
+	"\tincq %rcx",
+	"\tjmp 17b",
+	"20:\ttestq %r15, %r15",
+	"\tjle 25f",
+	"\txorl %ecx, %ecx",
+	"21:\tcmpq %r15, %rcx",
+	"\tjne 22f",
+	"\tmovb $46, (%r12)",
+	"\tincq %r12",
+	"22:\tmovb (%rsi,%rcx), %al",
+	"\taddb $48, %al",
+	"\tmovb %al, (%r12)",
+	"\tincq %r12",
+	"\tincq %rcx",
+	"\tcmpq %r13, %rcx",
+	"\tjb 21b",
+	"\tjmp .Lruntime_write",
+	"25:\tcmpq $-6, %r15",
+	"\tjle 30f",
+	"\tmovb $48, (%r12)",
+	"\tmovb $46, 1(%r12)",
+	"\taddq $2, %r12",
+	"\tmovq %r15, %rcx",
+	"26:\ttestq %rcx, %rcx",
+	"\tjz 27f",
+	"\tmovb $48, (%r12)",
+	"\tincq %r12",
+	"\tincq %rcx",
+	"\tjmp 26b",
+	"27:\txorl %ecx, %ecx",
+	"28:\tmovb (%rsi,%rcx), %al",
+	"\taddb $48, %al",
+	"\tmovb %al, (%r12)",
+	"\tincq %r12",
+	"\tincq %rcx",
+	"\tcmpq %r13, %rcx",
+	"\tjb 28b",
+	"\tjmp .Lruntime_write",
+	"30:\tmovb (%rsi), %al",
+	"\taddb $48, %al",
+	"\tmovb %al, (%r12)",
+	"\tincq %r12",
+	"\tmovl $1, %ecx",
+	"\tcmpq %r13, %rcx",
+	"\tjae 32f",
+	"\tmovb $46, (%r12)",
+	"\tincq %r12",
+	"31:\tmovb (%rsi,%rcx), %al",
+	"\taddb $48, %al",
+	"\tmovb %al, (%r12)",
+	"\tincq %r12",
+	"\tincq %rcx",
+	"\tcmpq %r13, %rcx",
+	"\tjb 31b",
+	"32:\tmovb $101, (%r12)",
+	"\tmovb $43, 1(%r12)",
+	"\tdecq %r15",
+	"\tjns 33f",
+	"\tmovb $45, 1(%r12)",
+	"\tnegq %r15",
+	"33:\taddq $2, %r12",
+	"\tmovq %r15, %rax",
+	"\tmovl $10, %ecx",
+	"\txorl %r8d, %r8d",
+	"34:\txorl %edx, %edx",
+	"\tdivq %rcx",
+	"\taddb $48, %dl",
+	"\tpushq %rdx",
+	"\tincl %r8d",
+	"\ttestq %rax, %rax",
+	"\tjnz 34b",
+	"35:\tpopq %rdx",
+	"\tmovb %dl, (%r12)",
+	"\tincq %r12",
+	"\tdecl %r8d",
+	"\tjnz 35b",
+	".Lruntime_write:",
+	"\tleaq __text(%rip), %rdi",
+	"\tmovq %r12, %rsi",
+	"\tsubq %rdi, %rsi",
+	"\tcall __emit",
+	"\tpopq %r15",
+	"\tpopq %r14",
+	"\tpopq %r13",
+	"\tpopq %r12",
+	"\tpopq %rbx",
+	"\tjmp __newline",
+	"# __bn_scale(): r, m+ and m- times 10.",
+	"__bn_scale:",
+	"\tleaq __bn_r(%rip), %rdi",
+	"\tmovl $10, %esi",
+	"\tcall __bn_mul",
+	"\tleaq __bn_mp(%rip), %rdi",
+	"\tmovl $10, %esi",
+	"\tcall __bn_mul",
+	"\tleaq __bn_mm(%rip), %rdi",
+	"\tmovl $10, %esi",
+	"\tjmp __bn_mul",
+	"# The entry point runs the top-level code, flushes the output, and exits.",
+	"\t.globl _start",
+	"_start:",
+	"\tcall F0",
+	"\tcall __flush",
+	"\tmovl $60, %eax",
+	"\txorl %edi, %edi",
+	"\tsyscall",
+	"\t.section .rodata",
+	"__newline_text: .ascii \"\\n\"",
+	"__true_text: .ascii \"true\"",
+	"__false_text: .ascii \"false\"",
+	"__infinity_text: .ascii \"Infinity\"",
+	"__nan_text: .ascii \"NaN\"",
+	"\t.bss",
+	"\t.align 8",
+	"__bn_r: .zero 160",
+	"__bn_s: .zero 160",
+	"__bn_mp: .zero 160",
+	"__bn_mm: .zero 160",
+	"__bn_t: .zero 160",
+	"__length: .zero 8",
+	"__low: .zero 8",
+	"__digits: .zero 32",
+	"__text: .zero 64",
+	"__buffer: .zero 4096",
+};
+
+/** PUBLIC FUNCTIONS */
+
+void emitX86Runtime(FILE * stream) {
+	for (unsigned int k = 0; k < sizeof(_runtime) / sizeof(_runtime[0]); ++k) {
+		fprintf(stream, "%s\n", _runtime[k]);
+	}
+}
@@ -0,0 +1,15 @@
+#ifndef X86_RUNTIME_HEADER
+#define X86_RUNTIME_HEADER
+
+#include <stdio.h>
+
+/**
+ * Writes the runtime of the x86-64 programs: their entry point ("_start",
+ * that calls the top-level code, labeled "F0"), and the printers of numbers
+ * (with the digits of JavaScript), booleans and strings (see "print"), which
+ * write through a buffer flushed before the exit. It only uses the system
+ * calls of Linux, so it links without the C library.
+ */
+void emitX86Runtime(FILE * stream);
+
+#endif
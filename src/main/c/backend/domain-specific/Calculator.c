@@ -16,32 +16,499 @@ void shutdownCalculatorModule() {
 
 /** PRIVATE FUNCTIONS */
 
-static BinaryOperator _expressionTypeToBinaryOperator(const ExpressionType type);
-static ComputationResult _invalidBinaryOperator(const int x, const int y);
+/**
+ * The deepest nesting of calls in a computation.
+ */
+#define MAXIMUM_CALL_DEPTH 64
+
+/**
+ * The longest string that a computation builds.
+ */
+#define MAXIMUM_STRING_LENGTH 1024
+
+typedef struct Binding Binding;
+
+/**
+ * A binding of a running function. The bindings of a block are dropped when
+ * it ends, by restoring the innermost binding from before it started.
+ */
+struct Binding {
+	const char * name;
+	DeclarationType type;
+	ComputationResult value;
+	Binding * next;
+};
+
+/**
+ * The bindings of a running function (the innermost one first).
+ */
+typedef struct {
+	Binding * bindings;
+} Frame;
+
+static boolean _burn(Calculation * calculation);
+static ComputationResult _computeAddition(Calculation * calculation, const ComputationResult left, const ComputationResult right);
+static ComputationResult _computeBinary(const ExpressionType type, const ComputationResult left, const ComputationResult right);
+static ComputationResult _computeCall(Calculation * calculation, Frame * frame, FunctionCall * functionCall);
+static ComputationResult _computeEquality(const ComputationResult left, const ComputationResult right, const boolean strict);
+static ComputationResult _computeExpression(Calculation * calculation, Frame * frame, Expression * expression);
+static ComputationResult _computeVariable(Calculation * calculation, Frame * frame, Variable * variable);
+static boolean _declare(Calculation * calculation, Frame * frame, Declaration * declaration);
+static boolean _execute(Calculation * calculation, Frame * frame, Code * code);
+static boolean _executeBlock(Calculation * calculation, Frame * frame, Code * code);
+static boolean _executeIncDec(Frame * frame, IncDec * incDec);
+static boolean _executeStatement(Calculation * calculation, Frame * frame, Statement * statement);
+static Binding * _findBinding(Frame * frame, const char * name);
+static void _formatNumber(char * buffer, const double number);
 static ComputationResult _invalidComputation();
+static ComputationResult _toBoolean(const ComputationResult value);
+static ComputationResult _toNumber(const ComputationResult value);
+static ComputationResult _toString(Calculation * calculation, const ComputationResult value);
+static ComputationResult _value(const DataType type);
+
+/**
+ * Burns a unit of fuel, and returns false if there was none left.
+ */
+static boolean _burn(Calculation * calculation) {
+	if (calculation->fuel == 0) {
+		return false;
+	}
+	--calculation->fuel;
+	return true;
+}
 
 /**
- * Converts and expression type to the proper binary operator. If that's not
- * possible, returns a binary operator that always returns an invalid
- * computation result.
+ * The "+" operator: a concatenation if any operand is a string, otherwise a
+ * numeric addition.
  */
-static BinaryOperator _expressionTypeToBinaryOperator(const ExpressionType type) {
+static ComputationResult _computeAddition(Calculation * calculation, const ComputationResult left, const ComputationResult right) {
+	if (left.type == STRING || right.type == STRING) {
+		if (left.type == STRING && right.type == STRING && left.delimiter != right.delimiter) {
+			return _invalidComputation();
+		}
+		const ComputationResult leftString = _toString(calculation, left);
+		const ComputationResult rightString = _toString(calculation, right);
+		if (!leftString.succeed || !rightString.succeed) {
+			return _invalidComputation();
+		}
+		const size_t leftLength = strlen(leftString.string);
+		const size_t rightLength = strlen(rightString.string);
+		if (MAXIMUM_STRING_LENGTH < leftLength + rightLength) {
+			return _invalidComputation();
+		}
+		char * string = allocateInArena(calculation->arena, 1 + leftLength + rightLength);
+		memcpy(string, leftString.string, leftLength);
+		memcpy(string + leftLength, rightString.string, rightLength);
+		ComputationResult result = _value(STRING);
+		result.string = string;
+		result.delimiter = left.type == STRING ? left.delimiter : right.delimiter;
+		return result;
+	}
+	return _computeBinary(ADD_OP, left, right);
+}
+
+/**
+ * The numeric operators (with the doubles of JavaScript), and the relational
+ * ones. Strings are only compared for equality, because they are kept raw.
+ */
+static ComputationResult _computeBinary(const ExpressionType type, const ComputationResult left, const ComputationResult right) {
 	switch (type) {
-		case ADDITION: return add;
-		case DIVISION: return divide;
-		case MULTIPLICATION: return multiply;
-		case SUBTRACTION: return subtract;
+		case EQUAL_OP:
+		case NEQUAL_OP:
+		case STRICT_EQUAL_OP:
+		case STRICT_NEQUAL_OP: {
+			ComputationResult result = _computeEquality(left, right, type == STRICT_EQUAL_OP || type == STRICT_NEQUAL_OP);
+			if (result.succeed && (type == NEQUAL_OP || type == STRICT_NEQUAL_OP)) {
+				result.boolean = !result.boolean;
+			}
+			return result;
+		}
+		default:
+			break;
+	}
+	const ComputationResult leftNumber = _toNumber(left);
+	const ComputationResult rightNumber = _toNumber(right);
+	if (!leftNumber.succeed || !rightNumber.succeed) {
+		return _invalidComputation();
+	}
+	const double x = leftNumber.number;
+	const double y = rightNumber.number;
+	ComputationResult result = _value(NUMBER);
+	switch (type) {
+		case ADD_OP: result.number = x + y; return result;
+		case SUB_OP: result.number = x - y; return result;
+		case MUL_OP: result.number = x * y; return result;
+		case DIV_OP: result.number = x / y; return result;
+		default:
+			break;
+	}
+	result = _value(BOOLEAN);
+	switch (type) {
+		case GREATER_OP: result.boolean = x > y; return result;
+		case LESS_OP: result.boolean = x < y; return result;
+		case GREATER_EQUAL_OP: result.boolean = x >= y; return result;
+		case LESS_EQUAL_OP: result.boolean = x <= y; return result;
+		default:
+			logError(_logger, "The specified expression type cannot be computed: %d", type);
+			return _invalidComputation();
+	}
+}
+
+static ComputationResult _computeCall(Calculation * calculation, Frame * frame, FunctionCall * functionCall) {
+	FunctionDeclaration * function = functionCall->type == CLASSIC_CALL
+		? calculation->resolve(calculation->context, functionCall->id)
+		: NULL;
+	if (function == NULL || function->body == NULL || MAXIMUM_CALL_DEPTH <= calculation->depth || !_burn(calculation)) {
+		return _invalidComputation();
+	}
+	Frame callee = {
+		.bindings = NULL
+	};
+	ArgumentList * argument = functionCall->arguments;
+	for (VariableTypeList * parameter = function->arguments; parameter != NULL; parameter = parameter->next) {
+		Binding * binding = allocateInArena(calculation->arena, sizeof(Binding));
+		binding->name = parameter->variableType->id;
+		binding->type = LET_DT;
+		binding->value = _value(UNDEFINED);
+		if (argument != NULL) {
+			binding->value = _computeExpression(calculation, frame, argument->expression);
+			if (!binding->value.succeed) {
+				return _invalidComputation();
+			}
+			argument = argument->next;
+		}
+		binding->next = callee.bindings;
+		callee.bindings = binding;
+	}
+	// The extra arguments are still evaluated.
+	for (; argument != NULL; argument = argument->next) {
+		if (!_computeExpression(calculation, frame, argument->expression).succeed) {
+			return _invalidComputation();
+		}
+	}
+	++calculation->depth;
+	ComputationResult result = _invalidComputation();
+	if (_execute(calculation, &callee, function->body->code)) {
+		ReturnValue * returnValue = function->body->returnValue;
+		if (returnValue == NULL || returnValue->type == VOID_RT) {
+			result = _value(UNDEFINED);
+		}
+		else if (returnValue->type == EXPRESSION_RT) {
+			result = _computeExpression(calculation, &callee, returnValue->expression);
+		}
+		else if (returnValue->type == FUNCTIONCALL_RT) {
+			result = _computeCall(calculation, &callee, returnValue->functionCall);
+		}
+	}
+	--calculation->depth;
+	return result;
+}
+
+/**
+ * The "==" (or "===") operator. A string only equals another one with the
+ * same content, if none of them escapes a character (which could be written
+ * in several ways).
+ */
+static ComputationResult _computeEquality(const ComputationResult left, const ComputationResult right, const boolean strict) {
+	ComputationResult result = _value(BOOLEAN);
+	if (left.type == right.type) {
+		switch (left.type) {
+			case NUMBER:
+				result.boolean = left.number == right.number;
+				return result;
+			case STRING:
+				if (strchr(left.string, '\\') != NULL || strchr(right.string, '\\') != NULL) {
+					return _invalidComputation();
+				}
+				result.boolean = strcmp(left.string, right.string) == 0;
+				return result;
+			case BOOLEAN:
+				result.boolean = left.boolean == right.boolean;
+				return result;
+			default:
+				result.boolean = true;
+				return result;
+		}
+	}
+	if (strict || left.type == UNDEFINED || right.type == UNDEFINED) {
+		result.boolean = false;
+		return result;
+	}
+	if (left.type == STRING || right.type == STRING) {
+		return _invalidComputation();
+	}
+	return _computeBinary(EQUAL_OP, _toNumber(left), _toNumber(right));
+}
+
+static ComputationResult _computeExpression(Calculation * calculation, Frame * frame, Expression * expression) {
+	if (expression == NULL || !_burn(calculation)) {
+		return _invalidComputation();
+	}
+	switch (expression->type) {
+		case FACTOR: {
+			Factor * factor = expression->factor;
+			switch (factor->type) {
+				case CONSTANT:
+					return computeConstant(calculation, factor->constant);
+				case VARIABLE: {
+					Binding * binding = _findBinding(frame, factor->variableName);
+					return binding == NULL ? _invalidComputation() : binding->value;
+				}
+				case EXPRESSION:
+					return _computeExpression(calculation, frame, factor->expression);
+				case FUNCTIONCALL:
+					return _computeCall(calculation, frame, factor->functionCall);
+			}
+			return _invalidComputation();
+		}
+		case NOT_OP: {
+			ComputationResult result = _toBoolean(_computeExpression(calculation, frame, expression->expression));
+			result.boolean = !result.boolean;
+			return result;
+		}
+		case AND_OP:
+		case OR_OP: {
+			const ComputationResult left = _computeExpression(calculation, frame, expression->leftExpression);
+			const ComputationResult truth = _toBoolean(left);
+			if (!truth.succeed) {
+				return _invalidComputation();
+			}
+			if (truth.boolean == (expression->type == OR_OP)) {
+				return left;
+			}
+			return _computeExpression(calculation, frame, expression->rightExpression);
+		}
+		case AWAIT_OP:
+			return _invalidComputation();
+		default: {
+			const ComputationResult left = _computeExpression(calculation, frame, expression->leftExpression);
+			const ComputationResult right = _computeExpression(calculation, frame, expression->rightExpression);
+			if (!left.succeed || !right.succeed) {
+				return _invalidComputation();
+			}
+			return expression->type == ADD_OP
+				? _computeAddition(calculation, left, right)
+				: _computeBinary(expression->type, left, right);
+		}
+	}
+}
+
+/**
+ * The value of the right side of a declaration or an assignment.
+ */
+static ComputationResult _computeVariable(Calculation * calculation, Frame * frame, Variable * variable) {
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			return _computeExpression(calculation, frame, variable->expression);
+		case FUNCTIONCALL_VAR:
+			return _computeCall(calculation, frame, variable->functionCall);
+		case UNINITIALIZED:
+			return _value(UNDEFINED);
+		default:
+			return _invalidComputation();
+	}
+}
+
+static boolean _declare(Calculation * calculation, Frame * frame, Declaration * declaration) {
+	const ComputationResult value = _computeVariable(calculation, frame, declaration->variable);
+	if (!value.succeed) {
+		return false;
+	}
+	Binding * binding = allocateInArena(calculation->arena, sizeof(Binding));
+	binding->name = declaration->variable->variableType->id;
+	binding->type = declaration->type;
+	binding->value = value;
+	binding->next = frame->bindings;
+	frame->bindings = binding;
+	return true;
+}
+
+static boolean _execute(Calculation * calculation, Frame * frame, Code * code) {
+	for (; code != NULL; code = code->next) {
+		if (!_burn(calculation) || !_executeStatement(calculation, frame, code->statement)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Executes a block, whose bindings end with it. A "var" ends with it too,
+ * so reading it afterwards fails, as if it was never declared.
+ */
+static boolean _executeBlock(Calculation * calculation, Frame * frame, Code * code) {
+	Binding * bindings = frame->bindings;
+	const boolean succeed = _execute(calculation, frame, code);
+	frame->bindings = bindings;
+	return succeed;
+}
+
+static boolean _executeIncDec(Frame * frame, IncDec * incDec) {
+	const Expression * expression = incDec->expression;
+	if (expression->type != FACTOR || expression->factor->type != VARIABLE) {
+		return false;
+	}
+	Binding * binding = _findBinding(frame, expression->factor->variableName);
+	if (binding == NULL || binding->type == CONST_DT || binding->value.type != NUMBER) {
+		return false;
+	}
+	binding->value.number += incDec->type == INC_OP ? 1 : -1;
+	return true;
+}
+
+static boolean _executeStatement(Calculation * calculation, Frame * frame, Statement * statement) {
+	switch (statement->statement) {
+		case IF_ST: {
+			const ComputationResult condition = _toBoolean(_computeExpression(calculation, frame, statement->ifStatement->condition));
+			if (!condition.succeed) {
+				return false;
+			}
+			return _executeBlock(calculation, frame, condition.boolean ? statement->ifStatement->thenBody : statement->ifStatement->elseBody);
+		}
+		case WHILE_ST:
+			while (true) {
+				const ComputationResult condition = _toBoolean(_computeExpression(calculation, frame, statement->whileLoop->condition));
+				if (!condition.succeed) {
+					return false;
+				}
+				if (!condition.boolean) {
+					return true;
+				}
+				if (!_executeBlock(calculation, frame, statement->whileLoop->body)) {
+					return false;
+				}
+			}
+		case FOR_ST: {
+			ParamsFor * params = statement->forLoop->params;
+			if (params->type != FOR_CLASSIC) {
+				return false;
+			}
+			Binding * bindings = frame->bindings;
+			boolean succeed = params->init == NULL || _declare(calculation, frame, params->init);
+			while (succeed) {
+				const ComputationResult condition = _toBoolean(_computeExpression(calculation, frame, params->condition));
+				if (!condition.succeed || !condition.boolean) {
+					succeed = condition.succeed;
+					break;
+				}
+				succeed = _executeBlock(calculation, frame, statement->forLoop->body);
+				if (succeed && params->updateType == INC_DEC_UT) {
+					succeed = _executeIncDec(frame, params->updateIncDec);
+				}
+				else if (succeed && params->update != NULL) {
+					succeed = _computeExpression(calculation, frame, params->update).succeed;
+				}
+			}
+			frame->bindings = bindings;
+			return succeed;
+		}
+		case DECLARATION_ST:
+			return _declare(calculation, frame, statement->declaration);
+		case VARIABLE_ST: {
+			Binding * binding = _findBinding(frame, statement->variable->variableType->id);
+			if (binding == NULL || binding->type == CONST_DT) {
+				return false;
+			}
+			const ComputationResult value = _computeVariable(calculation, frame, statement->variable);
+			if (!value.succeed) {
+				return false;
+			}
+			binding->value = value;
+			return true;
+		}
+		case EXPRESSION_ST:
+			return _computeExpression(calculation, frame, statement->expression).succeed;
+		case FUNCTIONCALL_ST:
+			return _computeCall(calculation, frame, statement->functionCall).succeed;
+		case INC_DEC_ST:
+			return _executeIncDec(frame, statement->incDec);
 		default:
-			logError(_logger, "The specified expression type cannot be converted into character: %d", type);
-			return _invalidBinaryOperator;
+			return false;
 	}
 }
 
+static Binding * _findBinding(Frame * frame, const char * name) {
+	for (Binding * binding = frame->bindings; binding != NULL; binding = binding->next) {
+		if (strcmp(binding->name, name) == 0) {
+			return binding;
+		}
+	}
+	return NULL;
+}
+
 /**
- * A binary operator that always returns an invalid computation result.
+ * Writes a finite number as JavaScript does (Number::toString): with the
+ * fewest significant digits that read back as the same double, positional
+ * from 1e-7 up to 1e21, and exponential otherwise.
  */
-static ComputationResult _invalidBinaryOperator(const int x, const int y) {
-	return _invalidComputation();
+static void _formatNumber(char * buffer, const double number) {
+	if (number == 0) {
+		strcpy(buffer, "0");
+		return;
+	}
+	const double magnitude = fabs(number);
+	char digits[24];
+	char scientific[40];
+	int count = 0;
+	int exponent = 0;
+	for (int precision = 1; precision <= 17; ++precision) {
+		snprintf(scientific, sizeof(scientific), "%.*e", precision - 1, magnitude);
+		count = 0;
+		for (const char * character = scientific; *character != 'e'; ++character) {
+			if (*character != '.') {
+				digits[count++] = *character;
+			}
+		}
+		digits[count] = '\0';
+		exponent = atoi(strchr(scientific, 'e') + 1);
+		if (strtod(scientific, NULL) == magnitude) {
+			break;
+		}
+		// Next to a power of two, the closest digits may fall below the
+		// (narrower) lower half of the interval, while the next ones up
+		// still read back.
+		int k = count - 1;
+		while (0 <= k && digits[k] == '9') {
+			digits[k--] = '0';
+		}
+		if (k < 0) {
+			digits[0] = '1';
+			++exponent;
+		}
+		else {
+			++digits[k];
+		}
+		snprintf(scientific, sizeof(scientific), "%se%d", digits, exponent - count + 1);
+		if (strtod(scientific, NULL) == magnitude) {
+			break;
+		}
+	}
+	while (1 < count && digits[count - 1] == '0') {
+		digits[--count] = '\0';
+	}
+	// The digits are read as 0.digits * 10^n.
+	const int n = exponent + 1;
+	char * end = buffer + sprintf(buffer, "%s", number < 0 ? "-" : "");
+	if (count <= n && n <= 21) {
+		end += sprintf(end, "%s", digits);
+		for (int k = count; k < n; ++k) {
+			*end++ = '0';
+		}
+		*end = '\0';
+	}
+	else if (0 < n && n <= 21) {
+		sprintf(end, "%.*s.%s", n, digits, digits + n);
+	}
+	else if (-6 < n && n <= 0) {
+		end += sprintf(end, "%s", "0.");
+		for (int k = n; k < 0; ++k) {
+			*end++ = '0';
+		}
+		sprintf(end, "%s", digits);
+	}
+	else {
+		sprintf(end, "%c%s%se%c%d", digits[0], count == 1 ? "" : ".", digits + 1, n < 1 ? '-' : '+', abs(n - 1));
+	}
 }
 
 /**
@@ -50,87 +517,159 @@ static ComputationResult _invalidBinaryOperator(const int x, const int y) {
 static ComputationResult _invalidComputation() {
 	ComputationResult computationResult = {
 		.succeed = false,
-		.value = 0
+		.type = UNKNOWN
 	};
 	return computationResult;
 }
 
-/** PUBLIC FUNCTIONS */
-
-ComputationResult add(const int leftAddend, const int rightAddend) {
-	ComputationResult computationResult = {
-		.succeed = true,
-		.value = leftAddend + rightAddend
-	};
-	return computationResult;
+static ComputationResult _toBoolean(const ComputationResult value) {
+	ComputationResult result = _value(BOOLEAN);
+	switch (value.type) {
+		case NUMBER:
+			result.boolean = value.number != 0 && !isnan(value.number);
+			return result;
+		case STRING:
+			// An escaped line break is empty.
+			if (strchr(value.string, '\\') != NULL) {
+				return _invalidComputation();
+			}
+			result.boolean = value.string[0] != '\0';
+			return result;
+		case BOOLEAN:
+			return value;
+		case UNDEFINED:
+			result.boolean = false;
+			return result;
+		default:
+			return _invalidComputation();
+	}
 }
 
-ComputationResult divide(const int dividend, const int divisor) {
-	const int sign = dividend < 0 ? -1 : +1;
-	const boolean divisionByZero = divisor == 0 ? true : false;
-	if (divisionByZero) {
-		logError(_logger, "The divisor cannot be zero (the computation was %d/%d).", dividend, divisor);
+/**
+ * Converts to a number, except for strings (whose grammar of numbers is not
+ * worth it).
+ */
+static ComputationResult _toNumber(const ComputationResult value) {
+	ComputationResult result = _value(NUMBER);
+	switch (value.type) {
+		case NUMBER:
+			return value;
+		case BOOLEAN:
+			result.number = value.boolean ? 1 : 0;
+			return result;
+		case UNDEFINED:
+			result.number = NAN;
+			return result;
+		default:
+			return _invalidComputation();
 	}
-	ComputationResult computationResult = {
-		.succeed = divisionByZero ? false : true,
-		.value = divisionByZero ? (sign * INT_MAX) : (dividend / divisor)
-	};
-	return computationResult;
 }
 
-ComputationResult multiply(const int multiplicand, const int multiplier) {
-	ComputationResult computationResult = {
-		.succeed = true,
-		.value = multiplicand * multiplier
-	};
-	return computationResult;
+/**
+ * Converts to a string, as JavaScript does.
+ */
+static ComputationResult _toString(Calculation * calculation, const ComputationResult value) {
+	char buffer[32];
+	switch (value.type) {
+		case STRING:
+			return value;
+		case NUMBER:
+			if (isnan(value.number)) {
+				snprintf(buffer, sizeof(buffer), "NaN");
+			}
+			else if (isinf(value.number)) {
+				snprintf(buffer, sizeof(buffer), "%sInfinity", value.number < 0 ? "-" : "");
+			}
+			else {
+				_formatNumber(buffer, value.number);
+			}
+			break;
+		case BOOLEAN:
+			snprintf(buffer, sizeof(buffer), "%s", value.boolean ? "true" : "false");
+			break;
+		case UNDEFINED:
+			snprintf(buffer, sizeof(buffer), "undefined");
+			break;
+		default:
+			return _invalidComputation();
+	}
+	ComputationResult result = _value(STRING);
+	result.string = copyStringInArena(calculation->arena, buffer);
+	return result;
 }
 
-ComputationResult subtract(const int minuend, const int subtract) {
+static ComputationResult _value(const DataType type) {
 	ComputationResult computationResult = {
 		.succeed = true,
-		.value = minuend - subtract
+		.type = type
 	};
 	return computationResult;
 }
 
-ComputationResult computeConstant(Constant * constant) {
-	ComputationResult computationResult = {
-		.succeed = true,
-		.value = constant->value
-	};
-	return computationResult;
-}
+/** PUBLIC FUNCTIONS */
 
-ComputationResult computeExpression(Expression * expression) {
-	switch (expression->type) {
-		case ADDITION:
-		case DIVISION:
-		case MULTIPLICATION:
-		case SUBTRACTION:
-			ComputationResult leftResult = computeExpression(expression->leftExpression);
-			ComputationResult rightResult = computeExpression(expression->rightExpression);
-			if (leftResult.succeed && rightResult.succeed) {
-				BinaryOperator binaryOperator = _expressionTypeToBinaryOperator(expression->type);
-				return binaryOperator(leftResult.value, rightResult.value);
+ComputationResult computeConstant(Calculation * calculation, Constant * constant) {
+	ComputationResult result = _value(constant->type);
+	switch (constant->type) {
+		case NUMBER:
+			if (constant->numberType == INTEGER_NT) {
+				result.number = constant->integer;
 			}
 			else {
+				result.number = constant->floating;
+			}
+			return result;
+		case BOOLEAN:
+			result.boolean = constant->boolean ? true : false;
+			return result;
+		case STRING: {
+			// The lexeme keeps its delimiters, and a template cannot be interpolated.
+			const char * lexeme = constant->string;
+			const size_t length = strlen(lexeme);
+			if (length < 2 || (lexeme[0] == '`' && strstr(lexeme, "${") != NULL)) {
 				return _invalidComputation();
 			}
-		case FACTOR:
-			return computeFactor(expression->factor);
+			char * string = allocateInArena(calculation->arena, length - 1);
+			memcpy(string, lexeme + 1, length - 2);
+			string[length - 2] = '\0';
+			result.string = string;
+			result.delimiter = lexeme[0];
+			return result;
+		}
 		default:
 			return _invalidComputation();
 	}
 }
 
-ComputationResult computeFactor(Factor * factor) {
-	switch (factor->type) {
-		case CONSTANT:
-			return computeConstant(factor->constant);
-		case EXPRESSION:
-			return computeExpression(factor->expression);
-		default:
-			return _invalidComputation();
+ComputationResult computeExpression(Calculation * calculation, Expression * expression) {
+	Frame frame = {
+		.bindings = NULL
+	};
+	return _computeExpression(calculation, &frame, expression);
+}
+
+ComputationResult computeCall(Calculation * calculation, FunctionCall * functionCall) {
+	Frame frame = {
+		.bindings = NULL
+	};
+	return _computeCall(calculation, &frame, functionCall);
+}
+
+Code * computeCode(Calculation * calculation, Code * code, Code * end, BindingVisitor visit) {
+	Frame frame = {
+		.bindings = NULL
+	};
+	for (; code != end; code = code->next) {
+		const StatementType type = code->statement->statement;
+		if (type == FUNCTION_DECLARATION_ST || type == ASYNC_FUNCTION_ST || type == TYPE_DECLARATION_ST) {
+			continue;
+		}
+		if (!_burn(calculation) || !_executeStatement(calculation, &frame, code->statement)) {
+			return code;
+		}
+	}
+	for (Binding * binding = frame.bindings; binding != NULL; binding = binding->next) {
+		visit(calculation->context, binding->name, binding->value);
 	}
+	return end;
 }
@@ -7,9 +7,14 @@
  * domain-specific models or DTOs (Data Transfer Objects).
  */
 #include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Arena.h"
 #include "../../shared/Logger.h"
 #include "../../shared/Type.h"
 #include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 /** Initialize module's internal state. */
 void initializeCalculatorModule();
@@ -19,35 +24,69 @@ void shutdownCalculatorModule();
 
 /**
  * The result of a computation. It's considered valid only if "succeed" is
- * true.
+ * true. Its value is a NUMBER, a STRING (its raw content, as written between
+ * its delimiters), a BOOLEAN, or UNDEFINED.
  */
 typedef struct {
 	boolean succeed;
-	int value;
+	DataType type;
+	union {
+		double number;
+		boolean boolean;
+		const char * string;
+	};
+	char delimiter;
 } ComputationResult;
 
-typedef ComputationResult (*BinaryOperator)(const int, const int);
+/**
+ * Finds the function that a call reaches, or NULL if it cannot be known.
+ */
+typedef FunctionDeclaration * (*FunctionResolver)(void * context, const char * name);
+
+/**
+ * A computation in progress. Every statement and every operation burns a unit
+ * of fuel, and the computation fails once it runs out (or once the calls
+ * nest too deeply), so it always ends.
+ */
+typedef struct {
+	FunctionResolver resolve;
+	void * context;
+	Arena * arena;
+	unsigned int fuel;
+	unsigned int depth;
+} Calculation;
 
-/** Arithmetic operations. */
+/**
+ * Receives a binding that a computation leaves, and its final value (the
+ * context is the one of the calculation).
+ */
+typedef void (*BindingVisitor)(void * context, const char * name, const ComputationResult value);
 
-ComputationResult add(const int leftAddend, const int rightAddend);
-ComputationResult divide(const int dividend, const int divisor);
-ComputationResult multiply(const int multiplicand, const int multiplier);
-ComputationResult subtract(const int minuend, const int subtract);
+/**
+ * Computes the final value of a constant.
+ */
+ComputationResult computeConstant(Calculation * calculation, Constant * constant);
 
 /**
- * Computes the final value of a mathematical constant.
+ * Computes the final value of an expression that reads no binding.
  */
-ComputationResult computeConstant(Constant * constant);
+ComputationResult computeExpression(Calculation * calculation, Expression * expression);
 
 /**
- * Computes the final value of a mathematical expression.
+ * Computes the value that a call returns, by running the function that it
+ * reaches. The computation fails on anything that the function could observe
+ * or change outside of its own bindings (reading any other binding, calling
+ * an unknown function, or awaiting), so a computed call is pure.
  */
-ComputationResult computeExpression(Expression * expression);
+ComputationResult computeCall(Calculation * calculation, FunctionCall * functionCall);
 
 /**
- * Computes the final value of a mathematical factor.
+ * Runs a block of statements up to an end (NULL for all of them), like the
+ * body of a function, skipping the declarations of functions and types (they
+ * only name things). Returns the first statement that cannot be computed, or
+ * the end if none fails, and then visits every binding that the block leaves
+ * (the last one declared first).
  */
-ComputationResult computeFactor(Factor * factor);
+Code * computeCode(Calculation * calculation, Code * code, Code * end, BindingVisitor visit);
 
 #endif
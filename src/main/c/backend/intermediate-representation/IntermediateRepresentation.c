@@ -0,0 +1,379 @@
+#include "IntermediateRepresentation.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializeIntermediateRepresentationModule() {
+	_logger = createLogger("IntermediateRepresentation");
+}
+
+void shutdownIntermediateRepresentationModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The size of every chunk of the arena of a module.
+ */
+#define IR_ARENA_CHUNK_SIZE 65536
+
+static unsigned int *_appendIndex(Arena *arena, unsigned int *array, unsigned int *count, unsigned int *capacity, const unsigned int index);
+static void _printInstruction(FILE *stream, const IrModule *module, const IrFunction *function, const unsigned int value);
+static const char *_valueTypeName(const IrValueType type);
+
+/**
+ * Appends an index to a growable array of the arena, and returns the array
+ * (that moves if it has to grow).
+ */
+static unsigned int *_appendIndex(Arena *arena, unsigned int *array, unsigned int *count, unsigned int *capacity, const unsigned int index) {
+	if (*count == *capacity) {
+		const unsigned int capacity_ = *capacity == 0 ? 4 : 2 * *capacity;
+		array = reallocateInArena(arena, array, *capacity * sizeof(unsigned int), capacity_ * sizeof(unsigned int));
+		*capacity = capacity_;
+	}
+	array[(*count)++] = index;
+	return array;
+}
+
+static void _printInstruction(FILE *stream, const IrModule *module, const IrFunction *function, const unsigned int value) {
+	const IrInstruction *instruction = &function->instructions[value];
+	if (isIrTerminator(instruction->opcode) || instruction->opcode == STORE_IR) {
+		fprintf(stream, "    %s", irOpcodeName(instruction->opcode));
+	}
+	else {
+		fprintf(stream, "    %%%u: %s", value, _valueTypeName(instruction->type));
+		if (instruction->representation != TAGGED_REP) {
+			fprintf(stream, "(%s)", irRepresentationName(instruction->representation));
+		}
+		fprintf(stream, " = %s", irOpcodeName(instruction->opcode));
+	}
+	switch (instruction->opcode) {
+		case CONSTANT_IR:
+			switch (instruction->type) {
+				case NUMBER_VT:
+					fprintf(stream, " %.17g", instruction->number);
+					break;
+				case STRING_VT:
+					fprintf(stream, " %s", instruction->string);
+					break;
+				case BOOLEAN_VT:
+					fprintf(stream, " %s", instruction->boolean ? "true" : "false");
+					break;
+				default:
+					fprintf(stream, " undefined");
+					break;
+			}
+			break;
+		case LOAD_IR:
+		case STORE_IR:
+			fprintf(stream, " @%s", instruction->name);
+			break;
+		case CALL_IR:
+		case AWAIT_IR:
+			fprintf(stream, " @%s", instruction->name);
+			if (instruction->callee != IR_NONE) {
+				fprintf(stream, " [F%u]", instruction->callee);
+			}
+			break;
+		case PARAMETER_IR:
+			fprintf(stream, " #%u", instruction->index);
+			break;
+		case CLOSURE_IR:
+			fprintf(stream, " @%s", module->functions[instruction->index].name);
+			break;
+		default:
+			break;
+	}
+	for (unsigned int k = 0; k < instruction->operandCount; ++k) {
+		if (instruction->opcode == OBJECT_IR) {
+			fprintf(stream, "%s %s: %%%u", k == 0 ? "" : ",", instruction->keys[k], instruction->operands[k]);
+		}
+		else {
+			fprintf(stream, "%s %%%u", k == 0 ? "" : ",", instruction->operands[k]);
+		}
+	}
+	if (instruction->opcode == JUMP_IR) {
+		fprintf(stream, " B%u", instruction->targets[0]);
+	}
+	else if (instruction->opcode == BRANCH_IR) {
+		fprintf(stream, ", B%u, B%u", instruction->targets[0], instruction->targets[1]);
+	}
+	fprintf(stream, "\n");
+}
+
+static const char *_valueTypeName(const IrValueType type) {
+	switch (type) {
+		case UNDEFINED_VT: return "undefined";
+		case NUMBER_VT: return "number";
+		case STRING_VT: return "string";
+		case BOOLEAN_VT: return "boolean";
+		case ARRAY_VT: return "array";
+		case OBJECT_VT: return "object";
+		case FUNCTION_VT: return "function";
+		default: return "any";
+	}
+}
+
+/** PUBLIC FUNCTIONS */
+
+IrModule *createIrModule() {
+	Arena *arena = createArena(IR_ARENA_CHUNK_SIZE);
+	IrModule *module = allocateInArena(arena, sizeof(IrModule));
+	module->arena = arena;
+	return module;
+}
+
+void releaseIrModule(IrModule *module) {
+	if (module != NULL) {
+		logDebugging(_logger, "Releasing IR module (%u functions, %zu bytes in %u allocations).",
+					 module->functionCount,
+					 module->arena->allocatedBytes,
+					 module->arena->allocations);
+		destroyArena(module->arena);
+	}
+}
+
+unsigned int addIrFunction(IrModule *module, const char *name, const boolean async, const unsigned int parent) {
+	if (module->functionCount == module->functionCapacity) {
+		const unsigned int capacity = module->functionCapacity == 0 ? 8 : 2 * module->functionCapacity;
+		module->functions = reallocateInArena(module->arena, module->functions, module->functionCapacity * sizeof(IrFunction), capacity * sizeof(IrFunction));
+		module->functionCapacity = capacity;
+	}
+	const unsigned int index = module->functionCount++;
+	IrFunction *function = &module->functions[index];
+	memset(function, 0, sizeof(IrFunction));
+	function->name = copyStringInArena(module->arena, name);
+	function->async = async;
+	function->parent = parent;
+	return index;
+}
+
+unsigned int addIrBlock(IrModule *module, const unsigned int function) {
+	IrFunction *irFunction = &module->functions[function];
+	if (irFunction->blockCount == irFunction->blockCapacity) {
+		const unsigned int capacity = irFunction->blockCapacity == 0 ? 8 : 2 * irFunction->blockCapacity;
+		irFunction->blocks = reallocateInArena(module->arena, irFunction->blocks, irFunction->blockCapacity * sizeof(IrBlock), capacity * sizeof(IrBlock));
+		irFunction->blockCapacity = capacity;
+	}
+	const unsigned int index = irFunction->blockCount++;
+	memset(&irFunction->blocks[index], 0, sizeof(IrBlock));
+	return index;
+}
+
+void addIrEdge(IrModule *module, const unsigned int function, const unsigned int from, const unsigned int to) {
+	IrBlock *block = &module->functions[function].blocks[to];
+	block->predecessors = _appendIndex(module->arena, block->predecessors, &block->predecessorCount, &block->predecessorCapacity, from);
+}
+
+unsigned int addIrInstruction(IrModule *module, const unsigned int function, const unsigned int block, const IrOpcode opcode, const IrValueType type, const unsigned int operandCount) {
+	IrFunction *irFunction = &module->functions[function];
+	if (irFunction->instructionCount == irFunction->instructionCapacity) {
+		const unsigned int capacity = irFunction->instructionCapacity == 0 ? 32 : 2 * irFunction->instructionCapacity;
+		irFunction->instructions = reallocateInArena(module->arena, irFunction->instructions, irFunction->instructionCapacity * sizeof(IrInstruction), capacity * sizeof(IrInstruction));
+		irFunction->instructionCapacity = capacity;
+	}
+	const unsigned int index = irFunction->instructionCount++;
+	IrInstruction *instruction = &irFunction->instructions[index];
+	memset(instruction, 0, sizeof(IrInstruction));
+	instruction->opcode = opcode;
+	instruction->type = type;
+	instruction->block = block;
+	instruction->operandCount = operandCount;
+	if (0 < operandCount) {
+		instruction->operands = allocateInArena(module->arena, operandCount * sizeof(unsigned int));
+	}
+	if (block != IR_NONE) {
+		IrBlock *irBlock = &irFunction->blocks[block];
+		if (opcode == PHI_IR) {
+			irBlock->phis = _appendIndex(module->arena, irBlock->phis, &irBlock->phiCount, &irBlock->phiCapacity, index);
+		}
+		else {
+			irBlock->instructions = _appendIndex(module->arena, irBlock->instructions, &irBlock->instructionCount, &irBlock->instructionCapacity, index);
+		}
+	}
+	return index;
+}
+
+unsigned int getIrSuccessors(const IrFunction *function, const unsigned int block, unsigned int successors[2]) {
+	const IrBlock *irBlock = &function->blocks[block];
+	if (irBlock->instructionCount == 0) {
+		return 0;
+	}
+	const IrInstruction *terminator = &function->instructions[irBlock->instructions[irBlock->instructionCount - 1]];
+	switch (terminator->opcode) {
+		case JUMP_IR:
+			successors[0] = terminator->targets[0];
+			return 1;
+		case BRANCH_IR:
+			successors[0] = terminator->targets[0];
+			successors[1] = terminator->targets[1];
+			return 2;
+		default:
+			return 0;
+	}
+}
+
+unsigned int orderIrBlocks(const IrFunction *function, unsigned int *order) {
+	if (function->blockCount == 0) {
+		return 0;
+	}
+	// An explicit stack, where a block stays until it visited every successor.
+	boolean *visited = calloc(function->blockCount, sizeof(boolean));
+	unsigned int *stack = malloc(function->blockCount * sizeof(unsigned int));
+	unsigned int *next = calloc(function->blockCount, sizeof(unsigned int));
+	unsigned int count = 0;
+	unsigned int depth = 0;
+	stack[depth++] = 0;
+	visited[0] = true;
+	while (0 < depth) {
+		const unsigned int block = stack[depth - 1];
+		unsigned int successors[2];
+		const unsigned int successorCount = getIrSuccessors(function, block, successors);
+		if (next[block] < successorCount) {
+			const unsigned int successor = successors[next[block]++];
+			if (!visited[successor]) {
+				visited[successor] = true;
+				stack[depth++] = successor;
+			}
+		}
+		else {
+			order[count++] = block;
+			--depth;
+		}
+	}
+	for (unsigned int k = 0; k < count / 2; ++k) {
+		const unsigned int block = order[k];
+		order[k] = order[count - 1 - k];
+		order[count - 1 - k] = block;
+	}
+	free(next);
+	free(stack);
+	free(visited);
+	return count;
+}
+
+boolean isIrTerminator(const IrOpcode opcode) {
+	return opcode == JUMP_IR || opcode == BRANCH_IR || opcode == RETURN_IR;
+}
+
+boolean isIrPure(const IrOpcode opcode) {
+	switch (opcode) {
+		case STORE_IR:
+		case CALL_IR:
+		case AWAIT_IR:
+		case ITERATOR_IR:
+		case NEXT_IR:
+		case JUMP_IR:
+		case BRANCH_IR:
+		case RETURN_IR:
+			return false;
+		default:
+			return true;
+	}
+}
+
+const char *irRepresentationName(const IrRepresentation representation) {
+	switch (representation) {
+		case INT32_REP: return "int32";
+		case INT64_REP: return "int64";
+		case DOUBLE_REP: return "double";
+		default: return "tagged";
+	}
+}
+
+const char *irOpcodeName(const IrOpcode opcode) {
+	switch (opcode) {
+		case CONSTANT_IR: return "constant";
+		case PARAMETER_IR: return "parameter";
+		case PHI_IR: return "phi";
+		case LOAD_IR: return "load";
+		case STORE_IR: return "store";
+		case CLOSURE_IR: return "closure";
+		case ADD_IR: return "add";
+		case SUB_IR: return "sub";
+		case MUL_IR: return "mul";
+		case DIV_IR: return "div";
+		case GREATER_IR: return "gt";
+		case LESS_IR: return "lt";
+		case GREATER_EQUAL_IR: return "ge";
+		case LESS_EQUAL_IR: return "le";
+		case EQUAL_IR: return "eq";
+		case NEQUAL_IR: return "ne";
+		case STRICT_EQUAL_IR: return "seq";
+		case STRICT_NEQUAL_IR: return "sne";
+		case AND_IR: return "and";
+		case OR_IR: return "or";
+		case NOT_IR: return "not";
+		case CALL_IR: return "call";
+		case AWAIT_IR: return "await";
+		case ARRAY_IR: return "array";
+		case OBJECT_IR: return "object";
+		case ITERATOR_IR: return "iterator";
+		case NEXT_IR: return "next";
+		case DONE_IR: return "done";
+		case VALUE_IR: return "value";
+		case JUMP_IR: return "jump";
+		case BRANCH_IR: return "branch";
+		case RETURN_IR: return "return";
+		default: return "?";
+	}
+}
+
+void printIrModule(FILE *stream, const IrModule *module) {
+	for (unsigned int f = 0; f < module->functionCount; ++f) {
+		const IrFunction *function = &module->functions[f];
+		fprintf(stream, "F%u: %sfunction %s(%u) {\n", f, function->async ? "async " : "", function->name, function->parameterCount);
+		for (unsigned int b = 0; b < function->blockCount; ++b) {
+			const IrBlock *block = &function->blocks[b];
+			fprintf(stream, "  B%u:", b);
+			for (unsigned int k = 0; k < block->predecessorCount; ++k) {
+				fprintf(stream, "%s B%u", k == 0 ? " <-" : ",", block->predecessors[k]);
+			}
+			fprintf(stream, "\n");
+			for (unsigned int k = 0; k < block->phiCount; ++k) {
+				_printInstruction(stream, module, function, block->phis[k]);
+			}
+			for (unsigned int k = 0; k < block->instructionCount; ++k) {
+				_printInstruction(stream, module, function, block->instructions[k]);
+			}
+		}
+		fprintf(stream, "}\n");
+	}
+}
+
+void printIrPairs(FILE *stream, const IrModule *module) {
+	unsigned int counts[IR_OPCODES][IR_OPCODES] = {{0}};
+	unsigned int total = 0;
+	for (unsigned int f = 0; f < module->functionCount; ++f) {
+		const IrFunction *function = &module->functions[f];
+		for (unsigned int k = 0; k < function->instructionCount; ++k) {
+			const IrInstruction *instruction = &function->instructions[k];
+			for (unsigned int o = 0; o < instruction->operandCount; ++o) {
+				++counts[function->instructions[instruction->operands[o]].opcode][instruction->opcode];
+				++total;
+			}
+		}
+	}
+	fprintf(stream, "%u pairs\n", total);
+	for (;;) {
+		unsigned int producer = 0;
+		unsigned int consumer = 0;
+		for (unsigned int p = 0; p < IR_OPCODES; ++p) {
+			for (unsigned int c = 0; c < IR_OPCODES; ++c) {
+				if (counts[producer][consumer] < counts[p][c]) {
+					producer = p;
+					consumer = c;
+				}
+			}
+		}
+		if (counts[producer][consumer] == 0) {
+			break;
+		}
+		fprintf(stream, "%6u %s -> %s\n", counts[producer][consumer], irOpcodeName(producer), irOpcodeName(consumer));
+		counts[producer][consumer] = 0;
+	}
+}
@@ -0,0 +1,249 @@
+#ifndef INTERMEDIATE_REPRESENTATION_HEADER
+#define INTERMEDIATE_REPRESENTATION_HEADER
+
+#include "../../shared/Arena.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Initialize module's internal state. */
+void initializeIntermediateRepresentationModule();
+
+/** Shutdown module's internal state. */
+void shutdownIntermediateRepresentationModule();
+
+/**
+ * The index that refers to nothing (no value, no block, no function).
+ */
+#define IR_NONE ((unsigned int) -1)
+
+typedef enum IrOpcode IrOpcode;
+typedef enum IrValueType IrValueType;
+typedef enum IrRepresentation IrRepresentation;
+
+typedef struct IrInstruction IrInstruction;
+typedef struct IrBlock IrBlock;
+typedef struct IrFunction IrFunction;
+typedef struct IrModule IrModule;
+
+/**
+ * The operations of the IR. Every instruction defines at most one value,
+ * which is named by the index of the instruction inside its function. The
+ * last instruction of every block is a terminator (jump, branch or return).
+ */
+enum IrOpcode {
+	CONSTANT_IR,	  // number, string, boolean or undefined
+	PARAMETER_IR,	  // the n-th parameter of the function
+	PHI_IR,			  // one operand per predecessor, in the same order
+	LOAD_IR,		  // reads a binding that lives in memory (by name)
+	STORE_IR,		  // writes a binding that lives in memory (by name)
+	CLOSURE_IR,		  // a nested function of the module
+	ADD_IR,
+	SUB_IR,
+	MUL_IR,
+	DIV_IR,
+	GREATER_IR,
+	LESS_IR,
+	GREATER_EQUAL_IR,
+	LESS_EQUAL_IR,
+	EQUAL_IR,
+	NEQUAL_IR,
+	STRICT_EQUAL_IR,
+	STRICT_NEQUAL_IR,
+	AND_IR,
+	OR_IR,
+	NOT_IR,
+	CALL_IR,		  // calls a function by name
+	AWAIT_IR,		  // suspends on a call (by name)
+	ARRAY_IR,		  // an array literal of its operands
+	OBJECT_IR,		  // an object literal of its operands (see keys)
+	ITERATOR_IR,	  // starts iterating its operand
+	NEXT_IR,		  // advances an iterator
+	DONE_IR,		  // true if the step of an iterator is the last one
+	VALUE_IR,		  // the value of a step of an iterator
+	JUMP_IR,
+	BRANCH_IR,		  // to the first target if its operand is truthy
+	RETURN_IR		  // returns its operand, if any
+};
+
+#define IR_OPCODES (RETURN_IR + 1)
+
+/**
+ * The static type of a value, as far as the annotations and the operations
+ * tell. ANY_VT means that nothing is known.
+ */
+enum IrValueType {
+	UNDEFINED_VT,
+	NUMBER_VT,
+	STRING_VT,
+	BOOLEAN_VT,
+	ARRAY_VT,
+	OBJECT_VT,
+	FUNCTION_VT,
+	ANY_VT
+};
+
+/**
+ * How a number is held at run time (see the inference of representations).
+ * An INT32_REP value is proven integral and within 32 bits, so its operations
+ * need no check. An INT64_REP value is integral too, but its range is not
+ * proven: the operations that define it check for overflow past 2^53 (where
+ * doubles stop being exact), and fall back to doubles. Any other number is a
+ * DOUBLE_REP, and any other value keeps its tag (TAGGED_REP).
+ */
+enum IrRepresentation {
+	TAGGED_REP,
+	INT32_REP,
+	INT64_REP,
+	DOUBLE_REP
+};
+
+struct IrInstruction {
+	IrOpcode opcode;
+	IrValueType type;
+	IrRepresentation representation;
+	unsigned int block;			   // IR_NONE once the instruction is removed
+	unsigned int operandCount;
+	unsigned int *operands;
+	union {
+		double number;			   // number constant
+		char *string;			   // string constant (lexeme, with quotes)
+		boolean boolean;		   // boolean constant
+		struct {
+			char *name;			   // load, store, call, await
+			unsigned int callee;   // call, await: the function, if statically bound
+		};
+		unsigned int index;		   // parameter, closure (the function)
+		char **keys;			   // object (one per operand)
+		unsigned int targets[2];   // jump, branch
+	};
+};
+
+/**
+ * A basic block. Phi instructions are kept apart, because they are placed
+ * at the entry of the block, but created at any time.
+ */
+struct IrBlock {
+	unsigned int *phis;
+	unsigned int phiCount;
+	unsigned int phiCapacity;
+	unsigned int *instructions;
+	unsigned int instructionCount;
+	unsigned int instructionCapacity;
+	unsigned int *predecessors;
+	unsigned int predecessorCount;
+	unsigned int predecessorCapacity;
+};
+
+/**
+ * A function in SSA form. The instructions and blocks live in flat arrays,
+ * the first block is the entry, and the first instruction of the entry is
+ * always the "undefined" constant.
+ */
+struct IrFunction {
+	char *name;
+	boolean async;
+	unsigned int parent;			// the enclosing function, if any
+	unsigned int parameterCount;
+	IrInstruction *instructions;
+	unsigned int instructionCount;
+	unsigned int instructionCapacity;
+	IrBlock *blocks;
+	unsigned int blockCount;
+	unsigned int blockCapacity;
+};
+
+/**
+ * A whole program. The top-level code is the first function ("$main"). Every
+ * node of the module lives in its arena.
+ */
+struct IrModule {
+	Arena *arena;
+	IrFunction *functions;
+	unsigned int functionCount;
+	unsigned int functionCapacity;
+};
+
+/**
+ * Creates an empty module.
+ */
+IrModule *createIrModule();
+
+/**
+ * Releases a module and all of its functions.
+ */
+void releaseIrModule(IrModule *module);
+
+/**
+ * Appends a new function to the module, and returns its index. Functions,
+ * blocks and instructions are referred by index, because their arrays move
+ * as they grow.
+ */
+unsigned int addIrFunction(IrModule *module, const char *name, const boolean async, const unsigned int parent);
+
+/**
+ * Appends a new (empty) block to the function, and returns its index.
+ */
+unsigned int addIrBlock(IrModule *module, const unsigned int function);
+
+/**
+ * Records that the control flows from one block to another.
+ */
+void addIrEdge(IrModule *module, const unsigned int function, const unsigned int from, const unsigned int to);
+
+/**
+ * Creates an instruction with room for its operands. If the block is not
+ * IR_NONE, the instruction is appended to it (or to its phis). Returns the
+ * index of the instruction, which is also the value it defines.
+ */
+unsigned int addIrInstruction(IrModule *module, const unsigned int function, const unsigned int block, const IrOpcode opcode, const IrValueType type, const unsigned int operandCount);
+
+/**
+ * Writes the blocks that the terminator of a block jumps to, and returns how
+ * many there are (none after a return).
+ */
+unsigned int getIrSuccessors(const IrFunction *function, const unsigned int block, unsigned int successors[2]);
+
+/**
+ * Writes the blocks reachable from the entry in reverse postorder (every
+ * block before its successors, but for back edges), and returns how many
+ * there are. The order must have room for every block.
+ */
+unsigned int orderIrBlocks(const IrFunction *function, unsigned int *order);
+
+/**
+ * Returns true if the opcode ends a block.
+ */
+boolean isIrTerminator(const IrOpcode opcode);
+
+/**
+ * Returns true if the instruction can be removed when its value is unused
+ * (i.e., it has no side effects).
+ */
+boolean isIrPure(const IrOpcode opcode);
+
+/**
+ * Returns the (read-only) name of a representation.
+ */
+const char *irRepresentationName(const IrRepresentation representation);
+
+/**
+ * Returns the (read-only) name of an opcode.
+ */
+const char *irOpcodeName(const IrOpcode opcode);
+
+/**
+ * Prints a readable listing of the module.
+ */
+void printIrModule(FILE *stream, const IrModule *module);
+
+/**
+ * Prints how many times each opcode feeds each other one (an operand and the
+ * instruction that uses it, phis included), from the most to the least
+ * frequent pair. The most frequent pairs are the ones worth selecting as a
+ * single instruction of the target.
+ */
+void printIrPairs(FILE *stream, const IrModule *module);
+
+#endif
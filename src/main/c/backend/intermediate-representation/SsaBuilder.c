@@ -0,0 +1,1358 @@
+#include "SsaBuilder.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializeSsaBuilderModule() {
+	_logger = createLogger("SsaBuilder");
+}
+
+void shutdownSsaBuilderModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The number of buckets of the tables of names (they chain on collision).
+ */
+#define NAME_BUCKETS 256
+
+/**
+ * A source variable of the function being lowered.
+ */
+typedef struct {
+	char *name;
+	IrValueType type;
+	boolean memory;
+} SsaVariable;
+
+/**
+ * An entry of a table of names. Bindings of the same bucket are chained from
+ * the most recent one, so shadowing (and leaving a scope) is a push (a pop).
+ */
+typedef struct {
+	char *name;
+	unsigned int value;
+	unsigned int next;
+} NameEntry;
+
+typedef struct {
+	NameEntry *entries;
+	unsigned int count;
+	unsigned int capacity;
+	unsigned int buckets[NAME_BUCKETS];
+} NameTable;
+
+/**
+ * A phi created on a block whose predecessors are still unknown. Its operands
+ * are added once the block is sealed.
+ */
+typedef struct {
+	unsigned int variable;
+	unsigned int phi;
+	unsigned int next;
+} IncompletePhi;
+
+/**
+ * What the program binds to a name, to tell which calls reach a single
+ * known function.
+ */
+typedef struct {
+	unsigned int declarations;
+	unsigned int writes;
+	unsigned int function;	  // the last closure written to it
+} CallTarget;
+
+/**
+ * A nested function waiting to be lowered.
+ */
+typedef struct {
+	unsigned int function;
+	VariableTypeList *arguments;
+	FunctionBody *body;
+} PendingFunction;
+
+typedef struct {
+	IrModule *module;
+	unsigned int function;
+	unsigned int block;
+	unsigned int depth;
+	// The variables of the function, and the bindings in scope.
+	SsaVariable *variables;
+	unsigned int variableCount;
+	unsigned int variableCapacity;
+	NameTable bindings;
+	// The names that nested functions refer to.
+	NameTable captured;
+	// The return type of every top-level function.
+	NameTable signatures;
+	// The bindings of every name, across the whole program.
+	NameTable targetNames;
+	CallTarget *targets;
+	unsigned int targetCount;
+	unsigned int targetCapacity;
+	// The current definition of every variable on every block.
+	unsigned long long *definitionKeys;
+	unsigned int *definitionValues;
+	unsigned int definitionCount;
+	unsigned int definitionCapacity;
+	// The state of every block, and the replacement of every trivial phi.
+	boolean *sealed;
+	unsigned int *incomplete;
+	unsigned int blockCapacity;
+	IncompletePhi *incompletePhis;
+	unsigned int incompletePhiCount;
+	unsigned int incompletePhiCapacity;
+	unsigned int *forward;
+	unsigned int forwardCapacity;
+	PendingFunction *pending;
+	unsigned int pendingCount;
+	unsigned int pendingCapacity;
+} SsaBuilder;
+
+static unsigned int _addPhiOperands(SsaBuilder *builder, const unsigned int variable, const unsigned int phi);
+static void _bindCalls(SsaBuilder *builder);
+static void _branch(SsaBuilder *builder, const unsigned int condition, const unsigned int thenBlock, const unsigned int elseBlock);
+static void _captureCode(SsaBuilder *builder, Code *code, const boolean nested);
+static void _captureExpression(SsaBuilder *builder, Expression *expression);
+static void _captureFunctionBody(SsaBuilder *builder, FunctionBody *body);
+static void _captureIterable(SsaBuilder *builder, IterableVariable *iterable);
+static void _captureName(SsaBuilder *builder, char *name);
+static void _captureStatement(SsaBuilder *builder, Statement *statement, const boolean nested);
+static void _captureVariable(SsaBuilder *builder, Variable *variable);
+static unsigned int _constant(SsaBuilder *builder, const IrValueType type);
+static unsigned int _declareVariable(SsaBuilder *builder, char *name, const IrValueType type);
+static unsigned int _emit(SsaBuilder *builder, const unsigned int block, const IrOpcode opcode, const IrValueType type, const unsigned int operandCount);
+static void _enterScope(SsaBuilder *builder);
+static void _exitScope(SsaBuilder *builder, const unsigned int mark);
+static unsigned int _findName(NameTable *table, const char *name);
+static void _finishFunction(SsaBuilder *builder);
+static unsigned int _functionClosure(SsaBuilder *builder, char *name, const boolean async, VariableTypeList *arguments, FunctionBody *body);
+static unsigned int _hashName(const char *name);
+static IrValueType _join(const IrValueType type, const IrValueType otherType);
+static void _jump(SsaBuilder *builder, const unsigned int target);
+static unsigned int _lookupDefinition(SsaBuilder *builder, const unsigned int variable, const unsigned int block);
+static unsigned int _lowerArray(SsaBuilder *builder, ArrayContent *arrayContent);
+static unsigned int _lowerCall(SsaBuilder *builder, FunctionCall *functionCall);
+static void _lowerCode(SsaBuilder *builder, Code *code);
+static unsigned int _lowerConstant(SsaBuilder *builder, Constant *constant);
+static unsigned int _lowerExpression(SsaBuilder *builder, Expression *expression);
+static void _lowerForLoop(SsaBuilder *builder, ForLoop *forLoop);
+static void _lowerFunction(SsaBuilder *builder, PendingFunction pending, Code *code);
+static void _lowerIfStatement(SsaBuilder *builder, IfStatement *ifStatement);
+static unsigned int _lowerIterable(SsaBuilder *builder, IterableVariable *iterable);
+static unsigned int _lowerObject(SsaBuilder *builder, ObjectContent *objectContent);
+static unsigned int _lowerReturnValue(SsaBuilder *builder, ReturnValue *returnValue);
+static void _lowerStatement(SsaBuilder *builder, Statement *statement);
+static void _lowerSwitch(SsaBuilder *builder, SwitchStatement *switchStatement);
+static unsigned int _lowerVariableValue(SsaBuilder *builder, Variable *variable);
+static void _lowerWhileLoop(SsaBuilder *builder, WhileLoop *whileLoop);
+static unsigned int _newBlock(SsaBuilder *builder);
+static unsigned int _operation(SsaBuilder *builder, const IrOpcode opcode, const IrValueType type, const unsigned int left, const unsigned int right);
+static void _pushName(NameTable *table, char *name, const unsigned int value);
+static unsigned int _readName(SsaBuilder *builder, char *name);
+static unsigned int _readVariable(SsaBuilder *builder, const unsigned int variable, const unsigned int block);
+static unsigned int _readVariableRecursive(SsaBuilder *builder, const unsigned int variable, const unsigned int block);
+static unsigned int _resolve(SsaBuilder *builder, unsigned int value);
+static void _resetFunctionState(SsaBuilder *builder);
+static void _seal(SsaBuilder *builder, const unsigned int block);
+static unsigned int _tryRemoveTrivialPhi(SsaBuilder *builder, const unsigned int phi);
+static CallTarget *_target(SsaBuilder *builder, char *name);
+static IrValueType _valueType(Type *type);
+static void _writeName(SsaBuilder *builder, char *name, const unsigned int value);
+static void _writeVariable(SsaBuilder *builder, const unsigned int variable, const unsigned int block, const unsigned int value);
+
+/**
+ * Fills the operands of a phi (one per predecessor), and removes it if it
+ * turns out to be trivial.
+ */
+static unsigned int _addPhiOperands(SsaBuilder *builder, const unsigned int variable, const unsigned int phi) {
+	const unsigned int block = builder->module->functions[builder->function].instructions[phi].block;
+	const unsigned int count = builder->module->functions[builder->function].blocks[block].predecessorCount;
+	unsigned int *operands = allocateInArena(builder->module->arena, count * sizeof(unsigned int));
+	IrValueType type = builder->variables[variable].type;
+	for (unsigned int k = 0; k < count; ++k) {
+		const unsigned int predecessor = builder->module->functions[builder->function].blocks[block].predecessors[k];
+		operands[k] = _readVariable(builder, variable, predecessor);
+		if (operands[k] != phi) {
+			type = _join(type, builder->module->functions[builder->function].instructions[operands[k]].type);
+		}
+	}
+	IrInstruction *instruction = &builder->module->functions[builder->function].instructions[phi];
+	instruction->operands = operands;
+	instruction->operandCount = count;
+	instruction->type = type;
+	return _tryRemoveTrivialPhi(builder, phi);
+}
+
+/**
+ * Binds every call to the function that it always reaches: the name is
+ * declared once in the whole program (so no other binding shadows it), and
+ * its only write is that function. The other calls stay dynamic (by name).
+ */
+static void _bindCalls(SsaBuilder *builder) {
+	unsigned int calls = 0;
+	unsigned int bound = 0;
+	for (unsigned int f = 0; f < builder->module->functionCount; ++f) {
+		IrFunction *function = &builder->module->functions[f];
+		for (unsigned int k = 0; k < function->instructionCount; ++k) {
+			IrInstruction *instruction = &function->instructions[k];
+			if (instruction->opcode != CALL_IR && instruction->opcode != AWAIT_IR) {
+				continue;
+			}
+			const unsigned int target = _findName(&builder->targetNames, instruction->name);
+			instruction->callee = IR_NONE;
+			if (target != IR_NONE) {
+				const CallTarget *callTarget = &builder->targets[target];
+				if (callTarget->declarations == 1 && callTarget->writes == 1 && callTarget->function != IR_NONE) {
+					instruction->callee = callTarget->function;
+					++bound;
+				}
+			}
+			++calls;
+		}
+	}
+	logDebugging(_logger, "Bound %u of %u calls statically.", bound, calls);
+}
+
+static void _branch(SsaBuilder *builder, const unsigned int condition, const unsigned int thenBlock, const unsigned int elseBlock) {
+	const unsigned int branch = _emit(builder, builder->block, BRANCH_IR, UNDEFINED_VT, 1);
+	IrInstruction *instruction = &builder->module->functions[builder->function].instructions[branch];
+	instruction->operands[0] = condition;
+	instruction->targets[0] = thenBlock;
+	instruction->targets[1] = elseBlock;
+	addIrEdge(builder->module, builder->function, builder->block, thenBlock);
+	addIrEdge(builder->module, builder->function, builder->block, elseBlock);
+}
+
+/**
+ * Collects the names that the nested functions of the code refer to. Outside
+ * of a nested function only the control structures are inspected.
+ */
+static void _captureCode(SsaBuilder *builder, Code *code, const boolean nested) {
+	for (; code != NULL; code = code->next) {
+		_captureStatement(builder, code->statement, nested);
+	}
+}
+
+static void _captureExpression(SsaBuilder *builder, Expression *expression) {
+	if (expression == NULL) {
+		return;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			if (expression->factor->type == VARIABLE) {
+				_captureName(builder, expression->factor->variableName);
+			}
+			else if (expression->factor->type == EXPRESSION) {
+				_captureExpression(builder, expression->factor->expression);
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			_captureExpression(builder, expression->expression);
+			break;
+		default:
+			_captureExpression(builder, expression->leftExpression);
+			_captureExpression(builder, expression->rightExpression);
+			break;
+	}
+}
+
+static void _captureFunctionBody(SsaBuilder *builder, FunctionBody *body) {
+	if (body == NULL) {
+		return;
+	}
+	_captureCode(builder, body->code, true);
+	ReturnValue *returnValue = body->returnValue;
+	if (returnValue != NULL) {
+		switch (returnValue->type) {
+			case EXPRESSION_RT:
+				_captureExpression(builder, returnValue->expression);
+				break;
+			case FUNCTIONCALL_RT:
+				_captureName(builder, returnValue->functionCall->id);
+				for (ArgumentList *argument = returnValue->functionCall->arguments; argument != NULL; argument = argument->next) {
+					_captureExpression(builder, argument->expression);
+				}
+				break;
+			case ASYNC_FUNCTION_RT:
+				_captureFunctionBody(builder, returnValue->asyncFunction->body);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+static void _captureIterable(SsaBuilder *builder, IterableVariable *iterable) {
+	switch (iterable->type) {
+		case VARIABLE_IT:
+			_captureName(builder, iterable->variableName);
+			break;
+		case FUNCTIONCALL_IT:
+			_captureName(builder, iterable->functionCall->id);
+			for (ArgumentList *argument = iterable->functionCall->arguments; argument != NULL; argument = argument->next) {
+				_captureExpression(builder, argument->expression);
+			}
+			break;
+		case ARRAY_IT:
+			for (ArrayContent *element = iterable->arrayContent; element != NULL; element = element->next) {
+				_captureExpression(builder, element->value);
+			}
+			break;
+		case OBJECT_IT:
+			for (ObjectContent *member = iterable->objectContent; member != NULL; member = member->next) {
+				_captureExpression(builder, member->value);
+			}
+			break;
+	}
+}
+
+static void _captureName(SsaBuilder *builder, char *name) {
+	if (_findName(&builder->captured, name) == IR_NONE) {
+		_pushName(&builder->captured, name, 0);
+	}
+}
+
+static void _captureStatement(SsaBuilder *builder, Statement *statement, const boolean nested) {
+	switch (statement->statement) {
+		case IF_ST:
+			if (nested) {
+				_captureExpression(builder, statement->ifStatement->condition);
+			}
+			_captureCode(builder, statement->ifStatement->thenBody, nested);
+			_captureCode(builder, statement->ifStatement->elseBody, nested);
+			break;
+		case WHILE_ST:
+			if (nested) {
+				_captureExpression(builder, statement->whileLoop->condition);
+			}
+			_captureCode(builder, statement->whileLoop->body, nested);
+			break;
+		case FOR_ST: {
+			ParamsFor *params = statement->forLoop->params;
+			if (nested && params->type == FOR_CLASSIC) {
+				if (params->init != NULL) {
+					_captureVariable(builder, params->init->variable);
+				}
+				_captureExpression(builder, params->condition);
+				_captureExpression(builder, params->updateType == INC_DEC_UT ? params->updateIncDec->expression : params->update);
+			}
+			else if (nested) {
+				_captureIterable(builder, params->iterable);
+			}
+			_captureCode(builder, statement->forLoop->body, nested);
+			break;
+		}
+		case SWITCH_ST:
+			if (nested) {
+				_captureName(builder, statement->switchStatement->id);
+			}
+			for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+				if (nested) {
+					_captureExpression(builder, content->condition);
+				}
+				_captureCode(builder, content->body, nested);
+			}
+			break;
+		case FUNCTION_DECLARATION_ST:
+			_captureFunctionBody(builder, statement->FunctionDeclaration->body);
+			break;
+		case ASYNC_FUNCTION_ST:
+			_captureFunctionBody(builder, statement->asyncFunction->body);
+			break;
+		case DECLARATION_ST:
+			if (nested) {
+				_captureVariable(builder, statement->declaration->variable);
+			}
+			break;
+		case VARIABLE_ST:
+			if (nested) {
+				_captureVariable(builder, statement->variable);
+			}
+			break;
+		case EXPRESSION_ST:
+			if (nested) {
+				_captureExpression(builder, statement->expression);
+			}
+			break;
+		case INC_DEC_ST:
+			if (nested) {
+				_captureExpression(builder, statement->incDec->expression);
+			}
+			break;
+		case FUNCTIONCALL_ST:
+			if (nested) {
+				_captureName(builder, statement->functionCall->id);
+				for (ArgumentList *argument = statement->functionCall->arguments; argument != NULL; argument = argument->next) {
+					_captureExpression(builder, argument->expression);
+				}
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+static void _captureVariable(SsaBuilder *builder, Variable *variable) {
+	_captureName(builder, variable->variableType->id);
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_captureExpression(builder, variable->expression);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				_captureExpression(builder, element->value);
+			}
+			break;
+		case OBJECT_VAR:
+			for (ObjectContent *member = variable->objectContent; member != NULL; member = member->next) {
+				_captureExpression(builder, member->value);
+			}
+			break;
+		case FUNCTIONCALL_VAR:
+			_captureName(builder, variable->functionCall->id);
+			for (ArgumentList *argument = variable->functionCall->arguments; argument != NULL; argument = argument->next) {
+				_captureExpression(builder, argument->expression);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+static unsigned int _constant(SsaBuilder *builder, const IrValueType type) {
+	return _emit(builder, builder->block, CONSTANT_IR, type, 0);
+}
+
+/**
+ * Declares a new variable in the current scope. The bindings of the module
+ * scope and the captured locals live in memory.
+ */
+static unsigned int _declareVariable(SsaBuilder *builder, char *name, const IrValueType type) {
+	if (builder->variableCount == builder->variableCapacity) {
+		builder->variableCapacity = builder->variableCapacity == 0 ? 16 : 2 * builder->variableCapacity;
+		builder->variables = realloc(builder->variables, builder->variableCapacity * sizeof(SsaVariable));
+	}
+	const unsigned int variable = builder->variableCount++;
+	builder->variables[variable].name = name;
+	builder->variables[variable].type = type;
+	builder->variables[variable].memory = (builder->function == 0 && builder->depth == 0) || _findName(&builder->captured, name) != IR_NONE;
+	_pushName(&builder->bindings, name, variable);
+	++_target(builder, name)->declarations;
+	return variable;
+}
+
+static unsigned int _emit(SsaBuilder *builder, const unsigned int block, const IrOpcode opcode, const IrValueType type, const unsigned int operandCount) {
+	const unsigned int value = addIrInstruction(builder->module, builder->function, block, opcode, type, operandCount);
+	if (builder->forwardCapacity <= value) {
+		const unsigned int capacity = builder->forwardCapacity == 0 ? 64 : 2 * builder->forwardCapacity;
+		builder->forward = realloc(builder->forward, capacity * sizeof(unsigned int));
+		builder->forwardCapacity = capacity;
+	}
+	builder->forward[value] = IR_NONE;
+	return value;
+}
+
+static void _enterScope(SsaBuilder *builder) {
+	++builder->depth;
+}
+
+/**
+ * Drops the bindings declared after the mark, restoring the ones they shadow.
+ */
+static void _exitScope(SsaBuilder *builder, const unsigned int mark) {
+	NameTable *table = &builder->bindings;
+	while (mark < table->count) {
+		NameEntry *entry = &table->entries[--table->count];
+		table->buckets[_hashName(entry->name)] = entry->next;
+	}
+	--builder->depth;
+}
+
+/**
+ * Returns the value of the most recent entry of the name, or IR_NONE.
+ */
+static unsigned int _findName(NameTable *table, const char *name) {
+	for (unsigned int k = table->buckets[_hashName(name)]; k != IR_NONE; k = table->entries[k].next) {
+		if (strcmp(table->entries[k].name, name) == 0) {
+			return table->entries[k].value;
+		}
+	}
+	return IR_NONE;
+}
+
+/**
+ * Replaces every use of a removed phi by its final value, and drops the
+ * removed phis from their blocks.
+ */
+static void _finishFunction(SsaBuilder *builder) {
+	IrFunction *function = &builder->module->functions[builder->function];
+	for (unsigned int k = 0; k < function->instructionCount; ++k) {
+		IrInstruction *instruction = &function->instructions[k];
+		for (unsigned int j = 0; j < instruction->operandCount; ++j) {
+			instruction->operands[j] = _resolve(builder, instruction->operands[j]);
+		}
+	}
+	for (unsigned int b = 0; b < function->blockCount; ++b) {
+		IrBlock *block = &function->blocks[b];
+		unsigned int count = 0;
+		for (unsigned int k = 0; k < block->phiCount; ++k) {
+			if (builder->forward[block->phis[k]] == IR_NONE) {
+				block->phis[count++] = block->phis[k];
+			}
+			else {
+				function->instructions[block->phis[k]].block = IR_NONE;
+			}
+		}
+		block->phiCount = count;
+	}
+}
+
+/**
+ * Queues a nested function, and returns the closure that refers to it.
+ */
+static unsigned int _functionClosure(SsaBuilder *builder, char *name, const boolean async, VariableTypeList *arguments, FunctionBody *body) {
+	const unsigned int function = addIrFunction(builder->module, name, async, builder->function);
+	if (builder->pendingCount == builder->pendingCapacity) {
+		builder->pendingCapacity = builder->pendingCapacity == 0 ? 8 : 2 * builder->pendingCapacity;
+		builder->pending = realloc(builder->pending, builder->pendingCapacity * sizeof(PendingFunction));
+	}
+	PendingFunction *pending = &builder->pending[builder->pendingCount++];
+	pending->function = function;
+	pending->arguments = arguments;
+	pending->body = body;
+	const unsigned int closure = _emit(builder, builder->block, CLOSURE_IR, FUNCTION_VT, 0);
+	builder->module->functions[builder->function].instructions[closure].index = function;
+	return closure;
+}
+
+/**
+ * The FNV-1a hash of a name, reduced to a bucket.
+ */
+static unsigned int _hashName(const char *name) {
+	unsigned int hash = 2166136261u;
+	for (; *name != '\0'; ++name) {
+		hash = (hash ^ (unsigned char) *name) * 16777619u;
+	}
+	return hash % NAME_BUCKETS;
+}
+
+static IrValueType _join(const IrValueType type, const IrValueType otherType) {
+	return type == otherType ? type : ANY_VT;
+}
+
+static void _jump(SsaBuilder *builder, const unsigned int target) {
+	const unsigned int jump = _emit(builder, builder->block, JUMP_IR, UNDEFINED_VT, 0);
+	builder->module->functions[builder->function].instructions[jump].targets[0] = target;
+	addIrEdge(builder->module, builder->function, builder->block, target);
+}
+
+/**
+ * Looks the current definition of a variable on a block up, in an open
+ * addressing table keyed by both.
+ */
+static unsigned int _lookupDefinition(SsaBuilder *builder, const unsigned int variable, const unsigned int block) {
+	if (builder->definitionCapacity == 0) {
+		return IR_NONE;
+	}
+	const unsigned long long key = ((unsigned long long) variable << 32 | block) + 1;
+	unsigned int slot = (unsigned int) ((key * 11400714819323198485ull) >> 40) & (builder->definitionCapacity - 1);
+	while (builder->definitionKeys[slot] != 0) {
+		if (builder->definitionKeys[slot] == key) {
+			return builder->definitionValues[slot];
+		}
+		slot = (slot + 1) & (builder->definitionCapacity - 1);
+	}
+	return IR_NONE;
+}
+
+static unsigned int _lowerArray(SsaBuilder *builder, ArrayContent *arrayContent) {
+	unsigned int count = 0;
+	for (ArrayContent *element = arrayContent; element != NULL; element = element->next) {
+		++count;
+	}
+	unsigned int *elements = allocateInArena(builder->module->arena, count * sizeof(unsigned int));
+	count = 0;
+	for (ArrayContent *element = arrayContent; element != NULL; element = element->next) {
+		elements[count++] = _lowerExpression(builder, element->value);
+	}
+	const unsigned int array = _emit(builder, builder->block, ARRAY_IR, ARRAY_VT, 0);
+	builder->module->functions[builder->function].instructions[array].operands = elements;
+	builder->module->functions[builder->function].instructions[array].operandCount = count;
+	return array;
+}
+
+/**
+ * Lowers a call. Its type is the annotated return type of the callee, when
+ * the callee is a top-level function.
+ */
+static unsigned int _lowerCall(SsaBuilder *builder, FunctionCall *functionCall) {
+	unsigned int count = 0;
+	for (ArgumentList *argument = functionCall->arguments; argument != NULL; argument = argument->next) {
+		++count;
+	}
+	unsigned int *arguments = allocateInArena(builder->module->arena, count * sizeof(unsigned int));
+	count = 0;
+	for (ArgumentList *argument = functionCall->arguments; argument != NULL; argument = argument->next) {
+		arguments[count++] = _lowerExpression(builder, argument->expression);
+	}
+	const unsigned int signature = _findName(&builder->signatures, functionCall->id);
+	IrValueType type = ANY_VT;
+	if (signature != IR_NONE) {
+		// Calling an async function (without awaiting it) returns a promise.
+		const boolean async = signature & 0x80000000u;
+		type = async && functionCall->type == CLASSIC_CALL ? OBJECT_VT : (IrValueType) (signature & 0x7FFFFFFFu);
+	}
+	const unsigned int call = _emit(builder, builder->block, functionCall->type == AWAIT_CALL ? AWAIT_IR : CALL_IR, type, 0);
+	IrInstruction *instruction = &builder->module->functions[builder->function].instructions[call];
+	instruction->operands = arguments;
+	instruction->operandCount = count;
+	instruction->name = functionCall->id;
+	return call;
+}
+
+static void _lowerCode(SsaBuilder *builder, Code *code) {
+	for (; code != NULL; code = code->next) {
+		_lowerStatement(builder, code->statement);
+	}
+}
+
+static unsigned int _lowerConstant(SsaBuilder *builder, Constant *constant) {
+	unsigned int value;
+	IrInstruction *instruction;
+	switch (constant->type) {
+		case NUMBER:
+			value = _constant(builder, NUMBER_VT);
+			instruction = &builder->module->functions[builder->function].instructions[value];
+			instruction->number = constant->numberType == FLOATING_NT ? constant->floating : constant->integer;
+			return value;
+		case STRING:
+			value = _constant(builder, STRING_VT);
+			instruction = &builder->module->functions[builder->function].instructions[value];
+			instruction->string = constant->string;
+			return value;
+		case BOOLEAN:
+			value = _constant(builder, BOOLEAN_VT);
+			instruction = &builder->module->functions[builder->function].instructions[value];
+			instruction->boolean = constant->boolean ? true : false;
+			return value;
+		default:
+			return 0;
+	}
+}
+
+static unsigned int _lowerExpression(SsaBuilder *builder, Expression *expression) {
+	switch (expression->type) {
+		case FACTOR:
+			switch (expression->factor->type) {
+				case CONSTANT:
+					return _lowerConstant(builder, expression->factor->constant);
+				case VARIABLE:
+					return _readName(builder, expression->factor->variableName);
+				case EXPRESSION:
+					return _lowerExpression(builder, expression->factor->expression);
+				case FUNCTIONCALL:
+					return _lowerCall(builder, expression->factor->functionCall);
+			}
+			return 0;
+		case NOT_OP:
+			return _operation(builder, NOT_IR, BOOLEAN_VT, _lowerExpression(builder, expression->expression), IR_NONE);
+		case AWAIT_OP:
+			return _lowerExpression(builder, expression->expression);
+		default:
+			break;
+	}
+	const unsigned int left = _lowerExpression(builder, expression->leftExpression);
+	const unsigned int right = _lowerExpression(builder, expression->rightExpression);
+	const IrInstruction *instructions = builder->module->functions[builder->function].instructions;
+	const IrValueType leftType = instructions[left].type;
+	const IrValueType rightType = instructions[right].type;
+	switch (expression->type) {
+		case ADD_OP: {
+			IrValueType type = ANY_VT;
+			if (leftType == STRING_VT || rightType == STRING_VT) {
+				type = STRING_VT;
+			}
+			else if (leftType == NUMBER_VT && rightType == NUMBER_VT) {
+				type = NUMBER_VT;
+			}
+			return _operation(builder, ADD_IR, type, left, right);
+		}
+		case SUB_OP: return _operation(builder, SUB_IR, NUMBER_VT, left, right);
+		case MUL_OP: return _operation(builder, MUL_IR, NUMBER_VT, left, right);
+		case DIV_OP: return _operation(builder, DIV_IR, NUMBER_VT, left, right);
+		case GREATER_OP: return _operation(builder, GREATER_IR, BOOLEAN_VT, left, right);
+		case LESS_OP: return _operation(builder, LESS_IR, BOOLEAN_VT, left, right);
+		case GREATER_EQUAL_OP: return _operation(builder, GREATER_EQUAL_IR, BOOLEAN_VT, left, right);
+		case LESS_EQUAL_OP: return _operation(builder, LESS_EQUAL_IR, BOOLEAN_VT, left, right);
+		case EQUAL_OP: return _operation(builder, EQUAL_IR, BOOLEAN_VT, left, right);
+		case NEQUAL_OP: return _operation(builder, NEQUAL_IR, BOOLEAN_VT, left, right);
+		case STRICT_EQUAL_OP: return _operation(builder, STRICT_EQUAL_IR, BOOLEAN_VT, left, right);
+		case STRICT_NEQUAL_OP: return _operation(builder, STRICT_NEQUAL_IR, BOOLEAN_VT, left, right);
+		case AND_OP: return _operation(builder, AND_IR, _join(leftType, rightType), left, right);
+		case OR_OP: return _operation(builder, OR_IR, _join(leftType, rightType), left, right);
+		default:
+			logError(_logger, "Unknown expression type: %d", expression->type);
+			return 0;
+	}
+}
+
+static void _lowerForLoop(SsaBuilder *builder, ForLoop *forLoop) {
+	ParamsFor *params = forLoop->params;
+	const unsigned int mark = builder->bindings.count;
+	_enterScope(builder);
+	const unsigned int headBlock = _newBlock(builder);
+	const unsigned int bodyBlock = _newBlock(builder);
+	const unsigned int exitBlock = _newBlock(builder);
+	if (params->type == FOR_CLASSIC) {
+		if (params->init != NULL) {
+			Variable *variable = params->init->variable;
+			const unsigned int value = _lowerVariableValue(builder, variable);
+			const IrValueType type = variable->variableType->type == NULL
+				? builder->module->functions[builder->function].instructions[value].type
+				: _valueType(variable->variableType->type);
+			_declareVariable(builder, variable->variableType->id, type);
+			_writeName(builder, variable->variableType->id, value);
+		}
+		_jump(builder, headBlock);
+		builder->block = headBlock;
+		_branch(builder, _lowerExpression(builder, params->condition), bodyBlock, exitBlock);
+		_seal(builder, bodyBlock);
+		builder->block = bodyBlock;
+		const unsigned int bodyMark = builder->bindings.count;
+		_enterScope(builder);
+		_lowerCode(builder, forLoop->body);
+		_exitScope(builder, bodyMark);
+		if (params->updateType == INC_DEC_UT) {
+			Statement statement = {.statement = INC_DEC_ST, .incDec = params->updateIncDec};
+			_lowerStatement(builder, &statement);
+		}
+		else if (params->update != NULL) {
+			_lowerExpression(builder, params->update);
+		}
+	}
+	else {
+		const unsigned int iterator = _operation(builder, ITERATOR_IR, OBJECT_VT, _lowerIterable(builder, params->iterable), IR_NONE);
+		_jump(builder, headBlock);
+		builder->block = headBlock;
+		const unsigned int step = _operation(builder, NEXT_IR, OBJECT_VT, iterator, IR_NONE);
+		_branch(builder, _operation(builder, DONE_IR, BOOLEAN_VT, step, IR_NONE), exitBlock, bodyBlock);
+		_seal(builder, bodyBlock);
+		builder->block = bodyBlock;
+		const unsigned int bodyMark = builder->bindings.count;
+		_enterScope(builder);
+		VariableType *binding = params->value->variable->variableType;
+		const IrValueType type = binding->type == NULL ? ANY_VT : _valueType(binding->type);
+		_declareVariable(builder, binding->id, type);
+		_writeName(builder, binding->id, _operation(builder, VALUE_IR, type, step, IR_NONE));
+		_lowerCode(builder, forLoop->body);
+		_exitScope(builder, bodyMark);
+	}
+	_jump(builder, headBlock);
+	_seal(builder, headBlock);
+	_seal(builder, exitBlock);
+	builder->block = exitBlock;
+	_exitScope(builder, mark);
+}
+
+/**
+ * Lowers the body of a function. The top-level code of the program is the
+ * body of "$main" (without arguments nor return value).
+ */
+static void _lowerFunction(SsaBuilder *builder, PendingFunction pending, Code *code) {
+	builder->function = pending.function;
+	_resetFunctionState(builder);
+	if (pending.body != NULL) {
+		code = pending.body->code;
+		if (pending.body->returnValue != NULL && pending.body->returnValue->type == ASYNC_FUNCTION_RT) {
+			_captureFunctionBody(builder, pending.body->returnValue->asyncFunction->body);
+		}
+	}
+	_captureCode(builder, code, false);
+	builder->block = _newBlock(builder);
+	_seal(builder, builder->block);
+	_constant(builder, UNDEFINED_VT);
+	unsigned int parameter = 0;
+	for (VariableTypeList *argument = pending.arguments; argument != NULL; argument = argument->next, ++parameter) {
+		const IrValueType type = _valueType(argument->variableType->type);
+		const unsigned int value = _emit(builder, builder->block, PARAMETER_IR, type, 0);
+		builder->module->functions[builder->function].instructions[value].index = parameter;
+		_declareVariable(builder, argument->variableType->id, type);
+		_writeName(builder, argument->variableType->id, value);
+	}
+	builder->module->functions[builder->function].parameterCount = parameter;
+	_lowerCode(builder, code);
+	const unsigned int returnValue = pending.body == NULL ? IR_NONE : _lowerReturnValue(builder, pending.body->returnValue);
+	const unsigned int ret = _emit(builder, builder->block, RETURN_IR, UNDEFINED_VT, returnValue == IR_NONE ? 0 : 1);
+	if (returnValue != IR_NONE) {
+		builder->module->functions[builder->function].instructions[ret].operands[0] = returnValue;
+	}
+	_finishFunction(builder);
+}
+
+static void _lowerIfStatement(SsaBuilder *builder, IfStatement *ifStatement) {
+	const unsigned int condition = _lowerExpression(builder, ifStatement->condition);
+	const unsigned int thenBlock = _newBlock(builder);
+	const unsigned int joinBlock = _newBlock(builder);
+	const unsigned int elseBlock = ifStatement->elseBody == NULL ? joinBlock : _newBlock(builder);
+	_branch(builder, condition, thenBlock, elseBlock);
+	_seal(builder, thenBlock);
+	builder->block = thenBlock;
+	unsigned int mark = builder->bindings.count;
+	_enterScope(builder);
+	_lowerCode(builder, ifStatement->thenBody);
+	_exitScope(builder, mark);
+	_jump(builder, joinBlock);
+	if (ifStatement->elseBody != NULL) {
+		_seal(builder, elseBlock);
+		builder->block = elseBlock;
+		mark = builder->bindings.count;
+		_enterScope(builder);
+		_lowerCode(builder, ifStatement->elseBody);
+		_exitScope(builder, mark);
+		_jump(builder, joinBlock);
+	}
+	_seal(builder, joinBlock);
+	builder->block = joinBlock;
+}
+
+static unsigned int _lowerIterable(SsaBuilder *builder, IterableVariable *iterable) {
+	switch (iterable->type) {
+		case VARIABLE_IT:
+			return _readName(builder, iterable->variableName);
+		case FUNCTIONCALL_IT:
+			return _lowerCall(builder, iterable->functionCall);
+		case ARRAY_IT:
+			return _lowerArray(builder, iterable->arrayContent);
+		case OBJECT_IT:
+			return _lowerObject(builder, iterable->objectContent);
+		default:
+			return 0;
+	}
+}
+
+static unsigned int _lowerObject(SsaBuilder *builder, ObjectContent *objectContent) {
+	unsigned int count = 0;
+	for (ObjectContent *member = objectContent; member != NULL; member = member->next) {
+		++count;
+	}
+	unsigned int *values = allocateInArena(builder->module->arena, count * sizeof(unsigned int));
+	char **keys = allocateInArena(builder->module->arena, count * sizeof(char *));
+	count = 0;
+	for (ObjectContent *member = objectContent; member != NULL; member = member->next) {
+		keys[count] = member->key;
+		values[count++] = _lowerExpression(builder, member->value);
+	}
+	const unsigned int object = _emit(builder, builder->block, OBJECT_IR, OBJECT_VT, 0);
+	IrInstruction *instruction = &builder->module->functions[builder->function].instructions[object];
+	instruction->operands = values;
+	instruction->operandCount = count;
+	instruction->keys = keys;
+	return object;
+}
+
+static unsigned int _lowerReturnValue(SsaBuilder *builder, ReturnValue *returnValue) {
+	if (returnValue == NULL) {
+		return IR_NONE;
+	}
+	switch (returnValue->type) {
+		case EXPRESSION_RT:
+			return _lowerExpression(builder, returnValue->expression);
+		case FUNCTIONCALL_RT:
+			return _lowerCall(builder, returnValue->functionCall);
+		case ASYNC_FUNCTION_RT: {
+			AsyncFunction *asyncFunction = returnValue->asyncFunction;
+			return _functionClosure(builder, asyncFunction->id, true, asyncFunction->arguments, asyncFunction->body);
+		}
+		default:
+			return IR_NONE;
+	}
+}
+
+static void _lowerStatement(SsaBuilder *builder, Statement *statement) {
+	switch (statement->statement) {
+		case IF_ST:
+			_lowerIfStatement(builder, statement->ifStatement);
+			break;
+		case WHILE_ST:
+			_lowerWhileLoop(builder, statement->whileLoop);
+			break;
+		case FOR_ST:
+			_lowerForLoop(builder, statement->forLoop);
+			break;
+		case SWITCH_ST:
+			_lowerSwitch(builder, statement->switchStatement);
+			break;
+		case DECLARATION_ST: {
+			Variable *variable = statement->declaration->variable;
+			const unsigned int value = _lowerVariableValue(builder, variable);
+			const IrValueType type = variable->variableType->type == NULL
+				? builder->module->functions[builder->function].instructions[value].type
+				: _valueType(variable->variableType->type);
+			_declareVariable(builder, variable->variableType->id, type);
+			_writeName(builder, variable->variableType->id, value);
+			break;
+		}
+		case VARIABLE_ST:
+			_writeName(builder, statement->variable->variableType->id, _lowerVariableValue(builder, statement->variable));
+			break;
+		case EXPRESSION_ST:
+			_lowerExpression(builder, statement->expression);
+			break;
+		case INC_DEC_ST: {
+			Expression *operand = statement->incDec->expression;
+			if (operand->type == FACTOR && operand->factor->type == VARIABLE) {
+				const unsigned int one = _constant(builder, NUMBER_VT);
+				builder->module->functions[builder->function].instructions[one].number = 1;
+				const IrOpcode opcode = statement->incDec->type == INC_OP ? ADD_IR : SUB_IR;
+				const unsigned int value = _operation(builder, opcode, NUMBER_VT, _readName(builder, operand->factor->variableName), one);
+				_writeName(builder, operand->factor->variableName, value);
+			}
+			else {
+				_lowerExpression(builder, operand);
+			}
+			break;
+		}
+		case FUNCTIONCALL_ST:
+			_lowerCall(builder, statement->functionCall);
+			break;
+		case FUNCTION_DECLARATION_ST: {
+			FunctionDeclaration *function = statement->FunctionDeclaration;
+			const unsigned int closure = _functionClosure(builder, function->id, false, function->arguments, function->body);
+			_declareVariable(builder, function->id, FUNCTION_VT);
+			_writeName(builder, function->id, closure);
+			break;
+		}
+		case ASYNC_FUNCTION_ST: {
+			AsyncFunction *function = statement->asyncFunction;
+			const unsigned int closure = _functionClosure(builder, function->id, true, function->arguments, function->body);
+			_declareVariable(builder, function->id, FUNCTION_VT);
+			_writeName(builder, function->id, closure);
+			break;
+		}
+		case TYPE_DECLARATION_ST: {
+			TypeDeclaration *typeDeclaration = statement->typeDeclaration;
+			if (typeDeclaration->type == TYPE_ENUM) {
+				// An enumeration is a frozen object that maps every member to its ordinal.
+				ObjectContent *members = NULL;
+				ObjectContent **last = &members;
+				unsigned int ordinal = 0;
+				for (ArgumentList *member = typeDeclaration->enumm; member != NULL; member = member->next) {
+					Expression *expression = member->expression;
+					if (expression->type == FACTOR && expression->factor->type == VARIABLE) {
+						Constant *constant = allocateInArena(builder->module->arena, sizeof(Constant));
+						constant->type = NUMBER;
+						constant->numberType = INTEGER_NT;
+						constant->integer = ordinal++;
+						Factor *factor = allocateInArena(builder->module->arena, sizeof(Factor));
+						factor->type = CONSTANT;
+						factor->constant = constant;
+						Expression *value = allocateInArena(builder->module->arena, sizeof(Expression));
+						value->type = FACTOR;
+						value->factor = factor;
+						*last = allocateInArena(builder->module->arena, sizeof(ObjectContent));
+						(*last)->key = expression->factor->variableName;
+						(*last)->value = value;
+						last = &(*last)->next;
+					}
+				}
+				const unsigned int object = _lowerObject(builder, members);
+				_declareVariable(builder, typeDeclaration->id, OBJECT_VT);
+				_writeName(builder, typeDeclaration->id, object);
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+/**
+ * The cases of a switch never fall through, so they lower to a chain of
+ * strict comparisons against the subject.
+ */
+static void _lowerSwitch(SsaBuilder *builder, SwitchStatement *switchStatement) {
+	const unsigned int subject = _readName(builder, switchStatement->id);
+	const unsigned int exitBlock = _newBlock(builder);
+	for (SwitchContent *content = switchStatement->content; content != NULL; content = content->next) {
+		const unsigned int mark = builder->bindings.count;
+		if (content->condition == NULL) {
+			_enterScope(builder);
+			_lowerCode(builder, content->body);
+			_exitScope(builder, mark);
+			break;
+		}
+		const unsigned int test = _operation(builder, STRICT_EQUAL_IR, BOOLEAN_VT, subject, _lowerExpression(builder, content->condition));
+		const unsigned int caseBlock = _newBlock(builder);
+		const unsigned int nextBlock = _newBlock(builder);
+		_branch(builder, test, caseBlock, nextBlock);
+		_seal(builder, caseBlock);
+		_seal(builder, nextBlock);
+		builder->block = caseBlock;
+		_enterScope(builder);
+		_lowerCode(builder, content->body);
+		_exitScope(builder, mark);
+		_jump(builder, exitBlock);
+		builder->block = nextBlock;
+	}
+	_jump(builder, exitBlock);
+	_seal(builder, exitBlock);
+	builder->block = exitBlock;
+}
+
+static unsigned int _lowerVariableValue(SsaBuilder *builder, Variable *variable) {
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			return _lowerExpression(builder, variable->expression);
+		case ARRAY_VAR:
+			return _lowerArray(builder, variable->arrayContent);
+		case OBJECT_VAR:
+			return _lowerObject(builder, variable->objectContent);
+		case FUNCTIONCALL_VAR:
+			return _lowerCall(builder, variable->functionCall);
+		default:
+			return 0;
+	}
+}
+
+static void _lowerWhileLoop(SsaBuilder *builder, WhileLoop *whileLoop) {
+	const unsigned int headBlock = _newBlock(builder);
+	const unsigned int bodyBlock = _newBlock(builder);
+	const unsigned int exitBlock = _newBlock(builder);
+	_jump(builder, headBlock);
+	builder->block = headBlock;
+	_branch(builder, _lowerExpression(builder, whileLoop->condition), bodyBlock, exitBlock);
+	_seal(builder, bodyBlock);
+	builder->block = bodyBlock;
+	const unsigned int mark = builder->bindings.count;
+	_enterScope(builder);
+	_lowerCode(builder, whileLoop->body);
+	_exitScope(builder, mark);
+	_jump(builder, headBlock);
+	_seal(builder, headBlock);
+	_seal(builder, exitBlock);
+	builder->block = exitBlock;
+}
+
+static unsigned int _newBlock(SsaBuilder *builder) {
+	const unsigned int block = addIrBlock(builder->module, builder->function);
+	if (builder->blockCapacity <= block) {
+		const unsigned int capacity = builder->blockCapacity == 0 ? 16 : 2 * builder->blockCapacity;
+		builder->sealed = realloc(builder->sealed, capacity * sizeof(boolean));
+		builder->incomplete = realloc(builder->incomplete, capacity * sizeof(unsigned int));
+		builder->blockCapacity = capacity;
+	}
+	builder->sealed[block] = false;
+	builder->incomplete[block] = IR_NONE;
+	return block;
+}
+
+/**
+ * Emits a unary (if the right operand is IR_NONE) or binary operation.
+ */
+static unsigned int _operation(SsaBuilder *builder, const IrOpcode opcode, const IrValueType type, const unsigned int left, const unsigned int right) {
+	const unsigned int value = _emit(builder, builder->block, opcode, type, right == IR_NONE ? 1 : 2);
+	IrInstruction *instruction = &builder->module->functions[builder->function].instructions[value];
+	instruction->operands[0] = left;
+	if (right != IR_NONE) {
+		instruction->operands[1] = right;
+	}
+	return value;
+}
+
+static void _pushName(NameTable *table, char *name, const unsigned int value) {
+	if (table->count == table->capacity) {
+		table->capacity = table->capacity == 0 ? 32 : 2 * table->capacity;
+		table->entries = realloc(table->entries, table->capacity * sizeof(NameEntry));
+	}
+	const unsigned int bucket = _hashName(name);
+	NameEntry *entry = &table->entries[table->count];
+	entry->name = name;
+	entry->value = value;
+	entry->next = table->buckets[bucket];
+	table->buckets[bucket] = table->count++;
+}
+
+/**
+ * Reads a name: an SSA value if it is a local of the function, or a load
+ * from memory otherwise.
+ */
+static unsigned int _readName(SsaBuilder *builder, char *name) {
+	const unsigned int variable = _findName(&builder->bindings, name);
+	if (variable != IR_NONE && !builder->variables[variable].memory) {
+		return _readVariable(builder, variable, builder->block);
+	}
+	IrValueType type = ANY_VT;
+	if (variable != IR_NONE) {
+		type = builder->variables[variable].type;
+	}
+	else if (_findName(&builder->signatures, name) != IR_NONE) {
+		type = FUNCTION_VT;
+	}
+	const unsigned int load = _emit(builder, builder->block, LOAD_IR, type, 0);
+	builder->module->functions[builder->function].instructions[load].name = name;
+	return load;
+}
+
+static unsigned int _readVariable(SsaBuilder *builder, const unsigned int variable, const unsigned int block) {
+	const unsigned int value = _lookupDefinition(builder, variable, block);
+	if (value != IR_NONE) {
+		return _resolve(builder, value);
+	}
+	return _readVariableRecursive(builder, variable, block);
+}
+
+/**
+ * Looks a definition up through the predecessors of a block, placing phis
+ * where the control flow joins (Braun et al., "Simple and Efficient
+ * Construction of Static Single Assignment Form", 2013).
+ */
+static unsigned int _readVariableRecursive(SsaBuilder *builder, const unsigned int variable, const unsigned int block) {
+	const IrBlock *irBlock = &builder->module->functions[builder->function].blocks[block];
+	unsigned int value;
+	if (!builder->sealed[block]) {
+		value = _emit(builder, block, PHI_IR, builder->variables[variable].type, 0);
+		if (builder->incompletePhiCount == builder->incompletePhiCapacity) {
+			builder->incompletePhiCapacity = builder->incompletePhiCapacity == 0 ? 16 : 2 * builder->incompletePhiCapacity;
+			builder->incompletePhis = realloc(builder->incompletePhis, builder->incompletePhiCapacity * sizeof(IncompletePhi));
+		}
+		IncompletePhi *incompletePhi = &builder->incompletePhis[builder->incompletePhiCount];
+		incompletePhi->variable = variable;
+		incompletePhi->phi = value;
+		incompletePhi->next = builder->incomplete[block];
+		builder->incomplete[block] = builder->incompletePhiCount++;
+	}
+	else if (irBlock->predecessorCount == 0) {
+		// Read before any definition: the variable is still undefined.
+		value = 0;
+	}
+	else if (irBlock->predecessorCount == 1) {
+		value = _readVariable(builder, variable, irBlock->predecessors[0]);
+	}
+	else {
+		value = _emit(builder, block, PHI_IR, builder->variables[variable].type, 0);
+		_writeVariable(builder, variable, block, value);
+		value = _addPhiOperands(builder, variable, value);
+	}
+	_writeVariable(builder, variable, block, value);
+	return value;
+}
+
+/**
+ * Follows the replacements of the removed phis (compressing the path).
+ */
+static unsigned int _resolve(SsaBuilder *builder, unsigned int value) {
+	unsigned int root = value;
+	while (builder->forward[root] != IR_NONE) {
+		root = builder->forward[root];
+	}
+	while (builder->forward[value] != IR_NONE) {
+		const unsigned int next = builder->forward[value];
+		builder->forward[value] = root;
+		value = next;
+	}
+	return root;
+}
+
+static void _resetFunctionState(SsaBuilder *builder) {
+	builder->depth = 0;
+	builder->variableCount = 0;
+	builder->bindings.count = 0;
+	memset(builder->bindings.buckets, 0xFF, sizeof(builder->bindings.buckets));
+	builder->captured.count = 0;
+	memset(builder->captured.buckets, 0xFF, sizeof(builder->captured.buckets));
+	builder->definitionCount = 0;
+	if (builder->definitionKeys != NULL) {
+		memset(builder->definitionKeys, 0, builder->definitionCapacity * sizeof(unsigned long long));
+	}
+	builder->incompletePhiCount = 0;
+}
+
+/**
+ * Seals a block once all of its predecessors are known, completing the phis
+ * that were created while they were not.
+ */
+static void _seal(SsaBuilder *builder, const unsigned int block) {
+	for (unsigned int k = builder->incomplete[block]; k != IR_NONE; k = builder->incompletePhis[k].next) {
+		_addPhiOperands(builder, builder->incompletePhis[k].variable, builder->incompletePhis[k].phi);
+	}
+	builder->incomplete[block] = IR_NONE;
+	builder->sealed[block] = true;
+}
+
+/**
+ * A phi is trivial if it merges a single value (besides itself). Then it is
+ * replaced by that value.
+ */
+static unsigned int _tryRemoveTrivialPhi(SsaBuilder *builder, const unsigned int phi) {
+	const IrInstruction *instruction = &builder->module->functions[builder->function].instructions[phi];
+	unsigned int same = IR_NONE;
+	for (unsigned int k = 0; k < instruction->operandCount; ++k) {
+		const unsigned int operand = _resolve(builder, instruction->operands[k]);
+		if (operand == same || operand == phi) {
+			continue;
+		}
+		if (same != IR_NONE) {
+			return phi;
+		}
+		same = operand;
+	}
+	if (same == IR_NONE) {
+		same = 0;
+	}
+	builder->forward[phi] = same;
+	return same;
+}
+
+static CallTarget *_target(SsaBuilder *builder, char *name) {
+	unsigned int target = _findName(&builder->targetNames, name);
+	if (target == IR_NONE) {
+		if (builder->targetCount == builder->targetCapacity) {
+			builder->targetCapacity = builder->targetCapacity == 0 ? 32 : 2 * builder->targetCapacity;
+			builder->targets = realloc(builder->targets, builder->targetCapacity * sizeof(CallTarget));
+		}
+		target = builder->targetCount++;
+		builder->targets[target].declarations = 0;
+		builder->targets[target].writes = 0;
+		builder->targets[target].function = IR_NONE;
+		_pushName(&builder->targetNames, name, target);
+	}
+	return &builder->targets[target];
+}
+
+static IrValueType _valueType(Type *type) {
+	if (type == NULL || type->next != NULL) {
+		return ANY_VT;
+	}
+	switch (type->singleType) {
+		case NUMBER:
+			return NUMBER_VT;
+		case STRING:
+			return STRING_VT;
+		case BOOLEAN:
+			return BOOLEAN_VT;
+		case UNDEFINED:
+		case VOID:
+			return UNDEFINED_VT;
+		case NBR_ARRAY:
+		case STR_ARRAY:
+		case BOOL_ARRAY:
+		case ANY_ARRAY:
+		case VOID_ARRAY:
+		case UNDEF_ARRAY:
+		case NEVER_ARRAY:
+		case UNK_ARRAY:
+			return ARRAY_VT;
+		default:
+			return ANY_VT;
+	}
+}
+
+/**
+ * Writes a name: a new SSA definition if it is a local of the function, or a
+ * store to memory otherwise.
+ */
+static void _writeName(SsaBuilder *builder, char *name, const unsigned int value) {
+	CallTarget *target = _target(builder, name);
+	const IrInstruction *instructions = builder->module->functions[builder->function].instructions;
+	++target->writes;
+	target->function = value != IR_NONE && instructions[value].opcode == CLOSURE_IR ? instructions[value].index : IR_NONE;
+	const unsigned int variable = _findName(&builder->bindings, name);
+	if (variable != IR_NONE && !builder->variables[variable].memory) {
+		_writeVariable(builder, variable, builder->block, value);
+	}
+	else {
+		const unsigned int store = _emit(builder, builder->block, STORE_IR, UNDEFINED_VT, 1);
+		IrInstruction *instruction = &builder->module->functions[builder->function].instructions[store];
+		instruction->operands[0] = value;
+		instruction->name = name;
+	}
+}
+
+static void _writeVariable(SsaBuilder *builder, const unsigned int variable, const unsigned int block, const unsigned int value) {
+	if (builder->definitionCapacity <= 2 * (builder->definitionCount + 1)) {
+		const unsigned int capacity = builder->definitionCapacity == 0 ? 64 : 2 * builder->definitionCapacity;
+		unsigned long long *keys = builder->definitionKeys;
+		unsigned int *values = builder->definitionValues;
+		const unsigned int oldCapacity = builder->definitionCapacity;
+		builder->definitionKeys = calloc(capacity, sizeof(unsigned long long));
+		builder->definitionValues = calloc(capacity, sizeof(unsigned int));
+		builder->definitionCapacity = capacity;
+		builder->definitionCount = 0;
+		for (unsigned int k = 0; k < oldCapacity; ++k) {
+			if (keys[k] != 0) {
+				const unsigned long long key = keys[k] - 1;
+				_writeVariable(builder, (unsigned int) (key >> 32), (unsigned int) key, values[k]);
+			}
+		}
+		free(keys);
+		free(values);
+	}
+	const unsigned long long key = ((unsigned long long) variable << 32 | block) + 1;
+	unsigned int slot = (unsigned int) ((key * 11400714819323198485ull) >> 40) & (builder->definitionCapacity - 1);
+	while (builder->definitionKeys[slot] != 0 && builder->definitionKeys[slot] != key) {
+		slot = (slot + 1) & (builder->definitionCapacity - 1);
+	}
+	if (builder->definitionKeys[slot] == 0) {
+		builder->definitionKeys[slot] = key;
+		++builder->definitionCount;
+	}
+	builder->definitionValues[slot] = value;
+}
+
+/** PUBLIC FUNCTIONS */
+
+IrModule *buildIrModule(Program *program) {
+	SsaBuilder builder;
+	memset(&builder, 0, sizeof(SsaBuilder));
+	builder.module = createIrModule();
+	memset(builder.signatures.buckets, 0xFF, sizeof(builder.signatures.buckets));
+	memset(builder.targetNames.buckets, 0xFF, sizeof(builder.targetNames.buckets));
+	// The return type of every top-level function (the top bit flags async ones).
+	for (Code *code = program->code; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		if (statement->statement == FUNCTION_DECLARATION_ST) {
+			_pushName(&builder.signatures, statement->FunctionDeclaration->id, _valueType(statement->FunctionDeclaration->returnType));
+		}
+		else if (statement->statement == ASYNC_FUNCTION_ST) {
+			PromiseReturnType *promise = statement->asyncFunction->promiseReturnType;
+			_pushName(&builder.signatures, statement->asyncFunction->id, 0x80000000u | _valueType(promise == NULL ? NULL : promise->type));
+		}
+	}
+	PendingFunction mainFunction = {
+		.function = addIrFunction(builder.module, "$main", false, IR_NONE),
+		.arguments = NULL,
+		.body = NULL};
+	_lowerFunction(&builder, mainFunction, program->code);
+	for (unsigned int k = 0; k < builder.pendingCount; ++k) {
+		_lowerFunction(&builder, builder.pending[k], NULL);
+	}
+	_bindCalls(&builder);
+	unsigned int blocks = 0;
+	unsigned int instructions = 0;
+	for (unsigned int k = 0; k < builder.module->functionCount; ++k) {
+		blocks += builder.module->functions[k].blockCount;
+		instructions += builder.module->functions[k].instructionCount;
+	}
+	logDebugging(_logger, "IR built: %u functions, %u blocks, %u instructions.", builder.module->functionCount, blocks, instructions);
+	free(builder.variables);
+	free(builder.bindings.entries);
+	free(builder.captured.entries);
+	free(builder.signatures.entries);
+	free(builder.targetNames.entries);
+	free(builder.targets);
+	free(builder.definitionKeys);
+	free(builder.definitionValues);
+	free(builder.sealed);
+	free(builder.incomplete);
+	free(builder.incompletePhis);
+	free(builder.forward);
+	free(builder.pending);
+	return builder.module;
+}
@@ -0,0 +1,28 @@
+#ifndef SSA_BUILDER_HEADER
+#define SSA_BUILDER_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "IntermediateRepresentation.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeSsaBuilderModule();
+
+/** Shutdown module's internal state. */
+void shutdownSsaBuilderModule();
+
+/**
+ * Lowers a program into an IR module in SSA form, in a single walk over the
+ * AST. The top-level code becomes the function "$main", and every nested
+ * function is lowered on its own afterwards.
+ *
+ * Locals become SSA values. The bindings of the module scope, and the locals
+ * captured by nested functions, live in memory instead (load and store by
+ * name), because other functions can observe them.
+ */
+IrModule *buildIrModule(Program *program);
+
+#endif
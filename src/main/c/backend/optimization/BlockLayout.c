@@ -0,0 +1,192 @@
+#include "BlockLayout.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializeBlockLayoutModule() {
+	_logger = createLogger("BlockLayout");
+}
+
+void shutdownBlockLayoutModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The most cases of a switch that are reordered.
+ */
+#define MAXIMUM_REORDERED_CASES 64
+
+/**
+ * The state of a single run of the pass.
+ */
+typedef struct {
+	const Profile *profile;
+	unsigned int nodes;
+	unsigned int inverted;
+	unsigned int reordered;
+} Layout;
+
+static boolean _distinctLiterals(const Expression *expression, const Expression *other);
+static void _invert(Layout *layout, IfStatement *ifStatement);
+static void _layoutCode(Layout *layout, Code *code);
+static void _reorder(Layout *layout, SwitchStatement *switchStatement);
+
+/**
+ * True if both expressions are literals that can never be strictly equal.
+ * Strings with escapes are compared by their text, so they are assumed to
+ * be possibly equal.
+ */
+static boolean _distinctLiterals(const Expression *expression, const Expression *other) {
+	if (expression->type != FACTOR || expression->factor->type != CONSTANT || other->type != FACTOR || other->factor->type != CONSTANT) {
+		return false;
+	}
+	const Constant *constant = expression->factor->constant;
+	const Constant *otherConstant = other->factor->constant;
+	if (constant->type != otherConstant->type) {
+		return true;
+	}
+	switch (constant->type) {
+		case NUMBER: {
+			const double value = constant->numberType == INTEGER_NT ? constant->integer : constant->floating;
+			const double otherValue = otherConstant->numberType == INTEGER_NT ? otherConstant->integer : otherConstant->floating;
+			return value != otherValue;
+		}
+		case STRING:
+			return strchr(constant->string, '\\') == NULL && strchr(otherConstant->string, '\\') == NULL
+				&& strcmp(constant->string, otherConstant->string) != 0;
+		case BOOLEAN:
+			return constant->boolean != otherConstant->boolean;
+		default:
+			return false;
+	}
+}
+
+/**
+ * Swaps the bodies of an if statement whose else body is hotter, and negates
+ * its condition (removing a negation, if it has one). The counts of its site
+ * follow the bodies.
+ */
+static void _invert(Layout *layout, IfStatement *ifStatement) {
+	ProfileSite *site = findMeasuredSite(layout->profile, ifStatement);
+	if (site == NULL || ifStatement->elseBody == NULL || site->counts[1] <= site->counts[0]) {
+		return;
+	}
+	Expression *condition = ifStatement->condition;
+	if (condition->type == NOT_OP) {
+		ifStatement->condition = condition->expression;
+	}
+	else {
+		Expression *negation = allocateNode(sizeof(Expression));
+		negation->type = NOT_OP;
+		negation->expression = condition;
+		ifStatement->condition = negation;
+	}
+	Code *thenBody = ifStatement->thenBody;
+	ifStatement->thenBody = ifStatement->elseBody;
+	ifStatement->elseBody = thenBody;
+	const double thenCount = site->counts[0];
+	site->counts[0] = site->counts[1];
+	site->counts[1] = thenCount;
+	++layout->inverted;
+}
+
+static void _layoutCode(Layout *layout, Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		++layout->nodes;
+		switch (statement->statement) {
+			case IF_ST:
+				_invert(layout, statement->ifStatement);
+				_layoutCode(layout, statement->ifStatement->thenBody);
+				_layoutCode(layout, statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_layoutCode(layout, statement->whileLoop->body);
+				break;
+			case FOR_ST:
+				_layoutCode(layout, statement->forLoop->body);
+				break;
+			case SWITCH_ST:
+				_reorder(layout, statement->switchStatement);
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_layoutCode(layout, content->body);
+				}
+				break;
+			case FUNCTION_DECLARATION_ST:
+				if (statement->FunctionDeclaration->body != NULL) {
+					_layoutCode(layout, statement->FunctionDeclaration->body->code);
+				}
+				break;
+			case ASYNC_FUNCTION_ST:
+				if (statement->asyncFunction->body != NULL) {
+					_layoutCode(layout, statement->asyncFunction->body->code);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * Sorts the cases of a switch by their runs (stably, so ties keep the order
+ * of the source). Every case ends with a break, so none falls through into
+ * its neighbour.
+ */
+static void _reorder(Layout *layout, SwitchStatement *switchStatement) {
+	SwitchContent *cases[MAXIMUM_REORDERED_CASES];
+	unsigned int count = 0;
+	SwitchContent *content = switchStatement->content;
+	for (; content != NULL && content->condition != NULL; content = content->next) {
+		if (count == MAXIMUM_REORDERED_CASES || findMeasuredSite(layout->profile, content) == NULL) {
+			return;
+		}
+		for (unsigned int k = 0; k < count; ++k) {
+			if (!_distinctLiterals(cases[k]->condition, content->condition)) {
+				return;
+			}
+		}
+		cases[count++] = content;
+	}
+	SwitchContent *defaultCase = content;
+	boolean changed = false;
+	for (unsigned int k = 1; k < count; ++k) {
+		SwitchContent *current = cases[k];
+		const double runs = findMeasuredSite(layout->profile, current)->counts[0];
+		unsigned int j = k;
+		for (; 0 < j && findMeasuredSite(layout->profile, cases[j - 1])->counts[0] < runs; --j) {
+			cases[j] = cases[j - 1];
+		}
+		cases[j] = current;
+		changed |= j != k;
+	}
+	if (!changed) {
+		return;
+	}
+	for (unsigned int k = 0; k < count; ++k) {
+		cases[k]->next = k + 1 < count ? cases[k + 1] : defaultCase;
+	}
+	switchStatement->content = cases[0];
+	logDebugging(_logger, "The cases of the switch over \"%s\" are reordered by frequency.", switchStatement->id);
+	++layout->reordered;
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult layoutHotPaths(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	Layout layout = {.profile = compilerState->profile, .nodes = 0, .inverted = 0, .reordered = 0};
+	if (layout.profile == NULL || !layout.profile->measured) {
+		PassResult result = {.nodes = 0, .changed = false};
+		return result;
+	}
+	_layoutCode(&layout, program->code);
+	logDebugging(_logger, "Inverted %u if statements, and reordered %u switches.", layout.inverted, layout.reordered);
+	PassResult result = {.nodes = layout.nodes, .changed = 0 < layout.inverted + layout.reordered};
+	return result;
+}
@@ -0,0 +1,28 @@
+#ifndef BLOCK_LAYOUT_HEADER
+#define BLOCK_LAYOUT_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "PassManager.h"
+#include "Profiling.h"
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeBlockLayoutModule();
+
+/** Shutdown module's internal state. */
+void shutdownBlockLayoutModule();
+
+/**
+ * Lays out the code along the hot paths of a profile (see Profiling). An if
+ * statement whose else body ran more often than its then body is inverted,
+ * so the hot body comes first (and falls through, once lowered). The cases
+ * of a switch are tested from the most to the least frequent, if they are
+ * distinct literals (so the same case matches in any order), and the
+ * default stays last. Without a profile, nothing changes.
+ */
+PassResult layoutHotPaths(CompilerState *compilerState);
+
+#endif
@@ -0,0 +1,514 @@
+#include "ConstantFolding.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializeConstantFoldingModule() {
+	_logger = createLogger("ConstantFolding");
+}
+
+void shutdownConstantFoldingModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The state of a single run of the pass.
+ */
+typedef struct {
+	unsigned int nodes;
+	unsigned int folded;
+} Folding;
+
+static boolean _declaresBindings(const Code *code);
+static boolean _foldBinary(Expression *expression);
+static unsigned int _foldConcatenation(Expression *expression);
+static void _foldCode(Folding *folding, Code **code);
+static void _foldFunctionBody(Folding *folding, FunctionBody *body);
+static void _foldStatement(Folding *folding, Code **code);
+static void _foldVariable(Folding *folding, Variable *variable);
+static Constant *_literal(const Expression *expression, const DataType type);
+static void _replaceWithBoolean(Expression *expression, const boolean value);
+static boolean _replaceWithInteger(Expression *expression, const long long value);
+static void _replaceWithString(Expression *expression, const char *lexeme);
+static Code *_splice(Code *replacement, Code *next);
+
+/**
+ * True if the code declares a binding directly in its own block, so that it
+ * cannot be moved into the enclosing block.
+ */
+static boolean _declaresBindings(const Code *code) {
+	for (; code != NULL; code = code->next) {
+		switch (code->statement->statement) {
+			case DECLARATION_ST:
+			case FUNCTION_DECLARATION_ST:
+			case ASYNC_FUNCTION_ST:
+			case TYPE_DECLARATION_ST:
+				return true;
+			default:
+				break;
+		}
+	}
+	return false;
+}
+
+/**
+ * Folds a binary (or unary) operation whose operands are already folded.
+ * Returns true if the expression became a literal (or one of its operands).
+ */
+static boolean _foldBinary(Expression *expression) {
+	if (expression->type == NOT_OP) {
+		const Constant *operand = _literal(expression->expression, BOOLEAN);
+		if (operand != NULL) {
+			_replaceWithBoolean(expression, !operand->boolean);
+			return true;
+		}
+		return false;
+	}
+	if (expression->type == AWAIT_OP) {
+		return false;
+	}
+	// A literal on the left decides a logical operation on its own.
+	if (expression->type == AND_OP || expression->type == OR_OP) {
+		const Constant *left = _literal(expression->leftExpression, BOOLEAN);
+		if (left == NULL) {
+			return false;
+		}
+		if ((expression->type == AND_OP) == (left->boolean != 0)) {
+			*expression = *expression->rightExpression;
+		}
+		else {
+			_replaceWithBoolean(expression, left->boolean);
+		}
+		return true;
+	}
+	const Constant *leftInteger = _literal(expression->leftExpression, NUMBER);
+	const Constant *rightInteger = _literal(expression->rightExpression, NUMBER);
+	if (leftInteger != NULL && rightInteger != NULL) {
+		const long long left = leftInteger->integer;
+		const long long right = rightInteger->integer;
+		switch (expression->type) {
+			case ADD_OP:
+				return _replaceWithInteger(expression, left + right);
+			case SUB_OP:
+				return _replaceWithInteger(expression, left - right);
+			case MUL_OP:
+				// A negative zero has no integer literal.
+				if (left * right == 0 && (left < 0 || right < 0)) {
+					return false;
+				}
+				return _replaceWithInteger(expression, left * right);
+			case DIV_OP:
+				if (right == 0 || left % right != 0 || (left == 0 && right < 0)) {
+					return false;
+				}
+				return _replaceWithInteger(expression, left / right);
+			case GREATER_OP:
+				_replaceWithBoolean(expression, left > right);
+				return true;
+			case LESS_OP:
+				_replaceWithBoolean(expression, left < right);
+				return true;
+			case GREATER_EQUAL_OP:
+				_replaceWithBoolean(expression, left >= right);
+				return true;
+			case LESS_EQUAL_OP:
+				_replaceWithBoolean(expression, left <= right);
+				return true;
+			case EQUAL_OP:
+			case STRICT_EQUAL_OP:
+				_replaceWithBoolean(expression, left == right);
+				return true;
+			case NEQUAL_OP:
+			case STRICT_NEQUAL_OP:
+				_replaceWithBoolean(expression, left != right);
+				return true;
+			default:
+				return false;
+		}
+	}
+	const Constant *leftBoolean = _literal(expression->leftExpression, BOOLEAN);
+	const Constant *rightBoolean = _literal(expression->rightExpression, BOOLEAN);
+	if (leftBoolean != NULL && rightBoolean != NULL) {
+		const boolean equal = (leftBoolean->boolean != 0) == (rightBoolean->boolean != 0);
+		switch (expression->type) {
+			case EQUAL_OP:
+			case STRICT_EQUAL_OP:
+				_replaceWithBoolean(expression, equal);
+				return true;
+			case NEQUAL_OP:
+			case STRICT_NEQUAL_OP:
+				_replaceWithBoolean(expression, !equal);
+				return true;
+			default:
+				return false;
+		}
+	}
+	// Literals are interned, so equal lexemes are the same pointer. Different
+	// lexemes denote different strings unless an escape (or the delimiter)
+	// spells the same characters in another way.
+	const Constant *leftString = _literal(expression->leftExpression, STRING);
+	const Constant *rightString = _literal(expression->rightExpression, STRING);
+	if (leftString != NULL && rightString != NULL) {
+		const boolean same = leftString->string == rightString->string;
+		if (!same && (leftString->string[0] != rightString->string[0] || strchr(leftString->string, '\\') != NULL || strchr(rightString->string, '\\') != NULL)) {
+			return false;
+		}
+		switch (expression->type) {
+			case EQUAL_OP:
+			case STRICT_EQUAL_OP:
+				_replaceWithBoolean(expression, same);
+				return true;
+			case NEQUAL_OP:
+			case STRICT_NEQUAL_OP:
+				_replaceWithBoolean(expression, !same);
+				return true;
+			default:
+				return false;
+		}
+	}
+	return false;
+}
+
+/**
+ * Folds a chain of additions ("x + a + b + ..."), which is parsed as a left
+ * spine. The operands are folded first, then every addition of two numbers,
+ * and at last every run of adjacent string literals (with the same delimiter)
+ * becomes a single literal. A run can follow any operand, because "x + a + b"
+ * and "x + (a + b)" build the same string when "a" and "b" are strings. Each
+ * run is copied once, so a long chain is folded in linear time (merging one
+ * pair at a time would copy the growing prefix again on every step).
+ */
+static unsigned int _foldConcatenation(Expression *expression) {
+	unsigned int count = 0;
+	for (Expression *node = expression; node->type == ADD_OP; node = node->leftExpression) {
+		++count;
+	}
+	Expression **spine = malloc(count * sizeof(Expression *));
+	Expression **operands = malloc((count + 1) * sizeof(Expression *));
+	Expression *node = expression;
+	for (unsigned int k = 0; k < count; ++k, node = node->leftExpression) {
+		spine[k] = node;
+	}
+	unsigned int folded = foldExpression(spine[count - 1]->leftExpression);
+	for (unsigned int k = 0; k < count; ++k) {
+		folded += foldExpression(spine[k]->rightExpression);
+	}
+	for (unsigned int k = count; 0 < k; --k) {
+		folded += _foldBinary(spine[k - 1]) ? 1 : 0;
+	}
+	// The spine may be shorter now, so its operands are collected again.
+	count = 0;
+	for (node = expression; node->type == ADD_OP; node = node->leftExpression) {
+		spine[count++] = node;
+	}
+	if (count == 0) {
+		free(operands);
+		free(spine);
+		return folded;
+	}
+	operands[0] = spine[count - 1]->leftExpression;
+	for (unsigned int k = 1; k <= count; ++k) {
+		operands[k] = spine[count - k]->rightExpression;
+	}
+	unsigned int kept = 0;
+	for (unsigned int first = 0; first <= count;) {
+		const Constant *string = _literal(operands[first], STRING);
+		unsigned int last = first;
+		size_t length = string == NULL ? 0 : strlen(string->string);
+		while (string != NULL && last < count) {
+			const Constant *next = _literal(operands[last + 1], STRING);
+			if (next == NULL || next->string[0] != string->string[0]) {
+				break;
+			}
+			length += strlen(next->string) - 2;
+			++last;
+		}
+		if (first < last) {
+			char *lexeme = malloc(length + 1);
+			size_t offset = 0;
+			for (unsigned int k = first; k <= last; ++k) {
+				const char *part = _literal(operands[k], STRING)->string;
+				const size_t partLength = strlen(part);
+				const size_t skip = k == first ? 0 : 1;
+				const size_t drop = k == last ? 0 : 1;
+				memcpy(lexeme + offset, part + skip, partLength - skip - drop);
+				offset += partLength - skip - drop;
+			}
+			lexeme[offset] = '\0';
+			_replaceWithString(operands[first], lexeme);
+			free(lexeme);
+			folded += last - first;
+		}
+		operands[kept++] = operands[first];
+		first = last + 1;
+	}
+	if (kept == 1) {
+		*expression = *operands[0];
+	}
+	else {
+		for (unsigned int k = 0; k + 1 < kept; ++k) {
+			spine[k]->rightExpression = operands[kept - 1 - k];
+			spine[k]->leftExpression = k + 2 == kept ? operands[0] : spine[k + 1];
+		}
+	}
+	free(operands);
+	free(spine);
+	return folded;
+}
+
+static void _foldCode(Folding *folding, Code **code) {
+	while (*code != NULL) {
+		Code *current = *code;
+		_foldStatement(folding, code);
+		// The statement was replaced, so its replacement is folded again.
+		if (*code != current) {
+			continue;
+		}
+		code = &(*code)->next;
+	}
+}
+
+static void _foldFunctionBody(Folding *folding, FunctionBody *body) {
+	if (body == NULL) {
+		return;
+	}
+	_foldCode(folding, &body->code);
+	ReturnValue *returnValue = body->returnValue;
+	if (returnValue != NULL) {
+		if (returnValue->type == EXPRESSION_RT) {
+			folding->folded += foldExpression(returnValue->expression);
+		}
+		else if (returnValue->type == FUNCTIONCALL_RT) {
+			for (ArgumentList *argument = returnValue->functionCall->arguments; argument != NULL; argument = argument->next) {
+				folding->folded += foldExpression(argument->expression);
+			}
+		}
+		else if (returnValue->type == ASYNC_FUNCTION_RT) {
+			_foldFunctionBody(folding, returnValue->asyncFunction->body);
+		}
+	}
+}
+
+/**
+ * Folds the statement at the head of the code. A branch with a literal
+ * condition is replaced (in the list) by the statements that would run.
+ */
+static void _foldStatement(Folding *folding, Code **code) {
+	Statement *statement = (*code)->statement;
+	++folding->nodes;
+	switch (statement->statement) {
+		case IF_ST: {
+			IfStatement *ifStatement = statement->ifStatement;
+			folding->folded += foldExpression(ifStatement->condition);
+			const Constant *condition = _literal(ifStatement->condition, BOOLEAN);
+			if (condition != NULL) {
+				Code *body = condition->boolean ? ifStatement->thenBody : ifStatement->elseBody;
+				if (!_declaresBindings(body)) {
+					*code = _splice(body, (*code)->next);
+					++folding->folded;
+					return;
+				}
+			}
+			_foldCode(folding, &ifStatement->thenBody);
+			_foldCode(folding, &ifStatement->elseBody);
+			break;
+		}
+		case WHILE_ST: {
+			folding->folded += foldExpression(statement->whileLoop->condition);
+			const Constant *condition = _literal(statement->whileLoop->condition, BOOLEAN);
+			if (condition != NULL && !condition->boolean) {
+				*code = (*code)->next;
+				++folding->folded;
+				return;
+			}
+			_foldCode(folding, &statement->whileLoop->body);
+			break;
+		}
+		case FOR_ST: {
+			ParamsFor *params = statement->forLoop->params;
+			if (params->type == FOR_CLASSIC) {
+				if (params->init != NULL) {
+					_foldVariable(folding, params->init->variable);
+				}
+				folding->folded += foldExpression(params->condition);
+				if (params->updateType == EXPRESSION_UT && params->update != NULL) {
+					folding->folded += foldExpression(params->update);
+				}
+			}
+			_foldCode(folding, &statement->forLoop->body);
+			break;
+		}
+		case DECLARATION_ST:
+			_foldVariable(folding, statement->declaration->variable);
+			break;
+		case EXPRESSION_ST:
+			folding->folded += foldExpression(statement->expression);
+			break;
+		case VARIABLE_ST:
+			_foldVariable(folding, statement->variable);
+			break;
+		case FUNCTIONCALL_ST:
+			for (ArgumentList *argument = statement->functionCall->arguments; argument != NULL; argument = argument->next) {
+				folding->folded += foldExpression(argument->expression);
+			}
+			break;
+		case FUNCTION_DECLARATION_ST:
+			_foldFunctionBody(folding, statement->FunctionDeclaration->body);
+			break;
+		case ASYNC_FUNCTION_ST:
+			_foldFunctionBody(folding, statement->asyncFunction->body);
+			break;
+		case SWITCH_ST:
+			for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+				folding->folded += foldExpression(content->condition);
+				_foldCode(folding, &content->body);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+static void _foldVariable(Folding *folding, Variable *variable) {
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			folding->folded += foldExpression(variable->expression);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				folding->folded += foldExpression(element->value);
+			}
+			break;
+		case OBJECT_VAR:
+			for (ObjectContent *property = variable->objectContent; property != NULL; property = property->next) {
+				folding->folded += foldExpression(property->value);
+			}
+			break;
+		case FUNCTIONCALL_VAR:
+			for (ArgumentList *argument = variable->functionCall->arguments; argument != NULL; argument = argument->next) {
+				folding->folded += foldExpression(argument->expression);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * The literal of the expression if it is one of the specified type, or
+ * NULL. Numbers only count if they are integers.
+ */
+static Constant *_literal(const Expression *expression, const DataType type) {
+	if (expression == NULL || expression->type != FACTOR || expression->factor->type != CONSTANT) {
+		return NULL;
+	}
+	Constant *constant = expression->factor->constant;
+	if (constant->type != type || (type == NUMBER && constant->numberType != INTEGER_NT)) {
+		return NULL;
+	}
+	return constant;
+}
+
+static void _replaceWithBoolean(Expression *expression, const boolean value) {
+	Constant *constant = allocateNode(sizeof(Constant));
+	constant->type = BOOLEAN;
+	constant->boolean = value ? 1 : 0;
+	Factor *factor = allocateNode(sizeof(Factor));
+	factor->type = CONSTANT;
+	factor->constant = constant;
+	expression->type = FACTOR;
+	expression->factor = factor;
+}
+
+/**
+ * Replaces the expression with an integer, if the integer fits (otherwise,
+ * the expression remains as it is, and returns false).
+ */
+static boolean _replaceWithInteger(Expression *expression, const long long value) {
+	if (value < INT_MIN || INT_MAX < value) {
+		return false;
+	}
+	Constant *constant = allocateNode(sizeof(Constant));
+	constant->type = NUMBER;
+	constant->numberType = INTEGER_NT;
+	constant->integer = (int) value;
+	Factor *factor = allocateNode(sizeof(Factor));
+	factor->type = CONSTANT;
+	factor->constant = constant;
+	expression->type = FACTOR;
+	expression->factor = factor;
+	return true;
+}
+
+static void _replaceWithString(Expression *expression, const char *lexeme) {
+	Constant *constant = allocateNode(sizeof(Constant));
+	constant->type = STRING;
+	constant->string = internString(lexeme);
+	Factor *factor = allocateNode(sizeof(Factor));
+	factor->type = CONSTANT;
+	factor->constant = constant;
+	expression->type = FACTOR;
+	expression->factor = factor;
+}
+
+/**
+ * Links a copy of the replacement code in front of the next statements.
+ */
+static Code *_splice(Code *replacement, Code *next) {
+	Code *head = next;
+	Code **tail = &head;
+	for (; replacement != NULL; replacement = replacement->next) {
+		Code *code = allocateNode(sizeof(Code));
+		code->statement = replacement->statement;
+		code->next = next;
+		*tail = code;
+		tail = &code->next;
+	}
+	return head;
+}
+
+/** PUBLIC FUNCTIONS */
+
+unsigned int foldExpression(Expression *expression) {
+	if (expression == NULL) {
+		return 0;
+	}
+	unsigned int folded = 0;
+	switch (expression->type) {
+		case FACTOR:
+			if (expression->factor->type == EXPRESSION) {
+				folded += foldExpression(expression->factor->expression);
+				// The parenthesis of a single factor are redundant.
+				if (expression->factor->expression->type == FACTOR) {
+					*expression = *expression->factor->expression;
+					++folded;
+				}
+			}
+			return folded;
+		case NOT_OP:
+		case AWAIT_OP:
+			folded += foldExpression(expression->expression);
+			break;
+		case ADD_OP:
+			return _foldConcatenation(expression);
+		default:
+			folded += foldExpression(expression->leftExpression);
+			folded += foldExpression(expression->rightExpression);
+			break;
+	}
+	return folded + (_foldBinary(expression) ? 1 : 0);
+}
+
+PassResult foldConstants(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	Folding folding = {.nodes = 0, .folded = 0};
+	_foldCode(&folding, &program->code);
+	logDebugging(_logger, "Folded %u operations.", folding.folded);
+	PassResult result = {.nodes = folding.nodes, .changed = 0 < folding.folded};
+	return result;
+}
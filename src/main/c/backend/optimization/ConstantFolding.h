@@ -0,0 +1,36 @@
+#ifndef CONSTANT_FOLDING_HEADER
+#define CONSTANT_FOLDING_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/StringPool.h"
+#include "../../shared/Type.h"
+#include "PassManager.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeConstantFoldingModule();
+
+/** Shutdown module's internal state. */
+void shutdownConstantFoldingModule();
+
+/**
+ * Evaluates the operations of the program whose operands are literals, and
+ * replaces them with their result, as JavaScript would compute it. Integer
+ * arithmetic is folded only while the result is exact, floating literals
+ * are never folded, adjacent string
+ * literals of a concatenation are merged, and a branch with a literal
+ * condition is replaced by the body that runs.
+ */
+PassResult foldConstants(CompilerState *compilerState);
+
+/**
+ * Folds a single expression in place, and returns the number of folded
+ * operations.
+ */
+unsigned int foldExpression(Expression *expression);
+
+#endif
@@ -0,0 +1,486 @@
+#include "DeadCodeElimination.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializeDeadCodeEliminationModule() {
+	_logger = createLogger("DeadCodeElimination");
+}
+
+void shutdownDeadCodeEliminationModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The number of buckets of the table of declarations.
+ */
+#define DECLARATION_BUCKETS 256
+
+typedef struct DeclarationSite DeclarationSite;
+typedef struct DeclaredName DeclaredName;
+
+/**
+ * A statement that declares a name.
+ */
+struct DeclarationSite {
+	Statement *statement;
+	DeclarationSite *next;
+};
+
+/**
+ * Every declaration of a name, and whether the name is reachable.
+ */
+struct DeclaredName {
+	const char *name;
+	boolean reachable;
+	DeclarationSite *sites;
+	DeclaredName *next;			  // in the same bucket
+	DeclaredName *pending;		  // in the worklist
+};
+
+/**
+ * The state of a single run of the pass. Everything lives in an arena that
+ * is released at the end of the run.
+ */
+typedef struct {
+	Arena *arena;
+	DeclaredName *buckets[DECLARATION_BUCKETS];
+	DeclaredName *worklist;
+	unsigned int nodes;
+	unsigned int removed;
+} Reachability;
+
+static void _collectCode(Reachability *reachability, Code *code);
+static void _collectFunctionBody(Reachability *reachability, FunctionBody *body);
+static void _collectStatement(Reachability *reachability, Statement *statement);
+static const char *_declaredName(const Statement *statement);
+static DeclaredName *_findName(Reachability *reachability, const char *name, const boolean create);
+static unsigned int _hashName(const char *name);
+static void _markArguments(Reachability *reachability, ArgumentList *arguments);
+static void _markArray(Reachability *reachability, ArrayContent *arrayContent);
+static void _markCode(Reachability *reachability, Code *code);
+static void _markDeclaration(Reachability *reachability, Statement *statement);
+static void _markExpression(Reachability *reachability, Expression *expression);
+static void _markFunctionBody(Reachability *reachability, FunctionBody *body);
+static void _markFunctionCall(Reachability *reachability, FunctionCall *functionCall);
+static void _markName(Reachability *reachability, const char *name);
+static void _markObject(Reachability *reachability, ObjectContent *objectContent);
+static void _markStatement(Reachability *reachability, Statement *statement);
+static void _markVariable(Reachability *reachability, Variable *variable);
+static void _sweepCode(Reachability *reachability, Code **code);
+static void _sweepFunctionBody(Reachability *reachability, FunctionBody *body);
+
+/**
+ * Registers every declaration of the code, including the ones nested inside
+ * functions and control structures.
+ */
+static void _collectCode(Reachability *reachability, Code *code) {
+	for (; code != NULL; code = code->next) {
+		_collectStatement(reachability, code->statement);
+	}
+}
+
+static void _collectFunctionBody(Reachability *reachability, FunctionBody *body) {
+	if (body != NULL) {
+		_collectCode(reachability, body->code);
+		if (body->returnValue != NULL && body->returnValue->type == ASYNC_FUNCTION_RT) {
+			_collectFunctionBody(reachability, body->returnValue->asyncFunction->body);
+		}
+	}
+}
+
+static void _collectStatement(Reachability *reachability, Statement *statement) {
+	const char *name = _declaredName(statement);
+	if (name != NULL) {
+		DeclaredName *declaredName = _findName(reachability, name, true);
+		DeclarationSite *site = allocateInArena(reachability->arena, sizeof(DeclarationSite));
+		site->statement = statement;
+		site->next = declaredName->sites;
+		declaredName->sites = site;
+	}
+	switch (statement->statement) {
+		case IF_ST:
+			_collectCode(reachability, statement->ifStatement->thenBody);
+			_collectCode(reachability, statement->ifStatement->elseBody);
+			break;
+		case WHILE_ST:
+			_collectCode(reachability, statement->whileLoop->body);
+			break;
+		case FOR_ST:
+			_collectCode(reachability, statement->forLoop->body);
+			break;
+		case SWITCH_ST:
+			for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+				_collectCode(reachability, content->body);
+			}
+			break;
+		case FUNCTION_DECLARATION_ST:
+			_collectFunctionBody(reachability, statement->FunctionDeclaration->body);
+			break;
+		case ASYNC_FUNCTION_ST:
+			_collectFunctionBody(reachability, statement->asyncFunction->body);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * The name declared by a statement that can be removed, or NULL if the
+ * statement declares nothing removable.
+ */
+static const char *_declaredName(const Statement *statement) {
+	switch (statement->statement) {
+		case FUNCTION_DECLARATION_ST:
+			return statement->FunctionDeclaration->id;
+		case ASYNC_FUNCTION_ST:
+			return statement->asyncFunction->id;
+		case TYPE_DECLARATION_ST:
+			return statement->typeDeclaration->id;
+		default:
+			return NULL;
+	}
+}
+
+static DeclaredName *_findName(Reachability *reachability, const char *name, const boolean create) {
+	const unsigned int bucket = _hashName(name);
+	for (DeclaredName *declaredName = reachability->buckets[bucket]; declaredName != NULL; declaredName = declaredName->next) {
+		if (strcmp(declaredName->name, name) == 0) {
+			return declaredName;
+		}
+	}
+	if (!create) {
+		return NULL;
+	}
+	DeclaredName *declaredName = allocateInArena(reachability->arena, sizeof(DeclaredName));
+	declaredName->name = name;
+	declaredName->next = reachability->buckets[bucket];
+	reachability->buckets[bucket] = declaredName;
+	return declaredName;
+}
+
+/**
+ * The FNV-1a hash of a name, reduced to a bucket.
+ */
+static unsigned int _hashName(const char *name) {
+	unsigned int hash = 2166136261u;
+	for (; *name != '\0'; ++name) {
+		hash = (hash ^ (unsigned char) *name) * 16777619u;
+	}
+	return hash % DECLARATION_BUCKETS;
+}
+
+static void _markArguments(Reachability *reachability, ArgumentList *arguments) {
+	for (; arguments != NULL; arguments = arguments->next) {
+		_markExpression(reachability, arguments->expression);
+	}
+}
+
+static void _markArray(Reachability *reachability, ArrayContent *arrayContent) {
+	for (; arrayContent != NULL; arrayContent = arrayContent->next) {
+		_markExpression(reachability, arrayContent->value);
+	}
+}
+
+/**
+ * Marks the names referenced by the statements of the code that run. The
+ * declarations are not roots: they are only walked once reachable.
+ */
+static void _markCode(Reachability *reachability, Code *code) {
+	for (; code != NULL; code = code->next) {
+		if (_declaredName(code->statement) == NULL) {
+			_markStatement(reachability, code->statement);
+		}
+	}
+}
+
+/**
+ * Marks the names referenced by a declaration that is reachable.
+ */
+static void _markDeclaration(Reachability *reachability, Statement *statement) {
+	++reachability->nodes;
+	switch (statement->statement) {
+		case FUNCTION_DECLARATION_ST:
+			_markFunctionBody(reachability, statement->FunctionDeclaration->body);
+			break;
+		case ASYNC_FUNCTION_ST:
+			_markFunctionBody(reachability, statement->asyncFunction->body);
+			break;
+		case TYPE_DECLARATION_ST:
+			switch (statement->typeDeclaration->type) {
+				case TYPE_OBJECT:
+					_markObject(reachability, statement->typeDeclaration->objectContent);
+					break;
+				case TYPE_EXPRESSION:
+					_markExpression(reachability, statement->typeDeclaration->expression);
+					break;
+				case TYPE_ARRAY:
+					_markArray(reachability, statement->typeDeclaration->arrayContent);
+					break;
+				case TYPE_ENUM:
+					_markArguments(reachability, statement->typeDeclaration->enumm);
+					break;
+				default:
+					break;
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+static void _markExpression(Reachability *reachability, Expression *expression) {
+	if (expression == NULL) {
+		return;
+	}
+	++reachability->nodes;
+	switch (expression->type) {
+		case FACTOR:
+			switch (expression->factor->type) {
+				case VARIABLE:
+					_markName(reachability, expression->factor->variableName);
+					break;
+				case EXPRESSION:
+					_markExpression(reachability, expression->factor->expression);
+					break;
+				case FUNCTIONCALL:
+					_markFunctionCall(reachability, expression->factor->functionCall);
+					break;
+				default:
+					break;
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			_markExpression(reachability, expression->expression);
+			break;
+		default:
+			_markExpression(reachability, expression->leftExpression);
+			_markExpression(reachability, expression->rightExpression);
+			break;
+	}
+}
+
+static void _markFunctionBody(Reachability *reachability, FunctionBody *body) {
+	if (body == NULL) {
+		return;
+	}
+	_markCode(reachability, body->code);
+	ReturnValue *returnValue = body->returnValue;
+	if (returnValue != NULL) {
+		switch (returnValue->type) {
+			case EXPRESSION_RT:
+				_markExpression(reachability, returnValue->expression);
+				break;
+			case FUNCTIONCALL_RT:
+				_markFunctionCall(reachability, returnValue->functionCall);
+				break;
+			case ASYNC_FUNCTION_RT:
+				// A returned function always escapes.
+				_markName(reachability, returnValue->asyncFunction->id);
+				_markFunctionBody(reachability, returnValue->asyncFunction->body);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+static void _markFunctionCall(Reachability *reachability, FunctionCall *functionCall) {
+	_markName(reachability, functionCall->id);
+	_markArguments(reachability, functionCall->arguments);
+}
+
+/**
+ * Makes every declaration of the name reachable (once), and queues it so
+ * that the names it references become reachable too.
+ */
+static void _markName(Reachability *reachability, const char *name) {
+	DeclaredName *declaredName = _findName(reachability, name, false);
+	if (declaredName != NULL && !declaredName->reachable) {
+		declaredName->reachable = true;
+		declaredName->pending = reachability->worklist;
+		reachability->worklist = declaredName;
+	}
+}
+
+static void _markObject(Reachability *reachability, ObjectContent *objectContent) {
+	for (; objectContent != NULL; objectContent = objectContent->next) {
+		_markExpression(reachability, objectContent->value);
+	}
+}
+
+static void _markStatement(Reachability *reachability, Statement *statement) {
+	++reachability->nodes;
+	switch (statement->statement) {
+		case IF_ST:
+			_markExpression(reachability, statement->ifStatement->condition);
+			_markCode(reachability, statement->ifStatement->thenBody);
+			_markCode(reachability, statement->ifStatement->elseBody);
+			break;
+		case WHILE_ST:
+			_markExpression(reachability, statement->whileLoop->condition);
+			_markCode(reachability, statement->whileLoop->body);
+			break;
+		case FOR_ST: {
+			ParamsFor *params = statement->forLoop->params;
+			if (params->type == FOR_CLASSIC) {
+				if (params->init != NULL) {
+					_markVariable(reachability, params->init->variable);
+				}
+				_markExpression(reachability, params->condition);
+				if (params->updateType == INC_DEC_UT) {
+					_markExpression(reachability, params->updateIncDec->expression);
+				}
+				else {
+					_markExpression(reachability, params->update);
+				}
+			}
+			else {
+				IterableVariable *iterable = params->iterable;
+				switch (iterable->type) {
+					case VARIABLE_IT:
+						_markName(reachability, iterable->variableName);
+						break;
+					case FUNCTIONCALL_IT:
+						_markFunctionCall(reachability, iterable->functionCall);
+						break;
+					case ARRAY_IT:
+						_markArray(reachability, iterable->arrayContent);
+						break;
+					case OBJECT_IT:
+						_markObject(reachability, iterable->objectContent);
+						break;
+				}
+			}
+			_markCode(reachability, statement->forLoop->body);
+			break;
+		}
+		case DECLARATION_ST:
+			_markVariable(reachability, statement->declaration->variable);
+			break;
+		case EXPRESSION_ST:
+			_markExpression(reachability, statement->expression);
+			break;
+		case VARIABLE_ST:
+			_markVariable(reachability, statement->variable);
+			break;
+		case FUNCTIONCALL_ST:
+			_markFunctionCall(reachability, statement->functionCall);
+			break;
+		case INC_DEC_ST:
+			_markExpression(reachability, statement->incDec->expression);
+			break;
+		case SWITCH_ST:
+			_markName(reachability, statement->switchStatement->id);
+			for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+				_markExpression(reachability, content->condition);
+				_markCode(reachability, content->body);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+static void _markVariable(Reachability *reachability, Variable *variable) {
+	if (variable == NULL) {
+		return;
+	}
+	// Writing a binding with the name of a declaration keeps it alive.
+	_markName(reachability, variable->variableType->id);
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_markExpression(reachability, variable->expression);
+			break;
+		case ARRAY_VAR:
+			_markArray(reachability, variable->arrayContent);
+			break;
+		case OBJECT_VAR:
+			_markObject(reachability, variable->objectContent);
+			break;
+		case FUNCTIONCALL_VAR:
+			_markFunctionCall(reachability, variable->functionCall);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Unlinks the unreachable declarations of the code, and sweeps the code
+ * nested inside the statements that remain.
+ */
+static void _sweepCode(Reachability *reachability, Code **code) {
+	while (*code != NULL) {
+		Statement *statement = (*code)->statement;
+		const char *name = _declaredName(statement);
+		if (name != NULL && !_findName(reachability, name, false)->reachable) {
+			logDebugging(_logger, "Removing the unreachable declaration \"%s\".", name);
+			++reachability->removed;
+			*code = (*code)->next;
+			continue;
+		}
+		switch (statement->statement) {
+			case IF_ST:
+				_sweepCode(reachability, &statement->ifStatement->thenBody);
+				_sweepCode(reachability, &statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_sweepCode(reachability, &statement->whileLoop->body);
+				break;
+			case FOR_ST:
+				_sweepCode(reachability, &statement->forLoop->body);
+				break;
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_sweepCode(reachability, &content->body);
+				}
+				break;
+			case FUNCTION_DECLARATION_ST:
+				_sweepFunctionBody(reachability, statement->FunctionDeclaration->body);
+				break;
+			case ASYNC_FUNCTION_ST:
+				_sweepFunctionBody(reachability, statement->asyncFunction->body);
+				break;
+			default:
+				break;
+		}
+		code = &(*code)->next;
+	}
+}
+
+static void _sweepFunctionBody(Reachability *reachability, FunctionBody *body) {
+	if (body != NULL) {
+		_sweepCode(reachability, &body->code);
+		if (body->returnValue != NULL && body->returnValue->type == ASYNC_FUNCTION_RT) {
+			_sweepFunctionBody(reachability, body->returnValue->asyncFunction->body);
+		}
+	}
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult eliminateDeadCode(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	Reachability reachability = {.arena = createArena(4096)};
+	_collectCode(&reachability, program->code);
+	_markCode(&reachability, program->code);
+	while (reachability.worklist != NULL) {
+		DeclaredName *declaredName = reachability.worklist;
+		reachability.worklist = declaredName->pending;
+		for (DeclarationSite *site = declaredName->sites; site != NULL; site = site->next) {
+			_markDeclaration(&reachability, site->statement);
+		}
+	}
+	_sweepCode(&reachability, &program->code);
+	logDebugging(_logger, "Removed %u unreachable declarations.", reachability.removed);
+	destroyArena(reachability.arena);
+	PassResult result = {.nodes = reachability.nodes, .changed = 0 < reachability.removed};
+	return result;
+}
@@ -0,0 +1,30 @@
+#ifndef DEAD_CODE_ELIMINATION_HEADER
+#define DEAD_CODE_ELIMINATION_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Arena.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "PassManager.h"
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeDeadCodeEliminationModule();
+
+/** Shutdown module's internal state. */
+void shutdownDeadCodeEliminationModule();
+
+/**
+ * Removes every function, async function, type, interface and enum of the
+ * program that the code never reaches. The roots are the statements that
+ * run (at the top level, and inside every reachable function), and a
+ * declaration becomes reachable once its name is referenced from reachable
+ * code, by a call, a read, a write or an iteration.
+ *
+ * Declarations are matched by name, regardless of their scope, so a name
+ * that is referenced anywhere keeps alive every declaration with that name.
+ */
+PassResult eliminateDeadCode(CompilerState *compilerState);
+
+#endif
@@ -0,0 +1,64 @@
+#include "DeadValueElimination.h"
+
+/** PRIVATE FUNCTIONS */
+
+static unsigned int _compact(IrFunction *function, unsigned int *values, const unsigned int count, const boolean *live);
+
+/**
+ * Drops the dead values of a list of instructions (in place), marking them
+ * as removed, and returns the new length of the list.
+ */
+static unsigned int _compact(IrFunction *function, unsigned int *values, const unsigned int count, const boolean *live) {
+	unsigned int kept = 0;
+	for (unsigned int k = 0; k < count; ++k) {
+		if (live[values[k]]) {
+			values[kept++] = values[k];
+		}
+		else {
+			function->instructions[values[k]].block = IR_NONE;
+		}
+	}
+	return kept;
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult eliminateDeadValues(IrModule *module, const unsigned int function) {
+	IrFunction *irFunction = &module->functions[function];
+	PassResult result = {.nodes = irFunction->instructionCount, .changed = false};
+	boolean *live = calloc(irFunction->instructionCount, sizeof(boolean));
+	unsigned int *worklist = malloc(irFunction->instructionCount * sizeof(unsigned int));
+	unsigned int pending = 0;
+
+	// The roots: every instruction with side effects, and the "undefined"
+	// constant, that the rest of the backend expects to find.
+	for (unsigned int k = 0; k < irFunction->instructionCount; ++k) {
+		const IrInstruction *instruction = &irFunction->instructions[k];
+		if (instruction->block != IR_NONE && (k == 0 || !isIrPure(instruction->opcode))) {
+			live[k] = true;
+			worklist[pending++] = k;
+		}
+	}
+	while (0 < pending) {
+		const IrInstruction *instruction = &irFunction->instructions[worklist[--pending]];
+		for (unsigned int k = 0; k < instruction->operandCount; ++k) {
+			const unsigned int operand = instruction->operands[k];
+			if (operand != IR_NONE && !live[operand]) {
+				live[operand] = true;
+				worklist[pending++] = operand;
+			}
+		}
+	}
+
+	for (unsigned int b = 0; b < irFunction->blockCount; ++b) {
+		IrBlock *block = &irFunction->blocks[b];
+		const unsigned int phiCount = _compact(irFunction, block->phis, block->phiCount, live);
+		const unsigned int instructionCount = _compact(irFunction, block->instructions, block->instructionCount, live);
+		result.changed |= phiCount != block->phiCount || instructionCount != block->instructionCount;
+		block->phiCount = phiCount;
+		block->instructionCount = instructionCount;
+	}
+	free(worklist);
+	free(live);
+	return result;
+}
@@ -0,0 +1,16 @@
+#ifndef DEAD_VALUE_ELIMINATION_HEADER
+#define DEAD_VALUE_ELIMINATION_HEADER
+
+#include "../intermediate-representation/IntermediateRepresentation.h"
+#include "PassManager.h"
+#include <stdlib.h>
+
+/**
+ * Removes every pure instruction of the function whose value does not reach
+ * any side effect (a store, a call, a terminator...), including cycles of
+ * phis that only feed each other. It allocates nothing inside the module, so
+ * it can run on every function at once.
+ */
+PassResult eliminateDeadValues(IrModule *module, const unsigned int function);
+
+#endif
@@ -0,0 +1,379 @@
+#include "EscapeAnalysis.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+static NodeTable _scalars = {NULL, NULL, 0, 0};
+static NodeTable _iterables = {NULL, NULL, 0, 0};
+
+void initializeEscapeAnalysisModule() {
+	_logger = createLogger("EscapeAnalysis");
+}
+
+void shutdownEscapeAnalysisModule() {
+	releaseAnnotations(&_scalars);
+	releaseAnnotations(&_iterables);
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The number of buckets of the table of names.
+ */
+#define ESCAPE_ANALYSIS_BUCKETS 256
+
+/**
+ * The longest array whose elements are replaced by scalars.
+ */
+#define MAXIMUM_SCALAR_ELEMENTS 8
+
+/**
+ * The longest body (in statements) of a loop over a replaced array, because
+ * it is copied once per element.
+ */
+#define MAXIMUM_SCALAR_STATEMENTS 6
+
+typedef struct NameEscapes NameEscapes;
+typedef struct Iteration Iteration;
+
+/**
+ * How a name is declared and used across the whole program.
+ */
+struct NameEscapes {
+	const char *name;
+	unsigned int declarations;
+	unsigned int writes;
+	unsigned int escapes;			  // every use other than a short loop over it
+	Declaration *array;				  // the array literal it declares
+	Iteration *iterations;
+	NameEscapes *next;
+};
+
+/**
+ * A loop over a name, short enough to be copied once per element.
+ */
+struct Iteration {
+	ParamsFor *params;
+	Iteration *next;
+};
+
+/**
+ * The state of a single run of the pass.
+ */
+typedef struct {
+	Arena *arena;
+	NameEscapes *buckets[ESCAPE_ANALYSIS_BUCKETS];
+	unsigned int nodes;
+	unsigned int replaced;
+} Escapes;
+
+static NameEscapes *_findName(Escapes *escapes, const char *name);
+static unsigned int _hashName(const char *name);
+static boolean _isShortBody(Code *body);
+static void _surveyCall(Escapes *escapes, FunctionCall *functionCall);
+static void _surveyCode(Escapes *escapes, Code *code, const boolean async);
+static void _surveyExpression(Escapes *escapes, const Expression *expression);
+static void _surveyFunctionBody(Escapes *escapes, VariableTypeList *parameters, FunctionBody *body, const boolean async);
+static void _surveyVariable(Escapes *escapes, Variable *variable);
+
+static NameEscapes *_findName(Escapes *escapes, const char *name) {
+	const unsigned int bucket = _hashName(name);
+	for (NameEscapes *uses = escapes->buckets[bucket]; uses != NULL; uses = uses->next) {
+		if (strcmp(uses->name, name) == 0) {
+			return uses;
+		}
+	}
+	NameEscapes *uses = allocateInArena(escapes->arena, sizeof(NameEscapes));
+	uses->name = name;
+	uses->next = escapes->buckets[bucket];
+	escapes->buckets[bucket] = uses;
+	return uses;
+}
+
+static unsigned int _hashName(const char *name) {
+	unsigned int hash = 2166136261u;
+	for (; *name != '\0'; ++name) {
+		hash = (hash ^ (unsigned char) *name) * 16777619u;
+	}
+	return hash % ESCAPE_ANALYSIS_BUCKETS;
+}
+
+static boolean _isShortBody(Code *body) {
+	if (containsFunctions(body)) {
+		return false;
+	}
+	unsigned int statements = 0;
+	for (Code *code = body; code != NULL; code = code->next) {
+		if (MAXIMUM_SCALAR_STATEMENTS < ++statements) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void _surveyCall(Escapes *escapes, FunctionCall *functionCall) {
+	++_findName(escapes, functionCall->id)->escapes;
+	for (ArgumentList *argument = functionCall->arguments; argument != NULL; argument = argument->next) {
+		_surveyExpression(escapes, argument->expression);
+	}
+}
+
+/**
+ * Surveys the code. Inside an async function, the locals can be spilled into
+ * the frame of its state machine, so nothing iterated there is replaced.
+ */
+static void _surveyCode(Escapes *escapes, Code *code, const boolean async) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		++escapes->nodes;
+		switch (statement->statement) {
+			case IF_ST:
+				_surveyExpression(escapes, statement->ifStatement->condition);
+				_surveyCode(escapes, statement->ifStatement->thenBody, async);
+				_surveyCode(escapes, statement->ifStatement->elseBody, async);
+				break;
+			case WHILE_ST:
+				_surveyExpression(escapes, statement->whileLoop->condition);
+				_surveyCode(escapes, statement->whileLoop->body, async);
+				break;
+			case FOR_ST: {
+				ForLoop *forLoop = statement->forLoop;
+				ParamsFor *params = forLoop->params;
+				if (params->type == FOR_CLASSIC) {
+					if (params->init != NULL) {
+						++_findName(escapes, params->init->variable->variableType->id)->declarations;
+						_surveyVariable(escapes, params->init->variable);
+					}
+					_surveyExpression(escapes, params->condition);
+					if (params->updateType == INC_DEC_UT) {
+						_surveyExpression(escapes, params->updateIncDec->expression);
+					}
+					else {
+						_surveyExpression(escapes, params->update);
+					}
+				}
+				else {
+					++_findName(escapes, params->value->variable->variableType->id)->declarations;
+					IterableVariable *iterable = params->iterable;
+					switch (iterable->type) {
+						case VARIABLE_IT: {
+							NameEscapes *uses = _findName(escapes, iterable->variableName);
+							if (async || !_isShortBody(forLoop->body)) {
+								++uses->escapes;
+							}
+							else {
+								Iteration *iteration = allocateInArena(escapes->arena, sizeof(Iteration));
+								iteration->params = params;
+								iteration->next = uses->iterations;
+								uses->iterations = iteration;
+							}
+							break;
+						}
+						case FUNCTIONCALL_IT:
+							_surveyCall(escapes, iterable->functionCall);
+							break;
+						case ARRAY_IT:
+							for (ArrayContent *element = iterable->arrayContent; element != NULL; element = element->next) {
+								_surveyExpression(escapes, element->value);
+							}
+							break;
+						case OBJECT_IT:
+							for (ObjectContent *property = iterable->objectContent; property != NULL; property = property->next) {
+								_surveyExpression(escapes, property->value);
+							}
+							break;
+					}
+				}
+				_surveyCode(escapes, forLoop->body, async);
+				break;
+			}
+			case DECLARATION_ST: {
+				Declaration *declaration = statement->declaration;
+				NameEscapes *uses = _findName(escapes, declaration->variable->variableType->id);
+				++uses->declarations;
+				if (declaration->variable->type == ARRAY_VAR && declaration->type != VAR_DT && !async) {
+					uses->array = declaration;
+				}
+				_surveyVariable(escapes, declaration->variable);
+				break;
+			}
+			case VARIABLE_ST:
+				++_findName(escapes, statement->variable->variableType->id)->writes;
+				_surveyVariable(escapes, statement->variable);
+				break;
+			case EXPRESSION_ST:
+				_surveyExpression(escapes, statement->expression);
+				break;
+			case FUNCTIONCALL_ST:
+				_surveyCall(escapes, statement->functionCall);
+				break;
+			case INC_DEC_ST: {
+				const Expression *expression = statement->incDec->expression;
+				if (expression->type == FACTOR && expression->factor->type == VARIABLE) {
+					++_findName(escapes, expression->factor->variableName)->writes;
+				}
+				_surveyExpression(escapes, expression);
+				break;
+			}
+			case FUNCTION_DECLARATION_ST: {
+				FunctionDeclaration *function = statement->FunctionDeclaration;
+				++_findName(escapes, function->id)->declarations;
+				_surveyFunctionBody(escapes, function->arguments, function->body, false);
+				break;
+			}
+			case ASYNC_FUNCTION_ST: {
+				AsyncFunction *asyncFunction = statement->asyncFunction;
+				++_findName(escapes, asyncFunction->id)->declarations;
+				_surveyFunctionBody(escapes, asyncFunction->arguments, asyncFunction->body, true);
+				break;
+			}
+			case TYPE_DECLARATION_ST:
+				++_findName(escapes, statement->typeDeclaration->id)->declarations;
+				break;
+			case SWITCH_ST:
+				if (statement->switchStatement->id != NULL) {
+					++_findName(escapes, statement->switchStatement->id)->escapes;
+				}
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_surveyExpression(escapes, content->condition);
+					_surveyCode(escapes, content->body, async);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+static void _surveyExpression(Escapes *escapes, const Expression *expression) {
+	if (expression == NULL) {
+		return;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			switch (expression->factor->type) {
+				case VARIABLE:
+					++_findName(escapes, expression->factor->variableName)->escapes;
+					break;
+				case EXPRESSION:
+					_surveyExpression(escapes, expression->factor->expression);
+					break;
+				case FUNCTIONCALL:
+					_surveyCall(escapes, expression->factor->functionCall);
+					break;
+				default:
+					break;
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			_surveyExpression(escapes, expression->expression);
+			break;
+		default:
+			_surveyExpression(escapes, expression->leftExpression);
+			_surveyExpression(escapes, expression->rightExpression);
+			break;
+	}
+}
+
+static void _surveyFunctionBody(Escapes *escapes, VariableTypeList *parameters, FunctionBody *body, const boolean async) {
+	for (; parameters != NULL; parameters = parameters->next) {
+		++_findName(escapes, parameters->variableType->id)->declarations;
+	}
+	if (body == NULL) {
+		return;
+	}
+	_surveyCode(escapes, body->code, async);
+	ReturnValue *returnValue = body->returnValue;
+	if (returnValue == NULL) {
+		return;
+	}
+	switch (returnValue->type) {
+		case EXPRESSION_RT:
+			_surveyExpression(escapes, returnValue->expression);
+			break;
+		case FUNCTIONCALL_RT:
+			_surveyCall(escapes, returnValue->functionCall);
+			break;
+		case ASYNC_FUNCTION_RT:
+			++_findName(escapes, returnValue->asyncFunction->id)->declarations;
+			_surveyFunctionBody(escapes, returnValue->asyncFunction->arguments, returnValue->asyncFunction->body, true);
+			break;
+		default:
+			break;
+	}
+}
+
+static void _surveyVariable(Escapes *escapes, Variable *variable) {
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_surveyExpression(escapes, variable->expression);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				_surveyExpression(escapes, element->value);
+			}
+			break;
+		case OBJECT_VAR:
+			for (ObjectContent *property = variable->objectContent; property != NULL; property = property->next) {
+				_surveyExpression(escapes, property->value);
+			}
+			break;
+		case FUNCTIONCALL_VAR:
+			_surveyCall(escapes, variable->functionCall);
+			break;
+		default:
+			break;
+	}
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult replaceArrayScalars(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	Escapes escapes = {
+		.arena = createArena(4096),
+		.buckets = {NULL},
+		.nodes = 0,
+		.replaced = 0};
+	_surveyCode(&escapes, program->code, false);
+	for (unsigned int bucket = 0; bucket < ESCAPE_ANALYSIS_BUCKETS; ++bucket) {
+		for (NameEscapes *uses = escapes.buckets[bucket]; uses != NULL; uses = uses->next) {
+			if (uses->array == NULL || uses->declarations != 1 || uses->writes != 0 || uses->escapes != 0) {
+				continue;
+			}
+			Variable *variable = uses->array->variable;
+			unsigned int length = 0;
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				++length;
+			}
+			if (length == 0 || MAXIMUM_SCALAR_ELEMENTS < length || findArrayScalars(variable) != NULL) {
+				continue;
+			}
+			char **scalars = allocateNode(length * sizeof(char *));
+			for (unsigned int k = 0; k < length; ++k) {
+				scalars[k] = createSyntheticName(uses->name);
+			}
+			annotateNode(&_scalars, variable, scalars);
+			for (Iteration *iteration = uses->iterations; iteration != NULL; iteration = iteration->next) {
+				annotateNode(&_iterables, iteration->params, variable);
+			}
+			logDebugging(_logger, "The array \"%s\" does not escape, so its %u elements are scalars.", uses->name, length);
+			++escapes.replaced;
+		}
+	}
+	destroyArena(escapes.arena);
+	PassResult result = {.nodes = escapes.nodes, .changed = 0 < escapes.replaced};
+	return result;
+}
+
+char **findArrayScalars(const Variable *variable) {
+	return findAnnotation(&_scalars, variable);
+}
+
+Variable *findScalarIterable(const ParamsFor *params) {
+	return findAnnotation(&_iterables, params);
+}
@@ -0,0 +1,47 @@
+#ifndef ESCAPE_ANALYSIS_HEADER
+#define ESCAPE_ANALYSIS_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Arena.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "PassManager.h"
+#include "TreeRewriting.h"
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeEscapeAnalysisModule();
+
+/** Shutdown module's internal state. */
+void shutdownEscapeAnalysisModule();
+
+/**
+ * Replaces the array literals that do not escape by one local per element
+ * (see findArrayScalars and findScalarIterable), so they are never built.
+ *
+ * Without property access nor indexing, a for...of is the only way to look
+ * into an array without letting it go (as an argument, a returned value, or
+ * another binding). So an array does not escape if it is declared once
+ * (with "let" or "const"), never written, and only iterated. Every loop
+ * over it then runs its body once per element, in its own block, which
+ * also unrolls it completely: the arrays and the bodies must be short.
+ *
+ * Object literals cannot be read at all (only passed around, which lets them
+ * escape), so the ones that do not escape are simply dead.
+ */
+PassResult replaceArrayScalars(CompilerState *compilerState);
+
+/**
+ * The locals that replace the elements of an array literal, or NULL if it
+ * is built.
+ */
+char **findArrayScalars(const Variable *variable);
+
+/**
+ * The array literal that a for...of iterates, if it was replaced by
+ * scalars (NULL otherwise).
+ */
+Variable *findScalarIterable(const ParamsFor *params);
+
+#endif
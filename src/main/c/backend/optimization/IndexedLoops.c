@@ -0,0 +1,289 @@
+#include "IndexedLoops.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+static NodeTable _loops = {NULL, NULL, 0, 0};
+
+void initializeIndexedLoopsModule() {
+	_logger = createLogger("IndexedLoops");
+}
+
+void shutdownIndexedLoopsModule() {
+	releaseAnnotations(&_loops);
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The number of buckets of the table of names.
+ */
+#define INDEXED_LOOPS_BUCKETS 256
+
+typedef struct NameFacts NameFacts;
+
+/**
+ * What the whole program tells about the values of a name.
+ */
+struct NameFacts {
+	const char *name;
+	unsigned int declarations;		  // of any kind (parameters, functions, ...)
+	unsigned int arrayDeclarations;	  // the ones that are proven to be arrays
+	unsigned int writes;			  // of anything but an array literal
+	NameFacts *next;
+};
+
+/**
+ * The state of a single run of the pass.
+ */
+typedef struct {
+	Arena *arena;
+	NameFacts *buckets[INDEXED_LOOPS_BUCKETS];
+	unsigned int nodes;
+	unsigned int indexed;
+} Indexing;
+
+static void _collectCode(Indexing *indexing, Code *code);
+static void _collectDeclaration(Indexing *indexing, Declaration *declaration);
+static void _collectFunctionBody(Indexing *indexing, VariableTypeList *parameters, FunctionBody *body);
+static NameFacts *_findName(Indexing *indexing, const char *name);
+static unsigned int _hashName(const char *name);
+static void _indexCode(Indexing *indexing, Code *code);
+static boolean _indexLoop(Indexing *indexing, ForLoop *forLoop);
+static boolean _isArrayType(const Type *type);
+
+static void _collectCode(Indexing *indexing, Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		switch (statement->statement) {
+			case IF_ST:
+				_collectCode(indexing, statement->ifStatement->thenBody);
+				_collectCode(indexing, statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_collectCode(indexing, statement->whileLoop->body);
+				break;
+			case FOR_ST: {
+				ParamsFor *params = statement->forLoop->params;
+				Declaration *declaration = params->type == FOR_CLASSIC ? params->init : params->value;
+				if (declaration != NULL) {
+					// The variable of a for...of holds elements, not the array.
+					++_findName(indexing, declaration->variable->variableType->id)->declarations;
+				}
+				_collectCode(indexing, statement->forLoop->body);
+				break;
+			}
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_collectCode(indexing, content->body);
+				}
+				break;
+			case DECLARATION_ST:
+				_collectDeclaration(indexing, statement->declaration);
+				break;
+			case VARIABLE_ST:
+				if (statement->variable->type != ARRAY_VAR) {
+					++_findName(indexing, statement->variable->variableType->id)->writes;
+				}
+				break;
+			case INC_DEC_ST:
+				if (statement->incDec->expression->type == FACTOR && statement->incDec->expression->factor->type == VARIABLE) {
+					++_findName(indexing, statement->incDec->expression->factor->variableName)->writes;
+				}
+				break;
+			case FUNCTION_DECLARATION_ST:
+				++_findName(indexing, statement->FunctionDeclaration->id)->declarations;
+				_collectFunctionBody(indexing, statement->FunctionDeclaration->arguments, statement->FunctionDeclaration->body);
+				break;
+			case ASYNC_FUNCTION_ST:
+				++_findName(indexing, statement->asyncFunction->id)->declarations;
+				_collectFunctionBody(indexing, statement->asyncFunction->arguments, statement->asyncFunction->body);
+				break;
+			case TYPE_DECLARATION_ST:
+				++_findName(indexing, statement->typeDeclaration->id)->declarations;
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * Records a declaration, which proves an array if it holds an array literal
+ * or if its annotation says so (and it is initialized).
+ */
+static void _collectDeclaration(Indexing *indexing, Declaration *declaration) {
+	Variable *variable = declaration->variable;
+	NameFacts *facts = _findName(indexing, variable->variableType->id);
+	++facts->declarations;
+	if (variable->type == ARRAY_VAR || (variable->type != UNINITIALIZED && _isArrayType(variable->variableType->type))) {
+		++facts->arrayDeclarations;
+	}
+}
+
+static void _collectFunctionBody(Indexing *indexing, VariableTypeList *parameters, FunctionBody *body) {
+	for (; parameters != NULL; parameters = parameters->next) {
+		NameFacts *facts = _findName(indexing, parameters->variableType->id);
+		++facts->declarations;
+		if (_isArrayType(parameters->variableType->type)) {
+			++facts->arrayDeclarations;
+		}
+	}
+	if (body != NULL) {
+		_collectCode(indexing, body->code);
+		if (body->returnValue != NULL && body->returnValue->type == ASYNC_FUNCTION_RT) {
+			AsyncFunction *asyncFunction = body->returnValue->asyncFunction;
+			++_findName(indexing, asyncFunction->id)->declarations;
+			_collectFunctionBody(indexing, asyncFunction->arguments, asyncFunction->body);
+		}
+	}
+}
+
+static NameFacts *_findName(Indexing *indexing, const char *name) {
+	const unsigned int bucket = _hashName(name);
+	for (NameFacts *facts = indexing->buckets[bucket]; facts != NULL; facts = facts->next) {
+		if (strcmp(facts->name, name) == 0) {
+			return facts;
+		}
+	}
+	NameFacts *facts = allocateInArena(indexing->arena, sizeof(NameFacts));
+	facts->name = name;
+	facts->next = indexing->buckets[bucket];
+	indexing->buckets[bucket] = facts;
+	return facts;
+}
+
+static unsigned int _hashName(const char *name) {
+	unsigned int hash = 2166136261u;
+	for (; *name != '\0'; ++name) {
+		hash = (hash ^ (unsigned char) *name) * 16777619u;
+	}
+	return hash % INDEXED_LOOPS_BUCKETS;
+}
+
+static void _indexCode(Indexing *indexing, Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		++indexing->nodes;
+		switch (statement->statement) {
+			case IF_ST:
+				_indexCode(indexing, statement->ifStatement->thenBody);
+				_indexCode(indexing, statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_indexCode(indexing, statement->whileLoop->body);
+				break;
+			case FOR_ST:
+				_indexCode(indexing, statement->forLoop->body);
+				if (_indexLoop(indexing, statement->forLoop)) {
+					++indexing->indexed;
+				}
+				break;
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_indexCode(indexing, content->body);
+				}
+				break;
+			case FUNCTION_DECLARATION_ST:
+				if (statement->FunctionDeclaration->body != NULL) {
+					_indexCode(indexing, statement->FunctionDeclaration->body->code);
+				}
+				break;
+			case ASYNC_FUNCTION_ST:
+				if (statement->asyncFunction->body != NULL) {
+					_indexCode(indexing, statement->asyncFunction->body->code);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * Marks the loop to be indexed, if its iterable is proven to be an array of
+ * invariant length. Returns false otherwise.
+ */
+static boolean _indexLoop(Indexing *indexing, ForLoop *forLoop) {
+	ParamsFor *params = forLoop->params;
+	if (params->type != FOR_OF || findIndexedLoop(params) != NULL || params->value == NULL) {
+		return false;
+	}
+	const char *element = params->value->variable->variableType->id;
+	IterableVariable *iterable = params->iterable;
+	const char *array = iterable->type == VARIABLE_IT ? iterable->variableName : NULL;
+	if (iterable->type != ARRAY_IT && array == NULL) {
+		return false;
+	}
+	if (array != NULL) {
+		const NameFacts *facts = _findName(indexing, array);
+		if (facts->declarations != 1 || facts->arrayDeclarations != 1 || facts->writes != 0 || strcmp(array, element) == 0) {
+			return false;
+		}
+		// Any call could reach the array (and change its length).
+		if (containsCalls(forLoop->body)) {
+			return false;
+		}
+	}
+	// The element is declared inside the body, so the body must not declare
+	// it again (nor hide the array).
+	NameSet written = {NULL, 0, 0};
+	collectWrittenNames(forLoop->body, &written, true);
+	const boolean clash = containsName(&written, element) || (array != NULL && containsName(&written, array));
+	releaseNames(&written);
+	if (clash) {
+		return false;
+	}
+	IndexedLoop *indexed = allocateNode(sizeof(IndexedLoop));
+	indexed->index = createSyntheticName("k");
+	// A literal is evaluated once, into a copy that nothing else can reach.
+	indexed->items = array == NULL ? createSyntheticName("items") : NULL;
+	annotateNode(&_loops, params, indexed);
+	logDebugging(_logger, "The loop over the elements \"%s\" of %s is indexed by \"%s\".", element, array == NULL ? "a literal" : array, indexed->index);
+	return true;
+}
+
+/**
+ * True if the annotation is a single array type (e.g., "number[]").
+ */
+static boolean _isArrayType(const Type *type) {
+	if (type == NULL || type->next != NULL) {
+		return false;
+	}
+	switch (type->singleType) {
+		case NBR_ARRAY:
+		case STR_ARRAY:
+		case BOOL_ARRAY:
+		case ANY_ARRAY:
+		case VOID_ARRAY:
+		case UNDEF_ARRAY:
+		case NEVER_ARRAY:
+		case UNK_ARRAY:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult indexArrayLoops(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	Indexing indexing = {
+		.arena = createArena(4096),
+		.buckets = {NULL},
+		.nodes = 0,
+		.indexed = 0};
+	_collectCode(&indexing, program->code);
+	_indexCode(&indexing, program->code);
+	destroyArena(indexing.arena);
+	PassResult result = {.nodes = indexing.nodes, .changed = 0 < indexing.indexed};
+	return result;
+}
+
+const IndexedLoop *findIndexedLoop(const ParamsFor *params) {
+	return findAnnotation(&_loops, params);
+}
@@ -0,0 +1,46 @@
+#ifndef INDEXED_LOOPS_HEADER
+#define INDEXED_LOOPS_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Arena.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "PassManager.h"
+#include "TreeRewriting.h"
+#include <string.h>
+
+/**
+ * How a for...of over an array is indexed.
+ */
+typedef struct {
+	char *index;	// the name of the index
+	char *items;	// the copy of a literal iterable, if any
+} IndexedLoop;
+
+/** Initialize module's internal state. */
+void initializeIndexedLoopsModule();
+
+/** Shutdown module's internal state. */
+void shutdownIndexedLoopsModule();
+
+/**
+ * Proves which for...of loops iterate over an array whose length cannot
+ * change while they run, and marks them to be emitted as a loop over an
+ * index instead (see findIndexedLoop). The index ranges over
+ * [0, length) by construction, so every element access is in bounds, and
+ * the loop skips the iterator protocol.
+ *
+ * An iterable is proven to be an array if it is an array literal, or a
+ * binding declared once (with an array literal, or annotated as an array)
+ * and never assigned anything but array literals. The length of a binding
+ * is invariant if the loop neither writes it nor calls any function.
+ */
+PassResult indexArrayLoops(CompilerState *compilerState);
+
+/**
+ * How the for...of is indexed, or NULL if it iterates as usual.
+ */
+const IndexedLoop *findIndexedLoop(const ParamsFor *params);
+
+#endif
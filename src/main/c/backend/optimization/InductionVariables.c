@@ -0,0 +1,431 @@
+#include "InductionVariables.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializeInductionVariablesModule() {
+	_logger = createLogger("InductionVariables");
+}
+
+void shutdownInductionVariablesModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The largest integer that a double represents exactly, along with all the
+ * integers below it.
+ */
+#define EXACT_INTEGER_LIMIT 9007199254740992LL
+
+/**
+ * The accumulator that replaces the products of the induction variable with
+ * a single factor.
+ */
+typedef struct {
+	long long factor;
+	const char *name;
+} Accumulator;
+
+/**
+ * The state of the reduction of a single loop.
+ */
+typedef struct {
+	InductionVariable *inductionVariable;
+	long long largestFactor;
+	Accumulator *accumulators;
+	unsigned int count;
+	unsigned int capacity;
+} Reduction;
+
+/**
+ * The state of a single run of the pass.
+ */
+typedef struct {
+	unsigned int nodes;
+	unsigned int reduced;
+} StrengthReduction;
+
+static Code **_append(Code **code, Statement *statement);
+static boolean _integerLiteral(const Expression *expression, long long *value);
+static ExpressionType _mirror(const ExpressionType comparison);
+static boolean _reduceExpression(Reduction *reduction, Expression *expression);
+static void _reduceCode(Reduction *reduction, Code *code);
+static void _reduceLoops(StrengthReduction *strengthReduction, Code **code);
+static void _reduceVariable(Reduction *reduction, Variable *variable);
+static boolean _tripCount(InductionVariable *inductionVariable);
+
+/**
+ * Appends a statement at the end of the code, and returns the link to it.
+ */
+static Code **_append(Code **code, Statement *statement) {
+	while (*code != NULL) {
+		code = &(*code)->next;
+	}
+	*code = createCode(statement, NULL);
+	return code;
+}
+
+static boolean _integerLiteral(const Expression *expression, long long *value) {
+	if (expression == NULL || expression->type != FACTOR || expression->factor->type != CONSTANT) {
+		return false;
+	}
+	const Constant *constant = expression->factor->constant;
+	if (constant->type != NUMBER || constant->numberType != INTEGER_NT) {
+		return false;
+	}
+	*value = constant->integer;
+	return true;
+}
+
+/**
+ * The comparison with its operands swapped ("b > i" is "i < b").
+ */
+static ExpressionType _mirror(const ExpressionType comparison) {
+	switch (comparison) {
+		case GREATER_OP: return LESS_OP;
+		case LESS_OP: return GREATER_OP;
+		case GREATER_EQUAL_OP: return LESS_EQUAL_OP;
+		case LESS_EQUAL_OP: return GREATER_EQUAL_OP;
+		default: return comparison;
+	}
+}
+
+/**
+ * Replaces the products "i * c" and "c * i" of the expression with their
+ * accumulator. Returns true if anything was replaced.
+ */
+static boolean _reduceExpression(Reduction *reduction, Expression *expression) {
+	if (expression == NULL) {
+		return false;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			return expression->factor->type == EXPRESSION && _reduceExpression(reduction, expression->factor->expression);
+		case NOT_OP:
+		case AWAIT_OP:
+			return _reduceExpression(reduction, expression->expression);
+		case MUL_OP: {
+			const char *name = reduction->inductionVariable->name;
+			long long factor;
+			const boolean leftFactor = isVariableExpression(expression->rightExpression, name) && _integerLiteral(expression->leftExpression, &factor);
+			const boolean rightFactor = isVariableExpression(expression->leftExpression, name) && _integerLiteral(expression->rightExpression, &factor);
+			if ((leftFactor || rightFactor) && factor <= reduction->largestFactor && -reduction->largestFactor <= factor) {
+				unsigned int k = 0;
+				while (k < reduction->count && reduction->accumulators[k].factor != factor) {
+					++k;
+				}
+				if (k == reduction->count) {
+					if (reduction->count == reduction->capacity) {
+						reduction->capacity = reduction->capacity == 0 ? 4 : 2 * reduction->capacity;
+						reduction->accumulators = realloc(reduction->accumulators, reduction->capacity * sizeof(Accumulator));
+					}
+					reduction->accumulators[k].factor = factor;
+					reduction->accumulators[k].name = createSyntheticName(name);
+					++reduction->count;
+				}
+				*expression = *createVariableExpression(reduction->accumulators[k].name);
+				return true;
+			}
+		}
+		// Fallthrough.
+		default: {
+			const boolean left = _reduceExpression(reduction, expression->leftExpression);
+			const boolean right = _reduceExpression(reduction, expression->rightExpression);
+			return left || right;
+		}
+	}
+}
+
+/**
+ * Reduces every expression of the code that runs in the same iteration,
+ * including the ones of nested loops and branches.
+ */
+static void _reduceCode(Reduction *reduction, Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		switch (statement->statement) {
+			case IF_ST:
+				_reduceExpression(reduction, statement->ifStatement->condition);
+				_reduceCode(reduction, statement->ifStatement->thenBody);
+				_reduceCode(reduction, statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_reduceExpression(reduction, statement->whileLoop->condition);
+				_reduceCode(reduction, statement->whileLoop->body);
+				break;
+			case FOR_ST: {
+				ParamsFor *params = statement->forLoop->params;
+				if (params->type == FOR_CLASSIC) {
+					if (params->init != NULL) {
+						_reduceVariable(reduction, params->init->variable);
+					}
+					_reduceExpression(reduction, params->condition);
+					if (params->updateType == EXPRESSION_UT) {
+						_reduceExpression(reduction, params->update);
+					}
+				}
+				_reduceCode(reduction, statement->forLoop->body);
+				break;
+			}
+			case DECLARATION_ST:
+				_reduceVariable(reduction, statement->declaration->variable);
+				break;
+			case VARIABLE_ST:
+				_reduceVariable(reduction, statement->variable);
+				break;
+			case EXPRESSION_ST:
+				_reduceExpression(reduction, statement->expression);
+				break;
+			case FUNCTIONCALL_ST:
+				for (ArgumentList *argument = statement->functionCall->arguments; argument != NULL; argument = argument->next) {
+					_reduceExpression(reduction, argument->expression);
+				}
+				break;
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_reduceExpression(reduction, content->condition);
+					_reduceCode(reduction, content->body);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * Reduces the loops of the code (innermost first), and declares their
+ * accumulators right before them.
+ */
+static void _reduceLoops(StrengthReduction *strengthReduction, Code **code) {
+	for (; *code != NULL; code = &(*code)->next) {
+		Statement *statement = (*code)->statement;
+		++strengthReduction->nodes;
+		switch (statement->statement) {
+			case IF_ST:
+				_reduceLoops(strengthReduction, &statement->ifStatement->thenBody);
+				_reduceLoops(strengthReduction, &statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_reduceLoops(strengthReduction, &statement->whileLoop->body);
+				break;
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_reduceLoops(strengthReduction, &content->body);
+				}
+				break;
+			case FUNCTION_DECLARATION_ST:
+				if (statement->FunctionDeclaration->body != NULL) {
+					_reduceLoops(strengthReduction, &statement->FunctionDeclaration->body->code);
+				}
+				break;
+			case ASYNC_FUNCTION_ST:
+				if (statement->asyncFunction->body != NULL) {
+					_reduceLoops(strengthReduction, &statement->asyncFunction->body->code);
+				}
+				break;
+			case FOR_ST: {
+				ForLoop *forLoop = statement->forLoop;
+				_reduceLoops(strengthReduction, &forLoop->body);
+				InductionVariable inductionVariable;
+				if (!findInductionVariable(forLoop, &inductionVariable)) {
+					break;
+				}
+				if (inductionVariable.constantTripCount) {
+					logDebugging(_logger, "The loop over \"%s\" runs %lld times.", inductionVariable.name, inductionVariable.tripCount);
+				}
+				if (!inductionVariable.constantTripCount || !inductionVariable.constantInitial) {
+					break;
+				}
+				// The variable takes every value between both ends (the last one
+				// only in the condition), so every product below the limit is exact.
+				const long long last = inductionVariable.initial + inductionVariable.step * inductionVariable.tripCount;
+				const long long first = inductionVariable.initial;
+				const long long largest = llabs(first) < llabs(last) ? llabs(last) : llabs(first);
+				Reduction reduction = {
+					.inductionVariable = &inductionVariable,
+					.largestFactor = (EXACT_INTEGER_LIMIT - 1) / (largest == 0 ? 1 : largest),
+					.accumulators = NULL,
+					.count = 0,
+					.capacity = 0};
+				if (INT_MAX < reduction.largestFactor) {
+					reduction.largestFactor = INT_MAX;
+				}
+				_reduceExpression(&reduction, forLoop->params->condition);
+				_reduceCode(&reduction, forLoop->body);
+				for (unsigned int k = 0; k < reduction.count; ++k) {
+					const Accumulator *accumulator = &reduction.accumulators[k];
+					const long long initial = first * accumulator->factor;
+					const long long increment = inductionVariable.step * accumulator->factor;
+					Expression *value = initial < INT_MIN || INT_MAX < initial
+						? createBinaryExpression(MUL_OP, createIntegerExpression((int) first), createIntegerExpression((int) accumulator->factor))
+						: createIntegerExpression((int) initial);
+					*code = createCode(createDeclarationStatement(LET_DT, accumulator->name, value), *code);
+					code = &(*code)->next;
+					_append(&forLoop->body, createAssignmentStatement(accumulator->name,
+						createBinaryExpression(increment < 0 ? SUB_OP : ADD_OP, createVariableExpression(accumulator->name), createIntegerExpression((int) llabs(increment)))));
+					logDebugging(_logger, "Reduced \"%s * %lld\" into the accumulator \"%s\".", inductionVariable.name, accumulator->factor, accumulator->name);
+					++strengthReduction->reduced;
+				}
+				free(reduction.accumulators);
+				break;
+			}
+			default:
+				break;
+		}
+	}
+}
+
+static void _reduceVariable(Reduction *reduction, Variable *variable) {
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_reduceExpression(reduction, variable->expression);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				_reduceExpression(reduction, element->value);
+			}
+			break;
+		case OBJECT_VAR:
+			for (ObjectContent *property = variable->objectContent; property != NULL; property = property->next) {
+				_reduceExpression(reduction, property->value);
+			}
+			break;
+		case FUNCTIONCALL_VAR:
+			for (ArgumentList *argument = variable->functionCall->arguments; argument != NULL; argument = argument->next) {
+				_reduceExpression(reduction, argument->expression);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Computes the trip count of the loop, if both ends are integer literals
+ * and the variable moves towards the bound.
+ */
+static boolean _tripCount(InductionVariable *inductionVariable) {
+	if (!inductionVariable->constantInitial || !inductionVariable->constantBound) {
+		return false;
+	}
+	const long long distance = inductionVariable->boundValue - inductionVariable->initial;
+	const int step = inductionVariable->step;
+	long long count;
+	switch (inductionVariable->comparison) {
+		case LESS_OP:
+			count = distance;
+			break;
+		case LESS_EQUAL_OP:
+			count = distance + 1;
+			break;
+		case GREATER_OP:
+			count = -distance;
+			break;
+		case GREATER_EQUAL_OP:
+			count = 1 - distance;
+			break;
+		case NEQUAL_OP:
+		case STRICT_NEQUAL_OP:
+			// It never stops unless it reaches the bound exactly.
+			if ((step < 0) != (distance < 0)) {
+				return false;
+			}
+			count = step * distance;
+			break;
+		default:
+			return false;
+	}
+	const boolean ascending = inductionVariable->comparison == LESS_OP || inductionVariable->comparison == LESS_EQUAL_OP;
+	const boolean descending = inductionVariable->comparison == GREATER_OP || inductionVariable->comparison == GREATER_EQUAL_OP;
+	if ((ascending && step < 0) || (descending && 0 < step)) {
+		// It runs forever (or never, if the condition is false from the start).
+		if (0 < count) {
+			return false;
+		}
+	}
+	inductionVariable->tripCount = count < 0 ? 0 : count;
+	return true;
+}
+
+/** PUBLIC FUNCTIONS */
+
+boolean findInductionVariable(ForLoop *forLoop, InductionVariable *inductionVariable) {
+	ParamsFor *params = forLoop->params;
+	if (params->type != FOR_CLASSIC || params->init == NULL || params->init->type == CONST_DT || params->condition == NULL) {
+		return false;
+	}
+	Variable *variable = params->init->variable;
+	if (variable->type != EXPRESSION_VAR || params->updateType != INC_DEC_UT || params->updateIncDec == NULL) {
+		return false;
+	}
+	const char *name = variable->variableType->id;
+	memset(inductionVariable, 0, sizeof(InductionVariable));
+	inductionVariable->name = name;
+	inductionVariable->constantInitial = _integerLiteral(variable->expression, &inductionVariable->initial);
+
+	// The update: "i++", "++i", "i--" or "--i".
+	if (!isVariableExpression(params->updateIncDec->expression, name)) {
+		return false;
+	}
+	inductionVariable->step = params->updateIncDec->type == INC_OP ? 1 : -1;
+
+	// The condition: the variable compared against an expression without it.
+	Expression *condition = params->condition;
+	switch (condition->type) {
+		case LESS_OP:
+		case LESS_EQUAL_OP:
+		case GREATER_OP:
+		case GREATER_EQUAL_OP:
+		case NEQUAL_OP:
+		case STRICT_NEQUAL_OP:
+			break;
+		default:
+			return false;
+	}
+	if (isVariableExpression(condition->leftExpression, name) && !readsVariable(condition->rightExpression, name)) {
+		inductionVariable->comparison = condition->type;
+		inductionVariable->bound = condition->rightExpression;
+	}
+	else if (isVariableExpression(condition->rightExpression, name) && !readsVariable(condition->leftExpression, name)) {
+		inductionVariable->comparison = _mirror(condition->type);
+		inductionVariable->bound = condition->leftExpression;
+	}
+	else {
+		return false;
+	}
+	if (expressionContainsCalls(inductionVariable->bound)) {
+		return false;
+	}
+	inductionVariable->constantBound = _integerLiteral(inductionVariable->bound, &inductionVariable->boundValue);
+
+	// The body must leave the variable (and the bound) alone.
+	if (containsFunctions(forLoop->body)) {
+		return false;
+	}
+	NameSet written = {NULL, 0, 0};
+	collectWrittenNames(forLoop->body, &written, true);
+	boolean canonical = !containsName(&written, name);
+	for (unsigned int k = 0; canonical && k < written.count; ++k) {
+		canonical = !readsVariable(inductionVariable->bound, written.names[k]);
+	}
+	releaseNames(&written);
+	if (!canonical) {
+		return false;
+	}
+	inductionVariable->constantTripCount = _tripCount(inductionVariable);
+	return true;
+}
+
+PassResult reduceStrength(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	StrengthReduction strengthReduction = {.nodes = 0, .reduced = 0};
+	_reduceLoops(&strengthReduction, &program->code);
+	PassResult result = {.nodes = strengthReduction.nodes, .changed = 0 < strengthReduction.reduced};
+	return result;
+}
@@ -0,0 +1,60 @@
+#ifndef INDUCTION_VARIABLES_HEADER
+#define INDUCTION_VARIABLES_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "PassManager.h"
+#include "TreeRewriting.h"
+#include <limits.h>
+#include <stdlib.h>
+
+/** Initialize module's internal state. */
+void initializeInductionVariablesModule();
+
+/** Shutdown module's internal state. */
+void shutdownInductionVariablesModule();
+
+/**
+ * The canonical induction variable of a classic for loop: a variable
+ * declared by the initialization, compared against a bound that the body
+ * never writes, and only changed by the update, one unit at a time.
+ */
+typedef struct {
+	const char *name;
+
+	// The initial value, if it is an integer literal.
+	boolean constantInitial;
+	long long initial;
+
+	// +1 or -1 per iteration.
+	int step;
+
+	// The comparison, as if the variable was on the left ("i < bound").
+	ExpressionType comparison;
+	Expression *bound;
+	boolean constantBound;
+	long long boundValue;
+
+	// The number of iterations, if both ends are integer literals.
+	boolean constantTripCount;
+	long long tripCount;
+} InductionVariable;
+
+/**
+ * Recognizes the canonical induction variable of a loop. Returns false if
+ * the loop is not a classic for loop in canonical shape, or if its body may
+ * write the variable or the bound (or capture them in a function).
+ */
+boolean findInductionVariable(ForLoop *forLoop, InductionVariable *inductionVariable);
+
+/**
+ * Replaces every product of a canonical induction variable and an integer
+ * literal with an accumulator, declared before the loop and incremented at
+ * the end of the body. Only loops with a known trip count are reduced, so
+ * every product is proven to be exact (below 2^53).
+ */
+PassResult reduceStrength(CompilerState *compilerState);
+
+#endif
@@ -0,0 +1,699 @@
+#include "Inliner.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializeInlinerModule() {
+	_logger = createLogger("Inliner");
+}
+
+void shutdownInlinerModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The number of buckets of the table of names.
+ */
+#define INLINER_BUCKETS 256
+
+/**
+ * The largest callee (in nodes) inlined at -O1, and at -O2.
+ */
+#define INLINE_THRESHOLD 16
+#define AGGRESSIVE_INLINE_THRESHOLD 48
+
+/**
+ * The longest chain of forwarders collapsed at a single call site.
+ */
+#define MAXIMUM_INLINE_DEPTH 8
+
+typedef struct NameUsage NameUsage;
+
+/**
+ * How a name is declared and written across the whole program.
+ */
+struct NameUsage {
+	const char *name;
+	FunctionDeclaration *function;	  // the top-level function, if any
+	unsigned int topLevelFunctions;
+	unsigned int topLevelBindings;	  // other top-level declarations
+	unsigned int localDeclarations;	  // parameters, locals, nested functions
+	unsigned int writes;
+	NameUsage *next;
+};
+
+/**
+ * The state of a single run of the pass.
+ */
+typedef struct {
+	Arena *arena;
+	NameUsage *buckets[INLINER_BUCKETS];
+	const Profile *profile;
+	unsigned int threshold;
+	long budget;
+	unsigned int nodes;
+	unsigned int inlined;
+} Inlining;
+
+/**
+ * The outcome of inlining a call: either an expression, or another call.
+ */
+typedef struct {
+	Expression *expression;
+	FunctionCall *functionCall;
+} Inlined;
+
+static ArgumentList *_cloneArguments(ArgumentList *arguments, VariableTypeList *parameters, ArgumentList *values);
+static Expression *_cloneExpression(Expression *expression, VariableTypeList *parameters, ArgumentList *values);
+static void _collectCode(Inlining *inlining, Code *code, const boolean topLevel);
+static void _collectFunctionBody(Inlining *inlining, VariableTypeList *parameters, FunctionBody *body);
+static void _collectStatement(Inlining *inlining, Statement *statement, const boolean topLevel);
+static boolean _eligible(Inlining *inlining, FunctionDeclaration *function);
+static unsigned int _expressionSize(const Expression *expression);
+static NameUsage *_findName(Inlining *inlining, const char *name, const boolean create);
+static boolean _freeNamesAreVisible(Inlining *inlining, const Expression *expression, VariableTypeList *parameters);
+static unsigned int _hashName(const char *name);
+static boolean _inlineCall(Inlining *inlining, FunctionCall *functionCall, Inlined *inlined);
+static boolean _inlineChain(Inlining *inlining, FunctionCall *functionCall, Inlined *inlined);
+static void _inlineCode(Inlining *inlining, Code **code);
+static void _inlineExpression(Inlining *inlining, Expression *expression);
+static void _inlineFunctionBody(Inlining *inlining, FunctionBody *body);
+static void _inlineVariable(Inlining *inlining, Variable *variable);
+static boolean _isParameter(const char *name, VariableTypeList *parameters);
+static boolean _isPure(const Expression *expression);
+static Expression *_parameterValue(const char *name, VariableTypeList *parameters, ArgumentList *values);
+static boolean _recursive(Inlining *inlining, FunctionDeclaration *function);
+static FunctionDeclaration *_resolve(Inlining *inlining, const FunctionCall *functionCall);
+
+static ArgumentList *_cloneArguments(ArgumentList *arguments, VariableTypeList *parameters, ArgumentList *values) {
+	if (arguments == NULL) {
+		return NULL;
+	}
+	ArgumentList *clone = allocateNode(sizeof(ArgumentList));
+	clone->expression = _cloneExpression(arguments->expression, parameters, values);
+	clone->next = _cloneArguments(arguments->next, parameters, values);
+	return clone;
+}
+
+/**
+ * Copies an expression, replacing every parameter with a copy of its value.
+ * Literals are shared, because no pass modifies them.
+ */
+static Expression *_cloneExpression(Expression *expression, VariableTypeList *parameters, ArgumentList *values) {
+	if (expression == NULL) {
+		return NULL;
+	}
+	if (expression->type == FACTOR && expression->factor->type == VARIABLE) {
+		Expression *value = _parameterValue(expression->factor->variableName, parameters, values);
+		if (value != NULL) {
+			return _cloneExpression(value, NULL, NULL);
+		}
+	}
+	Expression *clone = allocateNode(sizeof(Expression));
+	*clone = *expression;
+	switch (expression->type) {
+		case FACTOR:
+			clone->factor = allocateNode(sizeof(Factor));
+			*clone->factor = *expression->factor;
+			if (expression->factor->type == EXPRESSION) {
+				clone->factor->expression = _cloneExpression(expression->factor->expression, parameters, values);
+			}
+			else if (expression->factor->type == FUNCTIONCALL) {
+				clone->factor->functionCall = allocateNode(sizeof(FunctionCall));
+				*clone->factor->functionCall = *expression->factor->functionCall;
+				clone->factor->functionCall->arguments = _cloneArguments(expression->factor->functionCall->arguments, parameters, values);
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			clone->expression = _cloneExpression(expression->expression, parameters, values);
+			break;
+		default:
+			clone->leftExpression = _cloneExpression(expression->leftExpression, parameters, values);
+			clone->rightExpression = _cloneExpression(expression->rightExpression, parameters, values);
+			break;
+	}
+	return clone;
+}
+
+/**
+ * Registers every declaration and write of the code. Only the direct
+ * statements of the program are top-level: the blocks of control
+ * structures declare locals.
+ */
+static void _collectCode(Inlining *inlining, Code *code, const boolean topLevel) {
+	for (; code != NULL; code = code->next) {
+		_collectStatement(inlining, code->statement, topLevel);
+	}
+}
+
+static void _collectFunctionBody(Inlining *inlining, VariableTypeList *parameters, FunctionBody *body) {
+	for (; parameters != NULL; parameters = parameters->next) {
+		++_findName(inlining, parameters->variableType->id, true)->localDeclarations;
+	}
+	if (body != NULL) {
+		_collectCode(inlining, body->code, false);
+		if (body->returnValue != NULL && body->returnValue->type == ASYNC_FUNCTION_RT) {
+			AsyncFunction *asyncFunction = body->returnValue->asyncFunction;
+			++_findName(inlining, asyncFunction->id, true)->localDeclarations;
+			_collectFunctionBody(inlining, asyncFunction->arguments, asyncFunction->body);
+		}
+	}
+}
+
+static void _collectStatement(Inlining *inlining, Statement *statement, const boolean topLevel) {
+	switch (statement->statement) {
+		case IF_ST:
+			_collectCode(inlining, statement->ifStatement->thenBody, false);
+			_collectCode(inlining, statement->ifStatement->elseBody, false);
+			break;
+		case WHILE_ST:
+			_collectCode(inlining, statement->whileLoop->body, false);
+			break;
+		case FOR_ST: {
+			ParamsFor *params = statement->forLoop->params;
+			Declaration *declaration = params->type == FOR_CLASSIC ? params->init : params->value;
+			if (declaration != NULL) {
+				++_findName(inlining, declaration->variable->variableType->id, true)->localDeclarations;
+			}
+			_collectCode(inlining, statement->forLoop->body, false);
+			break;
+		}
+		case SWITCH_ST:
+			for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+				_collectCode(inlining, content->body, false);
+			}
+			break;
+		case DECLARATION_ST: {
+			NameUsage *usage = _findName(inlining, statement->declaration->variable->variableType->id, true);
+			if (topLevel) {
+				++usage->topLevelBindings;
+			}
+			else {
+				++usage->localDeclarations;
+			}
+			break;
+		}
+		case VARIABLE_ST:
+			++_findName(inlining, statement->variable->variableType->id, true)->writes;
+			break;
+		case INC_DEC_ST:
+			if (statement->incDec->expression->type == FACTOR && statement->incDec->expression->factor->type == VARIABLE) {
+				++_findName(inlining, statement->incDec->expression->factor->variableName, true)->writes;
+			}
+			break;
+		case FUNCTION_DECLARATION_ST: {
+			FunctionDeclaration *function = statement->FunctionDeclaration;
+			NameUsage *usage = _findName(inlining, function->id, true);
+			if (topLevel) {
+				++usage->topLevelFunctions;
+				usage->function = function;
+			}
+			else {
+				++usage->localDeclarations;
+			}
+			_collectFunctionBody(inlining, function->arguments, function->body);
+			break;
+		}
+		case ASYNC_FUNCTION_ST: {
+			NameUsage *usage = _findName(inlining, statement->asyncFunction->id, true);
+			if (topLevel) {
+				++usage->topLevelBindings;
+			}
+			else {
+				++usage->localDeclarations;
+			}
+			_collectFunctionBody(inlining, statement->asyncFunction->arguments, statement->asyncFunction->body);
+			break;
+		}
+		case TYPE_DECLARATION_ST: {
+			NameUsage *usage = _findName(inlining, statement->typeDeclaration->id, true);
+			if (topLevel) {
+				++usage->topLevelBindings;
+			}
+			else {
+				++usage->localDeclarations;
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+/**
+ * True if the function can be inlined at any call site of the program.
+ */
+static boolean _eligible(Inlining *inlining, FunctionDeclaration *function) {
+	const NameUsage *usage = _findName(inlining, function->id, false);
+	if (usage->topLevelFunctions != 1 || usage->topLevelBindings != 0 || usage->localDeclarations != 0 || usage->writes != 0) {
+		return false;
+	}
+	FunctionBody *body = function->body;
+	if (body == NULL || body->code != NULL || body->returnValue == NULL) {
+		return false;
+	}
+	ReturnValue *returnValue = body->returnValue;
+	if (returnValue->type == EXPRESSION_RT) {
+		return _isPure(returnValue->expression)
+			&& _expressionSize(returnValue->expression) <= inlining->threshold
+			&& _freeNamesAreVisible(inlining, returnValue->expression, function->arguments);
+	}
+	if (returnValue->type == FUNCTIONCALL_RT && returnValue->functionCall->type == CLASSIC_CALL) {
+		const NameUsage *callee = _findName(inlining, returnValue->functionCall->id, false);
+		if (callee != NULL && callee->localDeclarations != 0) {
+			return false;
+		}
+		for (ArgumentList *argument = returnValue->functionCall->arguments; argument != NULL; argument = argument->next) {
+			if (!_isPure(argument->expression) || !_freeNamesAreVisible(inlining, argument->expression, function->arguments)) {
+				return false;
+			}
+		}
+		return !_recursive(inlining, function);
+	}
+	return false;
+}
+
+/**
+ * The number of operations and operands of an expression.
+ */
+static unsigned int _expressionSize(const Expression *expression) {
+	if (expression == NULL) {
+		return 0;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			if (expression->factor->type == EXPRESSION) {
+				return _expressionSize(expression->factor->expression);
+			}
+			return 1;
+		case NOT_OP:
+		case AWAIT_OP:
+			return 1 + _expressionSize(expression->expression);
+		default:
+			return 1 + _expressionSize(expression->leftExpression) + _expressionSize(expression->rightExpression);
+	}
+}
+
+static NameUsage *_findName(Inlining *inlining, const char *name, const boolean create) {
+	const unsigned int bucket = _hashName(name);
+	for (NameUsage *usage = inlining->buckets[bucket]; usage != NULL; usage = usage->next) {
+		if (strcmp(usage->name, name) == 0) {
+			return usage;
+		}
+	}
+	if (!create) {
+		return NULL;
+	}
+	NameUsage *usage = allocateInArena(inlining->arena, sizeof(NameUsage));
+	usage->name = name;
+	usage->next = inlining->buckets[bucket];
+	inlining->buckets[bucket] = usage;
+	return usage;
+}
+
+/**
+ * True if every name that the expression reads (other than the parameters)
+ * means the same at any call site, because no local declares it.
+ */
+static boolean _freeNamesAreVisible(Inlining *inlining, const Expression *expression, VariableTypeList *parameters) {
+	if (expression == NULL) {
+		return true;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			if (expression->factor->type == VARIABLE) {
+				const char *name = expression->factor->variableName;
+				const NameUsage *usage = _findName(inlining, name, false);
+				return _isParameter(name, parameters) || usage == NULL || usage->localDeclarations == 0;
+			}
+			if (expression->factor->type == EXPRESSION) {
+				return _freeNamesAreVisible(inlining, expression->factor->expression, parameters);
+			}
+			return expression->factor->type == CONSTANT;
+		case NOT_OP:
+		case AWAIT_OP:
+			return _freeNamesAreVisible(inlining, expression->expression, parameters);
+		default:
+			return _freeNamesAreVisible(inlining, expression->leftExpression, parameters)
+				&& _freeNamesAreVisible(inlining, expression->rightExpression, parameters);
+	}
+}
+
+/**
+ * The FNV-1a hash of a name, reduced to a bucket.
+ */
+static unsigned int _hashName(const char *name) {
+	unsigned int hash = 2166136261u;
+	for (; *name != '\0'; ++name) {
+		hash = (hash ^ (unsigned char) *name) * 16777619u;
+	}
+	return hash % INLINER_BUCKETS;
+}
+
+/**
+ * Inlines a call (and the chain of forwarders it leads to), if the cost
+ * model and the budget allow it. Returns false if nothing was inlined. With
+ * a profile, a call that never ran is left alone (it is not worth growing
+ * the program), and a hot one takes the threshold of -O2.
+ */
+static boolean _inlineCall(Inlining *inlining, FunctionCall *functionCall, Inlined *inlined) {
+	++inlining->nodes;
+	inlined->expression = NULL;
+	inlined->functionCall = functionCall;
+	if (isColdSite(inlining->profile, functionCall)) {
+		return false;
+	}
+	const unsigned int threshold = inlining->threshold;
+	if (isHotSite(inlining->profile, functionCall) && threshold < AGGRESSIVE_INLINE_THRESHOLD) {
+		inlining->threshold = AGGRESSIVE_INLINE_THRESHOLD;
+	}
+	const boolean inlinedAny = _inlineChain(inlining, functionCall, inlined);
+	inlining->threshold = threshold;
+	return inlinedAny;
+}
+
+static boolean _inlineChain(Inlining *inlining, FunctionCall *functionCall, Inlined *inlined) {
+	for (unsigned int depth = 0; depth < MAXIMUM_INLINE_DEPTH; ++depth) {
+		FunctionDeclaration *function = _resolve(inlining, inlined->functionCall);
+		if (function == NULL || !_eligible(inlining, function)) {
+			break;
+		}
+		// Arguments are duplicated or dropped, so they must be pure.
+		unsigned int callSize = 1;
+		for (ArgumentList *argument = inlined->functionCall->arguments; argument != NULL; argument = argument->next) {
+			if (!_isPure(argument->expression)) {
+				return inlined->functionCall != functionCall;
+			}
+			callSize += _expressionSize(argument->expression);
+		}
+		ReturnValue *returnValue = function->body->returnValue;
+		if (returnValue->type == EXPRESSION_RT) {
+			Expression *expression = _cloneExpression(returnValue->expression, function->arguments, inlined->functionCall->arguments);
+			const long growth = (long) _expressionSize(expression) - (long) callSize;
+			if (inlining->budget < growth) {
+				break;
+			}
+			inlining->budget -= growth;
+			logDebugging(_logger, "Inlining \"%s\" (%ld nodes of growth).", function->id, growth);
+			++inlining->inlined;
+			inlined->expression = expression;
+			inlined->functionCall = NULL;
+			return true;
+		}
+		FunctionCall *call = allocateNode(sizeof(FunctionCall));
+		call->id = returnValue->functionCall->id;
+		call->type = CLASSIC_CALL;
+		call->arguments = _cloneArguments(returnValue->functionCall->arguments, function->arguments, inlined->functionCall->arguments);
+		logDebugging(_logger, "Forwarding the call to \"%s\" into \"%s\".", function->id, call->id);
+		++inlining->inlined;
+		inlined->functionCall = call;
+	}
+	return inlined->functionCall != functionCall;
+}
+
+static void _inlineCode(Inlining *inlining, Code **code) {
+	while (*code != NULL) {
+		Statement *statement = (*code)->statement;
+		Inlined inlined;
+		switch (statement->statement) {
+			case IF_ST:
+				_inlineExpression(inlining, statement->ifStatement->condition);
+				_inlineCode(inlining, &statement->ifStatement->thenBody);
+				_inlineCode(inlining, &statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_inlineExpression(inlining, statement->whileLoop->condition);
+				_inlineCode(inlining, &statement->whileLoop->body);
+				break;
+			case FOR_ST: {
+				ParamsFor *params = statement->forLoop->params;
+				if (params->type == FOR_CLASSIC) {
+					if (params->init != NULL) {
+						_inlineVariable(inlining, params->init->variable);
+					}
+					_inlineExpression(inlining, params->condition);
+					if (params->updateType == EXPRESSION_UT) {
+						_inlineExpression(inlining, params->update);
+					}
+				}
+				else if (params->iterable->type == FUNCTIONCALL_IT && _inlineCall(inlining, params->iterable->functionCall, &inlined)) {
+					// Only a call or a name can be iterated.
+					if (inlined.functionCall != NULL) {
+						params->iterable->functionCall = inlined.functionCall;
+					}
+					else if (inlined.expression->type == FACTOR && inlined.expression->factor->type == VARIABLE) {
+						params->iterable->type = VARIABLE_IT;
+						params->iterable->variableName = inlined.expression->factor->variableName;
+					}
+				}
+				_inlineCode(inlining, &statement->forLoop->body);
+				break;
+			}
+			case DECLARATION_ST:
+				_inlineVariable(inlining, statement->declaration->variable);
+				break;
+			case EXPRESSION_ST:
+				_inlineExpression(inlining, statement->expression);
+				break;
+			case VARIABLE_ST:
+				_inlineVariable(inlining, statement->variable);
+				break;
+			case FUNCTIONCALL_ST:
+				if (statement->functionCall->type == CLASSIC_CALL && _inlineCall(inlining, statement->functionCall, &inlined)) {
+					if (inlined.functionCall != NULL) {
+						statement->functionCall = inlined.functionCall;
+					}
+					else {
+						// A pure expression has no effect as a statement.
+						*code = (*code)->next;
+						continue;
+					}
+				}
+				break;
+			case FUNCTION_DECLARATION_ST:
+				_inlineFunctionBody(inlining, statement->FunctionDeclaration->body);
+				break;
+			case ASYNC_FUNCTION_ST:
+				_inlineFunctionBody(inlining, statement->asyncFunction->body);
+				break;
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_inlineExpression(inlining, content->condition);
+					_inlineCode(inlining, &content->body);
+				}
+				break;
+			default:
+				break;
+		}
+		code = &(*code)->next;
+	}
+}
+
+static void _inlineExpression(Inlining *inlining, Expression *expression) {
+	if (expression == NULL) {
+		return;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			if (expression->factor->type == EXPRESSION) {
+				_inlineExpression(inlining, expression->factor->expression);
+			}
+			else if (expression->factor->type == FUNCTIONCALL && expression->factor->functionCall->type == CLASSIC_CALL) {
+				Inlined inlined;
+				if (_inlineCall(inlining, expression->factor->functionCall, &inlined)) {
+					if (inlined.functionCall != NULL) {
+						expression->factor->functionCall = inlined.functionCall;
+					}
+					else {
+						expression->factor->type = EXPRESSION;
+						expression->factor->expression = inlined.expression;
+					}
+				}
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			_inlineExpression(inlining, expression->expression);
+			break;
+		default:
+			_inlineExpression(inlining, expression->leftExpression);
+			_inlineExpression(inlining, expression->rightExpression);
+			break;
+	}
+}
+
+static void _inlineFunctionBody(Inlining *inlining, FunctionBody *body) {
+	if (body == NULL) {
+		return;
+	}
+	_inlineCode(inlining, &body->code);
+	ReturnValue *returnValue = body->returnValue;
+	if (returnValue == NULL) {
+		return;
+	}
+	Inlined inlined;
+	if (returnValue->type == EXPRESSION_RT) {
+		_inlineExpression(inlining, returnValue->expression);
+	}
+	else if (returnValue->type == FUNCTIONCALL_RT && returnValue->functionCall->type == CLASSIC_CALL && _inlineCall(inlining, returnValue->functionCall, &inlined)) {
+		if (inlined.functionCall != NULL) {
+			returnValue->functionCall = inlined.functionCall;
+		}
+		else {
+			returnValue->type = EXPRESSION_RT;
+			returnValue->expression = inlined.expression;
+		}
+	}
+	else if (returnValue->type == ASYNC_FUNCTION_RT) {
+		_inlineFunctionBody(inlining, returnValue->asyncFunction->body);
+	}
+}
+
+static void _inlineVariable(Inlining *inlining, Variable *variable) {
+	Inlined inlined;
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_inlineExpression(inlining, variable->expression);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				_inlineExpression(inlining, element->value);
+			}
+			break;
+		case OBJECT_VAR:
+			for (ObjectContent *property = variable->objectContent; property != NULL; property = property->next) {
+				_inlineExpression(inlining, property->value);
+			}
+			break;
+		case FUNCTIONCALL_VAR:
+			if (variable->functionCall->type == CLASSIC_CALL && _inlineCall(inlining, variable->functionCall, &inlined)) {
+				if (inlined.functionCall != NULL) {
+					variable->functionCall = inlined.functionCall;
+				}
+				else {
+					variable->type = EXPRESSION_VAR;
+					variable->expression = inlined.expression;
+				}
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+static boolean _isParameter(const char *name, VariableTypeList *parameters) {
+	for (; parameters != NULL; parameters = parameters->next) {
+		if (strcmp(parameters->variableType->id, name) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * True if evaluating the expression has no effect, so it can be evaluated
+ * any number of times (including none).
+ */
+static boolean _isPure(const Expression *expression) {
+	if (expression == NULL) {
+		return true;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			if (expression->factor->type == EXPRESSION) {
+				return _isPure(expression->factor->expression);
+			}
+			return expression->factor->type != FUNCTIONCALL;
+		case AWAIT_OP:
+			return false;
+		case NOT_OP:
+			return _isPure(expression->expression);
+		default:
+			return _isPure(expression->leftExpression) && _isPure(expression->rightExpression);
+	}
+}
+
+/**
+ * The value bound to a parameter, or NULL if the name is not a parameter.
+ */
+static Expression *_parameterValue(const char *name, VariableTypeList *parameters, ArgumentList *values) {
+	for (; parameters != NULL && values != NULL; parameters = parameters->next, values = values->next) {
+		if (strcmp(parameters->variableType->id, name) == 0) {
+			return values->expression;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * True if the chain of forwarders that starts in the function leads back
+ * to it.
+ */
+static boolean _recursive(Inlining *inlining, FunctionDeclaration *function) {
+	FunctionDeclaration *current = function;
+	for (unsigned int depth = 0; depth <= MAXIMUM_INLINE_DEPTH; ++depth) {
+		ReturnValue *returnValue = current->body == NULL ? NULL : current->body->returnValue;
+		if (current->body == NULL || current->body->code != NULL || returnValue == NULL || returnValue->type != FUNCTIONCALL_RT) {
+			return false;
+		}
+		FunctionCall *call = returnValue->functionCall;
+		current = _resolve(inlining, call);
+		if (current == NULL) {
+			return false;
+		}
+		if (current == function) {
+			return true;
+		}
+	}
+	// Too deep to tell: treat it as recursive.
+	return true;
+}
+
+/**
+ * The top-level function that a call refers to, if it has exactly as many
+ * parameters as arguments.
+ */
+static FunctionDeclaration *_resolve(Inlining *inlining, const FunctionCall *functionCall) {
+	const NameUsage *usage = _findName(inlining, functionCall->id, false);
+	if (usage == NULL || usage->function == NULL) {
+		return NULL;
+	}
+	VariableTypeList *parameter = usage->function->arguments;
+	ArgumentList *argument = functionCall->arguments;
+	for (; parameter != NULL && argument != NULL; parameter = parameter->next, argument = argument->next) {
+	}
+	return parameter == NULL && argument == NULL ? usage->function : NULL;
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult inlineFunctions(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	const boolean aggressive = 2 <= compilerState->optimizationLevel;
+	Inlining inlining = {
+		.arena = createArena(4096),
+		.profile = compilerState->profile,
+		.threshold = aggressive ? AGGRESSIVE_INLINE_THRESHOLD : INLINE_THRESHOLD,
+		.budget = 0,
+		.nodes = 0,
+		.inlined = 0};
+	_collectCode(&inlining, program->code, true);
+	// The budget grows with the number of top-level statements, plus a
+	// constant for small programs.
+	unsigned int statements = 0;
+	for (Code *code = program->code; code != NULL; code = code->next) {
+		++statements;
+	}
+	inlining.budget = aggressive ? 16 * (long) statements + 256 : 4 * (long) statements + 64;
+	_inlineCode(&inlining, &program->code);
+	logDebugging(_logger, "Inlined %u calls (%ld nodes of budget left).", inlining.inlined, inlining.budget);
+	destroyArena(inlining.arena);
+	PassResult result = {.nodes = inlining.nodes, .changed = 0 < inlining.inlined};
+	return result;
+}
@@ -0,0 +1,35 @@
+#ifndef INLINER_HEADER
+#define INLINER_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Arena.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "PassManager.h"
+#include "Profiling.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeInlinerModule();
+
+/** Shutdown module's internal state. */
+void shutdownInlinerModule();
+
+/**
+ * Replaces the calls to small functions whose body is a single return with
+ * the returned expression, where every parameter is substituted with its
+ * argument. A function that returns another call (a forwarder) is replaced
+ * by that call, so chains of forwarders collapse into a single call.
+ *
+ * A function is only inlined if it is declared once, at the top level, is
+ * never reassigned, is not recursive, and none of the names it reads is
+ * shadowed anywhere. Its size must be under the threshold of the current
+ * optimization level, and the growth of the whole program must fit in a
+ * budget proportional to its size. With a profile (see Profiling), the calls
+ * that never ran keep their call, and the hot ones take the threshold of -O2.
+ */
+PassResult inlineFunctions(CompilerState *compilerState);
+
+#endif
@@ -0,0 +1,428 @@
+#include "LiteralPool.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializeLiteralPoolModule() {
+	_logger = createLogger("LiteralPool");
+}
+
+void shutdownLiteralPoolModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The number of buckets of the table of strings.
+ */
+#define LITERAL_POOL_BUCKETS 256
+
+/**
+ * The characters that a pooled string adds on its own ("const ", " = " and
+ * ";"), and the usual length of its name (e.g., "$lit$12").
+ */
+#define POOLED_STRING_OVERHEAD 10
+#define POOLED_NAME_LENGTH 7
+
+typedef struct Occurrence Occurrence;
+typedef struct StringLiteral StringLiteral;
+typedef struct ArrayLiteral ArrayLiteral;
+
+/**
+ * A place that holds a literal: a factor (for a string), or the parameters
+ * of a for...of (for an array).
+ */
+struct Occurrence {
+	Factor *factor;
+	ParamsFor *params;
+	Occurrence *next;
+};
+
+struct StringLiteral {
+	Constant *constant;
+	unsigned int uses;
+	Occurrence *occurrences;
+	StringLiteral *next;			  // in the same bucket
+	StringLiteral *following;		  // in order of appearance
+};
+
+struct ArrayLiteral {
+	ArrayContent *elements;
+	unsigned int uses;
+	boolean repeated;				  // built more than once per run
+	Occurrence *occurrences;
+	ArrayLiteral *following;		  // in order of appearance
+};
+
+/**
+ * The state of a single run of the pass.
+ */
+typedef struct {
+	Arena *arena;
+	StringLiteral *buckets[LITERAL_POOL_BUCKETS];
+	StringLiteral *strings;
+	StringLiteral **lastString;
+	ArrayLiteral *arrays;
+	ArrayLiteral **lastArray;
+	unsigned int nodes;
+	unsigned int pooled;
+} Pool;
+
+static void _collectArray(Pool *pool, ParamsFor *params, const boolean repeated);
+static void _collectCall(Pool *pool, FunctionCall *functionCall);
+static void _collectCode(Pool *pool, Code *code, const boolean repeated);
+static void _collectExpression(Pool *pool, Expression *expression);
+static void _collectFunctionBody(Pool *pool, FunctionBody *body);
+static void _collectVariable(Pool *pool, Variable *variable);
+static Expression *_createLiteralExpression(Constant *constant);
+static boolean _isConstantArray(const ArrayContent *elements);
+static Occurrence *_occurrence(Pool *pool, Factor *factor, ParamsFor *params, Occurrence *next);
+static boolean _sameConstant(const Constant *left, const Constant *right);
+static boolean _sameElements(const ArrayContent *left, const ArrayContent *right);
+static boolean _worthPooling(const StringLiteral *string);
+
+/**
+ * Records an array literal iterated by a for...of. The elements of an array
+ * already seen are not collected again, because its copy will be dropped.
+ */
+static void _collectArray(Pool *pool, ParamsFor *params, const boolean repeated) {
+	ArrayContent *elements = params->iterable->arrayContent;
+	for (ArrayLiteral *array = pool->arrays; array != NULL; array = array->following) {
+		if (_sameElements(array->elements, elements)) {
+			++array->uses;
+			array->repeated |= repeated;
+			array->occurrences = _occurrence(pool, NULL, params, array->occurrences);
+			return;
+		}
+	}
+	ArrayLiteral *array = allocateInArena(pool->arena, sizeof(ArrayLiteral));
+	array->elements = elements;
+	array->uses = 1;
+	array->repeated = repeated;
+	array->occurrences = _occurrence(pool, NULL, params, NULL);
+	*pool->lastArray = array;
+	pool->lastArray = &array->following;
+	for (; elements != NULL; elements = elements->next) {
+		_collectExpression(pool, elements->value);
+	}
+}
+
+static void _collectCall(Pool *pool, FunctionCall *functionCall) {
+	for (ArgumentList *argument = functionCall->arguments; argument != NULL; argument = argument->next) {
+		_collectExpression(pool, argument->expression);
+	}
+}
+
+/**
+ * Collects the literals of the code. The code is repeated if it can run more
+ * than once per run of the program (in a loop, or in a function).
+ */
+static void _collectCode(Pool *pool, Code *code, const boolean repeated) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		++pool->nodes;
+		switch (statement->statement) {
+			case IF_ST:
+				_collectExpression(pool, statement->ifStatement->condition);
+				_collectCode(pool, statement->ifStatement->thenBody, repeated);
+				_collectCode(pool, statement->ifStatement->elseBody, repeated);
+				break;
+			case WHILE_ST:
+				_collectExpression(pool, statement->whileLoop->condition);
+				_collectCode(pool, statement->whileLoop->body, true);
+				break;
+			case FOR_ST: {
+				ParamsFor *params = statement->forLoop->params;
+				if (params->type == FOR_CLASSIC) {
+					if (params->init != NULL) {
+						_collectVariable(pool, params->init->variable);
+					}
+					_collectExpression(pool, params->condition);
+					if (params->updateType == INC_DEC_UT) {
+						_collectExpression(pool, params->updateIncDec->expression);
+					}
+					else {
+						_collectExpression(pool, params->update);
+					}
+				}
+				else {
+					IterableVariable *iterable = params->iterable;
+					switch (iterable->type) {
+						case FUNCTIONCALL_IT:
+							_collectCall(pool, iterable->functionCall);
+							break;
+						case ARRAY_IT:
+							if (_isConstantArray(iterable->arrayContent)) {
+								_collectArray(pool, params, repeated);
+							}
+							else {
+								for (ArrayContent *element = iterable->arrayContent; element != NULL; element = element->next) {
+									_collectExpression(pool, element->value);
+								}
+							}
+							break;
+						case OBJECT_IT:
+							for (ObjectContent *property = iterable->objectContent; property != NULL; property = property->next) {
+								_collectExpression(pool, property->value);
+							}
+							break;
+						default:
+							break;
+					}
+				}
+				_collectCode(pool, statement->forLoop->body, true);
+				break;
+			}
+			case DECLARATION_ST:
+				_collectVariable(pool, statement->declaration->variable);
+				break;
+			case VARIABLE_ST:
+				_collectVariable(pool, statement->variable);
+				break;
+			case EXPRESSION_ST:
+				_collectExpression(pool, statement->expression);
+				break;
+			case FUNCTIONCALL_ST:
+				_collectCall(pool, statement->functionCall);
+				break;
+			case INC_DEC_ST:
+				_collectExpression(pool, statement->incDec->expression);
+				break;
+			case FUNCTION_DECLARATION_ST:
+				_collectFunctionBody(pool, statement->FunctionDeclaration->body);
+				break;
+			case ASYNC_FUNCTION_ST:
+				_collectFunctionBody(pool, statement->asyncFunction->body);
+				break;
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_collectExpression(pool, content->condition);
+					_collectCode(pool, content->body, repeated);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+static void _collectExpression(Pool *pool, Expression *expression) {
+	if (expression == NULL) {
+		return;
+	}
+	switch (expression->type) {
+		case FACTOR: {
+			Factor *factor = expression->factor;
+			if (factor->type == EXPRESSION) {
+				_collectExpression(pool, factor->expression);
+			}
+			else if (factor->type == FUNCTIONCALL) {
+				_collectCall(pool, factor->functionCall);
+			}
+			else if (factor->type == CONSTANT && factor->constant->type == STRING) {
+				const char *lexeme = factor->constant->string;
+				const unsigned int bucket = (unsigned int) (((uintptr_t) lexeme >> 4) % LITERAL_POOL_BUCKETS);
+				StringLiteral *string = pool->buckets[bucket];
+				while (string != NULL && string->constant->string != lexeme) {
+					string = string->next;
+				}
+				if (string == NULL) {
+					string = allocateInArena(pool->arena, sizeof(StringLiteral));
+					string->constant = factor->constant;
+					string->next = pool->buckets[bucket];
+					pool->buckets[bucket] = string;
+					*pool->lastString = string;
+					pool->lastString = &string->following;
+				}
+				++string->uses;
+				string->occurrences = _occurrence(pool, factor, NULL, string->occurrences);
+			}
+			break;
+		}
+		case NOT_OP:
+		case AWAIT_OP:
+			_collectExpression(pool, expression->expression);
+			break;
+		default:
+			_collectExpression(pool, expression->leftExpression);
+			_collectExpression(pool, expression->rightExpression);
+			break;
+	}
+}
+
+static void _collectFunctionBody(Pool *pool, FunctionBody *body) {
+	if (body == NULL) {
+		return;
+	}
+	_collectCode(pool, body->code, true);
+	ReturnValue *returnValue = body->returnValue;
+	if (returnValue == NULL) {
+		return;
+	}
+	switch (returnValue->type) {
+		case EXPRESSION_RT:
+			_collectExpression(pool, returnValue->expression);
+			break;
+		case FUNCTIONCALL_RT:
+			_collectCall(pool, returnValue->functionCall);
+			break;
+		case ASYNC_FUNCTION_RT:
+			_collectFunctionBody(pool, returnValue->asyncFunction->body);
+			break;
+		default:
+			break;
+	}
+}
+
+static void _collectVariable(Pool *pool, Variable *variable) {
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_collectExpression(pool, variable->expression);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				_collectExpression(pool, element->value);
+			}
+			break;
+		case OBJECT_VAR:
+			for (ObjectContent *property = variable->objectContent; property != NULL; property = property->next) {
+				_collectExpression(pool, property->value);
+			}
+			break;
+		case FUNCTIONCALL_VAR:
+			_collectCall(pool, variable->functionCall);
+			break;
+		default:
+			break;
+	}
+}
+
+static Expression *_createLiteralExpression(Constant *constant) {
+	Factor *factor = allocateNode(sizeof(Factor));
+	factor->type = CONSTANT;
+	factor->constant = constant;
+	Expression *expression = allocateNode(sizeof(Expression));
+	expression->type = FACTOR;
+	expression->factor = factor;
+	return expression;
+}
+
+/**
+ * True if the array is not empty, and every element is a literal.
+ */
+static boolean _isConstantArray(const ArrayContent *elements) {
+	if (elements == NULL) {
+		return false;
+	}
+	for (; elements != NULL; elements = elements->next) {
+		const Expression *value = elements->value;
+		if (value->type != FACTOR || value->factor->type != CONSTANT) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static Occurrence *_occurrence(Pool *pool, Factor *factor, ParamsFor *params, Occurrence *next) {
+	Occurrence *occurrence = allocateInArena(pool->arena, sizeof(Occurrence));
+	occurrence->factor = factor;
+	occurrence->params = params;
+	occurrence->next = next;
+	return occurrence;
+}
+
+static boolean _sameConstant(const Constant *left, const Constant *right) {
+	if (left->type != right->type) {
+		return false;
+	}
+	switch (left->type) {
+		case NUMBER:
+			if (left->numberType != right->numberType) {
+				return false;
+			}
+			return left->numberType == INTEGER_NT ? left->integer == right->integer : left->floating == right->floating;
+		case STRING:
+			return left->string == right->string;
+		case BOOLEAN:
+			return (left->boolean != 0) == (right->boolean != 0);
+		default:
+			return false;
+	}
+}
+
+static boolean _sameElements(const ArrayContent *left, const ArrayContent *right) {
+	for (; left != NULL && right != NULL; left = left->next, right = right->next) {
+		if (!_sameConstant(left->value->factor->constant, right->value->factor->constant)) {
+			return false;
+		}
+	}
+	return left == NULL && right == NULL;
+}
+
+/**
+ * True if a constant and its uses are shorter than the copies of the string.
+ */
+static boolean _worthPooling(const StringLiteral *string) {
+	const size_t length = strlen(string->constant->string);
+	const size_t pooled = POOLED_STRING_OVERHEAD + POOLED_NAME_LENGTH + length + string->uses * POOLED_NAME_LENGTH;
+	return 2 <= string->uses && pooled < string->uses * length;
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult poolLiterals(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	Pool pool = {
+		.arena = createArena(4096),
+		.buckets = {NULL},
+		.strings = NULL,
+		.arrays = NULL,
+		.nodes = 0,
+		.pooled = 0};
+	pool.lastString = &pool.strings;
+	pool.lastArray = &pool.arrays;
+	_collectCode(&pool, program->code, false);
+	// The strings go first, because the pooled arrays can refer to them.
+	Code *declarations = NULL;
+	Code **last = &declarations;
+	for (StringLiteral *string = pool.strings; string != NULL; string = string->following) {
+		if (!_worthPooling(string)) {
+			continue;
+		}
+		char *name = createSyntheticName("lit");
+		*last = createCode(createDeclarationStatement(CONST_DT, name, _createLiteralExpression(string->constant)), NULL);
+		last = &(*last)->next;
+		for (Occurrence *occurrence = string->occurrences; occurrence != NULL; occurrence = occurrence->next) {
+			occurrence->factor->type = VARIABLE;
+			occurrence->factor->variableName = name;
+		}
+		logDebugging(_logger, "The string %s is pooled as \"%s\" (%u uses).", string->constant->string, name, string->uses);
+		++pool.pooled;
+	}
+	for (ArrayLiteral *array = pool.arrays; array != NULL; array = array->following) {
+		if (array->uses < 2 && !array->repeated) {
+			continue;
+		}
+		char *name = createSyntheticName("lit");
+		Statement *declaration = createDeclarationStatement(CONST_DT, name, NULL);
+		declaration->declaration->variable->type = ARRAY_VAR;
+		declaration->declaration->variable->arrayContent = array->elements;
+		*last = createCode(declaration, NULL);
+		last = &(*last)->next;
+		for (Occurrence *occurrence = array->occurrences; occurrence != NULL; occurrence = occurrence->next) {
+			occurrence->params->iterable->type = VARIABLE_IT;
+			occurrence->params->iterable->variableName = name;
+		}
+		logDebugging(_logger, "An array is pooled as \"%s\" (%u uses).", name, array->uses);
+		++pool.pooled;
+	}
+	*last = program->code;
+	program->code = declarations;
+	destroyArena(pool.arena);
+	PassResult result = {.nodes = pool.nodes, .changed = 0 < pool.pooled};
+	return result;
+}
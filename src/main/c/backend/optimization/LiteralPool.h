@@ -0,0 +1,35 @@
+#ifndef LITERAL_POOL_HEADER
+#define LITERAL_POOL_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Arena.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "PassManager.h"
+#include "TreeRewriting.h"
+#include <stdint.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeLiteralPoolModule();
+
+/** Shutdown module's internal state. */
+void shutdownLiteralPoolModule();
+
+/**
+ * Moves the literals that would be written (or built) more than once into a
+ * pool of read-only constants at the top of the program, so each of them
+ * exists once in the output:
+ *
+ *	- A string literal repeated often enough that a "const" and its uses
+ *	  are shorter than the copies. The literals are interned, so the copies
+ *	  are found by pointer.
+ *	- An array of literals iterated by a for...of, when the same array is
+ *	  iterated elsewhere, or when the loop runs inside a function or another
+ *	  loop (which would build the array again on every run). The loop only
+ *	  reads it, so every run can share a single array.
+ */
+PassResult poolLiterals(CompilerState *compilerState);
+
+#endif
@@ -0,0 +1,439 @@
+#include "LoopInvariantCodeMotion.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializeLoopInvariantCodeMotionModule() {
+	_logger = createLogger("LoopInvariantCodeMotion");
+}
+
+void shutdownLoopInvariantCodeMotionModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * A binding in scope where the loops are visited.
+ */
+typedef struct {
+	const char *name;
+	boolean lexical;	  // declared with "let" or "const" (so it has a dead zone)
+	boolean initialized;  // its declaration runs before the statement being visited
+} ScopedName;
+
+/**
+ * The state of a single run of the pass.
+ */
+typedef struct {
+	// The bindings in scope, the innermost last. Reading a name that is not
+	// there could throw, and so could reading a "let" or "const" before its
+	// declaration runs, so neither is ever hoisted.
+	ScopedName *scope;
+	unsigned int scopeCount;
+	unsigned int scopeCapacity;
+
+	// Where the bindings of the function being visited start. The ones of
+	// the enclosing functions may not be initialized yet when it runs
+	// (a function declaration can be called before the code above it).
+	unsigned int functionBase;
+
+	// Every name that the program may write after its declaration.
+	NameSet mutableNames;
+
+	unsigned int nodes;
+	unsigned int hoisted;
+} Motion;
+
+/**
+ * The state of the hoisting out of a single loop.
+ */
+typedef struct {
+	Motion *motion;
+	NameSet written;
+	boolean calls;
+	Code **preheader;
+} Hoisting;
+
+static void _declare(Motion *motion, const char *name, const boolean lexical, const boolean initialized);
+static void _declareBlock(Motion *motion, Code *code);
+static void _hoist(Hoisting *hoisting, Expression *expression);
+static void _hoistCode(Hoisting *hoisting, Code *code);
+static void _hoistExpression(Hoisting *hoisting, Expression *expression);
+static void _hoistFunction(Motion *motion, VariableTypeList *parameters, FunctionBody *body);
+static Code **_hoistLoop(Motion *motion, Code **code);
+static void _hoistLoops(Motion *motion, Code **code);
+static void _hoistVariable(Hoisting *hoisting, Variable *variable);
+static void _initialize(Motion *motion, const char *name);
+static boolean _isInvariant(const Hoisting *hoisting, const Expression *expression, unsigned int *reads);
+static boolean _isReadable(const Motion *motion, const char *name);
+
+static void _declare(Motion *motion, const char *name, const boolean lexical, const boolean initialized) {
+	if (motion->scopeCount == motion->scopeCapacity) {
+		motion->scopeCapacity = motion->scopeCapacity == 0 ? 16 : 2 * motion->scopeCapacity;
+		motion->scope = realloc(motion->scope, motion->scopeCapacity * sizeof(ScopedName));
+	}
+	ScopedName *scoped = &motion->scope[motion->scopeCount++];
+	scoped->name = name;
+	scoped->lexical = lexical;
+	scoped->initialized = initialized;
+}
+
+/**
+ * Brings the declarations of a block into scope: the functions and the
+ * "var" ones can be read anywhere (before it runs, a "var" is undefined),
+ * but a "let" or "const" only once its declaration runs (see _initialize).
+ */
+static void _declareBlock(Motion *motion, Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		switch (statement->statement) {
+			case DECLARATION_ST: {
+				Declaration *declaration = statement->declaration;
+				const boolean lexical = declaration->type != VAR_DT;
+				_declare(motion, declaration->variable->variableType->id, lexical, !lexical);
+				break;
+			}
+			case FUNCTION_DECLARATION_ST:
+				_declare(motion, statement->FunctionDeclaration->id, false, true);
+				break;
+			case ASYNC_FUNCTION_ST:
+				_declare(motion, statement->asyncFunction->id, false, true);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * Moves the expression into a new constant before the loop, and replaces it
+ * with a read of the constant.
+ */
+static void _hoist(Hoisting *hoisting, Expression *expression) {
+	Expression *hoisted = allocateNode(sizeof(Expression));
+	*hoisted = *expression;
+	char *name = createSyntheticName("inv");
+	*expression = *createVariableExpression(name);
+	*hoisting->preheader = createCode(createDeclarationStatement(CONST_DT, name, hoisted), *hoisting->preheader);
+	hoisting->preheader = &(*hoisting->preheader)->next;
+	logDebugging(_logger, "Hoisted an invariant operation into \"%s\".", name);
+	++hoisting->motion->hoisted;
+}
+
+/**
+ * Hoists from every expression that runs once per iteration (including the
+ * ones of nested loops), but not from nested functions.
+ */
+static void _hoistCode(Hoisting *hoisting, Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		switch (statement->statement) {
+			case IF_ST:
+				_hoistExpression(hoisting, statement->ifStatement->condition);
+				_hoistCode(hoisting, statement->ifStatement->thenBody);
+				_hoistCode(hoisting, statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_hoistExpression(hoisting, statement->whileLoop->condition);
+				_hoistCode(hoisting, statement->whileLoop->body);
+				break;
+			case FOR_ST: {
+				ParamsFor *params = statement->forLoop->params;
+				if (params->type == FOR_CLASSIC) {
+					if (params->init != NULL) {
+						_hoistVariable(hoisting, params->init->variable);
+					}
+					_hoistExpression(hoisting, params->condition);
+					if (params->updateType == EXPRESSION_UT) {
+						_hoistExpression(hoisting, params->update);
+					}
+				}
+				_hoistCode(hoisting, statement->forLoop->body);
+				break;
+			}
+			case DECLARATION_ST:
+				_hoistVariable(hoisting, statement->declaration->variable);
+				break;
+			case VARIABLE_ST:
+				_hoistVariable(hoisting, statement->variable);
+				break;
+			case EXPRESSION_ST:
+				_hoistExpression(hoisting, statement->expression);
+				break;
+			case FUNCTIONCALL_ST:
+				for (ArgumentList *argument = statement->functionCall->arguments; argument != NULL; argument = argument->next) {
+					_hoistExpression(hoisting, argument->expression);
+				}
+				break;
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_hoistExpression(hoisting, content->condition);
+					_hoistCode(hoisting, content->body);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * Hoists the largest invariant operations of the expression. A lone literal
+ * or variable is never hoisted, because reading it costs the same.
+ */
+static void _hoistExpression(Hoisting *hoisting, Expression *expression) {
+	if (expression == NULL) {
+		return;
+	}
+	unsigned int reads = 0;
+	if (expression->type != FACTOR && _isInvariant(hoisting, expression, &reads) && 0 < reads) {
+		_hoist(hoisting, expression);
+		return;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			if (expression->factor->type == EXPRESSION) {
+				Expression *inner = expression->factor->expression;
+				_hoistExpression(hoisting, inner);
+				if (inner->type == FACTOR) {
+					// The parentheses around the hoisted constant are redundant.
+					*expression = *inner;
+				}
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			_hoistExpression(hoisting, expression->expression);
+			break;
+		default:
+			_hoistExpression(hoisting, expression->leftExpression);
+			_hoistExpression(hoisting, expression->rightExpression);
+			break;
+	}
+}
+
+static void _hoistFunction(Motion *motion, VariableTypeList *parameters, FunctionBody *body) {
+	if (body == NULL) {
+		return;
+	}
+	const unsigned int base = motion->scopeCount;
+	const unsigned int functionBase = motion->functionBase;
+	motion->functionBase = base;
+	for (; parameters != NULL; parameters = parameters->next) {
+		_declare(motion, parameters->variableType->id, false, true);
+	}
+	_hoistLoops(motion, &body->code);
+	motion->scopeCount = base;
+	motion->functionBase = functionBase;
+}
+
+/**
+ * Hoists the invariant operations of the loop of the statement at the link,
+ * and returns the link to the loop (after the new declarations).
+ */
+static Code **_hoistLoop(Motion *motion, Code **code) {
+	Statement *statement = (*code)->statement;
+	Hoisting hoisting = {
+		.motion = motion,
+		.written = {NULL, 0, 0},
+		.calls = false,
+		.preheader = code};
+	if (statement->statement == WHILE_ST) {
+		WhileLoop *whileLoop = statement->whileLoop;
+		collectWrittenNames(whileLoop->body, &hoisting.written, true);
+		hoisting.calls = expressionContainsCalls(whileLoop->condition) || containsCalls(whileLoop->body);
+		_hoistExpression(&hoisting, whileLoop->condition);
+		_hoistCode(&hoisting, whileLoop->body);
+	}
+	else {
+		ForLoop *forLoop = statement->forLoop;
+		ParamsFor *params = forLoop->params;
+		Code *header = createCode(statement, NULL);
+		collectWrittenNames(header, &hoisting.written, true);
+		hoisting.calls = containsCalls(forLoop->body)
+			|| (params->type == FOR_CLASSIC && expressionContainsCalls(params->condition))
+			|| (params->type == FOR_CLASSIC && params->updateType == EXPRESSION_UT && expressionContainsCalls(params->update));
+		if (params->type == FOR_CLASSIC) {
+			_hoistExpression(&hoisting, params->condition);
+			if (params->updateType == EXPRESSION_UT) {
+				_hoistExpression(&hoisting, params->update);
+			}
+		}
+		_hoistCode(&hoisting, forLoop->body);
+	}
+	releaseNames(&hoisting.written);
+	return hoisting.preheader;
+}
+
+/**
+ * Hoists out of every loop of the code, outermost first (so an operation
+ * invariant in both loops moves out of both at once). The code is a block,
+ * so its bindings go out of scope at its end.
+ */
+static void _hoistLoops(Motion *motion, Code **code) {
+	const unsigned int base = motion->scopeCount;
+	_declareBlock(motion, *code);
+	for (; *code != NULL; code = &(*code)->next) {
+		Statement *statement = (*code)->statement;
+		++motion->nodes;
+		switch (statement->statement) {
+			case IF_ST:
+				_hoistLoops(motion, &statement->ifStatement->thenBody);
+				_hoistLoops(motion, &statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				code = _hoistLoop(motion, code);
+				_hoistLoops(motion, &statement->whileLoop->body);
+				break;
+			case FOR_ST: {
+				code = _hoistLoop(motion, code);
+				ParamsFor *params = statement->forLoop->params;
+				const unsigned int header = motion->scopeCount;
+				Declaration *variable = params->type == FOR_CLASSIC ? params->init : params->value;
+				if (variable != NULL) {
+					_declare(motion, variable->variable->variableType->id, false, true);
+				}
+				_hoistLoops(motion, &statement->forLoop->body);
+				motion->scopeCount = header;
+				break;
+			}
+			case SWITCH_ST: {
+				// The declarations of a case are in scope in the next ones,
+				// which may run without them.
+				const unsigned int cases = motion->scopeCount;
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_declareBlock(motion, content->body);
+				}
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_hoistLoops(motion, &content->body);
+				}
+				motion->scopeCount = cases;
+				break;
+			}
+			case DECLARATION_ST:
+				_initialize(motion, statement->declaration->variable->variableType->id);
+				break;
+			case FUNCTION_DECLARATION_ST:
+				_hoistFunction(motion, statement->FunctionDeclaration->arguments, statement->FunctionDeclaration->body);
+				break;
+			case ASYNC_FUNCTION_ST:
+				_hoistFunction(motion, statement->asyncFunction->arguments, statement->asyncFunction->body);
+				break;
+			default:
+				break;
+		}
+	}
+	motion->scopeCount = base;
+}
+
+static void _hoistVariable(Hoisting *hoisting, Variable *variable) {
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_hoistExpression(hoisting, variable->expression);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				_hoistExpression(hoisting, element->value);
+			}
+			break;
+		case OBJECT_VAR:
+			for (ObjectContent *property = variable->objectContent; property != NULL; property = property->next) {
+				_hoistExpression(hoisting, property->value);
+			}
+			break;
+		case FUNCTIONCALL_VAR:
+			for (ArgumentList *argument = variable->functionCall->arguments; argument != NULL; argument = argument->next) {
+				_hoistExpression(hoisting, argument->expression);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Marks the innermost binding of the name as initialized, once its
+ * declaration runs.
+ */
+static void _initialize(Motion *motion, const char *name) {
+	for (unsigned int k = motion->scopeCount; 0 < k; --k) {
+		if (strcmp(motion->scope[k - 1].name, name) == 0) {
+			motion->scope[k - 1].initialized = true;
+			return;
+		}
+	}
+}
+
+/**
+ * True if the expression computes the same value in every iteration. Counts
+ * the variables that it reads.
+ */
+static boolean _isInvariant(const Hoisting *hoisting, const Expression *expression, unsigned int *reads) {
+	if (expression == NULL) {
+		return true;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			switch (expression->factor->type) {
+				case CONSTANT:
+					return true;
+				case VARIABLE: {
+					const char *name = expression->factor->variableName;
+					++*reads;
+					return _isReadable(hoisting->motion, name)
+						&& !containsName(&hoisting->written, name)
+						&& !(hoisting->calls && containsName(&hoisting->motion->mutableNames, name));
+				}
+				case EXPRESSION:
+					return _isInvariant(hoisting, expression->factor->expression, reads);
+				default:
+					return false;
+			}
+		case AWAIT_OP:
+			return false;
+		case NOT_OP:
+			return _isInvariant(hoisting, expression->expression, reads);
+		default:
+			return _isInvariant(hoisting, expression->leftExpression, reads)
+				&& _isInvariant(hoisting, expression->rightExpression, reads);
+	}
+}
+
+/**
+ * True if reading the name right before the loop being visited cannot
+ * throw: its innermost binding is initialized there, and it is not a "let"
+ * or "const" of an enclosing function.
+ */
+static boolean _isReadable(const Motion *motion, const char *name) {
+	for (unsigned int k = motion->scopeCount; 0 < k; --k) {
+		const ScopedName *scoped = &motion->scope[k - 1];
+		if (strcmp(scoped->name, name) == 0) {
+			return scoped->initialized && (!scoped->lexical || motion->functionBase < k);
+		}
+	}
+	return false;
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult hoistLoopInvariants(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	Motion motion = {
+		.scope = NULL,
+		.scopeCount = 0,
+		.scopeCapacity = 0,
+		.functionBase = 0,
+		.mutableNames = {NULL, 0, 0},
+		.nodes = 0,
+		.hoisted = 0};
+	collectWrittenNames(program->code, &motion.mutableNames, false);
+	_hoistLoops(&motion, &program->code);
+	free(motion.scope);
+	releaseNames(&motion.mutableNames);
+	PassResult result = {.nodes = motion.nodes, .changed = 0 < motion.hoisted};
+	return result;
+}
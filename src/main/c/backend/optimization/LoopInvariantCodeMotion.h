@@ -0,0 +1,29 @@
+#ifndef LOOP_INVARIANT_CODE_MOTION_HEADER
+#define LOOP_INVARIANT_CODE_MOTION_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "PassManager.h"
+#include "TreeRewriting.h"
+#include <stdlib.h>
+
+/** Initialize module's internal state. */
+void initializeLoopInvariantCodeMotionModule();
+
+/** Shutdown module's internal state. */
+void shutdownLoopInvariantCodeMotionModule();
+
+/**
+ * Moves the operations that compute the same value in every iteration of a
+ * loop (while, for and for-of) into a constant declared right before it.
+ * An operation is invariant if it does not call, and if the loop does not
+ * write any of the variables it reads. When the loop calls a function, only
+ * the bindings that nothing in the program can write are invariant. The
+ * constant is computed even if the loop never runs, so it only reads the
+ * bindings that are already initialized there.
+ */
+PassResult hoistLoopInvariants(CompilerState *compilerState);
+
+#endif
@@ -0,0 +1,137 @@
+#include "LoopUnrolling.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+static NodeTable _unrolled = {NULL, NULL, 0, 0};
+
+void initializeLoopUnrollingModule() {
+	_logger = createLogger("LoopUnrolling");
+}
+
+void shutdownLoopUnrollingModule() {
+	releaseAnnotations(&_unrolled);
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The number of copies of the body of an unrolled loop.
+ */
+#define UNROLL_FACTOR 4
+
+/**
+ * The longest body (in statements) that is unrolled.
+ */
+#define MAXIMUM_UNROLLED_STATEMENTS 6
+
+/**
+ * The state of a single run of the pass.
+ */
+typedef struct {
+	const Profile *profile;
+	unsigned int nodes;
+	unsigned int unrolled;
+} Unrolling;
+
+static boolean _isKernel(Code *body);
+static boolean _isShortLoop(const Profile *profile, ForLoop *forLoop);
+static void _unrollCode(Unrolling *unrolling, Code *code);
+
+/**
+ * True if the body is short, and runs every statement once per iteration
+ * without calling anything.
+ */
+static boolean _isKernel(Code *body) {
+	if (body == NULL || containsCalls(body) || containsFunctions(body)) {
+		return false;
+	}
+	unsigned int statements = 0;
+	for (Code *code = body; code != NULL; code = code->next) {
+		switch (code->statement->statement) {
+			case DECLARATION_ST:
+			case VARIABLE_ST:
+			case EXPRESSION_ST:
+			case INC_DEC_ST:
+				break;
+			default:
+				return false;
+		}
+		if (MAXIMUM_UNROLLED_STATEMENTS < ++statements) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * True if the profile measured the loop, and it never iterated, or ran fewer
+ * iterations per entry than the copies of an unrolled body (so they would
+ * never run together).
+ */
+static boolean _isShortLoop(const Profile *profile, ForLoop *forLoop) {
+	const ProfileSite *site = findMeasuredSite(profile, forLoop);
+	return site != NULL && (site->counts[0] == 0 || site->counts[0] < UNROLL_FACTOR * site->counts[1]);
+}
+
+static void _unrollCode(Unrolling *unrolling, Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		++unrolling->nodes;
+		switch (statement->statement) {
+			case IF_ST:
+				_unrollCode(unrolling, statement->ifStatement->thenBody);
+				_unrollCode(unrolling, statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_unrollCode(unrolling, statement->whileLoop->body);
+				break;
+			case FOR_ST: {
+				ForLoop *forLoop = statement->forLoop;
+				ParamsFor *params = forLoop->params;
+				const IndexedLoop *indexed = params->type == FOR_OF ? findIndexedLoop(params) : NULL;
+				if (indexed != NULL && findAnnotation(&_unrolled, params) == NULL && _isKernel(forLoop->body) && !_isShortLoop(unrolling->profile, forLoop)) {
+					annotateNode(&_unrolled, params, forLoop);
+					logDebugging(_logger, "The loop indexed by \"%s\" is unrolled %d times.", indexed->index, UNROLL_FACTOR);
+					++unrolling->unrolled;
+				}
+				_unrollCode(unrolling, forLoop->body);
+				break;
+			}
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_unrollCode(unrolling, content->body);
+				}
+				break;
+			case FUNCTION_DECLARATION_ST:
+				if (statement->FunctionDeclaration->body != NULL) {
+					_unrollCode(unrolling, statement->FunctionDeclaration->body->code);
+				}
+				break;
+			case ASYNC_FUNCTION_ST:
+				if (statement->asyncFunction->body != NULL) {
+					_unrollCode(unrolling, statement->asyncFunction->body->code);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult unrollLoops(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	Unrolling unrolling = {.profile = compilerState->profile, .nodes = 0, .unrolled = 0};
+	_unrollCode(&unrolling, program->code);
+	PassResult result = {.nodes = unrolling.nodes, .changed = 0 < unrolling.unrolled};
+	return result;
+}
+
+unsigned int findUnrollFactor(const ParamsFor *params) {
+	return findAnnotation(&_unrolled, params) == NULL ? 1 : UNROLL_FACTOR;
+}
@@ -0,0 +1,38 @@
+#ifndef LOOP_UNROLLING_HEADER
+#define LOOP_UNROLLING_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "IndexedLoops.h"
+#include "PassManager.h"
+#include "Profiling.h"
+#include "TreeRewriting.h"
+
+/** Initialize module's internal state. */
+void initializeLoopUnrollingModule();
+
+/** Shutdown module's internal state. */
+void shutdownLoopUnrollingModule();
+
+/**
+ * Marks the small kernels among the indexed loops (see IndexedLoops) to be
+ * emitted with several copies of their body per iteration, followed by a
+ * loop over the remaining elements (see findUnrollFactor). A
+ * kernel is a short, straight-line body without calls. A loop that a
+ * profile (see Profiling) saw run only a few iterations per entry is not
+ * unrolled.
+ *
+ * The copies run in order, so reductions keep a single chain of operations
+ * (reassociating floating-point additions would change their result).
+ */
+PassResult unrollLoops(CompilerState *compilerState);
+
+/**
+ * The copies of the body per iteration of an indexed loop (1 if it is not
+ * unrolled).
+ */
+unsigned int findUnrollFactor(const ParamsFor *params);
+
+#endif
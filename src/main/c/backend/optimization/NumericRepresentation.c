@@ -0,0 +1,414 @@
+#include "NumericRepresentation.h"
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The changes of an interval before it starts to be widened.
+ */
+#define WIDENING_DELAY 2
+
+/**
+ * The largest integer up to which every integer is an exact double.
+ */
+#define EXACT_INTEGER 9007199254740992.0
+
+/**
+ * What is known about a number: the interval of its values, and whether it
+ * is always an integer (never a fraction, NaN, an infinity nor -0). An
+ * unreached number has not been computed yet (or never is).
+ */
+typedef struct {
+	boolean reached;
+	boolean integral;
+	double low;
+	double high;
+} NumericRange;
+
+/**
+ * The state of the inference over a single function.
+ */
+typedef struct {
+	const IrFunction *function;
+	NumericRange *ranges;
+	unsigned int *changes;
+	// The blocks in reverse postorder, the position of every block in it, and
+	// the immediate dominator of every block (IR_NONE if it is unreachable).
+	unsigned int *order;
+	unsigned int orderCount;
+	unsigned int *position;
+	unsigned int *dominators;
+} Inference;
+
+static const NumericRange _unreached = {.reached = false, .integral = false, .low = 0, .high = 0};
+static const NumericRange _anyNumber = {.reached = true, .integral = false, .low = -INFINITY, .high = INFINITY};
+
+static void _computeDominators(Inference *inference);
+static NumericRange _constrain(const Inference *inference, NumericRange range, const unsigned int value, const unsigned int predecessor, const unsigned int block);
+static NumericRange _join(const NumericRange range, const NumericRange otherRange);
+static double _multiply(const double factor, const double otherFactor);
+static NumericRange _operand(const Inference *inference, const unsigned int value, const unsigned int block);
+static NumericRange _operate(const IrOpcode opcode, const NumericRange left, const NumericRange right);
+static NumericRange _range(const Inference *inference, const unsigned int value);
+static NumericRange _transfer(const Inference *inference, const unsigned int value);
+static boolean _update(Inference *inference, const unsigned int value);
+static NumericRange _widen(const NumericRange range, const NumericRange previousRange);
+
+/**
+ * Finds the immediate dominator of every reachable block (Cooper, Harvey
+ * and Kennedy), visiting the blocks in reverse postorder until they settle.
+ */
+static void _computeDominators(Inference *inference) {
+	const IrFunction *function = inference->function;
+	for (unsigned int b = 0; b < function->blockCount; ++b) {
+		inference->dominators[b] = IR_NONE;
+	}
+	inference->dominators[0] = 0;
+	boolean changed = true;
+	while (changed) {
+		changed = false;
+		for (unsigned int k = 1; k < inference->orderCount; ++k) {
+			const unsigned int block = inference->order[k];
+			const IrBlock *irBlock = &function->blocks[block];
+			unsigned int dominator = IR_NONE;
+			for (unsigned int p = 0; p < irBlock->predecessorCount; ++p) {
+				unsigned int predecessor = irBlock->predecessors[p];
+				if (inference->dominators[predecessor] == IR_NONE) {
+					continue;
+				}
+				if (dominator == IR_NONE) {
+					dominator = predecessor;
+					continue;
+				}
+				while (predecessor != dominator) {
+					while (inference->position[dominator] < inference->position[predecessor]) {
+						predecessor = inference->dominators[predecessor];
+					}
+					while (inference->position[predecessor] < inference->position[dominator]) {
+						dominator = inference->dominators[dominator];
+					}
+				}
+			}
+			if (inference->dominators[block] != dominator) {
+				inference->dominators[block] = dominator;
+				changed = true;
+			}
+		}
+	}
+}
+
+/**
+ * Narrows the range of a value with the comparison that guards an edge: if
+ * the predecessor branches on "value < other" to the block, then the value
+ * is below the other one in there. The branch that does not hold tells the
+ * opposite only if neither side can be NaN (both are integers).
+ */
+static NumericRange _constrain(const Inference *inference, NumericRange range, const unsigned int value, const unsigned int predecessor, const unsigned int block) {
+	const IrFunction *function = inference->function;
+	const IrBlock *irBlock = &function->blocks[predecessor];
+	if (irBlock->instructionCount == 0) {
+		return range;
+	}
+	const IrInstruction *terminator = &function->instructions[irBlock->instructions[irBlock->instructionCount - 1]];
+	if (terminator->opcode != BRANCH_IR || terminator->targets[0] == terminator->targets[1]) {
+		return range;
+	}
+	const IrInstruction *condition = &function->instructions[terminator->operands[0]];
+	IrOpcode opcode = condition->opcode;
+	if (opcode != LESS_IR && opcode != LESS_EQUAL_IR && opcode != GREATER_IR && opcode != GREATER_EQUAL_IR) {
+		return range;
+	}
+	unsigned int other;
+	if (condition->operands[0] == value) {
+		other = condition->operands[1];
+	}
+	else if (condition->operands[1] == value) {
+		// "other < value" is "value > other".
+		other = condition->operands[0];
+		switch (opcode) {
+			case LESS_IR: opcode = GREATER_IR; break;
+			case LESS_EQUAL_IR: opcode = GREATER_EQUAL_IR; break;
+			case GREATER_IR: opcode = LESS_IR; break;
+			default: opcode = LESS_EQUAL_IR; break;
+		}
+	}
+	else {
+		return range;
+	}
+	const NumericRange otherRange = _range(inference, other);
+	if (!otherRange.reached || other == value) {
+		return range;
+	}
+	const boolean integers = range.integral && otherRange.integral;
+	if (block != terminator->targets[0]) {
+		if (!integers) {
+			return range;
+		}
+		switch (opcode) {
+			case LESS_IR: opcode = GREATER_EQUAL_IR; break;
+			case LESS_EQUAL_IR: opcode = GREATER_IR; break;
+			case GREATER_IR: opcode = LESS_EQUAL_IR; break;
+			default: opcode = LESS_IR; break;
+		}
+	}
+	const double step = integers ? 1 : 0;
+	switch (opcode) {
+		case LESS_IR: range.high = fmin(range.high, otherRange.high - step); break;
+		case LESS_EQUAL_IR: range.high = fmin(range.high, otherRange.high); break;
+		case GREATER_IR: range.low = fmax(range.low, otherRange.low + step); break;
+		default: range.low = fmax(range.low, otherRange.low); break;
+	}
+	// The edge is never taken.
+	return range.high < range.low ? _unreached : range;
+}
+
+static NumericRange _join(const NumericRange range, const NumericRange otherRange) {
+	if (!range.reached) {
+		return otherRange;
+	}
+	if (!otherRange.reached) {
+		return range;
+	}
+	if (!range.integral || !otherRange.integral) {
+		return _anyNumber;
+	}
+	NumericRange join = range;
+	join.low = fmin(range.low, otherRange.low);
+	join.high = fmax(range.high, otherRange.high);
+	return join;
+}
+
+/**
+ * Multiplies two bounds, where zero times an infinity is zero (the bounds
+ * of integers are finite values, or no bound at all).
+ */
+static double _multiply(const double factor, const double otherFactor) {
+	return factor == 0 || otherFactor == 0 ? 0 : factor * otherFactor;
+}
+
+/**
+ * The range of an operand where a block reads it, narrowed by every
+ * comparison that guards that block: the edges that reach it, or any block
+ * that dominates it, from a single predecessor.
+ */
+static NumericRange _operand(const Inference *inference, const unsigned int value, const unsigned int block) {
+	NumericRange range = _range(inference, value);
+	unsigned int current = block;
+	while (range.reached && current != 0 && current != IR_NONE) {
+		const IrBlock *irBlock = &inference->function->blocks[current];
+		if (irBlock->predecessorCount == 1) {
+			range = _constrain(inference, range, value, irBlock->predecessors[0], current);
+		}
+		current = inference->dominators[current];
+	}
+	return range;
+}
+
+/**
+ * Adds, subtracts or multiplies two ranges. The result of integers stays
+ * integral (with its interval), unless a product could be -0 (zero times
+ * a negative number).
+ */
+static NumericRange _operate(const IrOpcode opcode, const NumericRange left, const NumericRange right) {
+	if (!left.reached || !right.reached) {
+		return _unreached;
+	}
+	if (!left.integral || !right.integral) {
+		return _anyNumber;
+	}
+	NumericRange result = left;
+	switch (opcode) {
+		case ADD_IR:
+			result.low = left.low + right.low;
+			result.high = left.high + right.high;
+			return result;
+		case SUB_IR:
+			result.low = left.low - right.high;
+			result.high = left.high - right.low;
+			return result;
+		case MUL_IR: {
+			const boolean leftZero = left.low <= 0 && 0 <= left.high;
+			const boolean rightZero = right.low <= 0 && 0 <= right.high;
+			if ((leftZero && right.low < 0) || (rightZero && left.low < 0)) {
+				return _anyNumber;
+			}
+			const double products[] = {
+				_multiply(left.low, right.low),
+				_multiply(left.low, right.high),
+				_multiply(left.high, right.low),
+				_multiply(left.high, right.high)};
+			result.low = fmin(fmin(products[0], products[1]), fmin(products[2], products[3]));
+			result.high = fmax(fmax(products[0], products[1]), fmax(products[2], products[3]));
+			return result;
+		}
+		default:
+			return _anyNumber;
+	}
+}
+
+/**
+ * The range of a value, anywhere. Anything but a number could be any
+ * double once it is converted.
+ */
+static NumericRange _range(const Inference *inference, const unsigned int value) {
+	if (inference->function->instructions[value].type != NUMBER_VT) {
+		return _anyNumber;
+	}
+	return inference->ranges[value];
+}
+
+/**
+ * Computes the range of a number from the current ranges of its operands.
+ */
+static NumericRange _transfer(const Inference *inference, const unsigned int value) {
+	const IrInstruction *instruction = &inference->function->instructions[value];
+	switch (instruction->opcode) {
+		case CONSTANT_IR: {
+			const double number = instruction->number;
+			if (!isfinite(number) || number != trunc(number) || (number == 0 && signbit(number))) {
+				return _anyNumber;
+			}
+			const NumericRange range = {.reached = true, .integral = true, .low = number, .high = number};
+			return range;
+		}
+		case PHI_IR: {
+			const IrBlock *irBlock = &inference->function->blocks[instruction->block];
+			NumericRange range = _unreached;
+			for (unsigned int k = 0; k < instruction->operandCount && k < irBlock->predecessorCount; ++k) {
+				const unsigned int predecessor = irBlock->predecessors[k];
+				if (inference->dominators[predecessor] == IR_NONE) {
+					continue;
+				}
+				// The operand is read at the end of its predecessor, on the edge to the phi.
+				const NumericRange operand = _operand(inference, instruction->operands[k], predecessor);
+				range = _join(range, operand.reached ? _constrain(inference, operand, instruction->operands[k], predecessor, instruction->block) : operand);
+			}
+			return range;
+		}
+		case ADD_IR:
+		case SUB_IR:
+		case MUL_IR:
+			return _operate(instruction->opcode,
+				_operand(inference, instruction->operands[0], instruction->block),
+				_operand(inference, instruction->operands[1], instruction->block));
+		default:
+			return _anyNumber;
+	}
+}
+
+/**
+ * Joins the range of a number with the one computed from its operands, and
+ * returns true if it grew.
+ */
+static boolean _update(Inference *inference, const unsigned int value) {
+	const NumericRange previousRange = inference->ranges[value];
+	const NumericRange computed = _transfer(inference, value);
+	NumericRange range = _join(previousRange, computed);
+	if (range.reached == previousRange.reached && range.integral == previousRange.integral && range.low == previousRange.low && range.high == previousRange.high) {
+		return false;
+	}
+	if (WIDENING_DELAY < ++inference->changes[value]) {
+		range = _widen(range, previousRange);
+	}
+	inference->ranges[value] = range;
+	return true;
+}
+
+/**
+ * Moves every bound that grew since the previous range to the next
+ * threshold, so a loop settles after a few more iterations.
+ */
+static NumericRange _widen(const NumericRange range, const NumericRange previousRange) {
+	static const double thresholds[] = {-INFINITY, -EXACT_INTEGER, INT_MIN, INT_MAX, EXACT_INTEGER, INFINITY};
+	const unsigned int count = sizeof(thresholds) / sizeof(thresholds[0]);
+	if (!range.integral || !previousRange.reached) {
+		return range;
+	}
+	NumericRange widened = range;
+	if (range.low < previousRange.low) {
+		for (unsigned int k = count; 0 < k; --k) {
+			if (thresholds[k - 1] <= range.low) {
+				widened.low = thresholds[k - 1];
+				break;
+			}
+		}
+	}
+	if (previousRange.high < range.high) {
+		for (unsigned int k = 0; k < count; ++k) {
+			if (range.high <= thresholds[k]) {
+				widened.high = thresholds[k];
+				break;
+			}
+		}
+	}
+	return widened;
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult inferNumericRepresentations(IrModule *module, const unsigned int function) {
+	IrFunction *irFunction = &module->functions[function];
+	PassResult result = {.nodes = irFunction->instructionCount, .changed = false};
+	if (irFunction->blockCount == 0) {
+		return result;
+	}
+	Inference inference = {
+		.function = irFunction,
+		.ranges = malloc(irFunction->instructionCount * sizeof(NumericRange)),
+		.changes = calloc(irFunction->instructionCount, sizeof(unsigned int)),
+		.order = malloc(irFunction->blockCount * sizeof(unsigned int)),
+		.orderCount = 0,
+		.position = malloc(irFunction->blockCount * sizeof(unsigned int)),
+		.dominators = malloc(irFunction->blockCount * sizeof(unsigned int))};
+	for (unsigned int k = 0; k < irFunction->instructionCount; ++k) {
+		inference.ranges[k] = _unreached;
+	}
+	inference.orderCount = orderIrBlocks(irFunction, inference.order);
+	for (unsigned int b = 0; b < irFunction->blockCount; ++b) {
+		inference.position[b] = IR_NONE;
+	}
+	for (unsigned int k = 0; k < inference.orderCount; ++k) {
+		inference.position[inference.order[k]] = k;
+	}
+	_computeDominators(&inference);
+
+	// Every number grows until no range changes (the phis of a loop read the
+	// values of its latch, visited after them).
+	boolean changed = true;
+	while (changed) {
+		changed = false;
+		for (unsigned int k = 0; k < inference.orderCount; ++k) {
+			const IrBlock *irBlock = &irFunction->blocks[inference.order[k]];
+			for (unsigned int p = 0; p < irBlock->phiCount; ++p) {
+				if (irFunction->instructions[irBlock->phis[p]].type == NUMBER_VT) {
+					changed |= _update(&inference, irBlock->phis[p]);
+				}
+			}
+			for (unsigned int i = 0; i < irBlock->instructionCount; ++i) {
+				if (irFunction->instructions[irBlock->instructions[i]].type == NUMBER_VT) {
+					changed |= _update(&inference, irBlock->instructions[i]);
+				}
+			}
+		}
+	}
+
+	for (unsigned int k = 0; k < irFunction->instructionCount; ++k) {
+		IrInstruction *instruction = &irFunction->instructions[k];
+		const NumericRange range = inference.ranges[k];
+		if (instruction->type != NUMBER_VT) {
+			instruction->representation = TAGGED_REP;
+		}
+		else if (!range.reached || !range.integral) {
+			instruction->representation = DOUBLE_REP;
+		}
+		else {
+			instruction->representation = INT_MIN <= range.low && range.high <= INT_MAX ? INT32_REP : INT64_REP;
+			result.changed = true;
+		}
+	}
+	free(inference.dominators);
+	free(inference.position);
+	free(inference.order);
+	free(inference.changes);
+	free(inference.ranges);
+	return result;
+}
@@ -0,0 +1,26 @@
+#ifndef NUMERIC_REPRESENTATION_HEADER
+#define NUMERIC_REPRESENTATION_HEADER
+
+#include "../intermediate-representation/IntermediateRepresentation.h"
+#include "PassManager.h"
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+
+/**
+ * Infers how every number of the function is held at run time (see the
+ * representations of the IR). It bounds every number with an interval, and
+ * tells whether it is always an integer: constants are exact, additions,
+ * subtractions and multiplications of integers stay integral (unless they
+ * could produce a negative zero), phis join their operands, and every other
+ * number (a parameter, a load, the result of a call or of a division) could
+ * be any double. The comparisons that guard a block narrow the intervals of
+ * their operands inside of it (e.g., "i" in the body of "i < 100").
+ *
+ * Loops reach a fixed point because intervals that keep growing are widened
+ * to the next threshold (32 bits, 2^53, infinity). It allocates nothing
+ * inside the module, so it can run on every function at once.
+ */
+PassResult inferNumericRepresentations(IrModule *module, const unsigned int function);
+
+#endif
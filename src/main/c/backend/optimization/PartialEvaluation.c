@@ -0,0 +1,705 @@
+#include "PartialEvaluation.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializePartialEvaluationModule() {
+	_logger = createLogger("PartialEvaluation");
+}
+
+void shutdownPartialEvaluationModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The number of buckets of the table of names.
+ */
+#define PARTIAL_EVALUATION_BUCKETS 256
+
+/**
+ * The fuel of a single call (see the Calculator), and of all of them.
+ */
+#define CALL_FUEL 100000
+#define PROGRAM_FUEL 2000000
+
+/**
+ * The fuel of the initialization of the program (see snapshotInitialization).
+ */
+#define INITIALIZATION_FUEL 2000000
+
+typedef struct NameBindings NameBindings;
+
+/**
+ * How many times a name is bound across the whole program.
+ */
+struct NameBindings {
+	const char *name;
+	unsigned int declarations;
+	unsigned int writes;
+	FunctionDeclaration *function;	  // the function it declares, if any
+	unsigned int initializations;	  // declarations in the initialization of the program
+	boolean snapshotted;			  // true once it has a value after the initialization
+	ComputationResult snapshot;
+	NameBindings *next;
+};
+
+/**
+ * The state of a single run of the pass.
+ */
+typedef struct {
+	Arena *arena;
+	NameBindings *buckets[PARTIAL_EVALUATION_BUCKETS];
+	unsigned int fuel;
+	unsigned int nodes;
+	unsigned int evaluated;
+} Evaluation;
+
+static Constant *_evaluateCall(Evaluation *evaluation, FunctionCall *functionCall);
+static void _evaluateCode(Evaluation *evaluation, Code *code);
+static unsigned int _evaluateExpression(Evaluation *evaluation, Expression *expression);
+static void _evaluateFunctionBody(Evaluation *evaluation, FunctionBody *body);
+static void _evaluateRoot(Evaluation *evaluation, Expression *expression);
+static void _evaluateVariable(Evaluation *evaluation, Variable *variable);
+static NameBindings *_findName(Evaluation *evaluation, const char *name);
+static unsigned int _hashName(const char *name);
+static boolean _hoistsBindings(Code *code, Code *end);
+static Code *_initializationEnd(Code *code);
+static boolean _isInitialized(Code *code, Code *end);
+static boolean _isLiteral(const Expression *expression);
+static Constant *_literal(const ComputationResult result);
+static void _recordSnapshot(void *context, const char *name, const ComputationResult value);
+static FunctionDeclaration *_resolve(void *context, const char *name);
+static boolean _snapshotDeclaration(Evaluation *evaluation, Declaration *declaration, const boolean write);
+static void _surveyCode(Evaluation *evaluation, Code *code);
+static void _surveyFunctionBody(Evaluation *evaluation, VariableTypeList *parameters, FunctionBody *body);
+
+/**
+ * Computes a call whose arguments are literals (once the calls among them
+ * are computed), and returns the literal that replaces it, if any.
+ */
+static Constant *_evaluateCall(Evaluation *evaluation, FunctionCall *functionCall) {
+	boolean literal = functionCall->type == CLASSIC_CALL;
+	for (ArgumentList *argument = functionCall->arguments; argument != NULL; argument = argument->next) {
+		_evaluateRoot(evaluation, argument->expression);
+		literal &= _isLiteral(argument->expression);
+	}
+	if (!literal || evaluation->fuel == 0 || _resolve(evaluation, functionCall->id) == NULL) {
+		return NULL;
+	}
+	Calculation calculation = {
+		.resolve = _resolve,
+		.context = evaluation,
+		.arena = evaluation->arena,
+		.fuel = evaluation->fuel < CALL_FUEL ? evaluation->fuel : CALL_FUEL,
+		.depth = 0};
+	const unsigned int fuel = calculation.fuel;
+	const ComputationResult result = computeCall(&calculation, functionCall);
+	evaluation->fuel -= fuel - calculation.fuel;
+	Constant *constant = result.succeed ? _literal(result) : NULL;
+	if (constant == NULL) {
+		logDebugging(_logger, "The call to \"%s\" is not computed (after %u units of fuel).", functionCall->id, fuel - calculation.fuel);
+		return NULL;
+	}
+	logDebugging(_logger, "The call to \"%s\" is computed (with %u units of fuel).", functionCall->id, fuel - calculation.fuel);
+	++evaluation->evaluated;
+	return constant;
+}
+
+static void _evaluateCode(Evaluation *evaluation, Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		++evaluation->nodes;
+		switch (statement->statement) {
+			case IF_ST:
+				_evaluateRoot(evaluation, statement->ifStatement->condition);
+				_evaluateCode(evaluation, statement->ifStatement->thenBody);
+				_evaluateCode(evaluation, statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_evaluateRoot(evaluation, statement->whileLoop->condition);
+				_evaluateCode(evaluation, statement->whileLoop->body);
+				break;
+			case FOR_ST: {
+				ParamsFor *params = statement->forLoop->params;
+				if (params->type == FOR_CLASSIC) {
+					if (params->init != NULL) {
+						_evaluateVariable(evaluation, params->init->variable);
+					}
+					_evaluateRoot(evaluation, params->condition);
+					if (params->updateType == EXPRESSION_UT) {
+						_evaluateRoot(evaluation, params->update);
+					}
+				}
+				else if (params->iterable->type == FUNCTIONCALL_IT) {
+					for (ArgumentList *argument = params->iterable->functionCall->arguments; argument != NULL; argument = argument->next) {
+						_evaluateRoot(evaluation, argument->expression);
+					}
+				}
+				else if (params->iterable->type == ARRAY_IT) {
+					for (ArrayContent *element = params->iterable->arrayContent; element != NULL; element = element->next) {
+						_evaluateRoot(evaluation, element->value);
+					}
+				}
+				_evaluateCode(evaluation, statement->forLoop->body);
+				break;
+			}
+			case DECLARATION_ST:
+				_evaluateVariable(evaluation, statement->declaration->variable);
+				break;
+			case VARIABLE_ST:
+				_evaluateVariable(evaluation, statement->variable);
+				break;
+			case EXPRESSION_ST:
+				_evaluateRoot(evaluation, statement->expression);
+				break;
+			case FUNCTIONCALL_ST:
+				// Its result is dropped, so it is only worth its arguments.
+				for (ArgumentList *argument = statement->functionCall->arguments; argument != NULL; argument = argument->next) {
+					_evaluateRoot(evaluation, argument->expression);
+				}
+				break;
+			case FUNCTION_DECLARATION_ST:
+				_evaluateFunctionBody(evaluation, statement->FunctionDeclaration->body);
+				break;
+			case ASYNC_FUNCTION_ST:
+				_evaluateFunctionBody(evaluation, statement->asyncFunction->body);
+				break;
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_evaluateRoot(evaluation, content->condition);
+					_evaluateCode(evaluation, content->body);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/**
+ * Computes the calls of an expression (the innermost ones first), and
+ * returns how many were replaced.
+ */
+static unsigned int _evaluateExpression(Evaluation *evaluation, Expression *expression) {
+	if (expression == NULL) {
+		return 0;
+	}
+	switch (expression->type) {
+		case FACTOR: {
+			Factor *factor = expression->factor;
+			if (factor->type == EXPRESSION) {
+				return _evaluateExpression(evaluation, factor->expression);
+			}
+			if (factor->type != FUNCTIONCALL) {
+				return 0;
+			}
+			Constant *constant = _evaluateCall(evaluation, factor->functionCall);
+			if (constant == NULL) {
+				return 0;
+			}
+			factor->type = CONSTANT;
+			factor->constant = constant;
+			return 1;
+		}
+		case NOT_OP:
+		case AWAIT_OP:
+			return _evaluateExpression(evaluation, expression->expression);
+		default:
+			return _evaluateExpression(evaluation, expression->leftExpression)
+				+ _evaluateExpression(evaluation, expression->rightExpression);
+	}
+}
+
+static void _evaluateFunctionBody(Evaluation *evaluation, FunctionBody *body) {
+	if (body == NULL) {
+		return;
+	}
+	_evaluateCode(evaluation, body->code);
+	ReturnValue *returnValue = body->returnValue;
+	if (returnValue == NULL) {
+		return;
+	}
+	switch (returnValue->type) {
+		case EXPRESSION_RT:
+			_evaluateRoot(evaluation, returnValue->expression);
+			break;
+		case FUNCTIONCALL_RT: {
+			Constant *constant = _evaluateCall(evaluation, returnValue->functionCall);
+			if (constant != NULL) {
+				Factor *factor = allocateNode(sizeof(Factor));
+				factor->type = CONSTANT;
+				factor->constant = constant;
+				returnValue->expression = allocateNode(sizeof(Expression));
+				returnValue->expression->type = FACTOR;
+				returnValue->expression->factor = factor;
+				returnValue->type = EXPRESSION_RT;
+			}
+			break;
+		}
+		case ASYNC_FUNCTION_RT:
+			_evaluateFunctionBody(evaluation, returnValue->asyncFunction->body);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * Computes the calls of a whole expression, and folds it again around the
+ * literals that replaced them.
+ */
+static void _evaluateRoot(Evaluation *evaluation, Expression *expression) {
+	if (0 < _evaluateExpression(evaluation, expression)) {
+		foldExpression(expression);
+	}
+}
+
+static void _evaluateVariable(Evaluation *evaluation, Variable *variable) {
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_evaluateRoot(evaluation, variable->expression);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				_evaluateRoot(evaluation, element->value);
+			}
+			break;
+		case OBJECT_VAR:
+			for (ObjectContent *property = variable->objectContent; property != NULL; property = property->next) {
+				_evaluateRoot(evaluation, property->value);
+			}
+			break;
+		case FUNCTIONCALL_VAR: {
+			Constant *constant = _evaluateCall(evaluation, variable->functionCall);
+			if (constant != NULL) {
+				Factor *factor = allocateNode(sizeof(Factor));
+				factor->type = CONSTANT;
+				factor->constant = constant;
+				variable->expression = allocateNode(sizeof(Expression));
+				variable->expression->type = FACTOR;
+				variable->expression->factor = factor;
+				variable->type = EXPRESSION_VAR;
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+static NameBindings *_findName(Evaluation *evaluation, const char *name) {
+	const unsigned int bucket = _hashName(name);
+	for (NameBindings *bindings = evaluation->buckets[bucket]; bindings != NULL; bindings = bindings->next) {
+		if (strcmp(bindings->name, name) == 0) {
+			return bindings;
+		}
+	}
+	NameBindings *bindings = allocateInArena(evaluation->arena, sizeof(NameBindings));
+	bindings->name = name;
+	bindings->next = evaluation->buckets[bucket];
+	evaluation->buckets[bucket] = bindings;
+	return bindings;
+}
+
+static unsigned int _hashName(const char *name) {
+	unsigned int hash = 2166136261u;
+	for (; *name != '\0'; ++name) {
+		hash = (hash ^ (unsigned char) *name) * 16777619u;
+	}
+	return hash % PARTIAL_EVALUATION_BUCKETS;
+}
+
+/**
+ * True if the statements up to an end declare a binding that outlives their
+ * block: a "var" (e.g., in "for (var j = 0; ...)"), or a function, which a
+ * script also hoists out of a block.
+ */
+static boolean _hoistsBindings(Code *code, Code *end) {
+	for (; code != end; code = code->next) {
+		Statement *statement = code->statement;
+		switch (statement->statement) {
+			case IF_ST:
+				if (_hoistsBindings(statement->ifStatement->thenBody, NULL) || _hoistsBindings(statement->ifStatement->elseBody, NULL)) {
+					return true;
+				}
+				break;
+			case WHILE_ST:
+				if (_hoistsBindings(statement->whileLoop->body, NULL)) {
+					return true;
+				}
+				break;
+			case FOR_ST: {
+				ParamsFor *params = statement->forLoop->params;
+				const Declaration *declaration = params->type == FOR_CLASSIC ? params->init : params->value;
+				if ((declaration != NULL && declaration->type == VAR_DT) || _hoistsBindings(statement->forLoop->body, NULL)) {
+					return true;
+				}
+				break;
+			}
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					if (_hoistsBindings(content->body, NULL)) {
+						return true;
+					}
+				}
+				break;
+			case DECLARATION_ST:
+				if (statement->declaration->type == VAR_DT) {
+					return true;
+				}
+				break;
+			case FUNCTION_DECLARATION_ST:
+			case ASYNC_FUNCTION_ST:
+				return true;
+			default:
+				break;
+		}
+	}
+	return false;
+}
+
+/**
+ * The first statement of the program that is not part of its initialization:
+ * the statements that only declare, write and compute bindings (possibly in
+ * loops and conditionals), and the declarations of functions and types. A
+ * loop or conditional that declares a binding for the rest of the program
+ * ends it, because only the top-level declarations are written back.
+ */
+static Code *_initializationEnd(Code *code) {
+	for (; code != NULL; code = code->next) {
+		switch (code->statement->statement) {
+			case IF_ST:
+			case WHILE_ST:
+			case FOR_ST:
+				if (_hoistsBindings(code, code->next)) {
+					return code;
+				}
+				break;
+			case DECLARATION_ST:
+			case EXPRESSION_ST:
+			case VARIABLE_ST:
+			case INC_DEC_ST:
+			case FUNCTION_DECLARATION_ST:
+			case ASYNC_FUNCTION_ST:
+			case TYPE_DECLARATION_ST:
+				break;
+			default:
+				return code;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * True if the statements up to an end only declare bindings with literals,
+ * functions and types, so the output already starts with their snapshot.
+ */
+static boolean _isInitialized(Code *code, Code *end) {
+	for (; code != end; code = code->next) {
+		const Statement *statement = code->statement;
+		switch (statement->statement) {
+			case DECLARATION_ST: {
+				const Variable *variable = statement->declaration->variable;
+				if (variable->type != UNINITIALIZED && (variable->type != EXPRESSION_VAR || !_isLiteral(variable->expression))) {
+					return false;
+				}
+				break;
+			}
+			case FUNCTION_DECLARATION_ST:
+			case ASYNC_FUNCTION_ST:
+			case TYPE_DECLARATION_ST:
+				break;
+			default:
+				return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * True if the expression only combines literals.
+ */
+static boolean _isLiteral(const Expression *expression) {
+	if (expression == NULL) {
+		return true;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			switch (expression->factor->type) {
+				case CONSTANT:
+					return true;
+				case EXPRESSION:
+					return _isLiteral(expression->factor->expression);
+				default:
+					return false;
+			}
+		case AWAIT_OP:
+			return false;
+		case NOT_OP:
+			return _isLiteral(expression->expression);
+		default:
+			return _isLiteral(expression->leftExpression) && _isLiteral(expression->rightExpression);
+	}
+}
+
+/**
+ * The literal that writes a result back exactly, if any. A number that is
+ * not an integer must be finite (NaN has no literal).
+ */
+static Constant *_literal(const ComputationResult result) {
+	Constant *constant = allocateNode(sizeof(Constant));
+	constant->type = result.type;
+	switch (result.type) {
+		case NUMBER: {
+			const double number = result.number;
+			constant->numberType = INTEGER_NT;
+			if (INT_MIN < number && number <= INT_MAX && number == (int) number && (number != 0 || !signbit(number))) {
+				constant->integer = (int) number;
+				return constant;
+			}
+			if (!isfinite(number)) {
+				return NULL;
+			}
+			constant->numberType = FLOATING_NT;
+			constant->floating = number;
+			return constant;
+		}
+		case STRING: {
+			const size_t length = strlen(result.string);
+			char *lexeme = malloc(length + 3);
+			lexeme[0] = result.delimiter;
+			memcpy(lexeme + 1, result.string, length);
+			lexeme[length + 1] = result.delimiter;
+			lexeme[length + 2] = '\0';
+			constant->string = internString(lexeme);
+			free(lexeme);
+			return constant;
+		}
+		case BOOLEAN:
+			constant->boolean = result.boolean ? 1 : 0;
+			return constant;
+		default:
+			return NULL;
+	}
+}
+
+/**
+ * Keeps the value of a binding of the program once it is initialized. The
+ * bindings are visited from the last one declared, which is the one that
+ * the rest of the program sees.
+ */
+static void _recordSnapshot(void *context, const char *name, const ComputationResult value) {
+	NameBindings *bindings = _findName((Evaluation *) context, name);
+	if (!bindings->snapshotted) {
+		bindings->snapshotted = true;
+		bindings->snapshot = value;
+	}
+}
+
+/**
+ * The function that a call always reaches: declared once, and never written.
+ */
+static FunctionDeclaration *_resolve(void *context, const char *name) {
+	NameBindings *bindings = _findName((Evaluation *) context, name);
+	if (bindings->declarations != 1 || bindings->writes != 0) {
+		return NULL;
+	}
+	return bindings->function;
+}
+
+/**
+ * Declares a binding with its value after the initialization (if asked to),
+ * and returns true if a literal writes it back exactly (or leaving it
+ * uninitialized, for undefined).
+ */
+static boolean _snapshotDeclaration(Evaluation *evaluation, Declaration *declaration, const boolean write) {
+	Variable *variable = declaration->variable;
+	NameBindings *bindings = _findName(evaluation, variable->variableType->id);
+	if (!bindings->snapshotted || bindings->initializations != 1) {
+		return false;
+	}
+	if (bindings->snapshot.type == UNDEFINED && declaration->type != CONST_DT) {
+		if (write) {
+			variable->type = UNINITIALIZED;
+		}
+		return true;
+	}
+	Constant *constant = _literal(bindings->snapshot);
+	if (constant == NULL || !write) {
+		return constant != NULL;
+	}
+	Factor *factor = allocateNode(sizeof(Factor));
+	factor->type = CONSTANT;
+	factor->constant = constant;
+	variable->expression = allocateNode(sizeof(Expression));
+	variable->expression->type = FACTOR;
+	variable->expression->factor = factor;
+	variable->type = EXPRESSION_VAR;
+	return true;
+}
+
+static void _surveyCode(Evaluation *evaluation, Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		switch (statement->statement) {
+			case IF_ST:
+				_surveyCode(evaluation, statement->ifStatement->thenBody);
+				_surveyCode(evaluation, statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_surveyCode(evaluation, statement->whileLoop->body);
+				break;
+			case FOR_ST: {
+				ParamsFor *params = statement->forLoop->params;
+				Declaration *declaration = params->type == FOR_CLASSIC ? params->init : params->value;
+				if (declaration != NULL) {
+					++_findName(evaluation, declaration->variable->variableType->id)->declarations;
+				}
+				_surveyCode(evaluation, statement->forLoop->body);
+				break;
+			}
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_surveyCode(evaluation, content->body);
+				}
+				break;
+			case DECLARATION_ST:
+				++_findName(evaluation, statement->declaration->variable->variableType->id)->declarations;
+				break;
+			case VARIABLE_ST:
+				++_findName(evaluation, statement->variable->variableType->id)->writes;
+				break;
+			case INC_DEC_ST: {
+				const Expression *expression = statement->incDec->expression;
+				if (expression->type == FACTOR && expression->factor->type == VARIABLE) {
+					++_findName(evaluation, expression->factor->variableName)->writes;
+				}
+				break;
+			}
+			case FUNCTION_DECLARATION_ST: {
+				FunctionDeclaration *function = statement->FunctionDeclaration;
+				NameBindings *bindings = _findName(evaluation, function->id);
+				++bindings->declarations;
+				bindings->function = function;
+				_surveyFunctionBody(evaluation, function->arguments, function->body);
+				break;
+			}
+			case ASYNC_FUNCTION_ST:
+				++_findName(evaluation, statement->asyncFunction->id)->declarations;
+				_surveyFunctionBody(evaluation, statement->asyncFunction->arguments, statement->asyncFunction->body);
+				break;
+			case TYPE_DECLARATION_ST:
+				++_findName(evaluation, statement->typeDeclaration->id)->declarations;
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+static void _surveyFunctionBody(Evaluation *evaluation, VariableTypeList *parameters, FunctionBody *body) {
+	for (; parameters != NULL; parameters = parameters->next) {
+		++_findName(evaluation, parameters->variableType->id)->declarations;
+	}
+	if (body == NULL) {
+		return;
+	}
+	_surveyCode(evaluation, body->code);
+	if (body->returnValue != NULL && body->returnValue->type == ASYNC_FUNCTION_RT) {
+		AsyncFunction *asyncFunction = body->returnValue->asyncFunction;
+		++_findName(evaluation, asyncFunction->id)->declarations;
+		_surveyFunctionBody(evaluation, asyncFunction->arguments, asyncFunction->body);
+	}
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult evaluateConstantCalls(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	Evaluation evaluation = {
+		.arena = createArena(4096),
+		.buckets = {NULL},
+		.fuel = PROGRAM_FUEL,
+		.nodes = 0,
+		.evaluated = 0};
+	_surveyCode(&evaluation, program->code);
+	_evaluateCode(&evaluation, program->code);
+	destroyArena(evaluation.arena);
+	PassResult result = {.nodes = evaluation.nodes, .changed = 0 < evaluation.evaluated};
+	return result;
+}
+
+PassResult snapshotInitialization(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	PassResult result = {.nodes = 0, .changed = false};
+	Evaluation evaluation = {
+		.arena = createArena(4096),
+		.buckets = {NULL},
+		.fuel = INITIALIZATION_FUEL,
+		.nodes = 0,
+		.evaluated = 0};
+	_surveyCode(&evaluation, program->code);
+	Calculation calculation = {
+		.resolve = _resolve,
+		.context = &evaluation,
+		.arena = evaluation.arena,
+		.fuel = INITIALIZATION_FUEL,
+		.depth = 0};
+	// The initialization stops at the first statement that cannot be computed.
+	Code *end = _initializationEnd(program->code);
+	Code *failure = computeCode(&calculation, program->code, end, _recordSnapshot);
+	if (failure != end) {
+		end = failure;
+		calculation.fuel = INITIALIZATION_FUEL;
+		computeCode(&calculation, program->code, end, _recordSnapshot);
+	}
+	for (Code *code = program->code; code != end; code = code->next) {
+		++result.nodes;
+		if (code->statement->statement == DECLARATION_ST) {
+			++_findName(&evaluation, code->statement->declaration->variable->variableType->id)->initializations;
+		}
+	}
+	if (_isInitialized(program->code, end)) {
+		destroyArena(evaluation.arena);
+		return result;
+	}
+	// Every binding must be written back, before any statement is dropped.
+	for (Code *code = program->code; code != end; code = code->next) {
+		if (code->statement->statement == DECLARATION_ST && !_snapshotDeclaration(&evaluation, code->statement->declaration, false)) {
+			logDebugging(_logger, "The initialization of \"%s\" cannot be written back.", code->statement->declaration->variable->variableType->id);
+			destroyArena(evaluation.arena);
+			return result;
+		}
+	}
+	unsigned int dropped = 0;
+	Code **link = &program->code;
+	for (Code *code = program->code; code != end; code = code->next) {
+		switch (code->statement->statement) {
+			case DECLARATION_ST:
+				_snapshotDeclaration(&evaluation, code->statement->declaration, true);
+				*link = code;
+				link = &code->next;
+				break;
+			case FUNCTION_DECLARATION_ST:
+			case ASYNC_FUNCTION_ST:
+			case TYPE_DECLARATION_ST:
+				*link = code;
+				link = &code->next;
+				break;
+			default:
+				++dropped;
+				break;
+		}
+	}
+	*link = end;
+	logDebugging(_logger, "The initialization of the program is computed (%u statements dropped, with %u units of fuel).",
+		dropped, INITIALIZATION_FUEL - calculation.fuel);
+	destroyArena(evaluation.arena);
+	result.changed = true;
+	return result;
+}
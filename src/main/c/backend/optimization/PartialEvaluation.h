@@ -0,0 +1,52 @@
+#ifndef PARTIAL_EVALUATION_HEADER
+#define PARTIAL_EVALUATION_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Arena.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/StringPool.h"
+#include "../../shared/Type.h"
+#include "../domain-specific/Calculator.h"
+#include "ConstantFolding.h"
+#include "PassManager.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializePartialEvaluationModule();
+
+/** Shutdown module's internal state. */
+void shutdownPartialEvaluationModule();
+
+/**
+ * Runs the calls whose arguments are all literals at compile time (see the
+ * Calculator), and replaces each of them with the literal that it returns,
+ * so the work that the program would do while it starts (e.g., computing a
+ * table) is done once, by the compiler. The literals then go through the
+ * pool of literals, like the ones of the source.
+ *
+ * A call is only replaced if the function it reaches (declared once, and
+ * never written) computes it without reading nor writing anything but its
+ * own bindings, within a budget of fuel, and if its result can be written
+ * back exactly: a boolean, a string, or a finite number.
+ */
+PassResult evaluateConstantCalls(CompilerState *compilerState);
+
+/**
+ * Runs the initialization of the program at compile time ("snapshot"): the
+ * statements at its top that only declare and compute bindings (e.g., filling
+ * a table of numbers or strings in a loop), up to the first one that cannot
+ * be computed (see the Calculator). Their declarations then start with the
+ * values that the bindings have once it ends, and every other statement of
+ * the initialization is dropped, so the output starts from its snapshot
+ * instead of running it again on every run.
+ *
+ * Nothing changes unless every binding that the initialization declares has
+ * a value that a literal writes back exactly (or is left undefined).
+ */
+PassResult snapshotInitialization(CompilerState *compilerState);
+
+#endif
@@ -0,0 +1,552 @@
+#include "PassManager.h"
+#include "../code-generation/Generator.h"
+#include "../code-generation/X86Generator.h"
+#include "../intermediate-representation/SsaBuilder.h"
+#include "BlockLayout.h"
+#include "ConstantFolding.h"
+#include "DeadCodeElimination.h"
+#include "DeadValueElimination.h"
+#include "EscapeAnalysis.h"
+#include "IndexedLoops.h"
+#include "InductionVariables.h"
+#include "Inliner.h"
+#include "LiteralPool.h"
+#include "LoopInvariantCodeMotion.h"
+#include "LoopUnrolling.h"
+#include "NumericRepresentation.h"
+#include "PartialEvaluation.h"
+#include "Profiling.h"
+#include "Specialization.h"
+#include "TreeRewriting.h"
+#include "TypedArrays.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger * _logger = NULL;
+
+void initializePassManagerModule() {
+	_logger = createLogger("PassManager");
+}
+
+void shutdownPassManagerModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+static PassResult _assemble(CompilerState * compilerState);
+static PassResult _buildSsa(CompilerState * compilerState);
+static PassResult _generate(CompilerState * compilerState);
+
+/**
+ * Every known pass. Transformations and emissions run in dependency order
+ * (and in this order, when they are independent).
+ */
+static const Pass _passes[] = {
+	{
+		.name = "profile",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 0,
+		.requires = NULL,
+		.invalidates = NULL,
+		.runProgram = profileProgram
+	},
+	{
+		.name = "ssa",
+		.kind = ANALYSIS_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 0,
+		.requires = NULL,
+		.invalidates = NULL,
+		.runProgram = _buildSsa
+	},
+	{
+		.name = "representations",
+		.kind = ANALYSIS_PASS,
+		.scope = FUNCTION_PASS,
+		.optimizationLevel = 0,
+		.requires = (const char * const []) {"ssa", NULL},
+		.invalidates = NULL,
+		.runFunction = inferNumericRepresentations
+	},
+	{
+		.name = "layout",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 1,
+		.requires = (const char * const []) {"profile", NULL},
+		.invalidates = (const char * const []) {"ssa", NULL},
+		.runProgram = layoutHotPaths
+	},
+	{
+		.name = "inline",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 1,
+		.requires = (const char * const []) {"profile", NULL},
+		.invalidates = (const char * const []) {"ssa", NULL},
+		.runProgram = inlineFunctions
+	},
+	{
+		.name = "fold",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 1,
+		.requires = (const char * const []) {"inline", NULL},
+		.invalidates = (const char * const []) {"ssa", NULL},
+		.runProgram = foldConstants
+	},
+	{
+		.name = "evaluate",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 1,
+		.requires = (const char * const []) {"fold", NULL},
+		.invalidates = (const char * const []) {"ssa", NULL},
+		.runProgram = evaluateConstantCalls
+	},
+	{
+		.name = "snapshot",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 1,
+		.requires = (const char * const []) {"evaluate", NULL},
+		.invalidates = (const char * const []) {"ssa", NULL},
+		.runProgram = snapshotInitialization
+	},
+	{
+		.name = "specialize",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 2,
+		.requires = (const char * const []) {"profile", "fold", NULL},
+		.invalidates = (const char * const []) {"ssa", NULL},
+		.runProgram = specializeFunctions
+	},
+	{
+		.name = "strength-reduce",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 2,
+		.requires = (const char * const []) {"fold", NULL},
+		.invalidates = (const char * const []) {"ssa", NULL},
+		.runProgram = reduceStrength
+	},
+	{
+		.name = "licm",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 1,
+		.requires = (const char * const []) {"fold", NULL},
+		.invalidates = (const char * const []) {"ssa", NULL},
+		.runProgram = hoistLoopInvariants
+	},
+	{
+		.name = "typed-arrays",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 1,
+		.requires = (const char * const []) {"inline", NULL},
+		.invalidates = NULL,
+		.runProgram = specializeTypedArrays
+	},
+	{
+		.name = "index-loops",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 1,
+		.requires = (const char * const []) {"fold", NULL},
+		.invalidates = NULL,
+		.runProgram = indexArrayLoops
+	},
+	{
+		.name = "unroll",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 2,
+		.requires = (const char * const []) {"profile", "index-loops", NULL},
+		.invalidates = NULL,
+		.runProgram = unrollLoops
+	},
+	{
+		.name = "scalar-replace",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 2,
+		.requires = (const char * const []) {"typed-arrays", "index-loops", NULL},
+		.invalidates = NULL,
+		.runProgram = replaceArrayScalars
+	},
+	{
+		.name = "tree-shake",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 1,
+		.requires = NULL,
+		.invalidates = (const char * const []) {"ssa", NULL},
+		.runProgram = eliminateDeadCode
+	},
+	{
+		.name = "literal-pool",
+		.kind = TRANSFORMATION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 1,
+		.requires = (const char * const []) {"tree-shake", NULL},
+		.invalidates = (const char * const []) {"ssa", NULL},
+		.runProgram = poolLiterals
+	},
+	{
+		.name = "ir-dce",
+		.kind = TRANSFORMATION_PASS,
+		.scope = FUNCTION_PASS,
+		.optimizationLevel = 1,
+		.native = true,
+		.requires = (const char * const []) {"ssa", NULL},
+		.invalidates = NULL,
+		.runFunction = eliminateDeadValues
+	},
+	{
+		.name = "generate",
+		.kind = EMISSION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 0,
+		.target = JAVASCRIPT_TARGET,
+		.requires = (const char * const []) {"profile", NULL},
+		.invalidates = NULL,
+		.runProgram = _generate
+	},
+	{
+		.name = "assemble",
+		.kind = EMISSION_PASS,
+		.scope = PROGRAM_PASS,
+		.optimizationLevel = 0,
+		.target = X86_64_TARGET,
+		.requires = (const char * const []) {"representations", NULL},
+		.invalidates = NULL,
+		.runProgram = _assemble
+	}
+};
+
+#define PASS_COUNT (sizeof(_passes) / sizeof(_passes[0]))
+
+/**
+ * The statistics of a pass, over all of its runs.
+ */
+typedef struct {
+	unsigned int runs;
+	unsigned int changes;
+	unsigned long nodes;
+	size_t bytes;
+	double milliseconds;
+} PassStatistics;
+
+struct PassManager {
+	CompilerState * compilerState;
+	ThreadPool * threadPool;
+	PassStatistics statistics[PASS_COUNT];
+	boolean valid[PASS_COUNT];
+	boolean visited[PASS_COUNT];
+	unsigned int order[PASS_COUNT];
+	unsigned int orderCount;
+};
+
+/**
+ * The context of a function pass, shared by every thread of the loop.
+ */
+typedef struct {
+	const Pass * pass;
+	IrModule * module;
+	PassResult * results;
+} FunctionPassContext;
+
+static boolean _enabled(const PassManager * passManager, const unsigned int pass);
+static int _findPass(const char * name);
+static size_t _irBytes(const CompilerState * compilerState);
+static double _milliseconds();
+static boolean _order(PassManager * passManager, const unsigned int pass, unsigned int depth);
+static boolean _runPass(PassManager * passManager, const unsigned int pass);
+static boolean _runRequirements(PassManager * passManager, const unsigned int pass);
+static void _runFunctionPass(void * context, const unsigned int index);
+
+/**
+ * Emits x86-64 assembly from the IR. A program outside of the subset that it
+ * supports fails the compilation, unless the target is automatic: then the
+ * program falls back to JavaScript, since the AST is still there.
+ */
+static PassResult _assemble(CompilerState * compilerState) {
+	if (generateX86(compilerState)) {
+		logDebugging(_logger, "The program runs natively.");
+	}
+	else if (compilerState->target == AUTOMATIC_TARGET) {
+		logDebugging(_logger, "The program falls back to JavaScript.");
+		generate(compilerState);
+	}
+	else {
+		compilerState->succeed = false;
+	}
+	PassResult result = {.nodes = 0, .changed = false};
+	return result;
+}
+
+/**
+ * Lowers the AST into SSA form, replacing the previous IR module (if any).
+ */
+static PassResult _buildSsa(CompilerState * compilerState) {
+	releaseIrModule(compilerState->intermediateRepresentation);
+	IrModule * module = buildIrModule(compilerState->abstractSyntaxtTree);
+	compilerState->intermediateRepresentation = module;
+	PassResult result = {.nodes = 0, .changed = true};
+	for (unsigned int k = 0; k < module->functionCount; ++k) {
+		result.nodes += module->functions[k].instructionCount;
+	}
+	return result;
+}
+
+static PassResult _generate(CompilerState * compilerState) {
+	generate(compilerState);
+	PassResult result = {.nodes = 0, .changed = false};
+	return result;
+}
+
+/**
+ * True if the pass runs at the optimization level of the compilation. An
+ * emission also needs the target of the compilation, and a compilation
+ * that has not failed so far (e.g., because of its profile). A pass over the
+ * IR only needs to run when the native backend reads it.
+ */
+static boolean _enabled(const PassManager * passManager, const unsigned int pass) {
+	const CompilerState * compilerState = passManager->compilerState;
+	const Target target = compilerState->target == AUTOMATIC_TARGET ? X86_64_TARGET : compilerState->target;
+	return _passes[pass].optimizationLevel <= compilerState->optimizationLevel
+		&& (!_passes[pass].native || target == X86_64_TARGET)
+		&& (_passes[pass].kind != EMISSION_PASS || (_passes[pass].target == target && compilerState->succeed));
+}
+
+static int _findPass(const char * name) {
+	for (unsigned int k = 0; k < PASS_COUNT; ++k) {
+		if (strcmp(_passes[k].name, name) == 0) {
+			return k;
+		}
+	}
+	return -1;
+}
+
+/**
+ * The memory held by the IR module, used to tell how much a pass allocates
+ * (together with the nodes that it adds to the tree).
+ */
+static size_t _irBytes(const CompilerState * compilerState) {
+	const IrModule * module = compilerState->intermediateRepresentation;
+	return module == NULL ? 0 : module->arena->allocatedBytes;
+}
+
+/**
+ * The wall time (not the processor time, which adds up the threads of the
+ * function passes), from a monotonic clock where there is one.
+ */
+static double _milliseconds() {
+	struct timespec now;
+#if defined (_WIN32)
+	timespec_get(&now, TIME_UTC);
+#else
+	clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+	return 1000.0 * now.tv_sec + now.tv_nsec / 1000000.0;
+}
+
+/**
+ * Appends the pass to the execution order after its requirements, with a
+ * depth-first walk. Analyses are not ordered, because they run on demand.
+ * Returns false if the requirements have a cycle, or an unknown name.
+ */
+static boolean _order(PassManager * passManager, const unsigned int pass, unsigned int depth) {
+	if (passManager->visited[pass]) {
+		return true;
+	}
+	if (PASS_COUNT < depth) {
+		logError(_logger, "The requirements of the pass \"%s\" have a cycle.", _passes[pass].name);
+		return false;
+	}
+	const char * const * requires = _passes[pass].requires;
+	for (unsigned int k = 0; requires != NULL && requires[k] != NULL; ++k) {
+		const int required = _findPass(requires[k]);
+		if (required < 0) {
+			logError(_logger, "The pass \"%s\" requires an unknown pass: \"%s\".", _passes[pass].name, requires[k]);
+			return false;
+		}
+		if (_passes[required].kind != ANALYSIS_PASS && !_order(passManager, required, depth + 1)) {
+			return false;
+		}
+	}
+	passManager->visited[pass] = true;
+	passManager->order[passManager->orderCount++] = pass;
+	return true;
+}
+
+/**
+ * Runs a single pass (over every function, if it is a function pass), and
+ * records its statistics. The analyses it invalidates will run again when
+ * they are required.
+ */
+static boolean _runPass(PassManager * passManager, const unsigned int pass) {
+	const Pass * descriptor = &_passes[pass];
+	CompilerState * compilerState = passManager->compilerState;
+	if (!_runRequirements(passManager, pass)) {
+		return false;
+	}
+	logDebugging(_logger, "Running pass \"%s\"...", descriptor->name);
+	PassResult result = {.nodes = 0, .changed = false};
+	const IrModule * moduleBefore = compilerState->intermediateRepresentation;
+	const size_t bytesBefore = _irBytes(compilerState);
+	const size_t nodeBytesBefore = nodeBytes();
+	const double start = _milliseconds();
+	if (descriptor->scope == PROGRAM_PASS) {
+		result = descriptor->runProgram(compilerState);
+	}
+	else {
+		IrModule * module = compilerState->intermediateRepresentation;
+		if (module == NULL) {
+			logError(_logger, "The function pass \"%s\" needs an IR module.", descriptor->name);
+			return false;
+		}
+		if (passManager->threadPool == NULL) {
+			passManager->threadPool = createThreadPool(0);
+		}
+		FunctionPassContext context = {
+			.pass = descriptor,
+			.module = module,
+			.results = calloc(module->functionCount, sizeof(PassResult))};
+		runInThreadPool(passManager->threadPool, _runFunctionPass, &context, module->functionCount);
+		for (unsigned int k = 0; k < module->functionCount; ++k) {
+			result.nodes += context.results[k].nodes;
+			result.changed |= context.results[k].changed;
+		}
+		free(context.results);
+	}
+	PassStatistics * statistics = &passManager->statistics[pass];
+	statistics->milliseconds += _milliseconds() - start;
+	statistics->nodes += result.nodes;
+	const size_t bytesAfter = _irBytes(compilerState);
+	statistics->bytes += nodeBytes() - nodeBytesBefore;
+	if (compilerState->intermediateRepresentation != moduleBefore) {
+		statistics->bytes += bytesAfter;
+	}
+	else if (bytesBefore < bytesAfter) {
+		statistics->bytes += bytesAfter - bytesBefore;
+	}
+	++statistics->runs;
+	if (result.changed) {
+		++statistics->changes;
+		const char * const * invalidates = descriptor->invalidates;
+		for (unsigned int k = 0; invalidates != NULL && invalidates[k] != NULL; ++k) {
+			const int invalidated = _findPass(invalidates[k]);
+			if (0 <= invalidated) {
+				passManager->valid[invalidated] = false;
+			}
+		}
+	}
+	// The analyses computed from the previous result of an analysis are stale.
+	if (descriptor->kind == ANALYSIS_PASS) {
+		for (unsigned int k = 0; k < PASS_COUNT; ++k) {
+			const char * const * requires = _passes[k].requires;
+			for (unsigned int r = 0; _passes[k].kind == ANALYSIS_PASS && requires != NULL && requires[r] != NULL; ++r) {
+				if (strcmp(requires[r], descriptor->name) == 0) {
+					passManager->valid[k] = false;
+				}
+			}
+		}
+	}
+	passManager->valid[pass] = true;
+	return true;
+}
+
+/**
+ * Makes sure that every analysis required by the pass is valid.
+ */
+static boolean _runRequirements(PassManager * passManager, const unsigned int pass) {
+	const char * const * requires = _passes[pass].requires;
+	for (unsigned int k = 0; requires != NULL && requires[k] != NULL; ++k) {
+		const int required = _findPass(requires[k]);
+		if (_passes[required].kind == ANALYSIS_PASS && !passManager->valid[required]) {
+			if (!_runPass(passManager, required)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static void _runFunctionPass(void * context, const unsigned int index) {
+	FunctionPassContext * functionPassContext = context;
+	functionPassContext->results[index] = functionPassContext->pass->runFunction(functionPassContext->module, index);
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassManager * createPassManager(CompilerState * compilerState) {
+	PassManager * passManager = calloc(1, sizeof(PassManager));
+	passManager->compilerState = compilerState;
+	return passManager;
+}
+
+void destroyPassManager(PassManager * passManager) {
+	if (passManager != NULL) {
+		destroyThreadPool(passManager->threadPool);
+		releaseProgramNames();
+		free(passManager);
+	}
+}
+
+boolean runPasses(PassManager * passManager) {
+	reserveProgramNames(passManager->compilerState->abstractSyntaxtTree);
+	passManager->orderCount = 0;
+	memset(passManager->visited, 0, sizeof(passManager->visited));
+	for (unsigned int k = 0; k < PASS_COUNT; ++k) {
+		if (_passes[k].kind != ANALYSIS_PASS && !_order(passManager, k, 0)) {
+			return false;
+		}
+	}
+	for (unsigned int k = 0; k < passManager->orderCount; ++k) {
+		const unsigned int pass = passManager->order[k];
+		if (_enabled(passManager, pass) && !_runPass(passManager, pass)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+boolean ensureAnalysis(PassManager * passManager, const char * name) {
+	const int pass = _findPass(name);
+	if (pass < 0 || _passes[pass].kind != ANALYSIS_PASS) {
+		logError(_logger, "There is no analysis named \"%s\".", name);
+		return false;
+	}
+	return passManager->valid[pass] || _runPass(passManager, pass);
+}
+
+void printPassStatistics(const PassManager * passManager, FILE * stream) {
+	double total = 0;
+	for (unsigned int k = 0; k < PASS_COUNT; ++k) {
+		total += passManager->statistics[k].milliseconds;
+	}
+	fprintf(stream, "%10s %7s %10s %10s %5s %8s  %s\n", "Time (ms)", "%", "Nodes", "Memory", "Runs", "Changed", "Pass");
+	for (unsigned int k = 0; k < PASS_COUNT; ++k) {
+		const PassStatistics * statistics = &passManager->statistics[k];
+		if (statistics->runs == 0) {
+			continue;
+		}
+		fprintf(stream, "%10.3f %6.1f%% %10lu %9.1fK %5u %8u  %s%s\n",
+			statistics->milliseconds,
+			total == 0 ? 0.0 : 100.0 * statistics->milliseconds / total,
+			statistics->nodes,
+			statistics->bytes / 1024.0,
+			statistics->runs,
+			statistics->changes,
+			_passes[k].name,
+			_passes[k].scope == FUNCTION_PASS ? " (per function)" : "");
+	}
+	fprintf(stream, "%10.3f %6.1f%% %10s %9.1fK %5s %8s  %s\n", total, 100.0, "", (nodeBytes() + _irBytes(passManager->compilerState)) / 1024.0, "", "", "Total");
+}
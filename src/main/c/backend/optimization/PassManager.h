@@ -0,0 +1,116 @@
+#ifndef PASS_MANAGER_HEADER
+#define PASS_MANAGER_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/ThreadPool.h"
+#include "../../shared/Type.h"
+#include "../intermediate-representation/IntermediateRepresentation.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/** Initialize module's internal state. */
+void initializePassManagerModule();
+
+/** Shutdown module's internal state. */
+void shutdownPassManagerModule();
+
+typedef enum PassKind PassKind;
+typedef enum PassScope PassScope;
+
+typedef struct Pass Pass;
+typedef struct PassResult PassResult;
+typedef struct PassManager PassManager;
+
+/**
+ * What a pass does. Analyses compute something that other passes require,
+ * and only run on demand (and again, once invalidated). Transformations
+ * rewrite the AST or the IR, and emissions write the output.
+ */
+enum PassKind {
+	ANALYSIS_PASS,
+	TRANSFORMATION_PASS,
+	EMISSION_PASS
+};
+
+/**
+ * What a pass runs over. A program pass runs once over the compiler state.
+ * A function pass runs once per function of the IR module, in parallel, so
+ * it must only touch its own function, and it must not allocate inside the
+ * arena of the module (which is not thread-safe).
+ */
+enum PassScope {
+	PROGRAM_PASS,
+	FUNCTION_PASS
+};
+
+/**
+ * The outcome of a run: how many nodes (AST nodes or IR instructions) the
+ * pass visited, and whether it changed anything.
+ */
+struct PassResult {
+	unsigned int nodes;
+	boolean changed;
+};
+
+/**
+ * The description of a pass. The lists of names end with NULL, and any of
+ * them can be NULL.
+ */
+struct Pass {
+	const char * name;
+	PassKind kind;
+	PassScope scope;
+
+	// The lowest optimization level (-O) that enables the pass.
+	unsigned int optimizationLevel;
+
+	// The output that an emission pass writes (the other passes ignore it).
+	Target target;
+
+	// True if the pass only rewrites the IR, which only the native backend reads.
+	boolean native;
+
+	// Passes that must run before this one.
+	const char * const * requires;
+
+	// Analyses that are no longer valid once this pass changes something.
+	const char * const * invalidates;
+
+	PassResult (*runProgram)(CompilerState * compilerState);
+	PassResult (*runFunction)(IrModule * module, const unsigned int function);
+};
+
+/**
+ * Creates a pass manager for a compilation, with every known pass.
+ */
+PassManager * createPassManager(CompilerState * compilerState);
+
+/**
+ * Destroys a pass manager. The IR module stays in the compiler state.
+ */
+void destroyPassManager(PassManager * passManager);
+
+/**
+ * Runs every transformation and emission enabled at the optimization level
+ * of the compilation (only the emissions of its target), in dependency order,
+ * and every analysis they require. Returns false if the pipeline is
+ * inconsistent.
+ */
+boolean runPasses(PassManager * passManager);
+
+/**
+ * Runs an analysis by name, unless its result is still valid. Returns false
+ * if there is no such analysis.
+ */
+boolean ensureAnalysis(PassManager * passManager, const char * name);
+
+/**
+ * Prints the time, nodes and memory taken by every pass that has run. The
+ * total memory is the heap that the tree and the IR hold at the end.
+ */
+void printPassStatistics(const PassManager * passManager, FILE * stream);
+
+#endif
@@ -0,0 +1,348 @@
+#include "Profiling.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializeProfilingModule() {
+	_logger = createLogger("Profiling");
+}
+
+void shutdownProfilingModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * A site is hot if it runs at least this fraction (1/n) of the times that
+ * the hottest site of its kind runs.
+ */
+#define HOT_SITE_FRACTION 8
+
+static void _addSite(Profile *profile, const ProfileSiteKind kind, const void *node, const char *name);
+static unsigned int _hashNode(const void *node);
+static boolean _readProfile(Profile *profile, const char *path);
+static void _visitArguments(Profile *profile, ArgumentList *arguments);
+static void _visitCall(Profile *profile, FunctionCall *functionCall);
+static void _visitCode(Profile *profile, Code *code);
+static void _visitExpression(Profile *profile, Expression *expression);
+static void _visitFunctionBody(Profile *profile, FunctionBody *body);
+static void _visitStatement(Profile *profile, Statement *statement);
+static void _visitVariable(Profile *profile, Variable *variable);
+static double _weight(const ProfileSite *site);
+
+/**
+ * Numbers a site, and folds its kind (and the name it calls, if any) into
+ * the signature of the program (FNV-1a).
+ */
+static void _addSite(Profile *profile, const ProfileSiteKind kind, const void *node, const char *name) {
+	if (profile->siteCount == profile->siteCapacity) {
+		profile->siteCapacity = profile->siteCapacity == 0 ? 64 : 2 * profile->siteCapacity;
+		profile->sites = realloc(profile->sites, profile->siteCapacity * sizeof(ProfileSite));
+	}
+	ProfileSite *site = &profile->sites[profile->siteCount++];
+	site->node = node;
+	site->kind = kind;
+	site->measured = false;
+	site->counts[0] = 0;
+	site->counts[1] = 0;
+	profile->signature = (profile->signature ^ (unsigned int) kind) * 16777619u;
+	for (; name != NULL && *name != '\0'; ++name) {
+		profile->signature = (profile->signature ^ (unsigned char) *name) * 16777619u;
+	}
+}
+
+static unsigned int _hashNode(const void *node) {
+	return (unsigned int) (((uintptr_t) node >> 4) * 2654435761u);
+}
+
+/**
+ * Reads the counts of every site, from a profile written by an instrumented
+ * output: a header with the number of sites and the signature of the
+ * program, and then both counters of each site ("NaN" if it was not
+ * counted).
+ */
+static boolean _readProfile(Profile *profile, const char *path) {
+	FILE *file = fopen(path, "r");
+	if (file == NULL) {
+		logError(_logger, "The profile \"%s\" cannot be read.", path);
+		return false;
+	}
+	unsigned int siteCount = 0;
+	unsigned int signature = 0;
+	boolean valid = fscanf(file, "profile %u %x", &siteCount, &signature) == 2
+		&& siteCount == profile->siteCount
+		&& signature == profile->signature;
+	for (unsigned int k = 0; valid && k < siteCount; ++k) {
+		ProfileSite *site = &profile->sites[k];
+		valid = fscanf(file, "%lf %lf", &site->counts[0], &site->counts[1]) == 2;
+		site->measured = valid && !isnan(site->counts[0]) && !isnan(site->counts[1]);
+		if (site->measured && profile->hottest[site->kind] < _weight(site)) {
+			profile->hottest[site->kind] = _weight(site);
+		}
+	}
+	fclose(file);
+	if (!valid) {
+		logError(_logger, "The profile \"%s\" does not belong to this program.", path);
+		for (unsigned int k = 0; k < profile->siteCount; ++k) {
+			profile->sites[k].measured = false;
+		}
+		return false;
+	}
+	profile->measured = true;
+	return true;
+}
+
+static void _visitArguments(Profile *profile, ArgumentList *arguments) {
+	for (; arguments != NULL; arguments = arguments->next) {
+		_visitExpression(profile, arguments->expression);
+	}
+}
+
+static void _visitCall(Profile *profile, FunctionCall *functionCall) {
+	_addSite(profile, CALL_SITE, functionCall, functionCall->id);
+	_visitArguments(profile, functionCall->arguments);
+}
+
+static void _visitCode(Profile *profile, Code *code) {
+	for (; code != NULL; code = code->next) {
+		_visitStatement(profile, code->statement);
+	}
+}
+
+static void _visitExpression(Profile *profile, Expression *expression) {
+	if (expression == NULL) {
+		return;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			if (expression->factor->type == EXPRESSION) {
+				_visitExpression(profile, expression->factor->expression);
+			}
+			else if (expression->factor->type == FUNCTIONCALL) {
+				_visitCall(profile, expression->factor->functionCall);
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			_visitExpression(profile, expression->expression);
+			break;
+		default:
+			_visitExpression(profile, expression->leftExpression);
+			_visitExpression(profile, expression->rightExpression);
+			break;
+	}
+}
+
+static void _visitFunctionBody(Profile *profile, FunctionBody *body) {
+	if (body == NULL) {
+		return;
+	}
+	_visitCode(profile, body->code);
+	ReturnValue *returnValue = body->returnValue;
+	if (returnValue == NULL) {
+		return;
+	}
+	switch (returnValue->type) {
+		case EXPRESSION_RT:
+			_visitExpression(profile, returnValue->expression);
+			break;
+		case FUNCTIONCALL_RT:
+			_visitCall(profile, returnValue->functionCall);
+			break;
+		case ARROWFUNCTION_RT:
+			_visitFunctionBody(profile, returnValue->arrowFunction->body);
+			break;
+		case ASYNC_FUNCTION_RT:
+			_visitFunctionBody(profile, returnValue->asyncFunction->body);
+			break;
+		default:
+			break;
+	}
+}
+
+static void _visitStatement(Profile *profile, Statement *statement) {
+	switch (statement->statement) {
+		case IF_ST:
+			_addSite(profile, BRANCH_SITE, statement->ifStatement, NULL);
+			_visitExpression(profile, statement->ifStatement->condition);
+			_visitCode(profile, statement->ifStatement->thenBody);
+			_visitCode(profile, statement->ifStatement->elseBody);
+			break;
+		case WHILE_ST:
+			_addSite(profile, LOOP_SITE, statement->whileLoop, NULL);
+			_visitExpression(profile, statement->whileLoop->condition);
+			_visitCode(profile, statement->whileLoop->body);
+			break;
+		case FOR_ST: {
+			ParamsFor *params = statement->forLoop->params;
+			_addSite(profile, LOOP_SITE, statement->forLoop, NULL);
+			if (params->type == FOR_CLASSIC) {
+				if (params->init != NULL) {
+					_visitVariable(profile, params->init->variable);
+				}
+				_visitExpression(profile, params->condition);
+				_visitExpression(profile, params->updateType == INC_DEC_UT ? params->updateIncDec->expression : params->update);
+			}
+			else {
+				IterableVariable *iterable = params->iterable;
+				if (iterable->type == FUNCTIONCALL_IT) {
+					_visitCall(profile, iterable->functionCall);
+				}
+				else if (iterable->type == ARRAY_IT) {
+					for (ArrayContent *element = iterable->arrayContent; element != NULL; element = element->next) {
+						_visitExpression(profile, element->value);
+					}
+				}
+				else if (iterable->type == OBJECT_IT) {
+					for (ObjectContent *property = iterable->objectContent; property != NULL; property = property->next) {
+						_visitExpression(profile, property->value);
+					}
+				}
+			}
+			_visitCode(profile, statement->forLoop->body);
+			break;
+		}
+		case DECLARATION_ST:
+			_visitVariable(profile, statement->declaration->variable);
+			break;
+		case EXPRESSION_ST:
+			_visitExpression(profile, statement->expression);
+			break;
+		case VARIABLE_ST:
+			_visitVariable(profile, statement->variable);
+			break;
+		case FUNCTIONCALL_ST:
+			_visitCall(profile, statement->functionCall);
+			break;
+		case FUNCTION_DECLARATION_ST:
+			_visitFunctionBody(profile, statement->FunctionDeclaration->body);
+			break;
+		case ASYNC_FUNCTION_ST:
+			_visitFunctionBody(profile, statement->asyncFunction->body);
+			break;
+		case INC_DEC_ST:
+			_visitExpression(profile, statement->incDec->expression);
+			break;
+		case SWITCH_ST:
+			for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+				_addSite(profile, CASE_SITE, content, NULL);
+				_visitExpression(profile, content->condition);
+				_visitCode(profile, content->body);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+static void _visitVariable(Profile *profile, Variable *variable) {
+	if (variable == NULL) {
+		return;
+	}
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_visitExpression(profile, variable->expression);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				_visitExpression(profile, element->value);
+			}
+			break;
+		case OBJECT_VAR:
+			for (ObjectContent *property = variable->objectContent; property != NULL; property = property->next) {
+				_visitExpression(profile, property->value);
+			}
+			break;
+		case FUNCTIONCALL_VAR:
+			_visitCall(profile, variable->functionCall);
+			break;
+		case ARROWFUNCTION_VAR:
+			_visitFunctionBody(profile, variable->arrowFunction->body);
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * How many times a site ran: both bodies of a branch, and the first counter
+ * of the others.
+ */
+static double _weight(const ProfileSite *site) {
+	return site->kind == BRANCH_SITE ? site->counts[0] + site->counts[1] : site->counts[0];
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult profileProgram(CompilerState *compilerState) {
+	PassResult result = {.nodes = 0, .changed = false};
+	if (compilerState->profileOutput == NULL && compilerState->profileInput == NULL) {
+		return result;
+	}
+	releaseProfile(compilerState->profile);
+	Profile *profile = calloc(1, sizeof(Profile));
+	profile->signature = 2166136261u;
+	Program *program = compilerState->abstractSyntaxtTree;
+	_visitCode(profile, program->code);
+	profile->tableSize = 16;
+	while (profile->tableSize < 2 * profile->siteCount) {
+		profile->tableSize *= 2;
+	}
+	profile->table = calloc(profile->tableSize, sizeof(unsigned int));
+	for (unsigned int k = 0; k < profile->siteCount; ++k) {
+		unsigned int slot = _hashNode(profile->sites[k].node) & (profile->tableSize - 1);
+		while (profile->table[slot] != 0) {
+			slot = (slot + 1) & (profile->tableSize - 1);
+		}
+		profile->table[slot] = k + 1;
+	}
+	compilerState->profile = profile;
+	logDebugging(_logger, "The program has %u sites (signature %08x).", profile->siteCount, profile->signature);
+	if (compilerState->profileInput != NULL && !_readProfile(profile, compilerState->profileInput)) {
+		compilerState->succeed = false;
+	}
+	result.nodes = profile->siteCount;
+	return result;
+}
+
+void releaseProfile(Profile *profile) {
+	if (profile != NULL) {
+		free(profile->sites);
+		free(profile->table);
+		free(profile);
+	}
+}
+
+int findProfileSite(const Profile *profile, const void *node) {
+	if (profile == NULL) {
+		return -1;
+	}
+	for (unsigned int slot = _hashNode(node) & (profile->tableSize - 1); profile->table[slot] != 0; slot = (slot + 1) & (profile->tableSize - 1)) {
+		if (profile->sites[profile->table[slot] - 1].node == node) {
+			return profile->table[slot] - 1;
+		}
+	}
+	return -1;
+}
+
+ProfileSite *findMeasuredSite(const Profile *profile, const void *node) {
+	if (profile == NULL || !profile->measured) {
+		return NULL;
+	}
+	const int index = findProfileSite(profile, node);
+	return 0 <= index && profile->sites[index].measured ? &profile->sites[index] : NULL;
+}
+
+boolean isColdSite(const Profile *profile, const void *node) {
+	const ProfileSite *site = findMeasuredSite(profile, node);
+	return site != NULL && _weight(site) == 0;
+}
+
+boolean isHotSite(const Profile *profile, const void *node) {
+	const ProfileSite *site = findMeasuredSite(profile, node);
+	return site != NULL && 0 < _weight(site) && profile->hottest[site->kind] <= HOT_SITE_FRACTION * _weight(site);
+}
@@ -0,0 +1,97 @@
+#ifndef PROFILING_HEADER
+#define PROFILING_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "PassManager.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/** Initialize module's internal state. */
+void initializeProfilingModule();
+
+/** Shutdown module's internal state. */
+void shutdownProfilingModule();
+
+typedef enum ProfileSiteKind ProfileSiteKind;
+
+typedef struct ProfileSite ProfileSite;
+typedef struct Profile Profile;
+
+/**
+ * What a site of the source counts, in its two counters: an if statement
+ * counts the runs of its then and else bodies, a loop its iterations and its
+ * entries, a case of a switch its runs, and a call its calls.
+ */
+enum ProfileSiteKind {
+	BRANCH_SITE,
+	LOOP_SITE,
+	CASE_SITE,
+	CALL_SITE
+};
+
+#define PROFILE_SITE_KINDS 4
+
+struct ProfileSite {
+	const void *node;
+	ProfileSiteKind kind;
+	boolean measured;	  // false if the instrumented output did not count it
+	double counts[2];
+};
+
+/**
+ * The sites of a program, numbered in the order of the source, and the
+ * counts of a training run (if a profile was read).
+ */
+struct Profile {
+	ProfileSite *sites;
+	unsigned int siteCount;
+	unsigned int siteCapacity;
+	unsigned int *table;
+	unsigned int tableSize;
+	unsigned int signature;
+	boolean measured;
+	double hottest[PROFILE_SITE_KINDS];
+};
+
+/**
+ * Numbers the sites of the program ("profile"), before any pass rewrites the
+ * tree, so that an instrumented compilation and a later one agree on them
+ * at any optimization level. If the compilation uses a profile (see
+ * "--profile-use"), it reads its counts. A profile of another program (or
+ * of another version of it) fails the compilation.
+ */
+PassResult profileProgram(CompilerState *compilerState);
+
+/**
+ * Releases the sites of a program, if any.
+ */
+void releaseProfile(Profile *profile);
+
+/**
+ * The index of the site of a node, or -1 if it is not one.
+ */
+int findProfileSite(const Profile *profile, const void *node);
+
+/**
+ * The site of a node, if the profile measured it (NULL otherwise).
+ */
+ProfileSite *findMeasuredSite(const Profile *profile, const void *node);
+
+/**
+ * True if the profile measured the site, and it never ran (or, for a loop,
+ * never iterated).
+ */
+boolean isColdSite(const Profile *profile, const void *node);
+
+/**
+ * True if the site ran at least a fraction of the times that the hottest
+ * site of its kind did.
+ */
+boolean isHotSite(const Profile *profile, const void *node);
+
+#endif
@@ -0,0 +1,991 @@
+#include "Specialization.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+
+void initializeSpecializationModule() {
+	_logger = createLogger("Specialization");
+}
+
+void shutdownSpecializationModule() {
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The number of buckets of the table of names.
+ */
+#define SPECIALIZATION_BUCKETS 256
+
+/**
+ * The most clones of a single function.
+ */
+#define MAXIMUM_SPECIALIZATIONS 4
+
+/**
+ * The longest body (in statements, nested ones included) of a function that
+ * is cloned.
+ */
+#define MAXIMUM_SPECIALIZED_STATEMENTS 32
+
+typedef struct NameTypes NameTypes;
+typedef struct Specialization Specialization;
+typedef struct Scope Scope;
+typedef struct CallSite CallSite;
+
+/**
+ * How a name is declared and used across the whole program.
+ */
+struct NameTypes {
+	const char *name;
+	unsigned int declarations;
+	unsigned int writes;
+	unsigned int incDecs;
+	Type *annotation;				  // of its declaration
+	Expression *initializer;		  // of its declaration, if any
+	FunctionDeclaration *function;	  // the function it declares, if any
+	Code *site;						  // and the code that declares it
+	boolean async;					  // if that function is inside an async function
+	boolean eligible;				  // if that function is specialized
+	boolean resolving;
+	unsigned int references;		  // outside of its own body
+	unsigned int rewritten;			  // of those references
+	Specialization *specializations;
+	unsigned int specializationCount;
+	NameTypes *next;
+};
+
+/**
+ * A clone of a function, for a single combination of argument types (UNKNOWN
+ * where the parameter keeps its own type).
+ */
+struct Specialization {
+	DataType *types;
+	FunctionDeclaration *clone;
+	Specialization *next;
+};
+
+/**
+ * The parameters of a function (and the names that its body binds, which
+ * could shadow them).
+ */
+struct Scope {
+	VariableTypeList *parameters;
+	NameSet locals;
+	Scope *next;
+};
+
+/**
+ * A call, in the scope where its arguments are evaluated.
+ */
+struct CallSite {
+	FunctionCall *call;
+	Scope *scope;
+	FunctionDeclaration *owner;
+	CallSite *next;
+};
+
+/**
+ * The state of a single run of the pass. It first surveys the program, and
+ * then rewrites the calls inside the clones.
+ */
+typedef struct {
+	Arena *arena;
+	NameTypes *buckets[SPECIALIZATION_BUCKETS];
+	CallSite *calls;
+	Scope *scopes;
+	boolean rewriting;
+	unsigned int nodes;
+	unsigned int specialized;
+} Specializer;
+
+static ArgumentList *_cloneArguments(ArgumentList *arguments);
+static ArrayContent *_cloneArray(ArrayContent *elements);
+static FunctionCall *_cloneCall(FunctionCall *functionCall);
+static Code *_cloneCode(Code *code);
+static Declaration *_cloneDeclaration(Declaration *declaration);
+static Expression *_cloneExpression(const Expression *expression);
+static ObjectContent *_cloneObject(ObjectContent *properties);
+static Statement *_cloneStatement(Statement *statement);
+static Variable *_cloneVariable(Variable *variable);
+static double _countCalls(const Profile *profile, const FunctionCall *functionCall);
+static unsigned int _countStatements(Code *code);
+static Scope *_createScope(Specializer *specializer, VariableTypeList *parameters, Code *body);
+static void _declare(Specializer *specializer, const char *name, Type *annotation, Expression *initializer);
+static NameTypes *_findName(Specializer *specializer, const char *name);
+static unsigned int _hashName(const char *name);
+static DataType _inferExpression(Specializer *specializer, const Expression *expression, Scope *scope);
+static DataType _inferName(Specializer *specializer, const char *name, Scope *scope);
+static boolean _isEligible(NameTypes *function);
+static void _reference(Specializer *specializer, const char *name, FunctionDeclaration *owner);
+static Specialization *_specialize(Specializer *specializer, NameTypes *callee, FunctionCall *call, Scope *scope, const boolean create);
+static DataType _singleType(const Type *type);
+static void _surveyCall(Specializer *specializer, FunctionCall *functionCall, Scope *scope, FunctionDeclaration *owner);
+static void _surveyCode(Specializer *specializer, Code *code, Scope *scope, FunctionDeclaration *owner, const boolean async);
+static void _surveyExpression(Specializer *specializer, const Expression *expression, Scope *scope, FunctionDeclaration *owner);
+static void _surveyFunction(Specializer *specializer, VariableTypeList *parameters, FunctionBody *body, FunctionDeclaration *owner, const boolean async);
+static void _surveyVariable(Specializer *specializer, Variable *variable, Scope *scope, FunctionDeclaration *owner);
+
+static ArgumentList *_cloneArguments(ArgumentList *arguments) {
+	if (arguments == NULL) {
+		return NULL;
+	}
+	ArgumentList *clone = allocateNode(sizeof(ArgumentList));
+	clone->expression = _cloneExpression(arguments->expression);
+	clone->next = _cloneArguments(arguments->next);
+	return clone;
+}
+
+static ArrayContent *_cloneArray(ArrayContent *elements) {
+	if (elements == NULL) {
+		return NULL;
+	}
+	ArrayContent *clone = allocateNode(sizeof(ArrayContent));
+	clone->value = _cloneExpression(elements->value);
+	clone->next = _cloneArray(elements->next);
+	return clone;
+}
+
+static FunctionCall *_cloneCall(FunctionCall *functionCall) {
+	FunctionCall *clone = allocateNode(sizeof(FunctionCall));
+	*clone = *functionCall;
+	clone->arguments = _cloneArguments(functionCall->arguments);
+	return clone;
+}
+
+static Code *_cloneCode(Code *code) {
+	if (code == NULL) {
+		return NULL;
+	}
+	return createCode(_cloneStatement(code->statement), _cloneCode(code->next));
+}
+
+static Declaration *_cloneDeclaration(Declaration *declaration) {
+	if (declaration == NULL) {
+		return NULL;
+	}
+	Declaration *clone = allocateNode(sizeof(Declaration));
+	clone->type = declaration->type;
+	clone->variable = _cloneVariable(declaration->variable);
+	return clone;
+}
+
+/**
+ * Copies an expression tree, like cloneExpression, but with its own calls,
+ * because the calls of a clone are rewritten on their own.
+ */
+static Expression *_cloneExpression(const Expression *expression) {
+	if (expression == NULL) {
+		return NULL;
+	}
+	Expression *clone = allocateNode(sizeof(Expression));
+	*clone = *expression;
+	switch (expression->type) {
+		case FACTOR:
+			clone->factor = allocateNode(sizeof(Factor));
+			*clone->factor = *expression->factor;
+			if (expression->factor->type == EXPRESSION) {
+				clone->factor->expression = _cloneExpression(expression->factor->expression);
+			}
+			else if (expression->factor->type == FUNCTIONCALL) {
+				clone->factor->functionCall = _cloneCall(expression->factor->functionCall);
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			clone->expression = _cloneExpression(expression->expression);
+			break;
+		default:
+			clone->leftExpression = _cloneExpression(expression->leftExpression);
+			clone->rightExpression = _cloneExpression(expression->rightExpression);
+			break;
+	}
+	return clone;
+}
+
+static ObjectContent *_cloneObject(ObjectContent *properties) {
+	if (properties == NULL) {
+		return NULL;
+	}
+	ObjectContent *clone = allocateNode(sizeof(ObjectContent));
+	clone->key = properties->key;
+	clone->value = _cloneExpression(properties->value);
+	clone->next = _cloneObject(properties->next);
+	return clone;
+}
+
+/**
+ * Copies a statement of a function that declares no function (see
+ * _countStatements). Type declarations are shared, because no pass modifies
+ * them.
+ */
+static Statement *_cloneStatement(Statement *statement) {
+	Statement *clone = allocateNode(sizeof(Statement));
+	*clone = *statement;
+	switch (statement->statement) {
+		case IF_ST:
+			clone->ifStatement = allocateNode(sizeof(IfStatement));
+			clone->ifStatement->condition = _cloneExpression(statement->ifStatement->condition);
+			clone->ifStatement->thenBody = _cloneCode(statement->ifStatement->thenBody);
+			clone->ifStatement->elseBody = _cloneCode(statement->ifStatement->elseBody);
+			break;
+		case WHILE_ST:
+			clone->whileLoop = allocateNode(sizeof(WhileLoop));
+			clone->whileLoop->condition = _cloneExpression(statement->whileLoop->condition);
+			clone->whileLoop->body = _cloneCode(statement->whileLoop->body);
+			break;
+		case FOR_ST: {
+			ParamsFor *params = statement->forLoop->params;
+			ParamsFor *paramsClone = allocateNode(sizeof(ParamsFor));
+			*paramsClone = *params;
+			if (params->type == FOR_CLASSIC) {
+				paramsClone->init = _cloneDeclaration(params->init);
+				paramsClone->condition = _cloneExpression(params->condition);
+				if (params->updateType == INC_DEC_UT) {
+					paramsClone->updateIncDec = allocateNode(sizeof(IncDec));
+					*paramsClone->updateIncDec = *params->updateIncDec;
+					paramsClone->updateIncDec->expression = _cloneExpression(params->updateIncDec->expression);
+				}
+				else {
+					paramsClone->update = _cloneExpression(params->update);
+				}
+			}
+			else {
+				paramsClone->value = _cloneDeclaration(params->value);
+				IterableVariable *iterable = allocateNode(sizeof(IterableVariable));
+				*iterable = *params->iterable;
+				switch (iterable->type) {
+					case FUNCTIONCALL_IT:
+						iterable->functionCall = _cloneCall(iterable->functionCall);
+						break;
+					case ARRAY_IT:
+						iterable->arrayContent = _cloneArray(iterable->arrayContent);
+						break;
+					case OBJECT_IT:
+						iterable->objectContent = _cloneObject(iterable->objectContent);
+						break;
+					default:
+						break;
+				}
+				paramsClone->iterable = iterable;
+			}
+			clone->forLoop = allocateNode(sizeof(ForLoop));
+			clone->forLoop->params = paramsClone;
+			clone->forLoop->body = _cloneCode(statement->forLoop->body);
+			break;
+		}
+		case DECLARATION_ST:
+			clone->declaration = _cloneDeclaration(statement->declaration);
+			break;
+		case EXPRESSION_ST:
+			clone->expression = _cloneExpression(statement->expression);
+			break;
+		case VARIABLE_ST:
+			clone->variable = _cloneVariable(statement->variable);
+			break;
+		case FUNCTIONCALL_ST:
+			clone->functionCall = _cloneCall(statement->functionCall);
+			break;
+		case INC_DEC_ST:
+			clone->incDec = allocateNode(sizeof(IncDec));
+			*clone->incDec = *statement->incDec;
+			clone->incDec->expression = _cloneExpression(statement->incDec->expression);
+			break;
+		case SWITCH_ST: {
+			clone->switchStatement = allocateNode(sizeof(SwitchStatement));
+			clone->switchStatement->id = statement->switchStatement->id;
+			SwitchContent **last = &clone->switchStatement->content;
+			for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+				SwitchContent *contentClone = allocateNode(sizeof(SwitchContent));
+				contentClone->condition = _cloneExpression(content->condition);
+				contentClone->body = _cloneCode(content->body);
+				*last = contentClone;
+				last = &contentClone->next;
+			}
+			break;
+		}
+		default:
+			break;
+	}
+	return clone;
+}
+
+static Variable *_cloneVariable(Variable *variable) {
+	Variable *clone = allocateNode(sizeof(Variable));
+	*clone = *variable;
+	clone->variableType = allocateNode(sizeof(VariableType));
+	*clone->variableType = *variable->variableType;
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			clone->expression = _cloneExpression(variable->expression);
+			break;
+		case ARRAY_VAR:
+			clone->arrayContent = _cloneArray(variable->arrayContent);
+			break;
+		case OBJECT_VAR:
+			clone->objectContent = _cloneObject(variable->objectContent);
+			break;
+		case FUNCTIONCALL_VAR:
+			clone->functionCall = _cloneCall(variable->functionCall);
+			break;
+		default:
+			break;
+	}
+	return clone;
+}
+
+/**
+ * The calls that a site made in the profile (0 if it was not measured).
+ */
+static double _countCalls(const Profile *profile, const FunctionCall *functionCall) {
+	const ProfileSite *site = findMeasuredSite(profile, functionCall);
+	return site == NULL ? 0 : site->counts[0];
+}
+
+/**
+ * The statements of the code, nested ones included, or more than the most
+ * that is cloned if it declares a function (of any kind).
+ */
+static unsigned int _countStatements(Code *code) {
+	unsigned int statements = 0;
+	for (; code != NULL && statements <= MAXIMUM_SPECIALIZED_STATEMENTS; code = code->next) {
+		Statement *statement = code->statement;
+		++statements;
+		switch (statement->statement) {
+			case IF_ST:
+				statements += _countStatements(statement->ifStatement->thenBody);
+				statements += _countStatements(statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				statements += _countStatements(statement->whileLoop->body);
+				break;
+			case FOR_ST:
+				statements += _countStatements(statement->forLoop->body);
+				break;
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					statements += _countStatements(content->body);
+				}
+				break;
+			case DECLARATION_ST:
+				if (statement->declaration->variable->type == ARROWFUNCTION_VAR) {
+					return 1 + MAXIMUM_SPECIALIZED_STATEMENTS;
+				}
+				break;
+			case VARIABLE_ST:
+				if (statement->variable->type == ARROWFUNCTION_VAR) {
+					return 1 + MAXIMUM_SPECIALIZED_STATEMENTS;
+				}
+				break;
+			case FUNCTION_DECLARATION_ST:
+			case ARROW_FUNCTION_ST:
+			case ASYNC_FUNCTION_ST:
+				return 1 + MAXIMUM_SPECIALIZED_STATEMENTS;
+			default:
+				break;
+		}
+	}
+	return statements;
+}
+
+static Scope *_createScope(Specializer *specializer, VariableTypeList *parameters, Code *body) {
+	Scope *scope = allocateInArena(specializer->arena, sizeof(Scope));
+	scope->parameters = parameters;
+	collectWrittenNames(body, &scope->locals, true);
+	scope->next = specializer->scopes;
+	specializer->scopes = scope;
+	return scope;
+}
+
+static void _declare(Specializer *specializer, const char *name, Type *annotation, Expression *initializer) {
+	if (specializer->rewriting) {
+		return;
+	}
+	NameTypes *types = _findName(specializer, name);
+	++types->declarations;
+	types->annotation = annotation;
+	types->initializer = initializer;
+}
+
+static NameTypes *_findName(Specializer *specializer, const char *name) {
+	const unsigned int bucket = _hashName(name);
+	for (NameTypes *types = specializer->buckets[bucket]; types != NULL; types = types->next) {
+		if (strcmp(types->name, name) == 0) {
+			return types;
+		}
+	}
+	NameTypes *types = allocateInArena(specializer->arena, sizeof(NameTypes));
+	types->name = name;
+	types->next = specializer->buckets[bucket];
+	specializer->buckets[bucket] = types;
+	return types;
+}
+
+static unsigned int _hashName(const char *name) {
+	unsigned int hash = 2166136261u;
+	for (; *name != '\0'; ++name) {
+		hash = (hash ^ (unsigned char) *name) * 16777619u;
+	}
+	return hash % SPECIALIZATION_BUCKETS;
+}
+
+/**
+ * The primitive type of the value of an expression, or UNKNOWN.
+ */
+static DataType _inferExpression(Specializer *specializer, const Expression *expression, Scope *scope) {
+	switch (expression->type) {
+		case FACTOR: {
+			const Factor *factor = expression->factor;
+			switch (factor->type) {
+				case CONSTANT:
+					return factor->constant->type;
+				case VARIABLE:
+					return _inferName(specializer, factor->variableName, scope);
+				case EXPRESSION:
+					return _inferExpression(specializer, factor->expression, scope);
+				case FUNCTIONCALL: {
+					const NameTypes *callee = _findName(specializer, factor->functionCall->id);
+					if (callee->function == NULL || callee->declarations != 1 || callee->writes != 0 || factor->functionCall->type == AWAIT_CALL) {
+						return UNKNOWN;
+					}
+					return _singleType(callee->function->returnType);
+				}
+			}
+			return UNKNOWN;
+		}
+		case ADD_OP: {
+			const DataType left = _inferExpression(specializer, expression->leftExpression, scope);
+			const DataType right = _inferExpression(specializer, expression->rightExpression, scope);
+			if (left == STRING || right == STRING) {
+				return STRING;
+			}
+			return left == NUMBER && right == NUMBER ? NUMBER : UNKNOWN;
+		}
+		case SUB_OP:
+		case MUL_OP:
+		case DIV_OP:
+			// Without both numbers, one of them could be a BigInt.
+			return _inferExpression(specializer, expression->leftExpression, scope) == NUMBER
+					&& _inferExpression(specializer, expression->rightExpression, scope) == NUMBER
+				? NUMBER
+				: UNKNOWN;
+		case GREATER_OP:
+		case LESS_OP:
+		case EQUAL_OP:
+		case NEQUAL_OP:
+		case GREATER_EQUAL_OP:
+		case LESS_EQUAL_OP:
+		case STRICT_EQUAL_OP:
+		case STRICT_NEQUAL_OP:
+		case NOT_OP:
+			return BOOLEAN;
+		case OR_OP:
+		case AND_OP: {
+			const DataType left = _inferExpression(specializer, expression->leftExpression, scope);
+			return left == _inferExpression(specializer, expression->rightExpression, scope) ? left : UNKNOWN;
+		}
+		default:
+			return UNKNOWN;
+	}
+}
+
+/**
+ * The primitive type of a name: the one of a parameter of the scope (unless
+ * its body binds it again), or else the one of a binding declared once,
+ * either annotated or never reassigned.
+ */
+static DataType _inferName(Specializer *specializer, const char *name, Scope *scope) {
+	if (scope != NULL) {
+		for (VariableTypeList *parameter = scope->parameters; parameter != NULL; parameter = parameter->next) {
+			if (strcmp(parameter->variableType->id, name) == 0) {
+				return containsName(&scope->locals, name) ? UNKNOWN : _singleType(parameter->variableType->type);
+			}
+		}
+	}
+	NameTypes *types = _findName(specializer, name);
+	if (types->declarations != 1 || types->function != NULL) {
+		return UNKNOWN;
+	}
+	if (types->annotation != NULL) {
+		return _singleType(types->annotation);
+	}
+	if (types->writes != 0 || types->initializer == NULL || types->resolving) {
+		return UNKNOWN;
+	}
+	types->resolving = true;
+	const DataType type = _inferExpression(specializer, types->initializer, NULL);
+	types->resolving = false;
+	return types->incDecs == 0 || type == NUMBER ? type : UNKNOWN;
+}
+
+static boolean _isEligible(NameTypes *function) {
+	FunctionDeclaration *declaration = function->function;
+	if (declaration == NULL || function->async || function->declarations != 1 || function->writes != 0 || function->incDecs != 0) {
+		return false;
+	}
+	FunctionBody *body = declaration->body;
+	if (body == NULL || (body->returnValue != NULL && (body->returnValue->type == ARROWFUNCTION_RT || body->returnValue->type == ASYNC_FUNCTION_RT))) {
+		return false;
+	}
+	boolean untyped = false;
+	for (VariableTypeList *parameter = declaration->arguments; parameter != NULL; parameter = parameter->next) {
+		const Type *type = parameter->variableType->type;
+		untyped |= type == NULL || (type->next == NULL && type->singleType == ANY);
+	}
+	return untyped && _countStatements(body->code) <= MAXIMUM_SPECIALIZED_STATEMENTS;
+}
+
+/**
+ * Records a reference to a name as a value (or a call that is not
+ * specialized), which could reach the original function.
+ */
+static void _reference(Specializer *specializer, const char *name, FunctionDeclaration *owner) {
+	if (owner == NULL || strcmp(owner->id, name) != 0 || specializer->rewriting) {
+		++_findName(specializer, name)->references;
+	}
+}
+
+/**
+ * The clone that a call reaches, given the types of its arguments: an
+ * existing one, or else a new one (if allowed, and if the function can
+ * have one more).
+ */
+static Specialization *_specialize(Specializer *specializer, NameTypes *callee, FunctionCall *call, Scope *scope, const boolean create) {
+	FunctionDeclaration *function = callee->function;
+	if (call->type == AWAIT_CALL) {
+		return NULL;
+	}
+	unsigned int count = 0;
+	for (VariableTypeList *parameter = function->arguments; parameter != NULL; parameter = parameter->next) {
+		++count;
+	}
+	DataType types[count];
+	boolean known = false;
+	ArgumentList *argument = call->arguments;
+	VariableTypeList *parameter = function->arguments;
+	for (unsigned int k = 0; k < count; ++k) {
+		if (argument == NULL) {
+			return NULL;
+		}
+		const Type *type = parameter->variableType->type;
+		types[k] = UNKNOWN;
+		if (type == NULL || (type->next == NULL && type->singleType == ANY)) {
+			const DataType inferred = _inferExpression(specializer, argument->expression, scope);
+			if (inferred == NUMBER || inferred == STRING || inferred == BOOLEAN) {
+				types[k] = inferred;
+				known = true;
+			}
+		}
+		argument = argument->next;
+		parameter = parameter->next;
+	}
+	if (argument != NULL || !known) {
+		return NULL;
+	}
+	for (Specialization *specialization = callee->specializations; specialization != NULL; specialization = specialization->next) {
+		if (memcmp(specialization->types, types, count * sizeof(DataType)) == 0) {
+			return specialization;
+		}
+	}
+	if (!create || MAXIMUM_SPECIALIZATIONS <= callee->specializationCount) {
+		return NULL;
+	}
+	Specialization *specialization = allocateInArena(specializer->arena, sizeof(Specialization));
+	specialization->types = allocateInArena(specializer->arena, (1 + count) * sizeof(DataType));
+	memcpy(specialization->types, types, count * sizeof(DataType));
+	FunctionDeclaration *clone = allocateNode(sizeof(FunctionDeclaration));
+	clone->id = createSyntheticName(function->id);
+	clone->returnType = function->returnType;
+	VariableTypeList **last = &clone->arguments;
+	parameter = function->arguments;
+	for (unsigned int k = 0; k < count; ++k, parameter = parameter->next) {
+		VariableType *variableType = allocateNode(sizeof(VariableType));
+		variableType->id = parameter->variableType->id;
+		variableType->type = parameter->variableType->type;
+		if (types[k] != UNKNOWN) {
+			variableType->type = allocateNode(sizeof(Type));
+			variableType->type->singleType = types[k];
+		}
+		*last = allocateNode(sizeof(VariableTypeList));
+		(*last)->variableType = variableType;
+		last = &(*last)->next;
+	}
+	specialization->clone = clone;
+	specialization->next = callee->specializations;
+	callee->specializations = specialization;
+	++callee->specializationCount;
+	return specialization;
+}
+
+static DataType _singleType(const Type *type) {
+	if (type == NULL || type->next != NULL) {
+		return UNKNOWN;
+	}
+	switch (type->singleType) {
+		case NUMBER:
+		case STRING:
+		case BOOLEAN:
+			return type->singleType;
+		default:
+			return UNKNOWN;
+	}
+}
+
+/**
+ * Surveys a call. While rewriting (the calls inside the clones), it is
+ * specialized at once, with the clones that already exist.
+ */
+static void _surveyCall(Specializer *specializer, FunctionCall *functionCall, Scope *scope, FunctionDeclaration *owner) {
+	for (ArgumentList *argument = functionCall->arguments; argument != NULL; argument = argument->next) {
+		_surveyExpression(specializer, argument->expression, scope, owner);
+	}
+	if (!specializer->rewriting) {
+		CallSite *site = allocateInArena(specializer->arena, sizeof(CallSite));
+		site->call = functionCall;
+		site->scope = scope;
+		site->owner = owner;
+		site->next = specializer->calls;
+		specializer->calls = site;
+		_reference(specializer, functionCall->id, owner);
+		return;
+	}
+	NameTypes *callee = _findName(specializer, functionCall->id);
+	if (!callee->eligible) {
+		return;
+	}
+	Specialization *specialization = _specialize(specializer, callee, functionCall, scope, false);
+	if (specialization == NULL) {
+		_reference(specializer, functionCall->id, owner);
+	}
+	else {
+		functionCall->id = specialization->clone->id;
+	}
+}
+
+static void _surveyCode(Specializer *specializer, Code *code, Scope *scope, FunctionDeclaration *owner, const boolean async) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		++specializer->nodes;
+		switch (statement->statement) {
+			case IF_ST:
+				_surveyExpression(specializer, statement->ifStatement->condition, scope, owner);
+				_surveyCode(specializer, statement->ifStatement->thenBody, scope, owner, async);
+				_surveyCode(specializer, statement->ifStatement->elseBody, scope, owner, async);
+				break;
+			case WHILE_ST:
+				_surveyExpression(specializer, statement->whileLoop->condition, scope, owner);
+				_surveyCode(specializer, statement->whileLoop->body, scope, owner, async);
+				break;
+			case FOR_ST: {
+				ParamsFor *params = statement->forLoop->params;
+				if (params->type == FOR_CLASSIC) {
+					if (params->init != NULL) {
+						Variable *variable = params->init->variable;
+						_declare(specializer, variable->variableType->id, variable->variableType->type, variable->type == EXPRESSION_VAR ? variable->expression : NULL);
+						_surveyVariable(specializer, variable, scope, owner);
+					}
+					_surveyExpression(specializer, params->condition, scope, owner);
+					if (params->updateType == INC_DEC_UT) {
+						const Expression *expression = params->updateIncDec->expression;
+						if (!specializer->rewriting && expression->type == FACTOR && expression->factor->type == VARIABLE) {
+							++_findName(specializer, expression->factor->variableName)->incDecs;
+						}
+						_surveyExpression(specializer, expression, scope, owner);
+					}
+					else {
+						_surveyExpression(specializer, params->update, scope, owner);
+					}
+				}
+				else {
+					_declare(specializer, params->value->variable->variableType->id, params->value->variable->variableType->type, NULL);
+					IterableVariable *iterable = params->iterable;
+					switch (iterable->type) {
+						case VARIABLE_IT:
+							_reference(specializer, iterable->variableName, owner);
+							break;
+						case FUNCTIONCALL_IT:
+							_surveyCall(specializer, iterable->functionCall, scope, owner);
+							break;
+						case ARRAY_IT:
+							for (ArrayContent *element = iterable->arrayContent; element != NULL; element = element->next) {
+								_surveyExpression(specializer, element->value, scope, owner);
+							}
+							break;
+						case OBJECT_IT:
+							for (ObjectContent *property = iterable->objectContent; property != NULL; property = property->next) {
+								_surveyExpression(specializer, property->value, scope, owner);
+							}
+							break;
+					}
+				}
+				_surveyCode(specializer, statement->forLoop->body, scope, owner, async);
+				break;
+			}
+			case DECLARATION_ST: {
+				Variable *variable = statement->declaration->variable;
+				_declare(specializer, variable->variableType->id, variable->variableType->type, variable->type == EXPRESSION_VAR ? variable->expression : NULL);
+				_surveyVariable(specializer, variable, scope, owner);
+				break;
+			}
+			case VARIABLE_ST:
+				if (!specializer->rewriting) {
+					++_findName(specializer, statement->variable->variableType->id)->writes;
+				}
+				_surveyVariable(specializer, statement->variable, scope, owner);
+				break;
+			case EXPRESSION_ST:
+				_surveyExpression(specializer, statement->expression, scope, owner);
+				break;
+			case FUNCTIONCALL_ST:
+				_surveyCall(specializer, statement->functionCall, scope, owner);
+				break;
+			case INC_DEC_ST: {
+				const Expression *expression = statement->incDec->expression;
+				if (!specializer->rewriting && expression->type == FACTOR && expression->factor->type == VARIABLE) {
+					++_findName(specializer, expression->factor->variableName)->incDecs;
+				}
+				_surveyExpression(specializer, expression, scope, owner);
+				break;
+			}
+			case FUNCTION_DECLARATION_ST: {
+				FunctionDeclaration *function = statement->FunctionDeclaration;
+				_declare(specializer, function->id, NULL, NULL);
+				if (!specializer->rewriting) {
+					NameTypes *types = _findName(specializer, function->id);
+					types->function = function;
+					types->site = code;
+					types->async = async;
+				}
+				_surveyFunction(specializer, function->arguments, function->body, function, async);
+				break;
+			}
+			case ASYNC_FUNCTION_ST:
+				_declare(specializer, statement->asyncFunction->id, NULL, NULL);
+				_surveyFunction(specializer, statement->asyncFunction->arguments, statement->asyncFunction->body, NULL, true);
+				break;
+			case TYPE_DECLARATION_ST:
+				_declare(specializer, statement->typeDeclaration->id, NULL, NULL);
+				break;
+			case SWITCH_ST:
+				if (statement->switchStatement->id != NULL) {
+					_reference(specializer, statement->switchStatement->id, owner);
+				}
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_surveyExpression(specializer, content->condition, scope, owner);
+					_surveyCode(specializer, content->body, scope, owner, async);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+static void _surveyExpression(Specializer *specializer, const Expression *expression, Scope *scope, FunctionDeclaration *owner) {
+	if (expression == NULL) {
+		return;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			switch (expression->factor->type) {
+				case VARIABLE:
+					_reference(specializer, expression->factor->variableName, owner);
+					break;
+				case EXPRESSION:
+					_surveyExpression(specializer, expression->factor->expression, scope, owner);
+					break;
+				case FUNCTIONCALL:
+					_surveyCall(specializer, expression->factor->functionCall, scope, owner);
+					break;
+				default:
+					break;
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			_surveyExpression(specializer, expression->expression, scope, owner);
+			break;
+		default:
+			_surveyExpression(specializer, expression->leftExpression, scope, owner);
+			_surveyExpression(specializer, expression->rightExpression, scope, owner);
+			break;
+	}
+}
+
+static void _surveyFunction(Specializer *specializer, VariableTypeList *parameters, FunctionBody *body, FunctionDeclaration *owner, const boolean async) {
+	for (VariableTypeList *parameter = parameters; parameter != NULL; parameter = parameter->next) {
+		_declare(specializer, parameter->variableType->id, parameter->variableType->type, NULL);
+	}
+	if (body == NULL) {
+		return;
+	}
+	Scope *scope = _createScope(specializer, parameters, body->code);
+	_surveyCode(specializer, body->code, scope, owner, async);
+	ReturnValue *returnValue = body->returnValue;
+	if (returnValue == NULL) {
+		return;
+	}
+	switch (returnValue->type) {
+		case EXPRESSION_RT:
+			_surveyExpression(specializer, returnValue->expression, scope, owner);
+			break;
+		case FUNCTIONCALL_RT:
+			_surveyCall(specializer, returnValue->functionCall, scope, owner);
+			break;
+		case ARROWFUNCTION_RT:
+			_surveyFunction(specializer, returnValue->arrowFunction->arguments, returnValue->arrowFunction->body, owner, async);
+			break;
+		case ASYNC_FUNCTION_RT:
+			_declare(specializer, returnValue->asyncFunction->id, NULL, NULL);
+			_surveyFunction(specializer, returnValue->asyncFunction->arguments, returnValue->asyncFunction->body, NULL, true);
+			break;
+		default:
+			break;
+	}
+}
+
+static void _surveyVariable(Specializer *specializer, Variable *variable, Scope *scope, FunctionDeclaration *owner) {
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_surveyExpression(specializer, variable->expression, scope, owner);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				_surveyExpression(specializer, element->value, scope, owner);
+			}
+			break;
+		case OBJECT_VAR:
+			for (ObjectContent *property = variable->objectContent; property != NULL; property = property->next) {
+				_surveyExpression(specializer, property->value, scope, owner);
+			}
+			break;
+		case FUNCTIONCALL_VAR:
+			_surveyCall(specializer, variable->functionCall, scope, owner);
+			break;
+		case ARROWFUNCTION_VAR:
+			_surveyFunction(specializer, variable->arrowFunction->arguments, variable->arrowFunction->body, owner, false);
+			break;
+		default:
+			break;
+	}
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult specializeFunctions(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	Specializer specializer = {
+		.arena = createArena(4096),
+		.buckets = {NULL},
+		.calls = NULL,
+		.scopes = NULL,
+		.rewriting = false,
+		.nodes = 0,
+		.specialized = 0};
+	_surveyCode(&specializer, program->code, NULL, NULL, false);
+	for (unsigned int bucket = 0; bucket < SPECIALIZATION_BUCKETS; ++bucket) {
+		for (NameTypes *types = specializer.buckets[bucket]; types != NULL; types = types->next) {
+			types->eligible = _isEligible(types);
+		}
+	}
+	// The calls of the source reach new clones, in the order of the source.
+	// With a profile, the hottest calls get the clones first (the order of
+	// the source breaks the ties), and a call that never ran creates none.
+	const Profile *profile = compilerState->profile;
+	CallSite *calls = NULL;
+	while (specializer.calls != NULL) {
+		CallSite *site = specializer.calls;
+		specializer.calls = site->next;
+		site->next = calls;
+		calls = site;
+	}
+	if (profile != NULL && profile->measured) {
+		CallSite *sorted = NULL;
+		while (calls != NULL) {
+			CallSite *site = calls;
+			calls = site->next;
+			const double count = _countCalls(profile, site->call);
+			CallSite **position = &sorted;
+			while (*position != NULL && count <= _countCalls(profile, (*position)->call)) {
+				position = &(*position)->next;
+			}
+			site->next = *position;
+			*position = site;
+		}
+		calls = sorted;
+	}
+	for (CallSite *site = calls; site != NULL; site = site->next) {
+		NameTypes *callee = _findName(&specializer, site->call->id);
+		if (!callee->eligible) {
+			continue;
+		}
+		Specialization *specialization = _specialize(&specializer, callee, site->call, site->scope, !isColdSite(profile, site->call));
+		if (specialization != NULL) {
+			site->call->id = specialization->clone->id;
+			if (site->owner != callee->function) {
+				++callee->rewritten;
+			}
+		}
+	}
+	// Every clone copies the body of its function, and its calls reach the
+	// clones that already exist.
+	specializer.rewriting = true;
+	for (unsigned int bucket = 0; bucket < SPECIALIZATION_BUCKETS; ++bucket) {
+		for (NameTypes *types = specializer.buckets[bucket]; types != NULL; types = types->next) {
+			if (!types->eligible) {
+				continue;
+			}
+			for (Specialization *specialization = types->specializations; specialization != NULL; specialization = specialization->next) {
+				FunctionDeclaration *clone = specialization->clone;
+				clone->body = allocateNode(sizeof(FunctionBody));
+				clone->body->code = _cloneCode(types->function->body->code);
+				ReturnValue *returnValue = types->function->body->returnValue;
+				if (returnValue != NULL) {
+					clone->body->returnValue = allocateNode(sizeof(ReturnValue));
+					*clone->body->returnValue = *returnValue;
+					if (returnValue->type == EXPRESSION_RT) {
+						clone->body->returnValue->expression = _cloneExpression(returnValue->expression);
+					}
+					else if (returnValue->type == FUNCTIONCALL_RT) {
+						clone->body->returnValue->functionCall = _cloneCall(returnValue->functionCall);
+					}
+				}
+				_surveyFunction(&specializer, clone->arguments, clone->body, clone, false);
+			}
+		}
+	}
+	// The clones are declared next to their function, which they replace
+	// when nothing else reaches it.
+	for (unsigned int bucket = 0; bucket < SPECIALIZATION_BUCKETS; ++bucket) {
+		for (NameTypes *types = specializer.buckets[bucket]; types != NULL; types = types->next) {
+			if (types->specializations == NULL) {
+				continue;
+			}
+			Code *site = types->site;
+			const boolean replaced = types->references == types->rewritten;
+			for (Specialization *specialization = types->specializations; specialization != NULL; specialization = specialization->next) {
+				Statement *statement = allocateNode(sizeof(Statement));
+				statement->statement = FUNCTION_DECLARATION_ST;
+				statement->FunctionDeclaration = specialization->clone;
+				if (replaced && specialization->next == NULL) {
+					site->statement = statement;
+				}
+				else {
+					site->next = createCode(statement, site->next);
+				}
+			}
+			logDebugging(_logger, "The function \"%s\" has %u specializations%s.", types->name, types->specializationCount, replaced ? ", which replace it" : "");
+			specializer.specialized += types->specializationCount;
+		}
+	}
+	for (Scope *scope = specializer.scopes; scope != NULL; scope = scope->next) {
+		releaseNames(&scope->locals);
+	}
+	destroyArena(specializer.arena);
+	PassResult result = {.nodes = specializer.nodes, .changed = 0 < specializer.specialized};
+	return result;
+}
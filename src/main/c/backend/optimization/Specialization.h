@@ -0,0 +1,42 @@
+#ifndef SPECIALIZATION_HEADER
+#define SPECIALIZATION_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Arena.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "PassManager.h"
+#include "Profiling.h"
+#include "TreeRewriting.h"
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeSpecializationModule();
+
+/** Shutdown module's internal state. */
+void shutdownSpecializationModule();
+
+/**
+ * Clones the functions with untyped (or "any") parameters once per
+ * combination of argument types that their calls pass, and makes every call
+ * reach the clone of its combination. A clone declares the types of its
+ * parameters, so its arithmetic is typed like the one of a hand-typed
+ * function (see the types of the SSA form), and the engine that runs the
+ * output sees a single type at each of its operations.
+ *
+ * The type of an argument is only known from its literals, annotations, and
+ * the bindings that are declared once and never reassigned. A function is
+ * specialized if it is declared once, never written, short, declares no
+ * function of its own, and is not inside an async function. It gets at
+ * most a few clones, and the calls inside every clone are specialized too
+ * (a recursive call usually reaches its own clone). The original function
+ * is replaced when no other code can reach it anymore.
+ *
+ * With a profile (see Profiling), the few clones go to the combinations of
+ * the hottest calls, and a call that never ran only reaches a clone that
+ * another call created.
+ */
+PassResult specializeFunctions(CompilerState *compilerState);
+
+#endif
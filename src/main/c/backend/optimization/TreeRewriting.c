@@ -0,0 +1,614 @@
+#include "TreeRewriting.h"
+
+/* MODULE INTERNAL STATE */
+
+static unsigned int _syntheticNames = 0;
+
+// The names of the source program that a synthetic name could clash with.
+static NameSet _programNames = {NULL, 0, 0};
+
+/** PRIVATE FUNCTIONS */
+
+static void _collectFunctionBody(VariableTypeList *parameters, FunctionBody *body, NameSet *names, const boolean includeConstants);
+static void _collectVariable(Declaration *declaration, NameSet *names, const boolean includeConstants);
+static void _reserveArguments(ArgumentList *arguments);
+static void _reserveArray(ArrayContent *arrayContent);
+static void _reserveCode(Code *code);
+static void _reserveExpression(Expression *expression);
+static void _reserveFunction(VariableTypeList *parameters, FunctionBody *body);
+static void _reserveFunctionCall(FunctionCall *functionCall);
+static void _reserveName(const char *name);
+static void _reserveObject(ObjectContent *objectContent);
+static void _reserveVariable(Variable *variable);
+static boolean _statementContainsCalls(Statement *statement);
+
+static void _collectFunctionBody(VariableTypeList *parameters, FunctionBody *body, NameSet *names, const boolean includeConstants) {
+	for (; parameters != NULL; parameters = parameters->next) {
+		addName(names, parameters->variableType->id);
+	}
+	if (body != NULL) {
+		collectWrittenNames(body->code, names, includeConstants);
+		if (body->returnValue != NULL && body->returnValue->type == ASYNC_FUNCTION_RT) {
+			AsyncFunction *asyncFunction = body->returnValue->asyncFunction;
+			addName(names, asyncFunction->id);
+			_collectFunctionBody(asyncFunction->arguments, asyncFunction->body, names, includeConstants);
+		}
+	}
+}
+
+static void _collectVariable(Declaration *declaration, NameSet *names, const boolean includeConstants) {
+	if (declaration != NULL && (includeConstants || declaration->type != CONST_DT)) {
+		addName(names, declaration->variable->variableType->id);
+	}
+}
+
+static void _reserveArguments(ArgumentList *arguments) {
+	for (; arguments != NULL; arguments = arguments->next) {
+		_reserveExpression(arguments->expression);
+	}
+}
+
+static void _reserveArray(ArrayContent *arrayContent) {
+	for (; arrayContent != NULL; arrayContent = arrayContent->next) {
+		_reserveExpression(arrayContent->value);
+	}
+}
+
+static void _reserveCode(Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		switch (statement->statement) {
+			case IF_ST:
+				_reserveExpression(statement->ifStatement->condition);
+				_reserveCode(statement->ifStatement->thenBody);
+				_reserveCode(statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_reserveExpression(statement->whileLoop->condition);
+				_reserveCode(statement->whileLoop->body);
+				break;
+			case FOR_ST: {
+				ParamsFor *params = statement->forLoop->params;
+				if (params->type == FOR_CLASSIC) {
+					if (params->init != NULL) {
+						_reserveVariable(params->init->variable);
+					}
+					_reserveExpression(params->condition);
+					_reserveExpression(params->updateType == INC_DEC_UT ? params->updateIncDec->expression : params->update);
+				}
+				else {
+					_reserveVariable(params->value->variable);
+					IterableVariable *iterable = params->iterable;
+					switch (iterable->type) {
+						case VARIABLE_IT:
+							_reserveName(iterable->variableName);
+							break;
+						case FUNCTIONCALL_IT:
+							_reserveFunctionCall(iterable->functionCall);
+							break;
+						case ARRAY_IT:
+							_reserveArray(iterable->arrayContent);
+							break;
+						case OBJECT_IT:
+							_reserveObject(iterable->objectContent);
+							break;
+					}
+				}
+				_reserveCode(statement->forLoop->body);
+				break;
+			}
+			case DECLARATION_ST:
+				_reserveVariable(statement->declaration->variable);
+				break;
+			case EXPRESSION_ST:
+				_reserveExpression(statement->expression);
+				break;
+			case VARIABLE_ST:
+				_reserveVariable(statement->variable);
+				break;
+			case FUNCTIONCALL_ST:
+				_reserveFunctionCall(statement->functionCall);
+				break;
+			case FUNCTION_DECLARATION_ST:
+				_reserveName(statement->FunctionDeclaration->id);
+				_reserveFunction(statement->FunctionDeclaration->arguments, statement->FunctionDeclaration->body);
+				break;
+			case ASYNC_FUNCTION_ST:
+				_reserveName(statement->asyncFunction->id);
+				_reserveFunction(statement->asyncFunction->arguments, statement->asyncFunction->body);
+				break;
+			case TYPE_DECLARATION_ST:
+				_reserveName(statement->typeDeclaration->id);
+				if (statement->typeDeclaration->type == TYPE_ENUM) {
+					_reserveArguments(statement->typeDeclaration->enumm);
+				}
+				break;
+			case INC_DEC_ST:
+				_reserveExpression(statement->incDec->expression);
+				break;
+			case SWITCH_ST:
+				_reserveName(statement->switchStatement->id);
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_reserveExpression(content->condition);
+					_reserveCode(content->body);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+static void _reserveExpression(Expression *expression) {
+	if (expression == NULL) {
+		return;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			switch (expression->factor->type) {
+				case VARIABLE:
+					_reserveName(expression->factor->variableName);
+					break;
+				case EXPRESSION:
+					_reserveExpression(expression->factor->expression);
+					break;
+				case FUNCTIONCALL:
+					_reserveFunctionCall(expression->factor->functionCall);
+					break;
+				default:
+					break;
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			_reserveExpression(expression->expression);
+			break;
+		default:
+			_reserveExpression(expression->leftExpression);
+			_reserveExpression(expression->rightExpression);
+			break;
+	}
+}
+
+static void _reserveFunction(VariableTypeList *parameters, FunctionBody *body) {
+	for (; parameters != NULL; parameters = parameters->next) {
+		_reserveName(parameters->variableType->id);
+	}
+	if (body == NULL) {
+		return;
+	}
+	_reserveCode(body->code);
+	ReturnValue *returnValue = body->returnValue;
+	if (returnValue != NULL) {
+		switch (returnValue->type) {
+			case EXPRESSION_RT:
+				_reserveExpression(returnValue->expression);
+				break;
+			case FUNCTIONCALL_RT:
+				_reserveFunctionCall(returnValue->functionCall);
+				break;
+			case ARROWFUNCTION_RT:
+				_reserveFunction(returnValue->arrowFunction->arguments, returnValue->arrowFunction->body);
+				break;
+			case ASYNC_FUNCTION_RT:
+				_reserveName(returnValue->asyncFunction->id);
+				_reserveFunction(returnValue->asyncFunction->arguments, returnValue->asyncFunction->body);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+static void _reserveFunctionCall(FunctionCall *functionCall) {
+	_reserveName(functionCall->id);
+	_reserveArguments(functionCall->arguments);
+}
+
+/**
+ * Only a name with a "$" can have the shape of a synthetic one.
+ */
+static void _reserveName(const char *name) {
+	if (name != NULL && strchr(name, '$') != NULL) {
+		addName(&_programNames, name);
+	}
+}
+
+static void _reserveObject(ObjectContent *objectContent) {
+	for (; objectContent != NULL; objectContent = objectContent->next) {
+		_reserveExpression(objectContent->value);
+	}
+}
+
+static void _reserveVariable(Variable *variable) {
+	if (variable == NULL) {
+		return;
+	}
+	_reserveName(variable->variableType->id);
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_reserveExpression(variable->expression);
+			break;
+		case ARRAY_VAR:
+			_reserveArray(variable->arrayContent);
+			break;
+		case OBJECT_VAR:
+			_reserveObject(variable->objectContent);
+			break;
+		case FUNCTIONCALL_VAR:
+			_reserveFunctionCall(variable->functionCall);
+			break;
+		case ARROWFUNCTION_VAR:
+			_reserveFunction(variable->arrowFunction->arguments, variable->arrowFunction->body);
+			break;
+		default:
+			break;
+	}
+}
+
+static boolean _statementContainsCalls(Statement *statement) {
+	switch (statement->statement) {
+		case IF_ST:
+			return expressionContainsCalls(statement->ifStatement->condition)
+				|| containsCalls(statement->ifStatement->thenBody)
+				|| containsCalls(statement->ifStatement->elseBody);
+		case WHILE_ST:
+			return expressionContainsCalls(statement->whileLoop->condition) || containsCalls(statement->whileLoop->body);
+		case FOR_ST: {
+			ParamsFor *params = statement->forLoop->params;
+			if (params->type == FOR_OF && params->iterable->type == FUNCTIONCALL_IT) {
+				return true;
+			}
+			if (params->type == FOR_CLASSIC) {
+				if (params->init != NULL && params->init->variable->type == FUNCTIONCALL_VAR) {
+					return true;
+				}
+				if (expressionContainsCalls(params->condition)) {
+					return true;
+				}
+			}
+			return containsCalls(statement->forLoop->body);
+		}
+		case DECLARATION_ST:
+			return statement->declaration->variable->type == FUNCTIONCALL_VAR
+				|| (statement->declaration->variable->type == EXPRESSION_VAR && expressionContainsCalls(statement->declaration->variable->expression));
+		case VARIABLE_ST:
+			return statement->variable->type == FUNCTIONCALL_VAR
+				|| (statement->variable->type == EXPRESSION_VAR && expressionContainsCalls(statement->variable->expression));
+		case EXPRESSION_ST:
+			return expressionContainsCalls(statement->expression);
+		case FUNCTIONCALL_ST:
+			return true;
+		case SWITCH_ST:
+			for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+				if (expressionContainsCalls(content->condition) || containsCalls(content->body)) {
+					return true;
+				}
+			}
+			return false;
+		default:
+			// A declared function does not run until it is called.
+			return false;
+	}
+}
+
+/** PUBLIC FUNCTIONS */
+
+Expression *createBinaryExpression(const ExpressionType type, Expression *left, Expression *right) {
+	Expression *expression = allocateNode(sizeof(Expression));
+	expression->type = type;
+	expression->leftExpression = left;
+	expression->rightExpression = right;
+	return expression;
+}
+
+Expression *createIntegerExpression(const int value) {
+	Constant *constant = allocateNode(sizeof(Constant));
+	constant->type = NUMBER;
+	constant->numberType = INTEGER_NT;
+	constant->integer = value;
+	Factor *factor = allocateNode(sizeof(Factor));
+	factor->type = CONSTANT;
+	factor->constant = constant;
+	Expression *expression = allocateNode(sizeof(Expression));
+	expression->type = FACTOR;
+	expression->factor = factor;
+	return expression;
+}
+
+Expression *createVariableExpression(const char *name) {
+	Factor *factor = allocateNode(sizeof(Factor));
+	factor->type = VARIABLE;
+	factor->variableName = (char *) name;
+	Expression *expression = allocateNode(sizeof(Expression));
+	expression->type = FACTOR;
+	expression->factor = factor;
+	return expression;
+}
+
+Statement *createAssignmentStatement(const char *name, Expression *value) {
+	VariableType *variableType = allocateNode(sizeof(VariableType));
+	variableType->id = (char *) name;
+	Variable *variable = allocateNode(sizeof(Variable));
+	variable->variableType = variableType;
+	variable->type = EXPRESSION_VAR;
+	variable->expression = value;
+	Statement *statement = allocateNode(sizeof(Statement));
+	statement->statement = VARIABLE_ST;
+	statement->variable = variable;
+	return statement;
+}
+
+Statement *createDeclarationStatement(const DeclarationType type, const char *name, Expression *value) {
+	Statement *assignment = createAssignmentStatement(name, value);
+	Declaration *declaration = allocateNode(sizeof(Declaration));
+	declaration->type = type;
+	declaration->variable = assignment->variable;
+	assignment->statement = DECLARATION_ST;
+	assignment->declaration = declaration;
+	return assignment;
+}
+
+Code *createCode(Statement *statement, Code *next) {
+	Code *code = allocateNode(sizeof(Code));
+	code->statement = statement;
+	code->next = next;
+	return code;
+}
+
+Expression *cloneExpression(const Expression *expression) {
+	if (expression == NULL) {
+		return NULL;
+	}
+	Expression *clone = allocateNode(sizeof(Expression));
+	*clone = *expression;
+	switch (expression->type) {
+		case FACTOR:
+			clone->factor = allocateNode(sizeof(Factor));
+			*clone->factor = *expression->factor;
+			if (expression->factor->type == EXPRESSION) {
+				clone->factor->expression = cloneExpression(expression->factor->expression);
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			clone->expression = cloneExpression(expression->expression);
+			break;
+		default:
+			clone->leftExpression = cloneExpression(expression->leftExpression);
+			clone->rightExpression = cloneExpression(expression->rightExpression);
+			break;
+	}
+	return clone;
+}
+
+char *createSyntheticName(const char *base) {
+	const size_t size = strlen(base) + 16;
+	char *name = allocateNode(size);
+	do {
+		snprintf(name, size, "$%s$%u", base, _syntheticNames++);
+	} while (containsName(&_programNames, name));
+	return name;
+}
+
+void reserveProgramNames(Program *program) {
+	releaseNames(&_programNames);
+	if (program != NULL) {
+		_reserveCode(program->code);
+	}
+}
+
+void releaseProgramNames() {
+	releaseNames(&_programNames);
+}
+
+boolean isVariableExpression(const Expression *expression, const char *name) {
+	return expression != NULL
+		&& expression->type == FACTOR
+		&& expression->factor->type == VARIABLE
+		&& strcmp(expression->factor->variableName, name) == 0;
+}
+
+boolean readsVariable(const Expression *expression, const char *name) {
+	if (expression == NULL) {
+		return false;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			switch (expression->factor->type) {
+				case VARIABLE:
+					return strcmp(expression->factor->variableName, name) == 0;
+				case EXPRESSION:
+					return readsVariable(expression->factor->expression, name);
+				case FUNCTIONCALL:
+					for (ArgumentList *argument = expression->factor->functionCall->arguments; argument != NULL; argument = argument->next) {
+						if (readsVariable(argument->expression, name)) {
+							return true;
+						}
+					}
+					return false;
+				default:
+					return false;
+			}
+		case NOT_OP:
+		case AWAIT_OP:
+			return readsVariable(expression->expression, name);
+		default:
+			return readsVariable(expression->leftExpression, name) || readsVariable(expression->rightExpression, name);
+	}
+}
+
+void collectWrittenNames(Code *code, NameSet *names, const boolean includeConstants) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		switch (statement->statement) {
+			case IF_ST:
+				collectWrittenNames(statement->ifStatement->thenBody, names, includeConstants);
+				collectWrittenNames(statement->ifStatement->elseBody, names, includeConstants);
+				break;
+			case WHILE_ST:
+				collectWrittenNames(statement->whileLoop->body, names, includeConstants);
+				break;
+			case FOR_ST: {
+				ParamsFor *params = statement->forLoop->params;
+				_collectVariable(params->type == FOR_CLASSIC ? params->init : params->value, names, includeConstants);
+				collectWrittenNames(statement->forLoop->body, names, includeConstants);
+				break;
+			}
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					collectWrittenNames(content->body, names, includeConstants);
+				}
+				break;
+			case DECLARATION_ST:
+				_collectVariable(statement->declaration, names, includeConstants);
+				break;
+			case VARIABLE_ST:
+				addName(names, statement->variable->variableType->id);
+				break;
+			case INC_DEC_ST:
+				if (statement->incDec->expression->type == FACTOR && statement->incDec->expression->factor->type == VARIABLE) {
+					addName(names, statement->incDec->expression->factor->variableName);
+				}
+				break;
+			case FUNCTION_DECLARATION_ST:
+				addName(names, statement->FunctionDeclaration->id);
+				_collectFunctionBody(statement->FunctionDeclaration->arguments, statement->FunctionDeclaration->body, names, includeConstants);
+				break;
+			case ASYNC_FUNCTION_ST:
+				addName(names, statement->asyncFunction->id);
+				_collectFunctionBody(statement->asyncFunction->arguments, statement->asyncFunction->body, names, includeConstants);
+				break;
+			case TYPE_DECLARATION_ST:
+				addName(names, statement->typeDeclaration->id);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+boolean containsCalls(Code *code) {
+	for (; code != NULL; code = code->next) {
+		if (_statementContainsCalls(code->statement)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+boolean expressionContainsCalls(const Expression *expression) {
+	if (expression == NULL) {
+		return false;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			if (expression->factor->type == EXPRESSION) {
+				return expressionContainsCalls(expression->factor->expression);
+			}
+			return expression->factor->type == FUNCTIONCALL;
+		case AWAIT_OP:
+			return true;
+		case NOT_OP:
+			return expressionContainsCalls(expression->expression);
+		default:
+			return expressionContainsCalls(expression->leftExpression) || expressionContainsCalls(expression->rightExpression);
+	}
+}
+
+boolean containsFunctions(Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		switch (statement->statement) {
+			case FUNCTION_DECLARATION_ST:
+			case ASYNC_FUNCTION_ST:
+				return true;
+			case IF_ST:
+				if (containsFunctions(statement->ifStatement->thenBody) || containsFunctions(statement->ifStatement->elseBody)) {
+					return true;
+				}
+				break;
+			case WHILE_ST:
+				if (containsFunctions(statement->whileLoop->body)) {
+					return true;
+				}
+				break;
+			case FOR_ST:
+				if (containsFunctions(statement->forLoop->body)) {
+					return true;
+				}
+				break;
+			case SWITCH_ST:
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					if (containsFunctions(content->body)) {
+						return true;
+					}
+				}
+				break;
+			default:
+				break;
+		}
+	}
+	return false;
+}
+
+void addName(NameSet *names, const char *name) {
+	if (containsName(names, name)) {
+		return;
+	}
+	if (names->count == names->capacity) {
+		names->capacity = names->capacity == 0 ? 8 : 2 * names->capacity;
+		names->names = realloc(names->names, names->capacity * sizeof(const char *));
+	}
+	names->names[names->count++] = name;
+}
+
+boolean containsName(const NameSet *names, const char *name) {
+	for (unsigned int k = 0; k < names->count; ++k) {
+		if (strcmp(names->names[k], name) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void releaseNames(NameSet *names) {
+	free(names->names);
+	names->names = NULL;
+	names->count = 0;
+	names->capacity = 0;
+}
+
+void annotateNode(NodeTable *table, const void *node, void *value) {
+	for (unsigned int k = 0; k < table->count; ++k) {
+		if (table->nodes[k] == node) {
+			table->values[k] = value;
+			return;
+		}
+	}
+	if (table->count == table->capacity) {
+		table->capacity = table->capacity == 0 ? 8 : 2 * table->capacity;
+		table->nodes = realloc(table->nodes, table->capacity * sizeof(const void *));
+		table->values = realloc(table->values, table->capacity * sizeof(void *));
+	}
+	table->nodes[table->count] = node;
+	table->values[table->count++] = value;
+}
+
+void *findAnnotation(const NodeTable *table, const void *node) {
+	for (unsigned int k = 0; k < table->count; ++k) {
+		if (table->nodes[k] == node) {
+			return table->values[k];
+		}
+	}
+	return NULL;
+}
+
+void releaseAnnotations(NodeTable *table) {
+	free(table->nodes);
+	free(table->values);
+	table->nodes = NULL;
+	table->values = NULL;
+	table->count = 0;
+	table->capacity = 0;
+}
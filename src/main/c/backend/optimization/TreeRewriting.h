@@ -0,0 +1,106 @@
+#ifndef TREE_REWRITING_HEADER
+#define TREE_REWRITING_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Type.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Helpers shared by the passes that rewrite the AST: constructors of the
+ * nodes they synthesize, and the analyses that every loop transformation
+ * needs. The nodes are allocated like the ones of the parser.
+ */
+
+/**
+ * A growable set of names (compared by content).
+ */
+typedef struct {
+	const char **names;
+	unsigned int count;
+	unsigned int capacity;
+} NameSet;
+
+/**
+ * A growable table from nodes (compared by address) to what a pass learned
+ * about them, so that its findings live beside the AST and not inside it.
+ */
+typedef struct {
+	const void **nodes;
+	void **values;
+	unsigned int count;
+	unsigned int capacity;
+} NodeTable;
+
+Expression *createBinaryExpression(const ExpressionType type, Expression *left, Expression *right);
+Expression *createIntegerExpression(const int value);
+Expression *createVariableExpression(const char *name);
+Statement *createAssignmentStatement(const char *name, Expression *value);
+Statement *createDeclarationStatement(const DeclarationType type, const char *name, Expression *value);
+Code *createCode(Statement *statement, Code *next);
+
+/**
+ * Copies an expression tree. Literals and names are shared, because no pass
+ * modifies them in place.
+ */
+Expression *cloneExpression(const Expression *expression);
+
+/**
+ * Creates a name from a "$", the base and a counter (e.g., "$i$3" from "i"),
+ * skipping the counters whose name the source program already uses (see
+ * reserveProgramNames).
+ */
+char *createSyntheticName(const char *base);
+
+/**
+ * Collects every identifier of the program, once before the passes rewrite
+ * it, so that no synthetic name clashes with them. The names are released
+ * with releaseProgramNames.
+ */
+void reserveProgramNames(Program *program);
+void releaseProgramNames();
+
+/**
+ * True if the expression is the variable with the specified name.
+ */
+boolean isVariableExpression(const Expression *expression, const char *name);
+
+/**
+ * True if the expression reads the variable with the specified name.
+ */
+boolean readsVariable(const Expression *expression, const char *name);
+
+/**
+ * Adds every name that the code may bind or write: assignments, increments,
+ * declarations (constant ones only if requested), loop variables, nested
+ * functions and their parameters, and everything written inside nested
+ * functions (which may run at any call).
+ */
+void collectWrittenNames(Code *code, NameSet *names, const boolean includeConstants);
+
+/**
+ * True if the code (or the expression) calls a function or awaits, which
+ * may write any binding that is not local.
+ */
+boolean containsCalls(Code *code);
+boolean expressionContainsCalls(const Expression *expression);
+
+/**
+ * True if the code declares a function (which could capture its bindings).
+ */
+boolean containsFunctions(Code *code);
+
+void addName(NameSet *names, const char *name);
+boolean containsName(const NameSet *names, const char *name);
+void releaseNames(NameSet *names);
+
+/**
+ * Attaches a value to a node (replacing the one it had, if any), finds it
+ * (NULL if it has none), and releases the table (not the values).
+ */
+void annotateNode(NodeTable *table, const void *node, void *value);
+void *findAnnotation(const NodeTable *table, const void *node);
+void releaseAnnotations(NodeTable *table);
+
+#endif
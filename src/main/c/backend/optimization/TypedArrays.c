@@ -0,0 +1,420 @@
+#include "TypedArrays.h"
+
+/* MODULE INTERNAL STATE */
+
+static Logger *_logger = NULL;
+static NodeTable _storages = {NULL, NULL, 0, 0};
+
+void initializeTypedArraysModule() {
+	_logger = createLogger("TypedArrays");
+}
+
+void shutdownTypedArraysModule() {
+	releaseAnnotations(&_storages);
+	if (_logger != NULL) {
+		destroyLogger(_logger);
+	}
+}
+
+/** PRIVATE FUNCTIONS */
+
+/**
+ * The number of buckets of the table of names.
+ */
+#define TYPED_ARRAYS_BUCKETS 256
+
+/**
+ * The storage of the arrays whose elements are numbers.
+ */
+#define NUMBER_ARRAY_STORAGE "Float64Array"
+
+typedef struct NameUses NameUses;
+typedef struct ArgumentUse ArgumentUse;
+
+/**
+ * How a name is declared and used across the whole program.
+ */
+struct NameUses {
+	const char *name;
+	unsigned int declarations;
+	unsigned int writes;
+	unsigned int reads;				  // other than the ones below
+	unsigned int iterations;		  // as the iterable of a for...of
+	unsigned int arguments;			  // as a whole argument of a call
+	Variable *array;				  // the numeric array literal it declares
+	VariableTypeList *parameters;	  // of the function it declares
+	NameUses *next;
+};
+
+/**
+ * A name passed as a whole argument of a call.
+ */
+struct ArgumentUse {
+	const char *name;
+	const char *callee;
+	unsigned int position;
+	ArgumentUse *next;
+};
+
+/**
+ * The state of a single run of the pass.
+ */
+typedef struct {
+	Arena *arena;
+	NameUses *buckets[TYPED_ARRAYS_BUCKETS];
+	ArgumentUse *arguments;
+	unsigned int nodes;
+	unsigned int specialized;
+} Specialization;
+
+static boolean _onlyIterated(Specialization *specialization, const NameUses *uses);
+static void _surveyCall(Specialization *specialization, FunctionCall *functionCall);
+static void _surveyCode(Specialization *specialization, Code *code);
+static void _surveyExpression(Specialization *specialization, const Expression *expression);
+static void _surveyFunctionBody(Specialization *specialization, VariableTypeList *parameters, FunctionBody *body);
+static void _surveyVariable(Specialization *specialization, Variable *variable);
+static NameUses *_findName(Specialization *specialization, const char *name);
+static unsigned int _hashName(const char *name);
+static boolean _isNumeric(const Expression *expression);
+static boolean _isNumericArray(const Variable *variable);
+
+/**
+ * True if every use of the name is an iteration, either directly or through
+ * a parameter that is only iterated.
+ */
+static boolean _onlyIterated(Specialization *specialization, const NameUses *uses) {
+	if (uses->declarations != 1 || uses->writes != 0 || uses->reads != 0) {
+		return false;
+	}
+	for (ArgumentUse *argument = specialization->arguments; argument != NULL; argument = argument->next) {
+		if (strcmp(argument->name, uses->name) != 0) {
+			continue;
+		}
+		const NameUses *callee = _findName(specialization, argument->callee);
+		if (callee->declarations != 1 || callee->parameters == NULL) {
+			return false;
+		}
+		VariableTypeList *parameter = callee->parameters;
+		for (unsigned int k = 0; parameter != NULL && k < argument->position; ++k) {
+			parameter = parameter->next;
+		}
+		if (parameter == NULL) {
+			return false;
+		}
+		const NameUses *parameterUses = _findName(specialization, parameter->variableType->id);
+		if (parameterUses->declarations != 1 || parameterUses->writes != 0 || parameterUses->reads != 0 || parameterUses->arguments != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void _surveyCall(Specialization *specialization, FunctionCall *functionCall) {
+	++_findName(specialization, functionCall->id)->reads;
+	unsigned int position = 0;
+	for (ArgumentList *argument = functionCall->arguments; argument != NULL; argument = argument->next, ++position) {
+		const Expression *expression = argument->expression;
+		if (expression->type == FACTOR && expression->factor->type == VARIABLE) {
+			ArgumentUse *use = allocateInArena(specialization->arena, sizeof(ArgumentUse));
+			use->name = expression->factor->variableName;
+			use->callee = functionCall->id;
+			use->position = position;
+			use->next = specialization->arguments;
+			specialization->arguments = use;
+			++_findName(specialization, use->name)->arguments;
+		}
+		else {
+			_surveyExpression(specialization, expression);
+		}
+	}
+}
+
+static void _surveyCode(Specialization *specialization, Code *code) {
+	for (; code != NULL; code = code->next) {
+		Statement *statement = code->statement;
+		++specialization->nodes;
+		switch (statement->statement) {
+			case IF_ST:
+				_surveyExpression(specialization, statement->ifStatement->condition);
+				_surveyCode(specialization, statement->ifStatement->thenBody);
+				_surveyCode(specialization, statement->ifStatement->elseBody);
+				break;
+			case WHILE_ST:
+				_surveyExpression(specialization, statement->whileLoop->condition);
+				_surveyCode(specialization, statement->whileLoop->body);
+				break;
+			case FOR_ST: {
+				ParamsFor *params = statement->forLoop->params;
+				if (params->type == FOR_CLASSIC) {
+					if (params->init != NULL) {
+						++_findName(specialization, params->init->variable->variableType->id)->declarations;
+						_surveyVariable(specialization, params->init->variable);
+					}
+					_surveyExpression(specialization, params->condition);
+					if (params->updateType == INC_DEC_UT) {
+						_surveyExpression(specialization, params->updateIncDec->expression);
+					}
+					else {
+						_surveyExpression(specialization, params->update);
+					}
+				}
+				else {
+					++_findName(specialization, params->value->variable->variableType->id)->declarations;
+					IterableVariable *iterable = params->iterable;
+					switch (iterable->type) {
+						case VARIABLE_IT:
+							++_findName(specialization, iterable->variableName)->iterations;
+							break;
+						case FUNCTIONCALL_IT:
+							_surveyCall(specialization, iterable->functionCall);
+							break;
+						case ARRAY_IT:
+							for (ArrayContent *element = iterable->arrayContent; element != NULL; element = element->next) {
+								_surveyExpression(specialization, element->value);
+							}
+							break;
+						case OBJECT_IT:
+							for (ObjectContent *property = iterable->objectContent; property != NULL; property = property->next) {
+								_surveyExpression(specialization, property->value);
+							}
+							break;
+					}
+				}
+				_surveyCode(specialization, statement->forLoop->body);
+				break;
+			}
+			case DECLARATION_ST: {
+				Variable *variable = statement->declaration->variable;
+				NameUses *uses = _findName(specialization, variable->variableType->id);
+				++uses->declarations;
+				if (_isNumericArray(variable)) {
+					uses->array = variable;
+				}
+				_surveyVariable(specialization, variable);
+				break;
+			}
+			case VARIABLE_ST:
+				++_findName(specialization, statement->variable->variableType->id)->writes;
+				_surveyVariable(specialization, statement->variable);
+				break;
+			case EXPRESSION_ST:
+				_surveyExpression(specialization, statement->expression);
+				break;
+			case FUNCTIONCALL_ST:
+				_surveyCall(specialization, statement->functionCall);
+				break;
+			case INC_DEC_ST: {
+				const Expression *expression = statement->incDec->expression;
+				if (expression->type == FACTOR && expression->factor->type == VARIABLE) {
+					++_findName(specialization, expression->factor->variableName)->writes;
+				}
+				_surveyExpression(specialization, expression);
+				break;
+			}
+			case FUNCTION_DECLARATION_ST: {
+				FunctionDeclaration *function = statement->FunctionDeclaration;
+				NameUses *uses = _findName(specialization, function->id);
+				++uses->declarations;
+				uses->parameters = function->arguments;
+				_surveyFunctionBody(specialization, function->arguments, function->body);
+				break;
+			}
+			case ASYNC_FUNCTION_ST: {
+				AsyncFunction *asyncFunction = statement->asyncFunction;
+				NameUses *uses = _findName(specialization, asyncFunction->id);
+				++uses->declarations;
+				uses->parameters = asyncFunction->arguments;
+				_surveyFunctionBody(specialization, asyncFunction->arguments, asyncFunction->body);
+				break;
+			}
+			case TYPE_DECLARATION_ST:
+				++_findName(specialization, statement->typeDeclaration->id)->declarations;
+				break;
+			case SWITCH_ST:
+				if (statement->switchStatement->id != NULL) {
+					++_findName(specialization, statement->switchStatement->id)->reads;
+				}
+				for (SwitchContent *content = statement->switchStatement->content; content != NULL; content = content->next) {
+					_surveyExpression(specialization, content->condition);
+					_surveyCode(specialization, content->body);
+				}
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+static void _surveyExpression(Specialization *specialization, const Expression *expression) {
+	if (expression == NULL) {
+		return;
+	}
+	switch (expression->type) {
+		case FACTOR:
+			switch (expression->factor->type) {
+				case VARIABLE:
+					++_findName(specialization, expression->factor->variableName)->reads;
+					break;
+				case EXPRESSION:
+					_surveyExpression(specialization, expression->factor->expression);
+					break;
+				case FUNCTIONCALL:
+					_surveyCall(specialization, expression->factor->functionCall);
+					break;
+				default:
+					break;
+			}
+			break;
+		case NOT_OP:
+		case AWAIT_OP:
+			_surveyExpression(specialization, expression->expression);
+			break;
+		default:
+			_surveyExpression(specialization, expression->leftExpression);
+			_surveyExpression(specialization, expression->rightExpression);
+			break;
+	}
+}
+
+static void _surveyFunctionBody(Specialization *specialization, VariableTypeList *parameters, FunctionBody *body) {
+	for (; parameters != NULL; parameters = parameters->next) {
+		++_findName(specialization, parameters->variableType->id)->declarations;
+	}
+	if (body == NULL) {
+		return;
+	}
+	_surveyCode(specialization, body->code);
+	ReturnValue *returnValue = body->returnValue;
+	if (returnValue == NULL) {
+		return;
+	}
+	switch (returnValue->type) {
+		case EXPRESSION_RT:
+			_surveyExpression(specialization, returnValue->expression);
+			break;
+		case FUNCTIONCALL_RT:
+			_surveyCall(specialization, returnValue->functionCall);
+			break;
+		case ASYNC_FUNCTION_RT: {
+			NameUses *uses = _findName(specialization, returnValue->asyncFunction->id);
+			++uses->declarations;
+			// The returned function escapes, so it may receive anything.
+			++uses->reads;
+			_surveyFunctionBody(specialization, returnValue->asyncFunction->arguments, returnValue->asyncFunction->body);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+static void _surveyVariable(Specialization *specialization, Variable *variable) {
+	switch (variable->type) {
+		case EXPRESSION_VAR:
+			_surveyExpression(specialization, variable->expression);
+			break;
+		case ARRAY_VAR:
+			for (ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+				_surveyExpression(specialization, element->value);
+			}
+			break;
+		case OBJECT_VAR:
+			for (ObjectContent *property = variable->objectContent; property != NULL; property = property->next) {
+				_surveyExpression(specialization, property->value);
+			}
+			break;
+		case FUNCTIONCALL_VAR:
+			_surveyCall(specialization, variable->functionCall);
+			break;
+		default:
+			break;
+	}
+}
+
+static NameUses *_findName(Specialization *specialization, const char *name) {
+	const unsigned int bucket = _hashName(name);
+	for (NameUses *uses = specialization->buckets[bucket]; uses != NULL; uses = uses->next) {
+		if (strcmp(uses->name, name) == 0) {
+			return uses;
+		}
+	}
+	NameUses *uses = allocateInArena(specialization->arena, sizeof(NameUses));
+	uses->name = name;
+	uses->next = specialization->buckets[bucket];
+	specialization->buckets[bucket] = uses;
+	return uses;
+}
+
+static unsigned int _hashName(const char *name) {
+	unsigned int hash = 2166136261u;
+	for (; *name != '\0'; ++name) {
+		hash = (hash ^ (unsigned char) *name) * 16777619u;
+	}
+	return hash % TYPED_ARRAYS_BUCKETS;
+}
+
+/**
+ * True if the expression is an arithmetic operation of number literals.
+ */
+static boolean _isNumeric(const Expression *expression) {
+	switch (expression->type) {
+		case FACTOR:
+			if (expression->factor->type == EXPRESSION) {
+				return _isNumeric(expression->factor->expression);
+			}
+			return expression->factor->type == CONSTANT && expression->factor->constant->type == NUMBER;
+		case ADD_OP:
+		case SUB_OP:
+		case MUL_OP:
+		case DIV_OP:
+			return _isNumeric(expression->leftExpression) && _isNumeric(expression->rightExpression);
+		default:
+			return false;
+	}
+}
+
+/**
+ * True if the variable holds an array literal of numbers, as its elements
+ * tell. The annotation is not trusted, because the checker does not verify
+ * the elements against it (e.g., "let a: number[] = [1, s]").
+ */
+static boolean _isNumericArray(const Variable *variable) {
+	if (variable->type != ARRAY_VAR || variable->arrayContent == NULL) {
+		return false;
+	}
+	for (const ArrayContent *element = variable->arrayContent; element != NULL; element = element->next) {
+		if (!_isNumeric(element->value)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/** PUBLIC FUNCTIONS */
+
+PassResult specializeTypedArrays(CompilerState *compilerState) {
+	Program *program = compilerState->abstractSyntaxtTree;
+	Specialization specialization = {
+		.arena = createArena(4096),
+		.buckets = {NULL},
+		.arguments = NULL,
+		.nodes = 0,
+		.specialized = 0};
+	_surveyCode(&specialization, program->code);
+	for (unsigned int bucket = 0; bucket < TYPED_ARRAYS_BUCKETS; ++bucket) {
+		for (NameUses *uses = specialization.buckets[bucket]; uses != NULL; uses = uses->next) {
+			if (uses->array != NULL && findArrayStorage(uses->array) == NULL && _onlyIterated(&specialization, uses)) {
+				annotateNode(&_storages, uses->array, NUMBER_ARRAY_STORAGE);
+				logDebugging(_logger, "The array \"%s\" is stored in a %s.", uses->name, NUMBER_ARRAY_STORAGE);
+				++specialization.specialized;
+			}
+		}
+	}
+	destroyArena(specialization.arena);
+	PassResult result = {.nodes = specialization.nodes, .changed = 0 < specialization.specialized};
+	return result;
+}
+
+const char *findArrayStorage(const Variable *variable) {
+	return findAnnotation(&_storages, variable);
+}
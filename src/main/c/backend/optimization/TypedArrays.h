@@ -0,0 +1,39 @@
+#ifndef TYPED_ARRAYS_HEADER
+#define TYPED_ARRAYS_HEADER
+
+#include "../../frontend/syntactic-analysis/AbstractSyntaxTree.h"
+#include "../../shared/Arena.h"
+#include "../../shared/CompilerState.h"
+#include "../../shared/Logger.h"
+#include "../../shared/Type.h"
+#include "PassManager.h"
+#include "TreeRewriting.h"
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeTypedArraysModule();
+
+/** Shutdown module's internal state. */
+void shutdownTypedArraysModule();
+
+/**
+ * Stores the numeric array literals in a flat buffer of doubles (a
+ * Float64Array) instead of a generic array of boxed values (see
+ * findArrayStorage).
+ *
+ * A typed array reads back the same numbers, but it is not an Array (it
+ * prints differently, and it has no push). So only the bindings that
+ * nothing can observe are converted: declared once, never written, with
+ * elements that are number literals (or arithmetic of them), and only ever
+ * iterated by for...of, either directly or through a parameter that is
+ * itself only iterated.
+ */
+PassResult specializeTypedArrays(CompilerState *compilerState);
+
+/**
+ * The typed array that holds an array literal, or NULL if it is a generic
+ * array.
+ */
+const char *findArrayStorage(const Variable *variable);
+
+#endif
@@ -102,13 +102,19 @@ Token AssignmentOperatorLexemeAction(LexicalAnalyzerContext *lexicalAnalyzerCont
 
 Token IntegerLexemeAction(LexicalAnalyzerContext *lexicalAnalyzerContext) {
 	_logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
-	lexicalAnalyzerContext->semanticValue->value_int = atoi(lexicalAnalyzerContext->lexeme);
+	// An integer beyond the range of an int is kept as a number (as in JavaScript).
+	const double value = strtod(lexicalAnalyzerContext->lexeme, NULL);
+	if (value < INT_MIN || INT_MAX < value) {
+		lexicalAnalyzerContext->semanticValue->value_double = value;
+		return FLOAT_VALUE;
+	}
+	lexicalAnalyzerContext->semanticValue->value_int = (int) value;
 	return INT_VALUE;
 }
 
 Token NumberLexemeAction(LexicalAnalyzerContext *lexicalAnalyzerContext) {
 	_logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
-	lexicalAnalyzerContext->semanticValue->value_float = atof(lexicalAnalyzerContext->lexeme);
+	lexicalAnalyzerContext->semanticValue->value_double = strtod(lexicalAnalyzerContext->lexeme, NULL);
 	return FLOAT_VALUE;
 }
 
@@ -120,13 +126,13 @@ Token BooleanLexemeAction(LexicalAnalyzerContext *lexicalAnalyzerContext) {
 	else if (strcmp(lexicalAnalyzerContext->lexeme, "false") == 0) {
 		lexicalAnalyzerContext->semanticValue->value_bool = 0; // Boolean false
 	}
-	return STRING_VALUE;
+	return BOOL_VALUE;
 }
 
 Token StringLexemeAction(LexicalAnalyzerContext *lexicalAnalyzerContext) {
 	_logLexicalAnalyzerContext(__FUNCTION__, lexicalAnalyzerContext);
 	lexicalAnalyzerContext->semanticValue->value_str = lexicalAnalyzerContext->lexeme;
-	return BOOL_VALUE;
+	return STRING_VALUE;
 }
 
 // Token IntegerLexemeAction(LexicalAnalyzerContext *lexicalAnalyzerContext) {
@@ -8,6 +8,7 @@
 #include "../syntactic-analysis/AbstractSyntaxTree.h"
 #include "../syntactic-analysis/BisonParser.h"
 #include "LexicalAnalyzerContext.h"
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -1,6 +1,7 @@
 #ifndef ABSTRACT_SYNTAX_TREE_HEADER
 #define ABSTRACT_SYNTAX_TREE_HEADER
 
+#include "../../shared/Arena.h"
 #include "../../shared/Logger.h"
 #include <stdlib.h>
 
@@ -27,6 +28,8 @@ typedef enum Assign Assign;
 typedef enum UserType UserType;
 typedef enum ReturnType ReturnType;
 typedef enum FunctionCallType FunctionCallType;
+typedef enum UpdateType UpdateType;
+typedef enum NumberType NumberType;
 
 typedef struct Type Type;
 typedef struct TypeDeclaration TypeDeclaration;
@@ -197,6 +200,16 @@ enum FunctionCallType {
 	AWAIT_CALL
 };
 
+enum UpdateType {
+	EXPRESSION_UT,
+	INC_DEC_UT
+};
+
+enum NumberType {
+	INTEGER_NT,
+	FLOATING_NT
+};
+
 struct Type {
 	DataType singleType;
 	Type *next;
@@ -205,11 +218,12 @@ struct Type {
 struct Constant {
 	union {
 		int integer;
-		float floating;
+		double floating;
 		char *string;
 		char boolean;
 	};
 	DataType type;
+	NumberType numberType; // only meaningful when type is NUMBER
 };
 
 struct VariableType {
@@ -339,6 +353,7 @@ struct ParamsFor {
 				Expression *update; 
 				IncDec *updateIncDec;
 			};   
+			UpdateType updateType;
 		};
 		struct {				  // for...of
 			Declaration *value;	  
@@ -428,34 +443,26 @@ struct Program {
 };
 
 /**
- * Node recursive destructors.
+ * Allocates a (zero-initialized) node of the tree. The nodes are bumped out
+ * of a single arena, because the passes share and rewrite subtrees freely,
+ * so no node has a single owner that could release it on its own.
  */
-// void releaseExpression(Expression *expression);
-// void releaseFactor(Factor *factor);
-// void releaseConstant(Constant *constant);
-
-// void releaseVariable(Variable *variable);
-// void releaseVariableType(VariableType *variableType);
-// void releaseVariableName(char *variableName);
-// void releaseVariableTypeList(VariableTypeList *variableTypeList);
-// void releaseArgumentList(ArgumentList *argumentList);
-
-// void releaseEnum(Enum *enumm);
-// void releaseInterface(Interface *interface);
-
-// void releaseDeclaration(Declaration *declaration);
+void *allocateNode(const size_t size);
 
-// void releaseIf(IfStatement *ifStatement);
-// void releaseForParams(ParamsFor *params);
-// void releaseFor(ForLoop *forLoop);
-// void releaseWhile(WhileLoop *whileLoop);
+/**
+ * Copies a string (a name, a key or a lexeme) into the tree.
+ */
+char *copyNodeString(const char *string);
 
-// void releaseFunctionCall(FunctionCall *functionCall);
-// void releaseFunctionDeclaration(FunctionDeclaration *functionDeclaration);
-// void releaseArrowFunction(ArrowFunction *arrowFunction);
-// void releaseAysncFunction(AsyncFunction *asyncFunction);
+/**
+ * The bytes held by the nodes of the tree so far.
+ */
+size_t nodeBytes();
 
-// void releaseCode(Code *code);
-// void releaseProgram(Program *program);
+/**
+ * Releases the program, and every node allocated since the module started
+ * (at once, without walking the tree).
+ */
+void releaseProgram(Program *program);
 
 #endif
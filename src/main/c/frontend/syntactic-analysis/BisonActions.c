@@ -33,32 +33,33 @@ static void _logSyntacticAnalyzerAction(const char *functionName) {
 // Constants -------------------------------------------------------------------------------------------------------------------------
 Constant *IntConstantSemanticAction(int value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Constant *constant = malloc(sizeof(Constant));
+	Constant *constant = allocateNode(sizeof(Constant));
 	constant->integer = value;
 	constant->type = NUMBER;
+	constant->numberType = INTEGER_NT;
 	return constant;
 }
 
-Constant *FloatConstantSemanticAction(float value) {
+Constant *FloatConstantSemanticAction(double value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Constant *constant = malloc(sizeof(Constant));
+	Constant *constant = allocateNode(sizeof(Constant));
 	constant->floating = value;
 	constant->type = NUMBER;
+	constant->numberType = FLOATING_NT;
 	return constant;
 }
 
 Constant *StringConstantSemanticAction(char *value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Constant *constant = malloc(sizeof(Constant));
-	constant->string = malloc(strlen(value) + 1);
-	strcpy(constant->string, value);
+	Constant *constant = allocateNode(sizeof(Constant));
+	constant->string = internString(value);
 	constant->type = STRING;
 	return constant;
 }
 
 Constant *BooleanConstantSemanticAction(char value) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Constant *constant = malloc(sizeof(Constant));
+	Constant *constant = allocateNode(sizeof(Constant));
 	constant->boolean = value;
 	constant->type = BOOLEAN;
 	return constant;
@@ -66,7 +67,7 @@ Constant *BooleanConstantSemanticAction(char value) {
 // Expression -------------------------------------------------------------------------------------------------------------------
 Expression *ExpressionSemanticAction(Expression *leftExpression, Expression *rightExpression, ExpressionType type) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Expression *expression = malloc(sizeof(Expression));
+	Expression *expression = allocateNode(sizeof(Expression));
 	expression->type = type;
 	switch (type) {
 		case NOT_OP:
@@ -82,15 +83,16 @@ Expression *ExpressionSemanticAction(Expression *leftExpression, Expression *rig
 
 IncDec *IncDecSemanticAction(Expression *expression, IncDecType type, IncDecPosition position) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	IncDec *incDecExpression = malloc(sizeof(IncDec));
+	IncDec *incDecExpression = allocateNode(sizeof(IncDec));
 	incDecExpression->expression = expression;
 	incDecExpression->type = type;
+	incDecExpression->position = position;
 	return incDecExpression;
 }
 
 Expression *FactorExpressionSemanticAction(Factor *factor) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Expression *expression = malloc(sizeof(Expression));
+	Expression *expression = allocateNode(sizeof(Expression));
 	expression->factor = factor;
 	expression->type = FACTOR;
 	return expression;
@@ -99,28 +101,28 @@ Expression *FactorExpressionSemanticAction(Factor *factor) {
 // Factor ---------------------------------------------------------------------------------------------------------------------
 Factor *ConstantFactorSemanticAction(Constant *constant) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Factor *factor = malloc(sizeof(Factor));
+	Factor *factor = allocateNode(sizeof(Factor));
 	factor->constant = constant;
 	factor->type = CONSTANT;
 	return factor;
 }
 Factor *VariableFactorSemanticAction(char *variableName) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Factor *factor = malloc(sizeof(Factor));
+	Factor *factor = allocateNode(sizeof(Factor));
 	factor->variableName = variableName;
 	factor->type = VARIABLE;
 	return factor;
 }
 Factor *ExpressionFactorSemanticAction(Expression *expression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Factor *factor = malloc(sizeof(Factor));
+	Factor *factor = allocateNode(sizeof(Factor));
 	factor->expression = expression;
 	factor->type = EXPRESSION;
 	return factor;
 }
 Factor *FunctionCallFactorSemanticAction(FunctionCall *functionCall) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Factor *factor = malloc(sizeof(Factor));
+	Factor *factor = allocateNode(sizeof(Factor));
 	factor->functionCall = functionCall;
 	factor->type = FUNCTIONCALL;
 	return factor;
@@ -128,7 +130,7 @@ Factor *FunctionCallFactorSemanticAction(FunctionCall *functionCall) {
 // Type -------------------------------------------------------------------------------------------------------------------------
 Type *SingleTypeSemanticAction(char *singleType, Type *next) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Type *type = malloc(sizeof(Type));
+	Type *type = allocateNode(sizeof(Type));
 	type->singleType = getDataType(singleType);
 	type->next = next;
 	return type;
@@ -136,8 +138,12 @@ Type *SingleTypeSemanticAction(char *singleType, Type *next) {
 
 Type *ArrayTypeSemanticAction(char *id) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Type *type = malloc(sizeof(Type));
-	type->singleType = getDataType(id);
+	Type *type = allocateNode(sizeof(Type));
+	char *name = calloc(strlen(id) + 3, sizeof(char));
+	strcpy(name, id);
+	strcat(name, "[]");
+	type->singleType = getDataType(name);
+	free(name);
 	type->next = NULL;
 	return type;
 }
@@ -197,16 +203,15 @@ DataType getDataType(char *name) {
 // Variable -------------------------------------------------------------------------------------------------------------------------
 VariableType *VariableTypeSemanticAction(char *id, Type *type) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	VariableType *variableType = malloc(sizeof(VariableType));
-	variableType->id = malloc(strlen(id) + 1);
-	strcpy(variableType->id, id);
+	VariableType *variableType = allocateNode(sizeof(VariableType));
+	variableType->id = copyNodeString(id);
 	variableType->type = type;
 	return variableType;
 }
 
 VariableTypeList *VariableTypeListSemanticAction(VariableType *variableType, VariableTypeList *next) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	VariableTypeList *variableTypeList = malloc(sizeof(VariableTypeList));
+	VariableTypeList *variableTypeList = allocateNode(sizeof(VariableTypeList));
 	variableTypeList->variableType = variableType;
 	variableTypeList->next = next;
 	return variableTypeList;
@@ -214,7 +219,7 @@ VariableTypeList *VariableTypeListSemanticAction(VariableType *variableType, Var
 
 Variable *VariableSemanticAction(VariableType *variableType) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Variable *assignVariable = malloc(sizeof(Variable));
+	Variable *assignVariable = allocateNode(sizeof(Variable));
 	assignVariable->variableType = variableType;
 	assignVariable->expression = NULL;
 	assignVariable->type = UNINITIALIZED;
@@ -223,7 +228,7 @@ Variable *VariableSemanticAction(VariableType *variableType) {
 
 Variable *VariableExpressionSemanticAction(VariableType *variableType, Expression *expression){
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Variable *assignVariable = malloc(sizeof(Variable));
+	Variable *assignVariable = allocateNode(sizeof(Variable));
 	assignVariable->variableType = variableType;
 	assignVariable->expression = expression;
 	assignVariable->type = EXPRESSION_VAR;
@@ -232,7 +237,7 @@ Variable *VariableExpressionSemanticAction(VariableType *variableType, Expressio
 
 Variable *VariableArraySemanticAction(VariableType *variableType, ArrayContent *arrayContent) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Variable *assignVariable = malloc(sizeof(Variable));
+	Variable *assignVariable = allocateNode(sizeof(Variable));
 	assignVariable->variableType = variableType;
 	assignVariable->arrayContent = arrayContent;
 	assignVariable->type = ARRAY_VAR;
@@ -241,7 +246,7 @@ Variable *VariableArraySemanticAction(VariableType *variableType, ArrayContent *
 
 Variable *VariableObjectSemanticAction(VariableType *variableType, ObjectContent *objectContent) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Variable *assignVariable = malloc(sizeof(Variable));
+	Variable *assignVariable = allocateNode(sizeof(Variable));
 	assignVariable->variableType = variableType;
 	assignVariable->objectContent = objectContent;
 	assignVariable->type = OBJECT_VAR;
@@ -250,7 +255,7 @@ Variable *VariableObjectSemanticAction(VariableType *variableType, ObjectContent
 
 Variable *VariableFunctionCallSemanticAction(VariableType *variableType, FunctionCall *functionCall) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Variable *assignVariable = malloc(sizeof(Variable));
+	Variable *assignVariable = allocateNode(sizeof(Variable));
 	assignVariable->variableType = variableType;
 	assignVariable->functionCall = functionCall;
 	assignVariable->type = FUNCTIONCALL_VAR;
@@ -259,7 +264,7 @@ Variable *VariableFunctionCallSemanticAction(VariableType *variableType, Functio
 
 Variable *VariableArrowFunctionSemanticAction(VariableType *variableType, ArrowFunction *arrowFunction) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Variable *assignVariable = malloc(sizeof(Variable));
+	Variable *assignVariable = allocateNode(sizeof(Variable));
 	assignVariable->variableType = variableType;
 	assignVariable->arrowFunction = arrowFunction;
 	assignVariable->type = ARROWFUNCTION_VAR;
@@ -269,7 +274,7 @@ Variable *VariableArrowFunctionSemanticAction(VariableType *variableType, ArrowF
 // PromiseReturnType -------------------------------------------------------------------------------------------------------------------------
 PromiseReturnType *PromiseReturnTypeSemanticAction(Type *returnType) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	PromiseReturnType *promiseReturn = malloc(sizeof(PromiseReturnType));
+	PromiseReturnType *promiseReturn = allocateNode(sizeof(PromiseReturnType));
 	promiseReturn->type = returnType;
 	return promiseReturn;
 }
@@ -277,9 +282,8 @@ PromiseReturnType *PromiseReturnTypeSemanticAction(Type *returnType) {
 // Content -------------------------------------------------------------------------------------------------------------------------
 ObjectContent *ObjectContentSemanticAction(char *key, Expression *expression, ObjectContent *next) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	ObjectContent *objectContent = malloc(sizeof(ObjectContent));
-	objectContent->key = malloc(strlen(key) + 1);
-	strcpy(objectContent->key, key);
+	ObjectContent *objectContent = allocateNode(sizeof(ObjectContent));
+	objectContent->key = copyNodeString(key);
 	objectContent->value = expression;
 	objectContent->next = next;
 	return objectContent;
@@ -287,7 +291,7 @@ ObjectContent *ObjectContentSemanticAction(char *key, Expression *expression, Ob
 
 ArrayContent *ArrayContentSemanticAction(Expression *expression, ArrayContent *next) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	ArrayContent *arrayContent = malloc(sizeof(ArrayContent));
+	ArrayContent *arrayContent = allocateNode(sizeof(ArrayContent));
 	arrayContent->value = expression;
 	arrayContent->next = next;
 	return arrayContent;
@@ -295,7 +299,7 @@ ArrayContent *ArrayContentSemanticAction(Expression *expression, ArrayContent *n
 // IterableVariable -------------------------------------------------------------------------------------------------------------------------
 IterableVariable *IterableVariableNameSemanticAction(char *variableName) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	IterableVariable *iterableVariable = malloc(sizeof(IterableVariable));
+	IterableVariable *iterableVariable = allocateNode(sizeof(IterableVariable));
 	iterableVariable->variableName = variableName;
 	iterableVariable->type = VARIABLE_IT;
 	return iterableVariable;
@@ -303,7 +307,7 @@ IterableVariable *IterableVariableNameSemanticAction(char *variableName) {
 
 IterableVariable *IterableVariableFunctionCallSemanticAction(FunctionCall *functionCall) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	IterableVariable *iterableVariable = malloc(sizeof(IterableVariable));
+	IterableVariable *iterableVariable = allocateNode(sizeof(IterableVariable));
 	iterableVariable->functionCall = functionCall;
 	iterableVariable->type = FUNCTIONCALL_IT;
 	return iterableVariable;
@@ -311,7 +315,7 @@ IterableVariable *IterableVariableFunctionCallSemanticAction(FunctionCall *funct
 
 IterableVariable *IterableVariableArraySemanticAction(ArrayContent *arrayContent) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	IterableVariable *iterableVariable = malloc(sizeof(IterableVariable));
+	IterableVariable *iterableVariable = allocateNode(sizeof(IterableVariable));
 	iterableVariable->arrayContent = arrayContent;
 	iterableVariable->type = ARRAY_IT;
 	return iterableVariable;
@@ -319,7 +323,7 @@ IterableVariable *IterableVariableArraySemanticAction(ArrayContent *arrayContent
 
 IterableVariable *IterableVariableObjectContentSemanticAction(ObjectContent *objectContent) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	IterableVariable *iterableVariable = malloc(sizeof(IterableVariable));
+	IterableVariable *iterableVariable = allocateNode(sizeof(IterableVariable));
 	iterableVariable->objectContent = objectContent;
 	iterableVariable->type = OBJECT_IT;
 	return iterableVariable;
@@ -329,8 +333,8 @@ IterableVariable *IterableVariableObjectContentSemanticAction(ObjectContent *obj
 // Declaration -------------------------------------------------------------------------------------------------------------------------
 Declaration *DeclarationSemanticAction(DeclarationType type, VariableType *variableType) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Declaration *declaration = malloc(sizeof(Declaration));
-	declaration->variable = malloc(sizeof(Variable));
+	Declaration *declaration = allocateNode(sizeof(Declaration));
+	declaration->variable = allocateNode(sizeof(Variable));
 	declaration->variable->variableType = variableType;
 	declaration->variable->type = UNINITIALIZED;
 	declaration->type = type;
@@ -339,8 +343,8 @@ Declaration *DeclarationSemanticAction(DeclarationType type, VariableType *varia
 
 Declaration *DeclarationVariableSemanticAction(DeclarationType type, Variable *variable) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Declaration *declaration = malloc(sizeof(Declaration));
-	declaration->variable = malloc(sizeof(Variable));
+	Declaration *declaration = allocateNode(sizeof(Declaration));
+	declaration->variable = allocateNode(sizeof(Variable));
 	declaration->variable = variable;
 	declaration->type = type;
 	return declaration;
@@ -349,9 +353,8 @@ Declaration *DeclarationVariableSemanticAction(DeclarationType type, Variable *v
 // TypeDeclaration -------------------------------------------------------------------------------------------------------------------------
 TypeDeclaration *ObjectTypeDeclarationSemanticAction(char *id, ObjectContent *objectContent) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	TypeDeclaration *typeDeclaration = malloc(sizeof(TypeDeclaration));
-	typeDeclaration->id = malloc(strlen(id) + 1);
-	strcpy(typeDeclaration->id, id);
+	TypeDeclaration *typeDeclaration = allocateNode(sizeof(TypeDeclaration));
+	typeDeclaration->id = copyNodeString(id);
 	typeDeclaration->objectContent = objectContent;
 	typeDeclaration->type = TYPE_OBJECT;
 	return typeDeclaration;
@@ -359,8 +362,8 @@ TypeDeclaration *ObjectTypeDeclarationSemanticAction(char *id, ObjectContent *ob
 
 TypeDeclaration *VariableTypeDeclarationSemanticAction(char *id, Expression *expression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	TypeDeclaration *typeDeclaration = malloc(sizeof(TypeDeclaration));
-	strcpy(typeDeclaration->id, id);
+	TypeDeclaration *typeDeclaration = allocateNode(sizeof(TypeDeclaration));
+	typeDeclaration->id = copyNodeString(id);
 	typeDeclaration->expression = expression;
 	typeDeclaration->type = TYPE_EXPRESSION;
 	return typeDeclaration;
@@ -368,9 +371,8 @@ TypeDeclaration *VariableTypeDeclarationSemanticAction(char *id, Expression *exp
 
 TypeDeclaration *ArrayTypeDeclarationSemanticAction(char *id, ArrayContent *arrayContent) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	TypeDeclaration *typeDeclaration = malloc(sizeof(TypeDeclaration));
-	typeDeclaration->id = malloc(strlen(id) + 1);
-	strcpy(typeDeclaration->id, id);
+	TypeDeclaration *typeDeclaration = allocateNode(sizeof(TypeDeclaration));
+	typeDeclaration->id = copyNodeString(id);
 	typeDeclaration->arrayContent = arrayContent;
 	typeDeclaration->type = TYPE_ARRAY;
 	return typeDeclaration;
@@ -378,9 +380,8 @@ TypeDeclaration *ArrayTypeDeclarationSemanticAction(char *id, ArrayContent *arra
 
 TypeDeclaration *EnumTypeDeclarationSemanticAction(char *id, ArgumentList *enumm) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	TypeDeclaration *typeDeclaration = malloc(sizeof(TypeDeclaration));
-	typeDeclaration->id = malloc(strlen(id) + 1);
-	strcpy(typeDeclaration->id, id);
+	TypeDeclaration *typeDeclaration = allocateNode(sizeof(TypeDeclaration));
+	typeDeclaration->id = copyNodeString(id);
 	typeDeclaration->enumm = enumm;
 	typeDeclaration->type = TYPE_ENUM;
 	return typeDeclaration;
@@ -388,9 +389,8 @@ TypeDeclaration *EnumTypeDeclarationSemanticAction(char *id, ArgumentList *enumm
 
 TypeDeclaration *InterfaceTypeDeclarationSemanticAction(char *id, VariableTypeList *interface) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	TypeDeclaration *typeDeclaration = malloc(sizeof(TypeDeclaration));
-	typeDeclaration->id = malloc(strlen(id) + 1);
-	strcpy(typeDeclaration->id, id);
+	TypeDeclaration *typeDeclaration = allocateNode(sizeof(TypeDeclaration));
+	typeDeclaration->id = copyNodeString(id);
 	typeDeclaration->interface = interface;
 	typeDeclaration->type = TYPE_INTERFACE;
 	return typeDeclaration;
@@ -399,7 +399,7 @@ TypeDeclaration *InterfaceTypeDeclarationSemanticAction(char *id, VariableTypeLi
 // FLow Control -------------------------------------------------------------------------------------------------------------------------
 IfStatement *IfSemanticAction(Expression *expression, Code *statement, Code *elseStatement) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	IfStatement *ifStatement = malloc(sizeof(IfStatement));
+	IfStatement *ifStatement = allocateNode(sizeof(IfStatement));
 	ifStatement->condition = expression;
 	ifStatement->thenBody = statement;
 	ifStatement->elseBody = elseStatement;
@@ -408,7 +408,7 @@ IfStatement *IfSemanticAction(Expression *expression, Code *statement, Code *els
 
 SwitchContent *SwitchContentSemanticAction(Expression *expression, Code *body, SwitchContent *next){
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	SwitchContent *switchContent = malloc(sizeof(SwitchContent));
+	SwitchContent *switchContent = allocateNode(sizeof(SwitchContent));
 	switchContent->condition = expression;
 	switchContent->body = body;
 	switchContent->next = next;
@@ -417,7 +417,7 @@ SwitchContent *SwitchContentSemanticAction(Expression *expression, Code *body, S
 
 SwitchStatement *SwitchSemanticAction(char *id, SwitchContent *switchContent){
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	SwitchStatement *switchStatement = malloc(sizeof(SwitchStatement));
+	SwitchStatement *switchStatement = allocateNode(sizeof(SwitchStatement));
 	switchStatement->id = id;
 	switchStatement->content = switchContent;
 	return switchStatement;
@@ -425,27 +425,29 @@ SwitchStatement *SwitchSemanticAction(char *id, SwitchContent *switchContent){
 
 ParamsFor *ForParamsSemanticAction(Declaration *init, Expression *condition, Expression *update) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	ParamsFor *params = malloc(sizeof(ParamsFor));
+	ParamsFor *params = allocateNode(sizeof(ParamsFor));
 	params->init = init;
 	params->condition = condition;
 	params->update = update;
+	params->updateType = EXPRESSION_UT;
 	params->type = FOR_CLASSIC;
 	return params;
 }
 
 ParamsFor *ForParamsIncDecSemanticAction(Declaration *init, Expression *condition, IncDec *update) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	ParamsFor *params = malloc(sizeof(ParamsFor));
+	ParamsFor *params = allocateNode(sizeof(ParamsFor));
 	params->init = init;
 	params->condition = condition;
 	params->updateIncDec = update;
+	params->updateType = INC_DEC_UT;
 	params->type = FOR_CLASSIC;
 	return params;
 }
 
 ParamsFor *ForOfParamsSemanticAction(Declaration *value, IterableVariable *iterable) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	ParamsFor *params = malloc(sizeof(ParamsFor));
+	ParamsFor *params = allocateNode(sizeof(ParamsFor));
 	params->value = value;
 	params->iterable = iterable;
 	params->type = FOR_OF;
@@ -454,7 +456,7 @@ ParamsFor *ForOfParamsSemanticAction(Declaration *value, IterableVariable *itera
 
 ForLoop *ForSemanticAction(ParamsFor *params, Code *code) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	ForLoop *forLoop = malloc(sizeof(ForLoop));
+	ForLoop *forLoop = allocateNode(sizeof(ForLoop));
 	forLoop->params = params;
 	forLoop->body = code;
 	return forLoop;
@@ -462,7 +464,7 @@ ForLoop *ForSemanticAction(ParamsFor *params, Code *code) {
 
 WhileLoop *WhileSemanticAction(Expression *condition, Code *code) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	WhileLoop *whileLoop = malloc(sizeof(WhileLoop));
+	WhileLoop *whileLoop = allocateNode(sizeof(WhileLoop));
 	whileLoop->condition = condition;
 	whileLoop->body = code;
 	return whileLoop;
@@ -470,7 +472,7 @@ WhileLoop *WhileSemanticAction(Expression *condition, Code *code) {
 // Await -------------------------------------------------------------------------------------------------------------------------
 Expression *AwaitExpressionSemanticAction(Expression *expression) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Expression *newExpression = (Expression *) malloc(sizeof(Expression));
+	Expression *newExpression = allocateNode(sizeof(Expression));
 	newExpression->type = AWAIT_OP;
 	newExpression->expression = expression;
 	return newExpression;
@@ -482,8 +484,8 @@ ArgumentList *ArgumentListSemanticAction(Expression *expression, ArgumentList *n
 	if (expression == NULL) {
 		return NULL;
 	}
-	ArgumentList *argList = malloc(sizeof(ArgumentList));
-	argList->expression = malloc(sizeof(Expression));
+	ArgumentList *argList = allocateNode(sizeof(ArgumentList));
+	argList->expression = allocateNode(sizeof(Expression));
 	argList->expression = expression;
 	argList->next = next;
 	return argList;
@@ -494,9 +496,8 @@ FunctionCall *FunctionCallSemanticAction(char *id, ArgumentList *arguments, Func
 	if (id == NULL) {
 		return NULL;
 	}
-	FunctionCall *functionCall = malloc(sizeof(FunctionCall));
-	functionCall->id = malloc(strlen(id) + 1);
-	strcpy(functionCall->id, id);
+	FunctionCall *functionCall = allocateNode(sizeof(FunctionCall));
+	functionCall->id = copyNodeString(id);
 	functionCall->arguments = arguments;
 	functionCall->type = type;
 	return functionCall;
@@ -507,7 +508,7 @@ FunctionBody *FunctionBodySemanticAction(Code *code, ReturnValue *returnValue) {
 	if (code == NULL && returnValue == NULL) {
 		return NULL;
 	}
-	FunctionBody *functionBody = malloc(sizeof(FunctionBody));
+	FunctionBody *functionBody = allocateNode(sizeof(FunctionBody));
 	functionBody->code = code;
 	functionBody->returnValue = returnValue;
 	return functionBody;
@@ -518,7 +519,7 @@ ReturnValue *ReturnExpressionSemanticAction(Expression *expression){
 	if (expression == NULL) {
 		return NULL;
 	}
-	ReturnValue *returnValue = malloc(sizeof(ReturnValue));
+	ReturnValue *returnValue = allocateNode(sizeof(ReturnValue));
 	returnValue->expression = expression;
 	returnValue->type = EXPRESSION_RT;
 	return returnValue;
@@ -529,7 +530,7 @@ ReturnValue *ReturnArrowFunctionSemanticAction(ArrowFunction *arrowFunction){
 	if (arrowFunction == NULL) {
 		return NULL;
 	}
-	ReturnValue *returnValue = malloc(sizeof(ReturnValue));
+	ReturnValue *returnValue = allocateNode(sizeof(ReturnValue));
 	returnValue->arrowFunction = arrowFunction;
 	returnValue->type = ARROWFUNCTION_RT;
 	return returnValue;
@@ -540,7 +541,7 @@ ReturnValue *ReturnFunctionCallSemanticAction(FunctionCall *functionCall){
 	if (functionCall == NULL) {
 		return NULL;
 	}
-	ReturnValue *returnValue = malloc(sizeof(ReturnValue));
+	ReturnValue *returnValue = allocateNode(sizeof(ReturnValue));
 	returnValue->functionCall = functionCall;
 	returnValue->type = FUNCTIONCALL_RT;
 	return returnValue;
@@ -551,7 +552,7 @@ ReturnValue *ReturnAsyncFunctionSemanticAction(AsyncFunction *asyncFunction){
 	if (asyncFunction == NULL) {
 		return NULL;
 	}
-	ReturnValue *returnValue = malloc(sizeof(ReturnValue));
+	ReturnValue *returnValue = allocateNode(sizeof(ReturnValue));
 	returnValue->asyncFunction = asyncFunction;
 	returnValue->type = ASYNC_FUNCTION_RT;
 	return returnValue;
@@ -562,9 +563,8 @@ FunctionDeclaration *FunctionDeclarationSemanticAction(char *id, VariableTypeLis
 	if (id == NULL) {
 		return NULL;
 	}
-	FunctionDeclaration *functionDeclaration = malloc(sizeof(FunctionDeclaration));
-	functionDeclaration->id = malloc(strlen(id) + 1);
-	strcpy(functionDeclaration->id, id);
+	FunctionDeclaration *functionDeclaration = allocateNode(sizeof(FunctionDeclaration));
+	functionDeclaration->id = copyNodeString(id);
 	functionDeclaration->arguments = arguments;
 	functionDeclaration->returnType = returnType;
 	functionDeclaration->body = body;
@@ -576,7 +576,7 @@ ArrowFunction *ArrowFunctionSemanticAction(VariableTypeList *arguments, Type *re
 	if (arguments == NULL) {
 		return NULL;
 	}
-	ArrowFunction *arrowFunction = malloc(sizeof(ArrowFunction));
+	ArrowFunction *arrowFunction = allocateNode(sizeof(ArrowFunction));
 	arrowFunction->arguments = arguments;
 	arrowFunction->returnType = returnType;
 	arrowFunction->body = body;
@@ -588,9 +588,8 @@ AsyncFunction *AsyncFunctionSemanticAction(char *id, VariableTypeList *arguments
 	if (id == NULL) {
 		return NULL;
 	}
-	AsyncFunction *asyncFunction = malloc(sizeof(asyncFunction));
-	asyncFunction->id = malloc(strlen(id) + 1);
-	strcpy(asyncFunction->id, id);
+	AsyncFunction *asyncFunction = allocateNode(sizeof(AsyncFunction));
+	asyncFunction->id = copyNodeString(id);
 	asyncFunction->arguments = arguments;
 	asyncFunction->promiseReturnType = promiseReturnType;
 	asyncFunction->body = body;
@@ -603,7 +602,7 @@ Statement *IfStatementSemanticAction(IfStatement *ifStatement) {
 	if (ifStatement == NULL) {
 		return NULL;
 	}
-	Statement *code = malloc(sizeof(Code));
+	Statement *code = allocateNode(sizeof(Code));
 	code->statement = IF_ST;
 	code->ifStatement = ifStatement;
 	return code;
@@ -614,7 +613,7 @@ Statement *ForStatementSemanticAction(ForLoop *forLoop) {
 	if (forLoop == NULL) {
 		return NULL;
 	}
-	Statement *code = malloc(sizeof(Code));
+	Statement *code = allocateNode(sizeof(Code));
 	code->statement = FOR_ST;
 	code->forLoop = forLoop;
 	return code;
@@ -625,7 +624,7 @@ Statement *DeclarationStatementSemanticAction(Declaration *declaration) {
 	if (declaration == NULL) {
 		return NULL;
 	}
-	Statement *stat = malloc(sizeof(Code));
+	Statement *stat = allocateNode(sizeof(Code));
 	stat->statement = DECLARATION_ST;
 	stat->declaration = declaration;
 	return stat;
@@ -636,7 +635,7 @@ Statement *TypeDeclarationStatementSemanticAction(TypeDeclaration *typeDeclarati
 	if (typeDeclaration == NULL) {
 		return NULL;
 	}
-	Statement *stat = malloc(sizeof(Code));
+	Statement *stat = allocateNode(sizeof(Code));
 	stat->statement = TYPE_DECLARATION_ST;
 	stat->typeDeclaration = typeDeclaration;
 	return stat;
@@ -647,7 +646,7 @@ Statement *FunctionCallStatementSemanticAction(FunctionCall *functionCall) {
 	if (functionCall == NULL) {
 		return NULL;
 	}
-	Statement *stat = malloc(sizeof(Code));
+	Statement *stat = allocateNode(sizeof(Code));
 	stat->statement = FUNCTIONCALL_ST;
 	stat->functionCall = functionCall;
 	return stat;
@@ -658,7 +657,7 @@ Statement *FunctionDeclarationStatementSemanticAction(FunctionDeclaration *funct
 	if (functionDeclaration == NULL) {
 		return NULL;
 	}
-	Statement *stat = malloc(sizeof(Code));
+	Statement *stat = allocateNode(sizeof(Code));
 	stat->statement = FUNCTION_DECLARATION_ST;
 	stat->FunctionDeclaration = functionDeclaration;
 	return stat;
@@ -669,7 +668,7 @@ Statement *AsyncFunctionStatementSemanticAction(AsyncFunction *asyncFunction) {
 	if (asyncFunction == NULL) {
 		return NULL;
 	}
-	Statement *stat = malloc(sizeof(Code));
+	Statement *stat = allocateNode(sizeof(Code));
 	stat->statement = ASYNC_FUNCTION_ST;
 	stat->asyncFunction = asyncFunction;
 	return stat;
@@ -680,7 +679,7 @@ Statement *WhileStatementSemanticAction(WhileLoop *whileLoop) {
 	if (whileLoop == NULL) {
 		return NULL;
 	}
-	Statement *stat = malloc(sizeof(Code));
+	Statement *stat = allocateNode(sizeof(Code));
 	stat->statement = WHILE_ST;
 	stat->whileLoop = whileLoop;
 	return stat;
@@ -691,7 +690,7 @@ Statement *ExpressionStatementSemanticAction(Expression *expression) {
 	if (expression == NULL) {
 		return NULL;
 	}
-	Statement *stat = malloc(sizeof(Code));
+	Statement *stat = allocateNode(sizeof(Code));
 	stat->statement = EXPRESSION_ST;
 	stat->expression = expression;
 	return stat;
@@ -702,7 +701,7 @@ Statement *IncDecStatementSemanticAction(IncDec *incDec) {
 	if (incDec == NULL) {
 		return NULL;
 	}
-	Statement *stat = malloc(sizeof(Code));
+	Statement *stat = allocateNode(sizeof(Code));
 	stat->statement = INC_DEC_ST;
 	stat->incDec = incDec;
 	return stat;
@@ -713,7 +712,7 @@ Statement *ReturnStatementSemanticAction(Expression *returnValue) {
 	if (returnValue == NULL) {
 		return NULL;
 	}
-	Statement *stat = malloc(sizeof(Statement));
+	Statement *stat = allocateNode(sizeof(Statement));
 	stat->statement = RETURN_ST;
 	return stat;
 }
@@ -723,7 +722,7 @@ Statement *VariableStatementSemanticAction(Variable *variable) {
 	if (variable == NULL) {
 		return NULL;
 	}
-	Statement *stat = malloc(sizeof(Statement));
+	Statement *stat = allocateNode(sizeof(Statement));
 	stat->statement = VARIABLE_ST;
 	stat->variable = variable;
 	return stat;
@@ -734,7 +733,7 @@ Statement *SwitchStatementSemanticAction(SwitchStatement *switchStatement) {
 	if (switchStatement == NULL) {
 		return NULL;
 	}
-	Statement *code = malloc(sizeof(Code));
+	Statement *code = allocateNode(sizeof(Code));
 	code->statement = SWITCH_ST;
 	code->switchStatement = switchStatement;
 	return code;
@@ -746,15 +745,16 @@ Code *CodeSemanticAction(Statement *statement, Code *next) {
 	if (statement == NULL) {
 		return NULL;
 	}
-	Code *code = malloc(sizeof(Code));
+	Code *code = allocateNode(sizeof(Code));
 	code->statement = statement;
+	code->next = next;
 	return code;
 }
 
 // Program -------------------------------------------------------------------------------------------------------------------------
 Program *CodeProgramSemanticAction(CompilerState *compilerState, Code *code) {
 	_logSyntacticAnalyzerAction(__FUNCTION__);
-	Program *program = calloc(1, sizeof(Program));
+	Program *program = allocateNode(sizeof(Program));
 	program->code = code;
 	compilerState->abstractSyntaxtTree = program;
 	if (0 < flexCurrentContext()) {
@@ -3,6 +3,7 @@
 
 #include "../../shared/CompilerState.h"
 #include "../../shared/Logger.h"
+#include "../../shared/StringPool.h"
 #include "../../shared/Type.h"
 #include "AbstractSyntaxTree.h"
 #include "SyntacticAnalyzer.h"
@@ -19,7 +20,7 @@ void shutdownBisonActionsModule();
  */
 
 Constant *IntConstantSemanticAction(int value);
-Constant *FloatConstantSemanticAction(float value);
+Constant *FloatConstantSemanticAction(double value);
 Constant *StringConstantSemanticAction(char *value);
 Constant *BooleanConstantSemanticAction(char value);
 
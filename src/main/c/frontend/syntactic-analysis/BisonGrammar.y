@@ -12,7 +12,7 @@
 	char * single_type;
 	char * id;
 	int value_int;
-    float value_float;
+    double value_double;
     char *value_str;
     char value_bool;
 	char * error;
@@ -114,7 +114,7 @@
 %token <token> PIPE
 %token <token> EQUAL
 %token <value_int> INT_VALUE
-%token <value_float> FLOAT_VALUE
+%token <value_double> FLOAT_VALUE
 %token <value_str> STRING_VALUE
 %token <value_bool> BOOL_VALUE
 
@@ -0,0 +1,90 @@
+#include "Arena.h"
+
+/**
+ * The alignment of every allocation, enough for any scalar type.
+ */
+#define ARENA_ALIGNMENT 16
+
+/* PRIVATE FUNCTIONS */
+
+static size_t _align(const size_t size);
+static ArenaChunk * _createChunk(Arena * arena, const size_t size);
+
+/**
+ * Rounds the size up, so every allocation is suitably aligned for any type.
+ */
+static size_t _align(const size_t size) {
+	return (size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+}
+
+static ArenaChunk * _createChunk(Arena * arena, const size_t size) {
+	const size_t chunkSize = arena->chunkSize < size ? size : arena->chunkSize;
+	ArenaChunk * chunk = malloc(sizeof(ArenaChunk) + chunkSize);
+	chunk->next = arena->chunk;
+	chunk->size = chunkSize;
+	chunk->used = 0;
+	arena->chunk = chunk;
+	arena->reservedBytes += chunkSize;
+	return chunk;
+}
+
+/* PUBLIC FUNCTIONS */
+
+Arena * createArena(const size_t chunkSize) {
+	Arena * arena = calloc(1, sizeof(Arena));
+	arena->chunkSize = _align(chunkSize);
+	return arena;
+}
+
+void destroyArena(Arena * arena) {
+	if (arena != NULL) {
+		ArenaChunk * chunk = arena->chunk;
+		while (chunk != NULL) {
+			ArenaChunk * next = chunk->next;
+			free(chunk);
+			chunk = next;
+		}
+		free(arena);
+	}
+}
+
+void * allocateInArena(Arena * arena, const size_t size) {
+	const size_t alignedSize = _align(size == 0 ? 1 : size);
+	ArenaChunk * chunk = arena->chunk;
+	if (chunk == NULL || chunk->size - chunk->used < alignedSize) {
+		chunk = _createChunk(arena, alignedSize);
+	}
+	void * pointer = chunk->memory + chunk->used;
+	chunk->used += alignedSize;
+	arena->allocatedBytes += alignedSize;
+	++arena->allocations;
+	return memset(pointer, 0, alignedSize);
+}
+
+void * reallocateInArena(Arena * arena, void * pointer, const size_t size, const size_t newSize) {
+	if (pointer == NULL) {
+		return allocateInArena(arena, newSize);
+	}
+	if (newSize <= size) {
+		return pointer;
+	}
+	ArenaChunk * chunk = arena->chunk;
+	const size_t alignedSize = _align(size);
+	const size_t alignedNewSize = _align(newSize);
+	if ((char *) pointer + alignedSize == chunk->memory + chunk->used && alignedNewSize - alignedSize <= chunk->size - chunk->used) {
+		memset(chunk->memory + chunk->used, 0, alignedNewSize - alignedSize);
+		chunk->used += alignedNewSize - alignedSize;
+		arena->allocatedBytes += alignedNewSize - alignedSize;
+		return pointer;
+	}
+	void * newPointer = allocateInArena(arena, newSize);
+	memcpy(newPointer, pointer, size);
+	return newPointer;
+}
+
+char * copyStringInArena(Arena * arena, const char * string) {
+	const size_t length = strlen(string);
+	char * copy = allocateInArena(arena, 1 + length);
+	memcpy(copy, string, length);
+	return copy;
+}
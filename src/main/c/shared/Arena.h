@@ -0,0 +1,58 @@
+#ifndef ARENA_HEADER
+#define ARENA_HEADER
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * A chunk of memory owned by an arena. Chunks are chained, so the memory of
+ * an arena never moves once it has been handed out.
+ */
+typedef struct ArenaChunk {
+	struct ArenaChunk * next;
+	size_t size;
+	size_t used;
+	char memory[];
+} ArenaChunk;
+
+/**
+ * A bump-pointer allocator. Every allocation lives until the whole arena is
+ * destroyed, which releases thousands of small objects at once.
+ */
+typedef struct {
+	ArenaChunk * chunk;
+	size_t chunkSize;
+	size_t allocatedBytes;
+	size_t reservedBytes;
+	unsigned int allocations;
+} Arena;
+
+/**
+ * Creates an arena that reserves memory in chunks of (at least) the specified
+ * size.
+ */
+Arena * createArena(const size_t chunkSize);
+
+/**
+ * Destroys an arena, and every object allocated within it.
+ */
+void destroyArena(Arena * arena);
+
+/**
+ * Allocates zero-initialized memory inside the arena, aligned for any type.
+ */
+void * allocateInArena(Arena * arena, const size_t size);
+
+/**
+ * Grows a previous allocation of the arena to a new size, preserving its
+ * content. If it was the last allocation it grows in place, otherwise it is
+ * copied (and the old memory is kept until the arena is destroyed).
+ */
+void * reallocateInArena(Arena * arena, void * pointer, const size_t size, const size_t newSize);
+
+/**
+ * Copies a string inside the arena.
+ */
+char * copyStringInArena(Arena * arena, const char * string);
+
+#endif
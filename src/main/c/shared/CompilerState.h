@@ -11,6 +11,17 @@ typedef enum {
 	FAILED = 1
 } CompilationStatus;
 
+/**
+ * What the compilation emits: JavaScript (from the AST), x86-64 assembly for
+ * Linux (from the IR), or the assembly whenever the program fits in what the
+ * native backend supports, and JavaScript otherwise (see "--target").
+ */
+typedef enum {
+	JAVASCRIPT_TARGET = 0,
+	X86_64_TARGET,
+	AUTOMATIC_TARGET
+} Target;
+
 /**
  * The global state of the compiler. Should transport every data structure
  * needed across the different phases of a compilation.
@@ -19,12 +30,31 @@ typedef struct {
 	// The root node of the AST.
 	void * abstractSyntaxtTree;
 
+	// The program lowered into SSA form (an IR module).
+	void * intermediateRepresentation;
+
+	// The sites of the program, and their counts (a Profile), if profiling.
+	void * profile;
+
 	// A flag that indicates the current state of the compilation so far.
 	boolean succeed;
 
+	// The optimization level (-O0, -O1 or -O2) that enables each pass.
+	unsigned int optimizationLevel;
+
+	// The output of the emission passes.
+	Target target;
+
+	// Report the time, nodes and memory of every pass (--time-passes).
+	boolean timePasses;
+
+	// The profile that the instrumented output writes (--profile-generate),
+	// and the one that guides the optimizations (--profile-use), if any.
+	const char * profileOutput;
+	const char * profileInput;
+
 	// TODO: Add an stack to handle nested scopes.
 	// TODO: Add a symbol table.
-	// TODO: Add configuration.
 	// TODO: ...
 
 	// The computed value of the entire program (only for the calculator).
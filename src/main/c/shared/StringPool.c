@@ -0,0 +1,60 @@
+#include "StringPool.h"
+
+/**
+ * The number of buckets of the pool (a power of two).
+ */
+#define STRING_POOL_BUCKETS 256
+
+typedef struct PooledString {
+	struct PooledString * next;
+	unsigned int hash;
+	char * string;
+} PooledString;
+
+/* MODULE INTERNAL STATE */
+
+static Arena * _arena = NULL;
+static PooledString * _buckets[STRING_POOL_BUCKETS];
+
+void initializeStringPoolModule() {
+	_arena = createArena(4096);
+	memset(_buckets, 0, sizeof(_buckets));
+}
+
+void shutdownStringPoolModule() {
+	destroyArena(_arena);
+	_arena = NULL;
+}
+
+/* PRIVATE FUNCTIONS */
+
+static unsigned int _hash(const char * string);
+
+/**
+ * The FNV-1a hash of a string.
+ */
+static unsigned int _hash(const char * string) {
+	unsigned int hash = 2166136261u;
+	for (; *string != '\0'; ++string) {
+		hash = (hash ^ (unsigned char) *string) * 16777619u;
+	}
+	return hash;
+}
+
+/* PUBLIC FUNCTIONS */
+
+char * internString(const char * string) {
+	const unsigned int hash = _hash(string);
+	PooledString ** bucket = &_buckets[hash & (STRING_POOL_BUCKETS - 1)];
+	for (PooledString * pooled = *bucket; pooled != NULL; pooled = pooled->next) {
+		if (pooled->hash == hash && strcmp(pooled->string, string) == 0) {
+			return pooled->string;
+		}
+	}
+	PooledString * pooled = allocateInArena(_arena, sizeof(PooledString));
+	pooled->next = *bucket;
+	pooled->hash = hash;
+	pooled->string = copyStringInArena(_arena, string);
+	*bucket = pooled;
+	return pooled->string;
+}
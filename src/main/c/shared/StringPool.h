@@ -0,0 +1,23 @@
+#ifndef STRING_POOL_HEADER
+#define STRING_POOL_HEADER
+
+#include "Arena.h"
+#include "Type.h"
+#include <stdlib.h>
+#include <string.h>
+
+/** Initialize module's internal state. */
+void initializeStringPoolModule();
+
+/** Shutdown module's internal state. */
+void shutdownStringPoolModule();
+
+/**
+ * Returns the unique (read-only) copy of a string. Two interned strings are
+ * equal if and only if they are the same pointer, so the lexemes of the
+ * literals can be compared without looking at their characters. The copies
+ * live until the module is shut down.
+ */
+char * internString(const char * string);
+
+#endif
@@ -0,0 +1,163 @@
+#include "ThreadPool.h"
+
+#if defined (_WIN32)
+
+struct ThreadPool {
+	unsigned int threads;
+};
+
+/* PUBLIC FUNCTIONS */
+
+ThreadPool * createThreadPool(const unsigned int threads) {
+	ThreadPool * threadPool = calloc(1, sizeof(ThreadPool));
+	threadPool->threads = 1;
+	return threadPool;
+}
+
+void destroyThreadPool(ThreadPool * threadPool) {
+	free(threadPool);
+}
+
+unsigned int threadPoolSize(const ThreadPool * threadPool) {
+	return threadPool->threads;
+}
+
+void runInThreadPool(ThreadPool * threadPool, ThreadPoolTask task, void * context, const unsigned int count) {
+	for (unsigned int k = 0; k < count; ++k) {
+		task(context, k);
+	}
+}
+
+#else
+
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * The workers sleep until a new loop (a new generation) is published. Then,
+ * every thread takes the next pending index until none is left, and the last
+ * one to leave the loop wakes up the caller.
+ */
+struct ThreadPool {
+	pthread_t * workers;
+	unsigned int threads;
+	pthread_mutex_t mutex;
+	pthread_cond_t started;
+	pthread_cond_t finished;
+	unsigned long generation;
+	boolean stopping;
+	ThreadPoolTask task;
+	void * context;
+	unsigned int count;
+	unsigned int next;
+	unsigned int active;
+};
+
+/* PRIVATE FUNCTIONS */
+
+static void _runLoop(ThreadPool * threadPool);
+static void * _work(void * argument);
+
+/**
+ * Takes indexes of the current loop until none is left. Must be called
+ * with the mutex locked, and returns with the mutex locked.
+ */
+static void _runLoop(ThreadPool * threadPool) {
+	++threadPool->active;
+	while (threadPool->next < threadPool->count) {
+		const unsigned int index = threadPool->next++;
+		pthread_mutex_unlock(&threadPool->mutex);
+		threadPool->task(threadPool->context, index);
+		pthread_mutex_lock(&threadPool->mutex);
+	}
+	if (--threadPool->active == 0) {
+		pthread_cond_broadcast(&threadPool->finished);
+	}
+}
+
+static void * _work(void * argument) {
+	ThreadPool * threadPool = argument;
+	unsigned long generation = 0;
+	pthread_mutex_lock(&threadPool->mutex);
+	while (true) {
+		while (!threadPool->stopping && threadPool->generation == generation) {
+			pthread_cond_wait(&threadPool->started, &threadPool->mutex);
+		}
+		if (threadPool->stopping) {
+			break;
+		}
+		generation = threadPool->generation;
+		_runLoop(threadPool);
+	}
+	pthread_mutex_unlock(&threadPool->mutex);
+	return NULL;
+}
+
+/* PUBLIC FUNCTIONS */
+
+ThreadPool * createThreadPool(const unsigned int threads) {
+	ThreadPool * threadPool = calloc(1, sizeof(ThreadPool));
+	unsigned int threads_ = threads;
+	if (threads_ == 0) {
+		const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+		threads_ = processors < 1 ? 1 : (unsigned int) processors;
+	}
+	pthread_mutex_init(&threadPool->mutex, NULL);
+	pthread_cond_init(&threadPool->started, NULL);
+	pthread_cond_init(&threadPool->finished, NULL);
+	// The calling thread is one of the threads of every loop.
+	threadPool->workers = calloc(threads_, sizeof(pthread_t));
+	threadPool->threads = 1;
+	for (unsigned int k = 1; k < threads_; ++k) {
+		if (pthread_create(&threadPool->workers[k - 1], NULL, _work, threadPool) != 0) {
+			break;
+		}
+		++threadPool->threads;
+	}
+	return threadPool;
+}
+
+void destroyThreadPool(ThreadPool * threadPool) {
+	if (threadPool != NULL) {
+		pthread_mutex_lock(&threadPool->mutex);
+		threadPool->stopping = true;
+		pthread_cond_broadcast(&threadPool->started);
+		pthread_mutex_unlock(&threadPool->mutex);
+		for (unsigned int k = 1; k < threadPool->threads; ++k) {
+			pthread_join(threadPool->workers[k - 1], NULL);
+		}
+		pthread_cond_destroy(&threadPool->finished);
+		pthread_cond_destroy(&threadPool->started);
+		pthread_mutex_destroy(&threadPool->mutex);
+		free(threadPool->workers);
+		free(threadPool);
+	}
+}
+
+unsigned int threadPoolSize(const ThreadPool * threadPool) {
+	return threadPool->threads;
+}
+
+void runInThreadPool(ThreadPool * threadPool, ThreadPoolTask task, void * context, const unsigned int count) {
+	if (threadPool->threads == 1 || count < 2) {
+		for (unsigned int k = 0; k < count; ++k) {
+			task(context, k);
+		}
+		return;
+	}
+	pthread_mutex_lock(&threadPool->mutex);
+	threadPool->task = task;
+	threadPool->context = context;
+	threadPool->count = count;
+	threadPool->next = 0;
+	++threadPool->generation;
+	pthread_cond_broadcast(&threadPool->started);
+	_runLoop(threadPool);
+	// Late workers may still be running the tail of the loop.
+	while (threadPool->active != 0) {
+		pthread_cond_wait(&threadPool->finished, &threadPool->mutex);
+	}
+	pthread_mutex_unlock(&threadPool->mutex);
+}
+
+#endif
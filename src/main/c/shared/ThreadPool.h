@@ -0,0 +1,41 @@
+#ifndef THREAD_POOL_HEADER
+#define THREAD_POOL_HEADER
+
+#include "Type.h"
+#include <stdlib.h>
+
+/**
+ * A task of a parallel loop. It receives the shared context of the loop, and
+ * the index of the iteration to run.
+ */
+typedef void (*ThreadPoolTask)(void * context, const unsigned int index);
+
+/**
+ * A fixed set of worker threads that run parallel loops. On platforms
+ * without POSIX threads the loops run on the calling thread.
+ */
+typedef struct ThreadPool ThreadPool;
+
+/**
+ * Creates a pool with the specified number of workers. Zero means one per
+ * online processor.
+ */
+ThreadPool * createThreadPool(const unsigned int threads);
+
+/**
+ * Stops the workers of the pool and releases it.
+ */
+void destroyThreadPool(ThreadPool * threadPool);
+
+/**
+ * Returns the number of threads that run the loops (including the caller).
+ */
+unsigned int threadPoolSize(const ThreadPool * threadPool);
+
+/**
+ * Runs the task for every index in [0, count) and waits for all of them.
+ * The calling thread takes part in the loop.
+ */
+void runInThreadPool(ThreadPool * threadPool, ThreadPoolTask task, void * context, const unsigned int count);
+
+#endif
@@ -0,0 +1,2 @@
+profile 5 9adbcdc3
+10 90 100 1 100 0 10 90 1 0